@@ -50,6 +50,169 @@ bool argobj_copyipaddr(const struct argobj * const arg,
                        const char * const src,
                        void * const dst);
 
+/**
+ * @brief Copy a file I/O event notification model from a source memory area to
+ *        a destination memory area if it satisfies the restrictions contained
+ *        in the argument object.
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to an event notification model name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if an event notification model was copied to a destination
+ *         memory area.
+ */
+bool argobj_copyevent(const struct argobj * const arg,
+                      const char * const src,
+                      void * const dst);
+
+/**
+ * @brief Copy a server listener model from a source memory area to a
+ *        destination memory area if it satisfies the restrictions contained
+ *        in the argument object.
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a listener model name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a listener model was copied to a destination memory area.
+ */
+bool argobj_copylistener(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst);
+
+/**
+ * @brief Copy a TCP receive sink from a source memory area to a destination
+ *        memory area if it is a valid sink (copy, trunc or mmap).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a receive sink name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a receive sink was copied to a destination memory area.
+ */
+bool argobj_copysink(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst);
+
+/**
+ * @brief Copy a stream direction from a source memory area to a destination
+ *        memory area if it is a valid direction (forward, reverse or duplex).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a stream direction name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a stream direction was copied to a destination memory area.
+ */
+bool argobj_copydirection(const struct argobj * const arg,
+                          const char * const src,
+                          void * const dst);
+
+/**
+ * @brief Copy a workload from a source memory area to a destination memory
+ *        area if it is a valid workload (stream, rr or crr).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a workload name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a workload was copied to a destination memory area.
+ */
+bool argobj_copyworkload(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst);
+
+/**
+ * @brief Copy a report format from a source memory area to a destination
+ *        memory area if it is a valid format (text, json, csv or binary).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a report format name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a report format was copied to a destination memory area.
+ */
+bool argobj_copyformat(const struct argobj * const arg,
+                       const char * const src,
+                       void * const dst);
+
+/**
+ * @brief Copy a flow ranking from a source memory area to a destination
+ *        memory area if it is a valid ranking (slowest, goodput, retrans or
+ *        latency).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a flow ranking name.
+ * @param[in,out] dst A pointer to a destination buffer.
+ *
+ * @return True if a flow ranking was copied to a destination memory area.
+ */
+bool argobj_copyrank(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst);
+
+/**
+ * @brief Copy a file path from a source memory area to a destination memory
+ *        area if it fits (stdout for none).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a file path.
+ * @param[in,out] dst A pointer to a destination buffer of PATH_MAX bytes.
+ *
+ * @return True if a file path was copied to a destination memory area.
+ */
+bool argobj_copypath(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst);
+
+/**
+ * @brief Copy a CPU affinity policy from a source memory area to a destination
+ *        memory area if it is a valid policy (none, cpu, core or a CPU list).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a CPU affinity policy.
+ * @param[in,out] dst A pointer to a destination CPU set.
+ *
+ * @return True if a CPU affinity policy was copied to a destination memory
+ *         area.
+ */
+bool argobj_copyaffinity(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst);
+
+/**
+ * @brief Copy a set of IP addresses from a source memory area to a destination
+ *        memory area if it is a valid set (none or a list of addresses or CIDR
+ *        blocks with optional ports).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to an IP address list.
+ * @param[in,out] dst A pointer to a destination IP address set.
+ *
+ * @return True if a set of IP addresses was copied to a destination memory
+ *         area.
+ */
+bool argobj_copyaddrset(const struct argobj * const arg,
+                        const char * const src,
+                        void * const dst);
+
+/**
+ * @brief Copy a network device name from a source memory area to a
+ *        destination memory area if it fits in a device name (none for no
+ *        device).
+ *
+ * @param[in]     arg A pointer to an argument object.
+ * @param[in]     src A pointer to a network device name.
+ * @param[in,out] dst A pointer to a destination buffer of IFNAMSIZ bytes.
+ *
+ * @return True if a network device name was copied to a destination memory
+ *         area.
+ */
+bool argobj_copydevice(const struct argobj * const arg,
+                       const char * const src,
+                       void * const dst);
+
 /**
  * @brief Copy a 16-bit unsigned integer value  from a source memory area to a
  *        destination memory area if it satisfies the restrictions contained in
@@ -10,9 +10,14 @@
 #ifndef _ARGS_H_
 #define _ARGS_H_
 
+#include "fion_obj.h"
 #include "sock_obj.h"
 #include "system_types.h"
+#include "util_cpu.h"
+#include "util_inet.h"
 
+#include <limits.h>
+#include <net/if.h>
 #include <netinet/in.h>
 
 enum args_mode
@@ -23,6 +28,37 @@ enum args_mode
     ARGS_MODE_REPT = 0x04
 };
 
+enum args_listener
+{
+    ARGS_LISTENER_SINGLE    = 0, // One acceptor thread hands sockets to workers
+    ARGS_LISTENER_SHARD     = 1, // One SO_REUSEPORT listener per worker
+    ARGS_LISTENER_CBPF      = 2, // Sharded listeners steered by receiving CPU
+    ARGS_LISTENER_EXCLUSIVE = 3  // One listener watched by all workers
+};
+
+enum args_workload
+{
+    ARGS_WORKLOAD_STREAM = 0, // Bulk transfer from the client to the server
+    ARGS_WORKLOAD_RR     = 1, // Request/response transactions
+    ARGS_WORKLOAD_CRR    = 2  // A connection per request/response transaction
+};
+
+enum args_format
+{
+    ARGS_FORMAT_TEXT   = 0, // Fixed-width text for a terminal
+    ARGS_FORMAT_JSON   = 1, // JSON Lines
+    ARGS_FORMAT_CSV    = 2, // Comma-separated values
+    ARGS_FORMAT_BINARY = 3  // Fixed-size binary records
+};
+
+enum args_rank
+{
+    ARGS_RANK_SLOWEST = 0, // Lowest goodput first
+    ARGS_RANK_GOODPUT = 1, // Highest goodput first
+    ARGS_RANK_RETRANS = 2, // Most retransmits first
+    ARGS_RANK_LATENCY = 3  // Highest latency first
+};
+
 struct args_opts
 {
     bool nodelay;
@@ -30,24 +66,50 @@ struct args_opts
 
 struct args_obj
 {
-    enum args_mode     mode;
-    int32_t            family;
-    uint16_t           affinity;
-    uint64_t           ratelimitbps;
-    char               ipaddr[INET6_ADDRSTRLEN];
-    enum sockobj_model arch;
-    bool               echo;
-    uint64_t           intervalusec;
-    uint64_t           buflen;
-    struct args_opts   opts;
-    uint64_t           datalimitbyte;
-    uint32_t           maxcon;
-    uint16_t           ipport;
-    int32_t            backlog;
-    uint32_t           threads;
-    uint64_t           timelimitusec;
-    int32_t            type;
-    uint16_t           loglevel;
+    enum args_mode      mode;
+    int32_t             family;
+    struct utilcpu_set  affinity;
+    uint64_t            ratelimitbps;
+    uint64_t            threadbps;
+    uint64_t            aggregatebps;
+    uint64_t            spinusec;
+    char                ipaddr[INET6_ADDRSTRLEN];
+    struct utilinet_set source;
+    struct utilinet_set dest;
+    char                device[IFNAMSIZ];
+    enum sockobj_model  arch;
+    bool                echo;
+    enum fionobj_model  event;
+    bool                gso;
+    enum args_listener  listener;
+    enum sockobj_sink   sink;
+    enum sockobj_direction direction;
+    uint64_t            intervalusec;
+    uint64_t            buflen;
+    uint32_t            batch;
+    struct args_opts    opts;
+    uint64_t            datalimitbyte;
+    uint32_t            maxcon;
+    uint32_t            connrate;
+    uint32_t            connwindow;
+    uint16_t            ipport;
+    int32_t             backlog;
+    uint32_t            threads;
+    uint64_t            timelimitusec;
+    int32_t             type;
+    bool                uring;
+    bool                zerocopy;
+    enum args_workload  workload;
+    enum args_format    format;
+    char                output[PATH_MAX];
+    uint32_t            top;
+    enum args_rank      rank;
+    uint32_t            reqlen;
+    uint32_t            resplen;
+    uint32_t            window;
+    bool                fastopen;
+    bool                reset;
+    uint16_t            loglevel;
 };
 
 /**
@@ -19,11 +19,14 @@ struct dlist_node
                       *next;
 };
 
+struct mempool;
+
 struct dlist
 {
     struct dlist_node *head;
     struct dlist_node *tail;
     uint32_t           size;
+    struct mempool    *pool; // Node pool (NULL to allocate nodes from the heap)
 };
 
 /**
@@ -0,0 +1,81 @@
+/**
+ * @file      doorbell_obj.h
+ * @brief     Doorbell (cross-thread wakeup) object interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _DOORBELL_OBJ_H_
+#define _DOORBELL_OBJ_H_
+
+#include "system_types.h"
+
+struct doorbellobj_priv;
+
+struct doorbellobj
+{
+    struct doorbellobj_priv *priv;
+    uint64_t                 ringcnt; // Number of wakeups written
+};
+
+/**
+ * @brief Create a doorbell object. A doorbell wakes a thread blocked on the
+ *        doorbell file descriptor in its event loop, and only costs a system
+ *        call if that thread armed the doorbell before it blocked.
+ *
+ * @param[in,out] obj A pointer to a doorbell object.
+ *
+ * @return True if a doorbell object was created.
+ */
+bool doorbellobj_create(struct doorbellobj * const obj);
+
+/**
+ * @brief Destroy a doorbell object.
+ *
+ * @param[in,out] obj A pointer to a doorbell object.
+ *
+ * @return True if a doorbell object was destroyed.
+ */
+bool doorbellobj_destroy(struct doorbellobj * const obj);
+
+/**
+ * @brief Get the file descriptor that becomes readable when a doorbell rings.
+ *
+ * @param[in] obj A pointer to a doorbell object.
+ *
+ * @return A file descriptor (-1 on error).
+ */
+int32_t doorbellobj_getfd(const struct doorbellobj * const obj);
+
+/**
+ * @brief Arm a doorbell before blocking. The waiting thread must check its
+ *        wakeup condition again after arming the doorbell and before blocking.
+ *
+ * @param[in,out] obj A pointer to a doorbell object.
+ *
+ * @return True if a doorbell object was armed.
+ */
+bool doorbellobj_arm(struct doorbellobj * const obj);
+
+/**
+ * @brief Ring a doorbell. The doorbell file descriptor is only written if the
+ *        doorbell was armed.
+ *
+ * @param[in,out] obj A pointer to a doorbell object.
+ *
+ * @return True if the doorbell file descriptor was written.
+ */
+bool doorbellobj_ring(struct doorbellobj * const obj);
+
+/**
+ * @brief Disarm a doorbell and consume any pending wakeup.
+ *
+ * @param[in,out] obj A pointer to a doorbell object.
+ *
+ * @return True if a pending wakeup was consumed.
+ */
+bool doorbellobj_clear(struct doorbellobj * const obj);
+
+#endif // _DOORBELL_OBJ_H_
@@ -0,0 +1,68 @@
+/**
+ * @file      fion_epoll.h
+ * @brief     File I/O event notification epoll interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _FION_EPOLL_H_
+#define _FION_EPOLL_H_
+
+#include "fion_obj.h"
+#include "system_types.h"
+
+/**
+ * @see fion_create() for interface comments.
+ */
+bool fionepoll_create(struct fionobj * const obj);
+
+/**
+ * @see fion_destroy() for interface comments.
+ */
+bool fionepoll_destroy(struct fionobj * const obj);
+
+/**
+ * @see fion_insertfd() for interface comments.
+ */
+bool fionepoll_insertfd(struct fionobj * const obj, const int32_t fd);
+
+/**
+ * @see fion_deletefd() for interface comments.
+ */
+bool fionepoll_deletefd(struct fionobj * const obj, const int32_t fd);
+
+/**
+ * @see fion_setflags() for interface comments.
+ */
+bool fionepoll_setflags(struct fionobj * const obj);
+
+/**
+ * @see fion_setfdflags() for interface comments.
+ */
+bool fionepoll_setfdflags(struct fionobj * const obj,
+                          const int32_t fd,
+                          const uint32_t pevents);
+
+/**
+ * @see fion_poll() for interface comments.
+ */
+bool fionepoll_poll(struct fionobj * const obj);
+
+/**
+ * @see fion_getevents() for interface comments.
+ *
+ * @note A deleted file descriptor is replaced by the last file descriptor of
+ *       the group, so only the position of the last file descriptor changes.
+ */
+uint32_t fionepoll_getevents(struct fionobj * const obj, const uint32_t pos);
+
+/**
+ * @see fion_getready() for interface comments.
+ */
+uint32_t fionepoll_getready(struct fionobj * const obj,
+                            const uint32_t pos,
+                            int32_t * const fd);
+
+#endif // _FION_EPOLL_H_
@@ -15,8 +15,11 @@
 
 enum fionobj_pevent
 {
-    FIONOBJ_PEVENT_IN  = 0x01,
-    FIONOBJ_PEVENT_OUT = 0x02
+    FIONOBJ_PEVENT_IN   = 0x01,
+    FIONOBJ_PEVENT_OUT  = 0x02,
+    FIONOBJ_PEVENT_EDGE = 0x04, // Edge-triggered (if supported by the model)
+    FIONOBJ_PEVENT_EXCL = 0x08  // Wake one of the objects watching a shared
+                                // file descriptor (if supported by the model)
 };
 
 enum fionobj_revent
@@ -24,7 +27,16 @@ enum fionobj_revent
     FIONOBJ_REVENT_TIMEOUT  = 0x01,
     FIONOBJ_REVENT_ERROR    = 0x02,
     FIONOBJ_REVENT_INREADY  = 0x04,
-    FIONOBJ_REVENT_OUTREADY = 0x08
+    FIONOBJ_REVENT_OUTREADY = 0x08,
+    FIONOBJ_REVENT_HANGUP   = 0x10  // Peer shut down its side (unread input
+                                    // may remain)
+};
+
+enum fionobj_model
+{
+    FIONOBJ_MODEL_POLL    = 0,
+    FIONOBJ_MODEL_EPOLL   = 1,
+    FIONOBJ_MODEL_EPOLLET = 2
 };
 
 struct fionobj;
@@ -82,6 +94,21 @@ struct fionobj_ops
      */
     bool (*fion_setflags)(struct fionobj * const obj);
 
+    /**
+     * @brief Set the file I/O event flags to handle for a single file
+     *        descriptor (i.e., a per-file descriptor interest mask that
+     *        remains in effect until the next call to fion_setflags()).
+     *
+     * @param[in,out] obj     A pointer to a file I/O event notification object.
+     * @param[in]     fd      A file descriptor.
+     * @param[in]     pevents The file I/O event flags to handle.
+     *
+     * @return True on success.
+     */
+    bool (*fion_setfdflags)(struct fionobj * const obj,
+                            const int32_t fd,
+                            const uint32_t pevents);
+
     /**
      * @brief Check a file I/O event object for events of interest. The object
      *        will be polled until the file I/O event object timeout is reached
@@ -99,21 +126,59 @@ struct fionobj_ops
      *
      * @param[in,out] obj A pointer to a file I/O event notification object.
      * @param[in]     pos The position of a file descriptor within a group of
-     *                    file descriptors.
+     *                    file descriptors (0 to the group size - 1). Deleting
+     *                    a file descriptor may change the positions of others.
      *
      * @return The latest poll events returned for a file descriptor (0 if no
      *         file descriptor events are available).
      */
     uint32_t (*fion_getevents)(struct fionobj * const obj, const uint32_t pos);
+
+    /**
+     * @brief Get a file descriptor that was reported ready by the latest poll.
+     *        Only ready file descriptors are visited, so iterating over
+     *        positions 0 to (readycount - 1) costs O(ready) rather than O(n).
+     *
+     * @param[in,out] obj A pointer to a file I/O event notification object.
+     * @param[in]     pos The position of a file descriptor within the group of
+     *                    ready file descriptors.
+     * @param[out]    fd  A pointer to a ready file descriptor.
+     *
+     * @return The latest poll events returned for a ready file descriptor (0
+     *         if no ready file descriptor exists at the position).
+     */
+    uint32_t (*fion_getready)(struct fionobj * const obj,
+                              const uint32_t pos,
+                              int32_t * const fd);
 };
 
 struct fionobj
 {
     struct fionobj_ops ops;
     struct vector      fds;
+    struct vector      slots;      // Position of each file descriptor plus one
+                                   // indexed by file descriptor (epoll)
+    struct vector      ready;
+    enum fionobj_model model;
+    int32_t            efd;        // Event notification file descriptor
     int32_t            timeoutms;
     uint32_t           pevents;
     uint32_t           revents;
+    uint32_t           readycount; // Ready file descriptor count
+    uint32_t           readypos;   // Last ready position visited (poll)
+    uint32_t           readyindex; // File descriptor index of the last ready
+                                   // position visited (poll)
 };
 
+/**
+ * @brief Create a file I/O event notification object using a specific event
+ *        notification model.
+ *
+ * @param[in,out] obj   A pointer to a file I/O event notification object.
+ * @param[in]     model A file I/O event notification model.
+ *
+ * @return True on success.
+ */
+bool fionobj_create(struct fionobj * const obj, const enum fionobj_model model);
+
 #endif // _FION_OBJ_H_
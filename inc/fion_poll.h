@@ -38,6 +38,13 @@ bool fionpoll_deletefd(struct fionobj * const obj, const int32_t fd);
  */
 bool fionpoll_setflags(struct fionobj * const obj);
 
+/**
+ * @see fion_setfdflags() for interface comments.
+ */
+bool fionpoll_setfdflags(struct fionobj * const obj,
+                         const int32_t fd,
+                         const uint32_t pevents);
+
 /**
  * @see fion_poll() for interface comments.
  */
@@ -48,4 +55,11 @@ bool fionpoll_poll(struct fionobj * const obj);
  */
 uint32_t fionpoll_getevents(struct fionobj * const obj, const uint32_t pos);
 
+/**
+ * @see fion_getready() for interface comments.
+ */
+uint32_t fionpoll_getready(struct fionobj * const obj,
+                           const uint32_t pos,
+                           int32_t * const fd);
+
 #endif // _FION_POLL_H_
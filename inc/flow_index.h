@@ -0,0 +1,212 @@
+/**
+ * @file      flow_index.h
+ * @brief     Flow index interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _FLOW_INDEX_H_
+#define _FLOW_INDEX_H_
+
+#include "system_types.h"
+
+#define FLOWINDEX_ADDRLEN 16 // Largest address length (IPv6)
+
+// A five-tuple names a flow by its protocol, its addresses and its ports. The
+// unused bytes of an address must be zero.
+struct flowindex_tuple
+{
+    uint8_t  proto;                     // IP protocol (e.g., IPPROTO_TCP)
+    uint8_t  family;                    // Address family
+    uint16_t clientport;                // Client port
+    uint16_t serverport;                // Server port
+    uint8_t  client[FLOWINDEX_ADDRLEN]; // Client address (network order)
+    uint8_t  server[FLOWINDEX_ADDRLEN]; // Server address (network order)
+};
+
+struct flowindex_link
+{
+    struct flowindex_link *parent,
+                          *left,
+                          *right;
+    int32_t                height; // Height of the subtree of the link
+};
+
+// A node is kept in the object of the flow that it indexes, so that indexing
+// a flow never allocates.
+struct flowindex_node
+{
+    struct flowindex_link   idlink;    // Link in the flow id tree
+    struct flowindex_link   tuplelink; // Link in the five-tuple tree
+    struct flowindex_node  *older,     // Links in the age list
+                           *newer;
+    struct flowindex_tuple  tuple;     // Five-tuple of the flow
+    uint32_t                id;        // Flow id (unique in an index)
+    uint64_t                ageus;     // Time that the flow was last touched
+};
+
+// A flow index keeps its flows in two balanced (AVL) trees, one ordered by
+// flow id and the other by five-tuple (and then by flow id, since a flow may
+// not know its five-tuple until it connects), so that a flow is looked up,
+// added or removed in O(log n) and the flows are listed in order of either
+// key. The flows are also kept in a list ordered by the time they were last
+// touched (a new flow has not been touched yet), so that the flows that were
+// not touched since a given time are found in O(1) each without visiting the
+// other flows.
+struct flowindex
+{
+    struct flowindex_link *idroot;
+    struct flowindex_link *tupleroot;
+    struct flowindex_node *oldest;
+    struct flowindex_node *newest;
+    uint32_t               count;
+};
+
+/**
+ * @brief Create an empty flow index.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ *
+ * @return True if a flow index was created.
+ */
+bool flowindex_create(struct flowindex * const index);
+
+/**
+ * @brief Destroy a flow index. The nodes of the index are not freed.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ *
+ * @return True if a flow index was destroyed.
+ */
+bool flowindex_destroy(struct flowindex * const index);
+
+/**
+ * @brief Add a flow to a flow index as its oldest flow.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ * @param[in,out] node  A pointer to the node of a flow whose id, five-tuple
+ *                      and age are set.
+ *
+ * @return True if a flow was added (false if its id is already indexed).
+ */
+bool flowindex_insert(struct flowindex * const index,
+                      struct flowindex_node * const node);
+
+/**
+ * @brief Remove a flow from a flow index.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ * @param[in,out] node  A pointer to the node of an indexed flow.
+ *
+ * @return True if a flow was removed.
+ */
+bool flowindex_remove(struct flowindex * const index,
+                      struct flowindex_node * const node);
+
+/**
+ * @brief Change the five-tuple of an indexed flow (e.g., once it connects).
+ *
+ * @param[in,out] index A pointer to a flow index.
+ * @param[in,out] node  A pointer to the node of an indexed flow.
+ * @param[in]     tuple A pointer to the new five-tuple of the flow.
+ *
+ * @return True if the five-tuple of a flow was changed.
+ */
+bool flowindex_settuple(struct flowindex * const index,
+                        struct flowindex_node * const node,
+                        const struct flowindex_tuple * const tuple);
+
+/**
+ * @brief Touch an indexed flow, making it the newest flow of a flow index.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ * @param[in,out] node  A pointer to the node of an indexed flow.
+ * @param[in]     tsus  The current time in microseconds.
+ *
+ * @return Void.
+ */
+void flowindex_touch(struct flowindex * const index,
+                     struct flowindex_node * const node,
+                     const uint64_t tsus);
+
+/**
+ * @brief Find a flow by flow id.
+ *
+ * @param[in] index A pointer to a flow index.
+ * @param[in] id    A flow id.
+ *
+ * @return A pointer to the node of the flow (NULL if not found).
+ */
+struct flowindex_node *flowindex_getid(const struct flowindex * const index,
+                                       const uint32_t id);
+
+/**
+ * @brief Find a flow by five-tuple.
+ *
+ * @param[in] index A pointer to a flow index.
+ * @param[in] tuple A pointer to a five-tuple.
+ *
+ * @return A pointer to the node of the flow with the five-tuple and the
+ *         lowest flow id (NULL if not found).
+ */
+struct flowindex_node *flowindex_gettuple(const struct flowindex * const index,
+                                          const struct flowindex_tuple * const tuple);
+
+/**
+ * @brief Get the oldest flow of a flow index (the flow that was touched the
+ *        longest time ago).
+ *
+ * @param[in] index A pointer to a flow index.
+ *
+ * @return A pointer to the node of the oldest flow (NULL if empty).
+ */
+struct flowindex_node *flowindex_getoldest(const struct flowindex * const index);
+
+/**
+ * @brief Get the flow with the lowest flow id.
+ *
+ * @param[in] index A pointer to a flow index.
+ *
+ * @return A pointer to the node of the first flow (NULL if empty).
+ */
+struct flowindex_node *flowindex_firstid(const struct flowindex * const index);
+
+/**
+ * @brief Get the flow with the next flow id, in O(1) amortized.
+ *
+ * @param[in] node A pointer to the node of an indexed flow.
+ *
+ * @return A pointer to the node of the next flow (NULL if none).
+ */
+struct flowindex_node *flowindex_nextid(const struct flowindex_node * const node);
+
+/**
+ * @brief Get the flow with the lowest five-tuple.
+ *
+ * @param[in] index A pointer to a flow index.
+ *
+ * @return A pointer to the node of the first flow (NULL if empty).
+ */
+struct flowindex_node *flowindex_firsttuple(const struct flowindex * const index);
+
+/**
+ * @brief Get the flow with the next five-tuple, in O(1) amortized.
+ *
+ * @param[in] node A pointer to the node of an indexed flow.
+ *
+ * @return A pointer to the node of the next flow (NULL if none).
+ */
+struct flowindex_node *flowindex_nexttuple(const struct flowindex_node * const node);
+
+/**
+ * @brief Get the number of flows in a flow index.
+ *
+ * @param[in] index A pointer to a flow index.
+ *
+ * @return The number of indexed flows.
+ */
+uint32_t flowindex_getcount(const struct flowindex * const index);
+
+#endif // _FLOW_INDEX_H_
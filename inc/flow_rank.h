@@ -0,0 +1,119 @@
+/**
+ * @file      flow_rank.h
+ * @brief     Bounded flow ranking interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _FLOW_RANK_H_
+#define _FLOW_RANK_H_
+
+#include "system_types.h"
+
+#include <netinet/in.h>
+
+#define FLOWRANK_ADDRLEN (INET6_ADDRSTRLEN + 6) // <addr>:<port>
+
+struct flowrank_entry
+{
+    uint64_t val;                      // Ranked value
+    uint64_t goodputbps;               // Flow goodput of the ranking interval
+    uint64_t retrans;                  // Flow retransmits of the interval
+    uint64_t latencyns;                // Largest flow latency of the interval
+    uint32_t tid;                      // Worker thread id of the flow
+    uint32_t sid;                      // Flow id within the worker
+    char     client[FLOWRANK_ADDRLEN]; // Client address of the flow
+    char     server[FLOWRANK_ADDRLEN]; // Server address of the flow
+};
+
+// A ranking keeps the best entries offered to it in a binary heap whose root
+// is the worst of them, so a flow is ranked in O(log n) of the ranking size
+// and never in the number of flows.
+struct flowrank
+{
+    struct flowrank_entry *entries;
+    uint32_t               size;   // Largest number of ranked entries
+    uint32_t               count;  // Number of ranked entries
+    bool                   lowest; // Rank the lowest values first
+};
+
+/**
+ * @brief Create a bounded flow ranking.
+ *
+ * @param[in,out] rank   A pointer to a flow ranking.
+ * @param[in]     size   The largest number of ranked entries.
+ * @param[in]     lowest True to rank the lowest values first (e.g., the
+ *                       slowest flows).
+ *
+ * @return True if a flow ranking was created.
+ */
+bool flowrank_create(struct flowrank * const rank,
+                     const uint32_t size,
+                     const bool lowest);
+
+/**
+ * @brief Destroy a flow ranking.
+ *
+ * @param[in,out] rank A pointer to a flow ranking.
+ *
+ * @return True if a flow ranking was destroyed.
+ */
+bool flowrank_destroy(struct flowrank * const rank);
+
+/**
+ * @brief Remove all of the entries of a flow ranking.
+ *
+ * @param[in,out] rank A pointer to a flow ranking.
+ *
+ * @return Void.
+ */
+void flowrank_clear(struct flowrank * const rank);
+
+/**
+ * @brief Check if a value would be ranked, so that an entry only needs to be
+ *        filled in if it would be kept.
+ *
+ * @param[in] rank A pointer to a flow ranking.
+ * @param[in] val  A value to rank.
+ *
+ * @return True if an entry with the value would be ranked.
+ */
+bool flowrank_isranked(const struct flowrank * const rank, const uint64_t val);
+
+/**
+ * @brief Offer an entry to a flow ranking. The entry replaces the worst ranked
+ *        entry if the ranking is full.
+ *
+ * @param[in,out] rank  A pointer to a flow ranking.
+ * @param[in]     entry A pointer to a flow entry.
+ *
+ * @return True if the entry was ranked.
+ */
+bool flowrank_offer(struct flowrank * const rank,
+                    const struct flowrank_entry * const entry);
+
+/**
+ * @brief Offer all of the entries of a flow ranking to another flow ranking
+ *        (e.g., to merge the rankings of several workers).
+ *
+ * @param[in,out] dst A pointer to a flow ranking.
+ * @param[in]     src A pointer to a flow ranking.
+ *
+ * @return The number of entries ranked.
+ */
+uint32_t flowrank_merge(struct flowrank * const dst,
+                        const struct flowrank * const src);
+
+/**
+ * @brief Sort the entries of a flow ranking from best to worst. No entry may
+ *        be offered to a sorted ranking until it is cleared.
+ *
+ * @param[in,out] rank A pointer to a flow ranking.
+ *
+ * @return The number of ranked entries.
+ */
+uint32_t flowrank_sort(struct flowrank * const rank);
+
+#endif // _FLOW_RANK_H_
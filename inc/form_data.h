@@ -0,0 +1,82 @@
+/**
+ * @file      form_data.h
+ * @brief     Machine-readable presentation layer format interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _FORM_DATA_H_
+#define _FORM_DATA_H_
+
+#include "form_obj.h"
+#include "system_types.h"
+
+// The fields of a record, in the order that they are formatted. A body formats
+// an interval record, and a footer formats a summary record of the whole run.
+// The bit rates and latencies of an interval record are those of the interval,
+// and those of a summary record are those of the run.
+enum formdata_field
+{
+    FORMDATA_FIELD_TYPE = 0,  // Record type (0 for interval, 1 for summary)
+    FORMDATA_FIELD_TID,       // Worker thread id (thread count for aggregate)
+    FORMDATA_FIELD_AGGREGATE, // 1 for the sum of all workers, 0 for a worker
+    FORMDATA_FIELD_SID,       // Socket count
+    FORMDATA_FIELD_TSUS,      // Monotonic time of the record in microseconds
+    FORMDATA_FIELD_ELAPSEDUS, // Time since the first socket started
+    FORMDATA_FIELD_RECVBYTES, // Bytes received in the run
+    FORMDATA_FIELD_SENDBYTES, // Bytes sent in the run
+    FORMDATA_FIELD_RECVBPS,   // Receive bit rate
+    FORMDATA_FIELD_SENDBPS,   // Send bit rate
+    FORMDATA_FIELD_SYSCALLS,  // Data path system calls in the run
+    FORMDATA_FIELD_DATAGRAMS, // Datagrams in the run
+    FORMDATA_FIELD_CPU,       // CPU usage in percent
+    FORMDATA_FIELD_RRCOUNT,   // Transactions completed
+    FORMDATA_FIELD_RRLOST,    // Transactions without a response
+    FORMDATA_FIELD_RRP50NS,   // Transaction latency percentiles
+    FORMDATA_FIELD_RRP90NS,
+    FORMDATA_FIELD_RRP99NS,
+    FORMDATA_FIELD_RRP999NS,
+    FORMDATA_FIELD_RRMAXNS,
+    FORMDATA_FIELD_CONNCOUNT, // Connects completed (crr)
+    FORMDATA_FIELD_CONNFAIL,  // Connects that failed (crr)
+    FORMDATA_FIELD_CONNP50NS, // Connect latency percentiles (crr)
+    FORMDATA_FIELD_CONNP90NS,
+    FORMDATA_FIELD_CONNP99NS,
+    FORMDATA_FIELD_CONNP999NS,
+    FORMDATA_FIELD_CONNMAXNS,
+    FORMDATA_FIELDS
+};
+
+// A binary stream starts with a header (the magic bytes, a 16-bit version, a
+// 16-bit field count and the null-terminated field names), and each of its
+// records is an array of 64-bit little-endian field values.
+#define FORMDATA_MAGIC   "BRDATA"
+#define FORMDATA_VERSION 2
+
+/**
+ * @brief Create a format object that formats records as JSON Lines (one JSON
+ *        object per line).
+ *
+ * @see form_create() for interface comments.
+ */
+bool formdata_createjson(struct formobj * const obj, const int32_t bufsize);
+
+/**
+ * @brief Create a format object that formats records as comma-separated
+ *        values with a header line.
+ *
+ * @see form_create() for interface comments.
+ */
+bool formdata_createcsv(struct formobj * const obj, const int32_t bufsize);
+
+/**
+ * @brief Create a format object that formats records as fixed-size binary
+ *        records.
+ *
+ * @see form_create() for interface comments.
+ */
+bool formdata_createbinary(struct formobj * const obj, const int32_t bufsize);
+
+#endif // _FORM_DATA_H_
@@ -115,6 +115,8 @@ struct formobj
     uint64_t            intervalusec;
     uint64_t            timeoutusec;
     uint64_t            tsus;
+    uint64_t            records;
+    bool                aggregate; // Formats the sum of all workers
 };
 
 #endif // _FORM_OBJ_H_
@@ -0,0 +1,83 @@
+/**
+ * @file      lfqueue.h
+ * @brief     Bounded lock-free queue interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _LFQUEUE_H_
+#define _LFQUEUE_H_
+
+#include "system_types.h"
+
+struct lfqueue_priv;
+
+struct lfqueue
+{
+    struct lfqueue_priv *priv;
+};
+
+/**
+ * @brief Create a bounded lock-free queue. Values may be pushed by multiple
+ *        producer threads and popped by multiple consumer threads without
+ *        a lock.
+ *
+ * @param[in,out] queue A pointer to a lock-free queue.
+ * @param[in]     count The minimum queue capacity (rounded up to a power of
+ *                      two).
+ *
+ * @return True if a lock-free queue was created.
+ */
+bool lfqueue_create(struct lfqueue * const queue, const uint32_t count);
+
+/**
+ * @brief Destroy a lock-free queue. Values remaining in the queue are not
+ *        freed.
+ *
+ * @param[in,out] queue A pointer to a lock-free queue.
+ *
+ * @return True if a lock-free queue was destroyed.
+ */
+bool lfqueue_destroy(struct lfqueue * const queue);
+
+/**
+ * @brief Push a value to the tail of a lock-free queue.
+ *
+ * @param[in,out] queue A pointer to a lock-free queue.
+ * @param[in]     val   A non-null value to push.
+ *
+ * @return True if a value was pushed (false if the queue is full).
+ */
+bool lfqueue_push(struct lfqueue * const queue, void * const val);
+
+/**
+ * @brief Pop a value from the head of a lock-free queue.
+ *
+ * @param[in,out] queue A pointer to a lock-free queue.
+ *
+ * @return The value at the head of the queue (NULL if the queue is empty).
+ */
+void *lfqueue_pop(struct lfqueue * const queue);
+
+/**
+ * @brief Get the number of values in a lock-free queue. The size is only a
+ *        snapshot if other threads are pushing or popping values.
+ *
+ * @param[in] queue A pointer to a lock-free queue.
+ *
+ * @return The number of values in a lock-free queue.
+ */
+uint32_t lfqueue_getsize(const struct lfqueue * const queue);
+
+/**
+ * @brief Get the capacity of a lock-free queue.
+ *
+ * @param[in] queue A pointer to a lock-free queue.
+ *
+ * @return The maximum number of values in a lock-free queue.
+ */
+uint32_t lfqueue_getcapacity(const struct lfqueue * const queue);
+
+#endif // _LFQUEUE_H_
@@ -0,0 +1,102 @@
+/**
+ * @file      mem_pool.h
+ * @brief     Fixed-size object pool interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _MEM_POOL_H_
+#define _MEM_POOL_H_
+
+#include "system_types.h"
+
+struct mempool_priv;
+
+// A pool preallocates its objects in a single slab and keeps the free objects
+// in a lock-free queue, so objects may be taken by one thread and returned by
+// another without a lock. An object is only allocated from the heap if the
+// slab is exhausted.
+struct mempool
+{
+    struct mempool_priv *priv;
+};
+
+struct mempool_stats
+{
+    uint32_t count;  // Objects in the slab
+    uint32_t inuse;  // Slab objects in use
+    uint32_t peak;   // Largest number of slab objects in use
+    uint64_t gets;   // Objects taken from the slab
+    uint64_t misses; // Objects allocated from the heap (slab exhausted)
+};
+
+/**
+ * @brief Create an object pool and preallocate its objects.
+ *
+ * @param[in,out] pool  A pointer to an object pool.
+ * @param[in]     size  The size of an object in bytes.
+ * @param[in]     count The number of objects to preallocate.
+ *
+ * @return True if an object pool was created.
+ */
+bool mempool_create(struct mempool * const pool,
+                    const uint32_t size,
+                    const uint32_t count);
+
+/**
+ * @brief Destroy an object pool. Slab objects that are still in use are freed
+ *        with the pool.
+ *
+ * @param[in,out] pool A pointer to an object pool.
+ *
+ * @return True if an object pool was destroyed.
+ */
+bool mempool_destroy(struct mempool * const pool);
+
+/**
+ * @brief Take a zeroed object from an object pool, or allocate one from the
+ *        heap if the pool has no free object.
+ *
+ * @param[in,out] pool A pointer to an object pool.
+ *
+ * @return A pointer to an object (NULL on error).
+ */
+void *mempool_get(struct mempool * const pool);
+
+/**
+ * @brief Return an object to an object pool if it belongs to the pool's slab.
+ *
+ * @param[in,out] pool A pointer to an object pool.
+ * @param[in]     obj  A pointer to an object.
+ *
+ * @return True if the object was returned to the pool (false if the object
+ *         does not belong to the pool).
+ */
+bool mempool_put(struct mempool * const pool, void * const obj);
+
+/**
+ * @brief Return an object to an object pool, or free it if it was allocated
+ *        from the heap.
+ *
+ * @param[in,out] pool A pointer to an object pool.
+ * @param[in]     obj  A pointer to an object taken from the pool.
+ *
+ * @return Void.
+ */
+void mempool_free(struct mempool * const pool, void * const obj);
+
+/**
+ * @brief Get the statistics of an object pool. The statistics are only a
+ *        snapshot if other threads are using the pool.
+ *
+ * @param[in]  pool  A pointer to an object pool.
+ * @param[out] stats A pointer to object pool statistics.
+ *
+ * @return True if the statistics were copied.
+ */
+bool mempool_getstats(const struct mempool * const pool,
+                      struct mempool_stats * const stats);
+
+#endif // _MEM_POOL_H_
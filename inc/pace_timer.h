@@ -0,0 +1,94 @@
+/**
+ * @file      pace_timer.h
+ * @brief     Pacing timer interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _PACE_TIMER_H_
+#define _PACE_TIMER_H_
+
+#include "system_types.h"
+
+struct pacetimer_priv;
+
+// A pacing timer wakes a thread blocked in its event loop at a deadline with
+// microsecond resolution (an event loop timeout only has millisecond
+// resolution). A deadline that must be met more precisely than a wakeup allows
+// is approached by waking early and spinning for the remaining time.
+struct pacetimer
+{
+    struct pacetimer_priv *priv;
+    uint64_t               arms;  // Number of times the timer was armed
+    uint64_t               spins; // Number of deadlines spun for
+};
+
+/**
+ * @brief Create a pacing timer and set the timer slack of the calling thread,
+ *        so the timer must be created by the thread that waits for it.
+ *
+ * @param[in,out] timer   A pointer to a pacing timer.
+ * @param[in]     spinus  The time to spin before a deadline in microseconds
+ *                        (0 if the timer never spins).
+ * @param[in]     slackns The timer slack of the calling thread in nanoseconds.
+ *
+ * @return True if a pacing timer was created.
+ */
+bool pacetimer_create(struct pacetimer * const timer,
+                      const uint64_t spinus,
+                      const uint64_t slackns);
+
+/**
+ * @brief Destroy a pacing timer.
+ *
+ * @param[in,out] timer A pointer to a pacing timer.
+ *
+ * @return True if a pacing timer was destroyed.
+ */
+bool pacetimer_destroy(struct pacetimer * const timer);
+
+/**
+ * @brief Get the file descriptor that becomes readable when a pacing timer
+ *        fires.
+ *
+ * @param[in] timer A pointer to a pacing timer.
+ *
+ * @return A file descriptor (-1 if the platform has no timer file
+ *         descriptors).
+ */
+int32_t pacetimer_getfd(const struct pacetimer * const timer);
+
+/**
+ * @brief Arm a pacing timer to fire the spin time before a deadline. The
+ *        timer is not armed again if it is already armed for the deadline.
+ *
+ * @param[in,out] timer A pointer to a pacing timer.
+ * @param[in]     dueus The monotonic deadline in microseconds.
+ *
+ * @return True if the timer is armed for the deadline.
+ */
+bool pacetimer_arm(struct pacetimer * const timer, const uint64_t dueus);
+
+/**
+ * @brief Consume the expiry of a pacing timer that fired.
+ *
+ * @param[in,out] timer A pointer to a pacing timer.
+ *
+ * @return True if an expiry was consumed.
+ */
+bool pacetimer_clear(struct pacetimer * const timer);
+
+/**
+ * @brief Spin until a deadline if it is within the spin time of a pacing
+ *        timer.
+ *
+ * @param[in,out] timer A pointer to a pacing timer.
+ * @param[in]     dueus The monotonic deadline in microseconds.
+ *
+ * @return True if the deadline was spun for.
+ */
+bool pacetimer_spin(struct pacetimer * const timer, const uint64_t dueus);
+
+#endif // _PACE_TIMER_H_
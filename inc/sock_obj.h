@@ -10,13 +10,13 @@
 #ifndef _SOCK_OBJ_H_
 #define _SOCK_OBJ_H_
 
-#include "fion_obj.h"
 #include "system_types.h"
 #include "token_bucket.h"
 #include "util_cpu.h"
 #include "util_stats.h"
 #include "vector.h"
 
+#include <net/if.h>
 #include <netdb.h>
 #include <netinet/in.h>
 
@@ -82,7 +82,8 @@ struct sockobj_ops
                         const int32_t backlog);
 
     /**
-     * @brief Accept a connection on a listener socket.
+     * @brief Accept a connection on a listener socket. The call does not
+     *        wait, so the caller waits for the listener to become readable.
      *
      * @param[in,out] listener  A pointer to a listener socket object.
      * @param[in,out] obj       A pointer to a socket object to initialize
@@ -94,11 +95,14 @@ struct sockobj_ops
                         struct sockobj * const obj);
 
     /**
-     * @brief Initiate a connection on a socket.
+     * @brief Initiate a connection on a socket. The call does not wait for a
+     *        connection in progress (info.connerr is EINPROGRESS or
+     *        EALREADY), so the caller waits for the socket to become writable
+     *        and calls it again to get the result.
      *
      * @param[in,out] obj  A pointer to a socket object.
      *
-     * @return True on success.
+     * @return True if the socket is connected.
      */
     bool (*sock_connect)(struct sockobj * const obj);
 
@@ -132,7 +136,10 @@ struct sockobj_ops
      *                    socket.
      * @param[in]     len The maximum size of the receive buffer in bytes.
      *
-     * @return The number of bytes received from the socket (-1 on error).
+     * @return The number of bytes received from the socket (0 if the receive
+     *         would block, -1 on error or if the remote peer is closed). The
+     *         receive never waits for the socket to become ready; readiness
+     *         is the responsibility of the caller's event loop.
      */
     int32_t (*sock_recv)(struct sockobj * const obj,
                          void * const buf,
@@ -146,7 +153,10 @@ struct sockobj_ops
      *                    the socket.
      * @param[in]     len The maximum number of bytes in the send buffer.
      *
-     * @return The number of bytes sent to the socket (-1 on error).
+     * @return The number of bytes sent to the socket (0 if the send would
+     *         block, -1 on error). The send never waits for the socket to
+     *         become ready; readiness is the responsibility of the caller's
+     *         event loop.
      */
     int32_t (*sock_send)(struct sockobj * const obj,
                          void * const buf,
@@ -172,6 +182,20 @@ enum sockobj_model
     SOCKOBJ_MODEL_PEER2P = 0x03
 };
 
+enum sockobj_sink
+{
+    SOCKOBJ_SINK_COPY  = 0, // Copy received data into a buffer
+    SOCKOBJ_SINK_TRUNC = 1, // Discard received data in the kernel (MSG_TRUNC)
+    SOCKOBJ_SINK_MMAP  = 2  // Map received pages (TCP_ZEROCOPY_RECEIVE)
+};
+
+enum sockobj_direction
+{
+    SOCKOBJ_DIRECTION_FORWARD = 0, // Client sends and server receives
+    SOCKOBJ_DIRECTION_REVERSE = 1, // Server sends and client receives
+    SOCKOBJ_DIRECTION_DUPLEX  = 2  // Both ends send and receive at once
+};
+
 enum sockobj_state
 {
     SOCKOBJ_STATE_NULL    = 0x00,
@@ -205,12 +229,25 @@ struct sockobj_conf
     int32_t             type;   // e.g.: SOCK_DGRAM, SOCK_STREAM
     char                ipaddr[INET6_ADDRSTRLEN];
     uint16_t            ipport;
+    char                srcaddr[INET6_ADDRSTRLEN]; // Client source (empty if any)
+    char                device[IFNAMSIZ];          // Bound device (empty if any)
     int32_t             backlog;
     enum sockobj_model  model;
     int32_t             timeoutms;
     uint64_t            datalimitbyte;
     uint64_t            ratelimitbps;
     uint64_t            timelimitusec;
+    uint64_t            idlelimitusec; // Idle time before a datagram flow ends (0 if none)
+    uint32_t            batchcount; // Datagrams per receive or send call
+    uint32_t            batchlen;   // Datagram length in bytes in a batch
+    uint32_t            segmentlen; // UDP offload segment length (0 if disabled)
+    bool                zerocopy;   // Transmit without copying (MSG_ZEROCOPY)
+    enum sockobj_sink   sink;       // TCP receive sink
+    enum sockobj_direction direction; // Stream data direction
+    uint32_t            rrwindow;   // Transactions in flight (0 if streaming)
+    bool                reconnect;  // Connect once per transaction
+    bool                reset;      // Close with a reset (SO_LINGER 0)
+    bool                fastopen;   // Use TCP Fast Open
     struct vector      *opts;
 };
 
@@ -221,6 +258,17 @@ struct sockobj_flowstats
     struct utilstats_qty buflen;  // buffer size passed to/from socket function
 };
 
+struct sockobj_latency
+{
+    uint64_t cnt;  // Transactions completed (or samples)
+    uint64_t lost; // Transactions without a response
+    uint64_t p50;  // Latency percentiles in nanoseconds (or sample percentiles)
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
 struct sockobj_info
 {
     uint64_t                 startusec;
@@ -229,15 +277,36 @@ struct sockobj_info
     struct sockobj_flowstats send;
     struct sockobj_flowstats snaprecv;
     struct sockobj_flowstats snapsend;
+    uint64_t                 syscalls;  // data path system call count
+    uint64_t                 datagrams; // data path datagram count
+    uint32_t                 zcnext;    // next zero-copy send id
+    uint32_t                 zcdone;    // zero-copy send ids below are released
+    uint64_t                 zcsends;   // zero-copy sends released uncopied
+    uint64_t                 zccopies;  // zero-copy sends released after a copy
+    int32_t                  connerr;   // error of the last connect (0 if none)
+    uint64_t                 idleusec;  // start of an idle period (0 if active)
+    struct sockobj_latency   rr;        // transaction latency of an interval
+    struct sockobj_latency   rrtotal;   // transaction latency of a run
+    struct sockobj_latency   conn;      // connect latency of an interval
+    struct sockobj_latency   conntotal; // connect latency of a run
+    struct sockobj_latency   recvsize;  // stream receive size of a run (bytes)
+    struct sockobj_latency   sendsize;  // stream send size of a run (bytes)
+    struct sockobj_latency   recvgap;   // stream receive gap of a run (usec)
+    struct sockobj_latency   sendgap;   // paced stream send gap of a run (usec)
+    struct sockobj_latency   sendlate;  // paced stream send lateness of a run (usec)
+    uint64_t                 fairflows; // closed sockets with a goodput
+    double                   fairsum;   // sum of socket goodputs (bps)
+    double                   fairsumsq; // sum of squared socket goodputs
 };
 
 struct sockobj
 {
     struct utilcpu_info  cpu;
     struct sockobj_info  info;
-    struct sockobj_ops   ops;
-    struct fionobj       event;
+    const struct sockobj_ops *ops; // Shared operations table (NULL if destroyed)
     struct tokenbucket   tb;
+    uint64_t             tbheld;      // Tokens held from shared rate limits
+    uint64_t             tbreleaseus; // Time that the held tokens are earned
     int32_t              fd;
     uint32_t             sid;
     uint32_t             tid;
@@ -245,6 +314,8 @@ struct sockobj
                          addrpeer;
     struct sockobj_conf  conf;
     enum sockobj_state   state;
+    void                *sinkmap;    // TCP receive mapping (NULL if unmapped)
+    uint32_t             sinkmaplen; // TCP receive mapping length in bytes
 };
 
 /**
@@ -283,6 +354,28 @@ bool sockobj_getaddrsock(struct sockobj_addr * const addr);
  */
 bool sockobj_iserrfatal(const int32_t err);
 
+/**
+ * @brief Determine if a socket end sends stream data.
+ *
+ * @param[in] model     The socket model of the end (client or server).
+ * @param[in] direction The stream data direction.
+ *
+ * @return True if the socket end sends stream data.
+ */
+bool sockobj_issender(const enum sockobj_model model,
+                      const enum sockobj_direction direction);
+
+/**
+ * @brief Determine if a socket end receives stream data.
+ *
+ * @param[in] model     The socket model of the end (client or server).
+ * @param[in] direction The stream data direction.
+ *
+ * @return True if the socket end receives stream data.
+ */
+bool sockobj_isreceiver(const enum sockobj_model model,
+                        const enum sockobj_direction direction);
+
 /**
  * @see sock_create() for interface comments.
  */
@@ -36,6 +36,7 @@ struct socktcp_info
     uint64_t rxpackets; // Total segments received
     uint64_t rxbytes;   // Total bytes received
     uint64_t rxoobytes; // Total out-of-order bytes received
+    uint64_t retrans;   // Total segments retransmitted
 };
 
 /**
@@ -48,6 +49,17 @@ struct socktcp_info
  */
 bool socktcp_getinfo(const int32_t fd, struct socktcp_info * const info);
 
+/**
+ * @brief Reap the zero-copy send completion notifications of a TCP socket from
+ *        its error queue. Send ids below the socket's zcdone id are released
+ *        by the kernel, and their buffers may be reused.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ *
+ * @return The number of send ids released (-1 on error).
+ */
+int32_t socktcp_reapzerocopy(struct sockobj * const obj);
+
 /**
  * @see sock_create() for interface comments.
  */
@@ -58,6 +70,16 @@ bool socktcp_create(struct sockobj * const obj);
  */
 bool socktcp_destroy(struct sockobj * const obj);
 
+/**
+ * @see sock_open() for interface comments.
+ */
+bool socktcp_open(struct sockobj * const obj);
+
+/**
+ * @see sock_close() for interface comments.
+ */
+bool socktcp_close(struct sockobj * const obj);
+
 /**
  * @see sock_listen() for interface comments.
  */
@@ -69,6 +91,20 @@ bool socktcp_listen(struct sockobj * const obj, const int32_t backlog);
 bool socktcp_accept(struct sockobj * const listener,
                     struct sockobj * const obj);
 
+/**
+ * @brief Initialize a socket object with a connection that was already
+ *        accepted on a listener socket (e.g., by an asynchronous accept).
+ *
+ * @param[in,out] listener A pointer to a listener socket object.
+ * @param[in,out] obj      A pointer to a socket object to initialize.
+ * @param[in]     fd       The file descriptor of the accepted connection.
+ *
+ * @return True if the socket object was initialized.
+ */
+bool socktcp_acceptfd(struct sockobj * const listener,
+                      struct sockobj * const obj,
+                      const int32_t fd);
+
 /**
  * @see sock_connect() for interface comments.
  */
@@ -13,6 +13,19 @@
 #include "sock_obj.h"
 #include "system_types.h"
 
+// The maximum number of datagrams moved by a single batched receive or send
+// call (see sockobj_conf batchcount).
+#define SOCKUDP_BATCHMAX 256
+
+// The maximum number of segments and payload bytes in a single segmentation
+// offload buffer (see sockobj_conf segmentlen).
+#define SOCKUDP_SEGMENTMAX    64
+#define SOCKUDP_OFFLOADMAX 65507
+
+// The idle time after which a datagram flow ends, since a datagram peer does
+// not close a flow (see sockobj_conf idlelimitusec).
+#define SOCKUDP_IDLELIMITUS 5000000
+
 /**
  * @see sock_create() for interface comments.
  */
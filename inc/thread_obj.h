@@ -103,6 +103,18 @@ bool threadobj_sleepusec(const int32_t interval);
  */
 bool threadobj_isrunning(struct threadobj * const thread);
 
+/**
+ * @brief Pin a thread object to a CPU. The affinity of a thread object that has
+ *        not been started is applied when it starts.
+ *
+ * @param[in,out] thread A pointer to a thread object.
+ * @param[in]     cpu    A CPU number (-1 to allow the thread to run on any
+ *                       CPU).
+ *
+ * @return True if the CPU affinity of a thread object was set.
+ */
+bool threadobj_setaffinity(struct threadobj * const thread, const int32_t cpu);
+
 /**
  * @brief Suspend thread object caller.
  *
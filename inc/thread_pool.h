@@ -12,6 +12,7 @@
 
 #include "system_types.h"
 #include "thread_obj.h"
+#include "util_cpu.h"
 
 struct threadpool_priv;
 
@@ -94,6 +95,29 @@ bool threadpool_wait(struct threadpool * const pool, const uint32_t wait_count);
  */
 bool threadpool_wake(struct threadpool * const pool);
 
+/**
+ * @brief Set the CPU affinity of thread pool tasks. A thread that executes a
+ *        task is pinned to the CPU at the task id (modulo the CPU count) in a
+ *        resolved CPU set before the task function is called.
+ *
+ * @param[in,out] pool A pointer to a thread pool.
+ * @param[in]     set  A pointer to a resolved CPU set (see utilcpu_getset).
+ *
+ * @return True if the CPU affinity of thread pool tasks was set.
+ */
+bool threadpool_setaffinity(struct threadpool * const pool,
+                            const struct utilcpu_set * const set);
+
+/**
+ * @brief Get the CPU that a thread pool task will be pinned to.
+ *
+ * @param[in] pool   A pointer to a thread pool.
+ * @param[in] taskid A task id.
+ *
+ * @return A CPU number (-1 if the task is not pinned).
+ */
+int32_t threadpool_getcpu(struct threadpool * const pool, const uint32_t taskid);
+
 /**
  * @brief Get the thread pool task id of the calling thread.
  *
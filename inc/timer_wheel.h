@@ -0,0 +1,124 @@
+/**
+ * @file      timer_wheel.h
+ * @brief     Hierarchical timer wheel interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include "system_types.h"
+
+#define TIMERWHEEL_LEVELS 4
+#define TIMERWHEEL_BITS   8
+#define TIMERWHEEL_SLOTS  (1 << TIMERWHEEL_BITS)
+
+struct timerwheel_priv;
+
+// A timer wheel keeps its timers in slots of ticks, and each level of the
+// wheel has slots that are TIMERWHEEL_SLOTS times longer than the slots of the
+// level below it. A timer is scheduled and cancelled in O(1), and a timer that
+// is far from expiring only moves to a lower level when its slot is reached,
+// so the cost of advancing the wheel depends on the expired timers and not on
+// the number of scheduled timers. A timer further away than the span of the
+// top level waits in the top level until it is within reach.
+struct timerwheel
+{
+    struct timerwheel_priv *priv;
+};
+
+struct timerwheel_timer
+{
+    uint64_t key;      // Caller key of the timer
+    uint64_t expiryus; // Expiry time in microseconds
+};
+
+/**
+ * @brief Create a timer wheel.
+ *
+ * @param[in,out] wheel  A pointer to a timer wheel.
+ * @param[in]     tickus The length of a tick (a bottom level slot) in
+ *                       microseconds.
+ * @param[in]     nowus  The current time in microseconds.
+ *
+ * @return True if a timer wheel was created.
+ */
+bool timerwheel_create(struct timerwheel * const wheel,
+                       const uint64_t tickus,
+                       const uint64_t nowus);
+
+/**
+ * @brief Destroy a timer wheel and all of its timers.
+ *
+ * @param[in,out] wheel A pointer to a timer wheel.
+ *
+ * @return True if a timer wheel was destroyed.
+ */
+bool timerwheel_destroy(struct timerwheel * const wheel);
+
+/**
+ * @brief Schedule a timer. A timer that expires in the past expires on the
+ *        next advance of the wheel.
+ *
+ * @param[in,out] wheel    A pointer to a timer wheel.
+ * @param[in]     key      The caller key of the timer.
+ * @param[in]     expiryus The expiry time of the timer in microseconds.
+ *
+ * @return The handle of the timer (0 on error).
+ */
+uint32_t timerwheel_schedule(struct timerwheel * const wheel,
+                             const uint64_t key,
+                             const uint64_t expiryus);
+
+/**
+ * @brief Cancel a scheduled timer.
+ *
+ * @param[in,out] wheel  A pointer to a timer wheel.
+ * @param[in]     handle The handle of a scheduled timer.
+ *
+ * @return True if the timer was cancelled.
+ */
+bool timerwheel_cancel(struct timerwheel * const wheel, const uint32_t handle);
+
+/**
+ * @brief Advance a timer wheel to the current time and remove the timers that
+ *        have expired. The handles of the removed timers are no longer valid.
+ *
+ * @param[in,out] wheel  A pointer to a timer wheel.
+ * @param[in]     nowus  The current time in microseconds.
+ * @param[out]    timers A pointer to an array of expired timers.
+ * @param[in]     count  The number of timers in the array.
+ *
+ * @return The number of expired timers copied to the array (the wheel may
+ *         hold more expired timers if the array is full).
+ */
+uint32_t timerwheel_expire(struct timerwheel * const wheel,
+                           const uint64_t nowus,
+                           struct timerwheel_timer * const timers,
+                           const uint32_t count);
+
+/**
+ * @brief Get the earliest time at which a timer of a timer wheel may expire.
+ *        The time is exact for timers in the bottom level of the wheel, and
+ *        is the time that a timer moves down a level otherwise.
+ *
+ * @param[in] wheel A pointer to a timer wheel.
+ *
+ * @return The earliest expiry time in microseconds (UINT64_MAX if the wheel
+ *         has no timers).
+ */
+uint64_t timerwheel_getnext(const struct timerwheel * const wheel);
+
+/**
+ * @brief Get the number of scheduled timers of a timer wheel.
+ *
+ * @param[in] wheel A pointer to a timer wheel.
+ *
+ * @return The number of scheduled timers.
+ */
+uint32_t timerwheel_getsize(const struct timerwheel * const wheel);
+
+#endif // _TIMER_WHEEL_H_
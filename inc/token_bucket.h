@@ -17,6 +17,20 @@ struct tokenbucket
     uint64_t rate; // Bucket fill rate in tokens per second
     uint64_t size; // Bucket size in tokens
     uint64_t tsus; // Last fill Unix timestamp in microseconds
+    uint64_t rem;  // Fill remainder in millionths of a token
+};
+
+// A shared token bucket may be drawn from by several threads without a lock.
+// Rather than a token count, it keeps the time by which the tokens taken from
+// it are earned, so that taking tokens is a single compare-and-swap. Tokens
+// may be taken before they are earned, in which case the taker must wait
+// until they are, and the takers of a busy bucket are served in turn. A bucket
+// holds at most the tokens earned over its depth.
+struct tokenbucket_shared
+{
+    uint64_t rate;    // Bucket fill rate in tokens per second (0 if unlimited)
+    uint64_t depthns; // Time to fill an empty bucket in nanoseconds
+    uint64_t drainns; // Monotonic time by which the tokens taken are earned
 };
 
 /**
@@ -69,4 +83,44 @@ uint64_t tokenbucket_return(struct tokenbucket * const tb,
 uint64_t tokenbucket_delay(struct tokenbucket * const tb,
                            const uint64_t tokens);
 
+/**
+ * @brief Initialize a shared token bucket.
+ *
+ * @param[in,out] tb   A pointer to a shared token bucket.
+ * @param[in]     rate The token bucket fill rate in tokens per second. A value
+ *                     of zero signifies an unlimited token bucket fill rate.
+ * @param[in]     size The maximum number of tokens held by the bucket.
+ *
+ * @return True if a shared token bucket was initialized.
+ */
+bool tokenbucket_sharedinit(struct tokenbucket_shared * const tb,
+                            const uint64_t rate,
+                            const uint64_t size);
+
+/**
+ * @brief Take a number of tokens from a shared token bucket, whether or not
+ *        they have been earned yet.
+ *
+ * @param[in,out] tb     A pointer to a shared token bucket.
+ * @param[in]     tokens The number of tokens to take from the bucket.
+ * @param[in]     tsns   The current monotonic time in nanoseconds.
+ *
+ * @return The monotonic time in nanoseconds by which the tokens are earned
+ *         (not later than the current time if the tokens were available).
+ */
+uint64_t tokenbucket_sharedtake(struct tokenbucket_shared * const tb,
+                                const uint64_t tokens,
+                                const uint64_t tsns);
+
+/**
+ * @brief Return a number of unused tokens to a shared token bucket.
+ *
+ * @param[in,out] tb     A pointer to a shared token bucket.
+ * @param[in]     tokens The number of unused tokens to return to the bucket.
+ *
+ * @return The number of unused tokens returned to the bucket.
+ */
+uint64_t tokenbucket_sharedreturn(struct tokenbucket_shared * const tb,
+                                  const uint64_t tokens);
+
 #endif // _TOKEN_BUCKET_H_
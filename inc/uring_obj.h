@@ -0,0 +1,261 @@
+/**
+ * @file      uring_obj.h
+ * @brief     Asynchronous I/O ring (io_uring) object interface.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#ifndef _URING_OBJ_H_
+#define _URING_OBJ_H_
+
+#include "system_types.h"
+
+#include <sys/uio.h>
+
+enum uringobj_feature
+{
+    URINGOBJ_FEATURE_FIXEDBUFS = 0x01, // Registered (fixed) buffers
+    URINGOBJ_FEATURE_BUFRING   = 0x02, // Provided buffer rings
+    URINGOBJ_FEATURE_MULTISHOT = 0x04  // Multishot accept and receive
+};
+
+enum uringobj_cqeflag
+{
+    URINGOBJ_CQEFLAG_BUFFER = 0x01, // A provided buffer id is available
+    URINGOBJ_CQEFLAG_MORE   = 0x02  // More completions will be generated
+};
+
+struct uringobj_priv;
+
+struct uringobj_cqe
+{
+    uint64_t data;  // User data of the completed request
+    int32_t  res;   // Result (byte count, file descriptor or -errno)
+    uint32_t flags; // Completion flags (upper 16 bits hold a buffer id)
+};
+
+struct uringobj
+{
+    struct uringobj_priv *priv;
+    uint32_t              features; // Supported features
+    uint64_t              entercnt; // io_uring_enter() system call count
+    uint64_t              sqecnt;   // Submission queue entry count
+    uint64_t              cqecnt;   // Completion queue entry count
+};
+
+/**
+ * @brief Create an asynchronous I/O ring object. The object must only be used
+ *        by the thread that created it.
+ *
+ * @param[in,out] obj     A pointer to an asynchronous I/O ring object.
+ * @param[in]     entries The minimum number of submission queue entries.
+ *
+ * @return True if an asynchronous I/O ring object was created.
+ */
+bool uringobj_create(struct uringobj * const obj, const uint32_t entries);
+
+/**
+ * @brief Destroy an asynchronous I/O ring object.
+ *
+ * @param[in,out] obj A pointer to an asynchronous I/O ring object.
+ *
+ * @return True if an asynchronous I/O ring object was destroyed.
+ */
+bool uringobj_destroy(struct uringobj * const obj);
+
+/**
+ * @brief Register (pin) buffers with an asynchronous I/O ring object so that
+ *        they can be used by fixed-buffer operations.
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[in]     iov   A pointer to an array of buffers.
+ * @param[in]     count The number of buffers in the array.
+ *
+ * @return True if the buffers were registered.
+ */
+bool uringobj_registerbufs(struct uringobj * const obj,
+                           const struct iovec * const iov,
+                           const uint32_t count);
+
+/**
+ * @brief Create a ring of provided buffers from which the kernel selects a
+ *        buffer when data arrives (instead of pinning a buffer per request).
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[in]     group The buffer group id.
+ * @param[in]     count The number of buffers (a power of two).
+ * @param[in]     size  The size of each buffer in bytes.
+ *
+ * @return True if the buffer ring was created.
+ */
+bool uringobj_createbufring(struct uringobj * const obj,
+                            const uint16_t group,
+                            const uint16_t count,
+                            const uint32_t size);
+
+/**
+ * @brief Get a provided buffer selected by the kernel for a completion.
+ *
+ * @param[in,out] obj A pointer to an asynchronous I/O ring object.
+ * @param[in]     cqe A pointer to a completion queue entry.
+ *
+ * @return A pointer to the provided buffer (NULL if no buffer was selected).
+ */
+void *uringobj_getbuf(struct uringobj * const obj,
+                      const struct uringobj_cqe * const cqe);
+
+/**
+ * @brief Return a provided buffer selected for a completion to the buffer
+ *        ring.
+ *
+ * @param[in,out] obj A pointer to an asynchronous I/O ring object.
+ * @param[in]     cqe A pointer to a completion queue entry.
+ *
+ * @return True if a buffer was returned to the buffer ring.
+ */
+bool uringobj_returnbuf(struct uringobj * const obj,
+                        const struct uringobj_cqe * const cqe);
+
+/**
+ * @brief Queue an accept request on a listener socket (multishot if
+ *        supported).
+ *
+ * @param[in,out] obj  A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd   A listener socket file descriptor.
+ * @param[in]     data User data to return with each completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_accept(struct uringobj * const obj,
+                     const int32_t fd,
+                     const uint64_t data);
+
+/**
+ * @brief Queue a multishot receive request that uses the provided buffer
+ *        ring.
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd    A socket file descriptor.
+ * @param[in]     group The buffer group id.
+ * @param[in]     data  User data to return with each completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_recvmulti(struct uringobj * const obj,
+                        const int32_t fd,
+                        const uint16_t group,
+                        const uint64_t data);
+
+/**
+ * @brief Queue a (single shot) receive request into a buffer that is not
+ *        registered.
+ *
+ * @param[in,out] obj  A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd   A socket file descriptor.
+ * @param[in]     buf  A pointer to a buffer.
+ * @param[in]     len  The maximum number of bytes to receive.
+ * @param[in]     data User data to return with the completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_recv(struct uringobj * const obj,
+                   const int32_t fd,
+                   void * const buf,
+                   const uint32_t len,
+                   const uint64_t data);
+
+/**
+ * @brief Queue a (single shot) poll request on a file descriptor.
+ *
+ * @param[in,out] obj    A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd     A file descriptor.
+ * @param[in]     events The poll(2) events to wait for (e.g., POLLIN).
+ * @param[in]     data   User data to return with the completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_poll(struct uringobj * const obj,
+                   const int32_t fd,
+                   const uint32_t events,
+                   const uint64_t data);
+
+/**
+ * @brief Queue a read request into a registered buffer.
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd    A file descriptor.
+ * @param[in]     buf   A pointer to a location within a registered buffer.
+ * @param[in]     len   The maximum number of bytes to read.
+ * @param[in]     index The registered buffer index.
+ * @param[in]     data  User data to return with the completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_readfixed(struct uringobj * const obj,
+                        const int32_t fd,
+                        void * const buf,
+                        const uint32_t len,
+                        const uint16_t index,
+                        const uint64_t data);
+
+/**
+ * @brief Queue a send request.
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[in]     fd    A socket file descriptor.
+ * @param[in]     buf   A pointer to a buffer.
+ * @param[in]     len   The number of bytes to send.
+ * @param[in]     flags Send flags (e.g., MSG_NOSIGNAL).
+ * @param[in]     data  User data to return with the completion.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_send(struct uringobj * const obj,
+                   const int32_t fd,
+                   const void * const buf,
+                   const uint32_t len,
+                   const int32_t flags,
+                   const uint64_t data);
+
+/**
+ * @brief Queue a request to cancel all in-flight requests with matching user
+ *        data. The cancel request completes with a user data value of zero.
+ *
+ * @param[in,out] obj  A pointer to an asynchronous I/O ring object.
+ * @param[in]     data The user data of the requests to cancel.
+ *
+ * @return True if the request was queued.
+ */
+bool uringobj_cancel(struct uringobj * const obj, const uint64_t data);
+
+/**
+ * @brief Submit all queued requests and optionally wait for completions using
+ *        a single system call.
+ *
+ * @param[in,out] obj       A pointer to an asynchronous I/O ring object.
+ * @param[in]     waitcnt   The number of completions to wait for.
+ * @param[in]     timeoutus The maximum amount of time in microseconds to wait
+ *                          for completions.
+ *
+ * @return True on success (including a timeout).
+ */
+bool uringobj_submit(struct uringobj * const obj,
+                     const uint32_t waitcnt,
+                     const uint64_t timeoutus);
+
+/**
+ * @brief Reap a batch of completions from the completion queue.
+ *
+ * @param[in,out] obj   A pointer to an asynchronous I/O ring object.
+ * @param[out]    cqes  A pointer to an array of completion queue entries.
+ * @param[in]     count The maximum number of completions to reap.
+ *
+ * @return The number of completions reaped.
+ */
+uint32_t uringobj_reap(struct uringobj * const obj,
+                       struct uringobj_cqe * const cqes,
+                       const uint32_t count);
+
+#endif // _URING_OBJ_H_
@@ -14,6 +14,23 @@
 
 #include <sys/time.h>
 
+#define UTILCPU_SETMAX 256
+
+enum utilcpu_policy
+{
+    UTILCPU_POLICY_NONE = 0, // Threads are not pinned
+    UTILCPU_POLICY_LIST = 1, // Threads are pinned to a list of CPUs
+    UTILCPU_POLICY_CPU  = 2, // Threads are pinned to each available CPU
+    UTILCPU_POLICY_CORE = 3  // Threads are pinned to one CPU per physical core
+};
+
+struct utilcpu_set
+{
+    enum utilcpu_policy policy;
+    uint16_t            count;
+    uint16_t            cpus[UTILCPU_SETMAX];
+};
+
 struct utilcpu_info
 {
     int16_t        usage;
@@ -32,4 +49,36 @@ struct utilcpu_info
  */
 bool utilcpu_getinfo(struct utilcpu_info * const info);
 
+/**
+ * @brief Parse a CPU affinity policy: "none", "cpu" (each available CPU),
+ *        "core" (one CPU per physical core, skipping SMT siblings) or a CPU
+ *        list (e.g., "0,2,4-7").
+ *
+ * @param[in]     str A pointer to a CPU affinity policy string.
+ * @param[in,out] set A pointer to a CPU set.
+ *
+ * @return True if a CPU affinity policy was parsed.
+ */
+bool utilcpu_parseset(const char * const str, struct utilcpu_set * const set);
+
+/**
+ * @brief Resolve the CPU affinity policy of a CPU set to the list of CPUs that
+ *        the calling process is allowed to run on.
+ *
+ * @param[in,out] set A pointer to a CPU set.
+ *
+ * @return True if the policy resolved to at least one CPU (or if the policy is
+ *         none).
+ */
+bool utilcpu_getset(struct utilcpu_set * const set);
+
+/**
+ * @brief Get the NUMA node of a CPU.
+ *
+ * @param[in] cpu A CPU number.
+ *
+ * @return The NUMA node of a CPU (-1 if unknown).
+ */
+int32_t utilcpu_getnode(const uint16_t cpu);
+
 #endif // _UTIL_CPU_H_
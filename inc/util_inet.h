@@ -14,6 +14,26 @@
 
 #include <sys/socket.h>
 
+#define UTILINET_SETMAX     16
+#define UTILINET_RANGEMAX   (1U << 24)
+
+// A range of consecutive IP addresses that share a range of ports.
+struct utilinet_range
+{
+    struct sockaddr_storage addr;    // First address (port unused)
+    uint32_t                count;   // Consecutive addresses
+    uint16_t                portmin; // First port (0 for a default port)
+    uint16_t                portmax; // Last port
+};
+
+// A set of IP address ranges (e.g., "10.0.0.1,10.0.1.0/24:5001-5004").
+struct utilinet_set
+{
+    uint16_t              count;                  // Address ranges
+    uint64_t              size;                   // Addresses times ports
+    struct utilinet_range ranges[UTILINET_SETMAX];
+};
+
 /**
  * @brief Check if an IP address is a valid IPv4 address. The check determines
  *        if the address is expressed in valid dot-decimal notation (e.g.,
@@ -73,4 +93,35 @@ void *utilinet_getaddrfromstorage(const struct sockaddr_storage * const addr);
  */
 uint16_t *utilinet_getportfromstorage(const struct sockaddr_storage * const addr);
 
+/**
+ * @brief Parse a set of IP addresses from a comma-separated list. Each entry
+ *        is an IP address or a CIDR block, which may be followed by a port or
+ *        a range of ports (e.g., "10.0.0.1", "10.0.0.0/24:5001-5004",
+ *        "[fd00::/120]:5001"). The network and broadcast addresses of an IPv4
+ *        block are not part of the set. The set "none" is empty.
+ *
+ * @param[in]     str A pointer to an IP address list string.
+ * @param[in,out] set A pointer to an IP address set.
+ *
+ * @return True if an IP address set was parsed.
+ */
+bool utilinet_parseset(const char * const str, struct utilinet_set * const set);
+
+/**
+ * @brief Get a socket address of an IP address set. The addresses of a range
+ *        are visited before its ports, and the ranges are visited in order.
+ *
+ * @param[in]     set     A pointer to an IP address set.
+ * @param[in]     index   The position of a socket address in the set (modulo
+ *                        the size of the set).
+ * @param[in]     defport The port of a range without ports.
+ * @param[in,out] addr    A pointer to a socket address storage structure.
+ *
+ * @return True if a socket address was copied from the set.
+ */
+bool utilinet_getsetaddr(const struct utilinet_set * const set,
+                         const uint64_t index,
+                         const uint16_t defport,
+                         struct sockaddr_storage * const addr);
+
 #endif // _UTIL_INET_H_
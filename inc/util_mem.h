@@ -12,6 +12,8 @@
 
 #include <stdlib.h>
 
+#define UTILMEM_CACHELINE 64
+
 #if defined(__cplusplus)
     #define UTILMEM_CALLOC(type, size, count) ((type*)calloc(count, size))
 #else
@@ -32,4 +34,17 @@
     #define UTILMEM_REALLOC(type, ptr, size) (realloc(ptr, size))
 #endif
 
+// The size of an aligned allocation is rounded up to a multiple of the
+// alignment, as aligned_alloc() requires.
+#define UTILMEM_ALIGNED_SIZE(align, size, count) \
+    ((((size) * (count)) + (align) - 1) / (align) * (align))
+
+#if defined(__cplusplus)
+    #define UTILMEM_ALIGNED_ALLOC(type, align, size, count) \
+        ((type*)aligned_alloc(align, UTILMEM_ALIGNED_SIZE(align, size, count)))
+#else
+    #define UTILMEM_ALIGNED_ALLOC(type, align, size, count) \
+        (aligned_alloc(align, UTILMEM_ALIGNED_SIZE(align, size, count)))
+#endif
+
 #endif // _UTIL_MEM_H_
@@ -12,15 +12,32 @@
 
 #include "system_types.h"
 
+#define UTILSTATS_HISTSUB  5 // Linear sub-buckets (log2) per power of two
+#define UTILSTATS_HISTEXP 40 // Largest power of two of a recorded value
+#define UTILSTATS_HISTLEN ((UTILSTATS_HISTEXP - UTILSTATS_HISTSUB + 2) << \
+                           UTILSTATS_HISTSUB)
+
 struct utilstats_qty
 {
-    int64_t  avg; // Average of all sample values
     uint64_t cnt; // Sample count
     int64_t  max; // Maximum of all sample values
     int64_t  min; // Minimum of all sample values
     int64_t  sum; // Sum of all sample values
-    uint64_t tv0; // Unix time value of first sample
-    uint64_t tvn; // Unix time value of last sample
+};
+
+// A log-linear histogram of sample values (e.g., latencies, sizes or gaps).
+// Each power of two is split into linear sub-buckets so that a recorded value
+// is never off by more than 1/32 (about 3%), and the exact smallest and
+// largest values are kept next to the buckets so that quantiles are never
+// reported outside of them. A histogram has a single writer, and readers take
+// snapshots of its (monotonic) bucket counts. Histograms of different writers
+// are merged by adding their bucket counts.
+struct utilstats_hist
+{
+    uint64_t counts[UTILSTATS_HISTLEN]; // Samples per value bucket
+    uint64_t max;                       // Largest sample value
+    uint64_t minnot;                    // Complement of the smallest sample
+                                        // value (0 if there are no samples)
 };
 
 /**
@@ -34,4 +51,73 @@ struct utilstats_qty
  */
 bool utilstats_add(struct utilstats_qty * const stats, const int64_t val);
 
+/**
+ * @brief Get the average of the data samples of a statistical quantities
+ *        structure.
+ *
+ * @param[in] stats A pointer to a statistical quantities data structure.
+ *
+ * @return The average sample value (0 if there are no samples).
+ */
+int64_t utilstats_getavg(const struct utilstats_qty * const stats);
+
+/**
+ * @brief Record a data sample in a histogram owned by the caller. Recording
+ *        takes constant time and never divides.
+ *
+ * @param[in,out] hist A pointer to a histogram.
+ * @param[in]     val  A data sample value.
+ *
+ * @return True if a data sample was recorded in a histogram.
+ */
+bool utilstats_histrecord(struct utilstats_hist * const hist,
+                          const uint64_t val);
+
+/**
+ * @brief Take a snapshot of a histogram that may be written concurrently.
+ *
+ * @param[out] dst A pointer to a histogram snapshot.
+ * @param[in]  src A pointer to a histogram.
+ *
+ * @return True if a histogram snapshot was taken.
+ */
+bool utilstats_histcopy(struct utilstats_hist * const dst,
+                        const struct utilstats_hist * const src);
+
+/**
+ * @brief Add the difference between two snapshots of a histogram to another
+ *        histogram. The smallest and largest values of the difference are
+ *        bounded by those of the current snapshot.
+ *
+ * @param[in,out] dst  A pointer to a histogram.
+ * @param[in]     cur  A pointer to a histogram snapshot.
+ * @param[in]     prev A pointer to an earlier snapshot of the same histogram
+ *                     (NULL to add all of the current snapshot).
+ *
+ * @return True if a histogram snapshot was merged.
+ */
+bool utilstats_histmerge(struct utilstats_hist * const dst,
+                         const struct utilstats_hist * const cur,
+                         const struct utilstats_hist * const prev);
+
+/**
+ * @brief Get the sample count and quantiles of a histogram.
+ *
+ * @param[in]  hist     A pointer to a histogram.
+ * @param[in]  permille A pointer to an array of ascending quantiles in parts
+ *                      per thousand (0 is the minimum and 1000 is the maximum
+ *                      sample value).
+ * @param[out] vals     A pointer to an array of quantile values (the largest
+ *                      value of the bucket that holds each quantile, but no
+ *                      smaller than the minimum and no larger than the maximum
+ *                      sample value).
+ * @param[in]  count    The number of quantiles.
+ *
+ * @return The number of samples in the histogram.
+ */
+uint64_t utilstats_histget(const struct utilstats_hist * const hist,
+                           const uint32_t * const permille,
+                           uint64_t * const vals,
+                           const uint32_t count);
+
 #endif // _UTIL_STATS_H_
@@ -8,11 +8,17 @@
  */
 
 #include "arg_obj.h"
+#include "fion_obj.h"
+#include "util_cpu.h"
 #include "util_debug.h"
 #include "util_inet.h"
 #include "util_string.h"
 #include "util_unit.h"
 
+#include <limits.h>
+#include <net/if.h>
+#include <string.h>
+
 #define arg_noobjptr NULL
 #define arg_optional true
 #define arg_required false
@@ -50,6 +56,319 @@ bool argobj_copyipaddr(const struct argobj * const arg,
     return ret;
 }
 
+bool argobj_copyevent(const struct argobj * const arg,
+                      const char * const src,
+                      void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "poll", 0, true))
+        {
+            *(enum fionobj_model*)dst = FIONOBJ_MODEL_POLL;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "epoll", 0, true))
+        {
+            *(enum fionobj_model*)dst = FIONOBJ_MODEL_EPOLL;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "epollet", 0, true))
+        {
+            *(enum fionobj_model*)dst = FIONOBJ_MODEL_EPOLLET;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copylistener(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "single", 0, true))
+        {
+            *(enum args_listener*)dst = ARGS_LISTENER_SINGLE;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "shard", 0, true))
+        {
+            *(enum args_listener*)dst = ARGS_LISTENER_SHARD;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "cbpf", 0, true))
+        {
+            *(enum args_listener*)dst = ARGS_LISTENER_CBPF;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "exclusive", 0, true))
+        {
+            *(enum args_listener*)dst = ARGS_LISTENER_EXCLUSIVE;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copysink(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "copy", 0, true))
+        {
+            *(enum sockobj_sink*)dst = SOCKOBJ_SINK_COPY;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "trunc", 0, true))
+        {
+            *(enum sockobj_sink*)dst = SOCKOBJ_SINK_TRUNC;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "mmap", 0, true))
+        {
+            *(enum sockobj_sink*)dst = SOCKOBJ_SINK_MMAP;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copydirection(const struct argobj * const arg,
+                          const char * const src,
+                          void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "forward", 0, true))
+        {
+            *(enum sockobj_direction*)dst = SOCKOBJ_DIRECTION_FORWARD;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "reverse", 0, true))
+        {
+            *(enum sockobj_direction*)dst = SOCKOBJ_DIRECTION_REVERSE;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "duplex", 0, true))
+        {
+            *(enum sockobj_direction*)dst = SOCKOBJ_DIRECTION_DUPLEX;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copyworkload(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "stream", 0, true))
+        {
+            *(enum args_workload*)dst = ARGS_WORKLOAD_STREAM;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "rr", 0, true))
+        {
+            *(enum args_workload*)dst = ARGS_WORKLOAD_RR;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "crr", 0, true))
+        {
+            *(enum args_workload*)dst = ARGS_WORKLOAD_CRR;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copyformat(const struct argobj * const arg,
+                       const char * const src,
+                       void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "text", 0, true))
+        {
+            *(enum args_format*)dst = ARGS_FORMAT_TEXT;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "json", 0, true))
+        {
+            *(enum args_format*)dst = ARGS_FORMAT_JSON;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "csv", 0, true))
+        {
+            *(enum args_format*)dst = ARGS_FORMAT_CSV;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "binary", 0, true))
+        {
+            *(enum args_format*)dst = ARGS_FORMAT_BINARY;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copyrank(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "slowest", 0, true))
+        {
+            *(enum args_rank*)dst = ARGS_RANK_SLOWEST;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "goodput", 0, true))
+        {
+            *(enum args_rank*)dst = ARGS_RANK_GOODPUT;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "retrans", 0, true))
+        {
+            *(enum args_rank*)dst = ARGS_RANK_RETRANS;
+            ret = true;
+        }
+        else if (utilstring_compare(src, "latency", 0, true))
+        {
+            *(enum args_rank*)dst = ARGS_RANK_LATENCY;
+            ret = true;
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copypath(const struct argobj * const arg,
+                     const char * const src,
+                     void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "stdout", 0, true))
+        {
+            *(char*)dst = '\0';
+            ret = true;
+        }
+        else if ((*src != '\0') && (strlen(src) < PATH_MAX))
+        {
+            memcpy(dst, src, strlen(src) + 1);
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool argobj_copyaffinity(const struct argobj * const arg,
+                         const char * const src,
+                         void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        ret = utilcpu_parseset(src, (struct utilcpu_set*)dst);
+    }
+
+    return ret;
+}
+
+bool argobj_copyaddrset(const struct argobj * const arg,
+                        const char * const src,
+                        void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        ret = utilinet_parseset(src, (struct utilinet_set*)dst);
+    }
+
+    return ret;
+}
+
+bool argobj_copydevice(const struct argobj * const arg,
+                       const char * const src,
+                       void * const dst)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((arg != NULL) && (src != NULL) && (dst != NULL)))
+    {
+        if (utilstring_compare(src, "none", 0, true))
+        {
+            *(char*)dst = '\0';
+            ret = true;
+        }
+        else if ((*src != '\0') && (strlen(src) < IFNAMSIZ))
+        {
+            memcpy(dst, src, strlen(src) + 1);
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
 bool argobj_copyuint16(const struct argobj * const arg,
                        const char * const src,
                        void * const dst)
@@ -47,23 +47,49 @@ enum argsobj_flag
     ARGS_FLAG_IPV6       = 1LL << ('6' - '0' +  1),
     ARGS_FLAG_AFFINITY   = 1LL << ('A' - 'A' + 11),
     ARGS_FLAG_BIND       = 1LL << ('B' - 'A' + 11),
+    ARGS_FLAG_CONNRATE   = 1LL << ('C' - 'A' + 11),
+    ARGS_FLAG_SINK       = 1LL << ('D' - 'A' + 11),
+    ARGS_FLAG_EVENT      = 1LL << ('E' - 'A' + 11),
+    ARGS_FLAG_FASTOPEN   = 1LL << ('F' - 'A' + 11),
+    ARGS_FLAG_GSO        = 1LL << ('G' - 'A' + 11),
+    ARGS_FLAG_DEVICE     = 1LL << ('I' - 'A' + 11),
+    ARGS_FLAG_RESET      = 1LL << ('K' - 'A' + 11),
+    ARGS_FLAG_LISTENER   = 1LL << ('L' - 'A' + 11),
     ARGS_FLAG_OPTNODELAY = 1LL << ('N' - 'A' + 11),
     ARGS_FLAG_PARALLEL   = 1LL << ('P' - 'A' + 11),
+    ARGS_FLAG_CONNWINDOW = 1LL << ('Q' - 'A' + 11),
+    ARGS_FLAG_REQUEST    = 1LL << ('R' - 'A' + 11),
+    ARGS_FLAG_RESPONSE   = 1LL << ('S' - 'A' + 11),
     ARGS_FLAG_THREADS    = 1LL << ('T' - 'A' + 11),
+    ARGS_FLAG_URING      = 1LL << ('U' - 'A' + 11),
     ARGS_FLAG_VERBOSE    = 1LL << ('V' - 'A' + 11),
+    ARGS_FLAG_WINDOW     = 1LL << ('W' - 'A' + 11),
+    ARGS_FLAG_SOURCE     = 1LL << ('X' - 'A' + 11),
+    ARGS_FLAG_ZEROCOPY   = 1LL << ('Z' - 'A' + 11),
+    ARGS_FLAG_AGGREGATE  = 1LL << ('a' - 'a' + 37),
     ARGS_FLAG_BANDWIDTH  = 1LL << ('b' - 'a' + 37),
     ARGS_FLAG_CLIENT     = 1LL << ('c' - 'a' + 37),
+    ARGS_FLAG_DEST       = 1LL << ('d' - 'a' + 37),
     ARGS_FLAG_ECHO       = 1LL << ('e' - 'a' + 37),
+    ARGS_FLAG_FORMAT     = 1LL << ('f' - 'a' + 37),
     ARGS_FLAG_HELP       = 1LL << ('h' - 'a' + 37),
+    ARGS_FLAG_SPIN       = 1LL << ('j' - 'a' + 37),
+    ARGS_FLAG_TOP        = 1LL << ('k' - 'a' + 37),
     ARGS_FLAG_INTERVAL   = 1LL << ('i' - 'a' + 37),
     ARGS_FLAG_LEN        = 1LL << ('l' - 'a' + 37),
+    ARGS_FLAG_BATCH      = 1LL << ('m' - 'a' + 37),
     ARGS_FLAG_NUM        = 1LL << ('n' - 'a' + 37),
+    ARGS_FLAG_OUTPUT     = 1LL << ('o' - 'a' + 37),
     ARGS_FLAG_PORT       = 1LL << ('p' - 'a' + 37),
     ARGS_FLAG_BACKLOG    = 1LL << ('q' - 'a' + 37),
+    ARGS_FLAG_DIRECTION  = 1LL << ('r' - 'a' + 37),
     ARGS_FLAG_SERVER     = 1LL << ('s' - 'a' + 37),
     ARGS_FLAG_TIME       = 1LL << ('t' - 'a' + 37),
     ARGS_FLAG_UDP        = 1LL << ('u' - 'a' + 37),
-    ARGS_FLAG_VERSION    = 1LL << ('v' - 'a' + 37)
+    ARGS_FLAG_VERSION    = 1LL << ('v' - 'a' + 37),
+    ARGS_FLAG_WORKLOAD   = 1LL << ('w' - 'a' + 37),
+    ARGS_FLAG_PERTHREAD  = 1LL << ('x' - 'a' + 37),
+    ARGS_FLAG_RANK       = 1LL << ('y' - 'a' + 37)
 };
 
 static char        str_somaxconn[16];
@@ -242,15 +268,15 @@ static struct argobj options[] =
         ARG_ACTIVE,
         "--affinity",
         'A',
-        "set CPU affinity",
-        str_nproconln,
-        "1",
-        str_nproconln,
+        "CPU affinity (none, cpu, core or a CPU list)",
+        "none",
+        "none",
+        "core",
         val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        argobj_copyuint16,
+        argobj_copyaffinity,
         NULL
     },
     {
@@ -269,76 +295,76 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--connrate",
         'C',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "connections opened per second (0 for no limit)",
+        "0",
+        "0",
+        "16777216",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--sink",
         'D',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "TCP receive sink (copy, trunc or mmap)",
+        "copy",
+        "copy",
+        "mmap",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_UDP | ARGS_FLAG_URING,
         arg_noobjptr,
-        NULL,
+        argobj_copysink,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--event",
         'E',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "event notification model (poll, epoll or epollet)",
+        "poll",
+        "poll",
+        "epollet",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyevent,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--fastopen",
         'F',
-        NULL,
-        NULL,
+        "use TCP Fast Open",
+        "disabled",
         NULL,
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_UDP,
         arg_noobjptr,
         NULL,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--gso",
         'G',
-        NULL,
-        NULL,
+        "use UDP segmentation and receive offload",
+        "disabled",
         NULL,
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_URING | ARGS_FLAG_WORKLOAD,
         arg_noobjptr,
         NULL,
         NULL
@@ -359,18 +385,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--device",
         'I',
+        "bind sockets to a network device",
+        "none",
         NULL,
         NULL,
-        NULL,
-        NULL,
-        val_optional,
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copydevice,
         NULL
     },
     {
@@ -389,33 +415,33 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--reset",
         'K',
-        NULL,
-        NULL,
+        "close connections with a reset (SO_LINGER 0)",
+        "disabled",
         NULL,
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_UDP,
         arg_noobjptr,
         NULL,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--listener",
         'L',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "listener model (single, shard, cbpf or exclusive)",
+        "single",
+        "single",
+        "exclusive",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copylistener,
         NULL
     },
     {
@@ -479,48 +505,48 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--connwin",
         'Q',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "connects in flight while opening connections",
+        "256",
+        "1",
+        "65536",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--request",
         'R',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "request length in bytes (rr workload)",
+        "1",
+        "1",
+        "16777216",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--response",
         'S',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "response length in bytes (rr workload)",
+        "1",
+        "1",
+        "16777216",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
@@ -539,16 +565,19 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--uring",
         'U',
-        NULL,
-        NULL,
+        "use io_uring worker engine if available",
+        "disabled",
         NULL,
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_GSO |
+        ARGS_FLAG_SINK |
+        ARGS_FLAG_WORKLOAD |
+        ARGS_FLAG_ZEROCOPY,
         arg_noobjptr,
         NULL,
         NULL
@@ -569,33 +598,33 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--window",
         'W',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "transactions in flight per connection",
+        "1",
+        "1",
+        "256",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--source",
         'X',
+        "source addresses of clients (list or CIDR)",
+        "none",
         NULL,
         NULL,
-        NULL,
-        NULL,
-        val_optional,
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_SERVER,
         arg_noobjptr,
-        NULL,
+        argobj_copyaddrset,
         NULL
     },
     {
@@ -614,33 +643,33 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--zerocopy",
         'Z',
-        NULL,
-        NULL,
+        "send TCP data without copying (MSG_ZEROCOPY)",
+        "disabled",
         NULL,
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_UDP | ARGS_FLAG_URING | ARGS_FLAG_WORKLOAD,
         arg_noobjptr,
         NULL,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--aggregate",
         'a',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "target bandwidth of all connections",
+        "0bps",
+        "0bps",
+        "999Ebps",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyrateunit,
         NULL
     },
     {
@@ -674,18 +703,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--dest",
         'd',
+        "destination addresses of clients (list or CIDR)",
+        "none",
         NULL,
         NULL,
-        NULL,
-        NULL,
-        val_optional,
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_SERVER,
         arg_noobjptr,
-        NULL,
+        argobj_copyaddrset,
         NULL
     },
     {
@@ -704,18 +733,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--format",
         'f',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "report format (text, json, csv or binary)",
+        "text",
+        "text",
+        "binary",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyformat,
         NULL
     },
     {
@@ -764,33 +793,33 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--spin",
         'j',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "time to spin before a paced send (0 for none)",
+        "0us",
+        "1us",
+        "1ms",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_URING,
         arg_noobjptr,
-        NULL,
+        argobj_copytimeunit,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--top",
         'k',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "flows ranked per interval (0 for none)",
+        "0",
+        "0",
+        "1024",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_URING,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
@@ -809,18 +838,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--batch",
         'm',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "datagrams per UDP receive or send call",
+        "1",
+        "1",
+        "256",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyuint32,
         NULL
     },
     {
@@ -839,18 +868,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--output",
         'o',
+        "report file (stdout for standard output)",
+        "stdout",
         NULL,
         NULL,
-        NULL,
-        NULL,
-        val_optional,
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copypath,
         NULL
     },
     {
@@ -884,18 +913,18 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--direction",
         'r',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "stream direction (forward, reverse or duplex)",
+        "forward",
+        "forward",
+        "duplex",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_UDP | ARGS_FLAG_URING | ARGS_FLAG_WORKLOAD,
         arg_noobjptr,
-        NULL,
+        argobj_copydirection,
         NULL
     },
     {
@@ -938,7 +967,11 @@ static struct argobj options[] =
         NULL,
         val_optional,
         arg_optional,
-        ARGS_FLAG_OPTNODELAY,
+        ARGS_FLAG_FASTOPEN |
+        ARGS_FLAG_OPTNODELAY |
+        ARGS_FLAG_RESET |
+        ARGS_FLAG_SINK |
+        ARGS_FLAG_ZEROCOPY,
         arg_noobjptr,
         NULL,
         NULL
@@ -959,48 +992,48 @@ static struct argobj options[] =
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--workload",
         'w',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "workload (stream, rr or crr)",
+        "stream",
+        "stream",
+        "crr",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_GSO | ARGS_FLAG_URING | ARGS_FLAG_ZEROCOPY,
         arg_noobjptr,
-        NULL,
+        argobj_copyworkload,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--perthread",
         'x',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "target bandwidth of the connections of a thread",
+        "0bps",
+        "0bps",
+        "999Ebps",
+        val_required,
         arg_optional,
         ARGS_FLAG_NULL,
         arg_noobjptr,
-        NULL,
+        argobj_copyrateunit,
         NULL
     },
     {
-        ARG_INACTIVE,
-        "",
+        ARG_ACTIVE,
+        "--rank",
         'y',
-        NULL,
-        NULL,
-        NULL,
-        NULL,
-        val_optional,
+        "flow ranking (slowest, goodput, retrans, latency)",
+        "slowest",
+        "slowest",
+        "latency",
+        val_required,
         arg_optional,
-        ARGS_FLAG_NULL,
+        ARGS_FLAG_URING,
         arg_noobjptr,
-        NULL,
+        argobj_copyrank,
         NULL
     },
     {
@@ -1110,7 +1143,7 @@ static bool args_getarg(const uint32_t argc,
 
             if (flag == ARGS_FLAG_NULL)
             {
-                fprintf(stderr, "\nunknown option '%s'\n", name);
+                fprintf(stderr, "\nunknown option '%s'\n", argv[i]);
                 ret = false;
             }
             else if ((map->keys & flag) || ((map->keys = map->keys | flag) == 0))
@@ -1205,22 +1238,48 @@ static void args_init(struct args_obj * const args)
     args->family = AF_INET;
     options[utilmath_log2(ARGS_FLAG_AFFINITY)].dest = &args->affinity;
     options[utilmath_log2(ARGS_FLAG_BIND)].dest = &args->ipport;
+    options[utilmath_log2(ARGS_FLAG_SINK)].dest = &args->sink;
+    options[utilmath_log2(ARGS_FLAG_AGGREGATE)].dest = &args->aggregatebps;
     options[utilmath_log2(ARGS_FLAG_BANDWIDTH)].dest = &args->ratelimitbps;
     options[utilmath_log2(ARGS_FLAG_CLIENT)].dest = &args->ipaddr;
+    options[utilmath_log2(ARGS_FLAG_CONNRATE)].dest = &args->connrate;
+    options[utilmath_log2(ARGS_FLAG_CONNWINDOW)].dest = &args->connwindow;
+    options[utilmath_log2(ARGS_FLAG_DEST)].dest = &args->dest;
+    options[utilmath_log2(ARGS_FLAG_DEVICE)].dest = &args->device;
+    options[utilmath_log2(ARGS_FLAG_DIRECTION)].dest = &args->direction;
     args->arch = SOCKOBJ_MODEL_CLIENT;
     args->echo = false;
+    options[utilmath_log2(ARGS_FLAG_EVENT)].dest = &args->event;
     options[utilmath_log2(ARGS_FLAG_INTERVAL)].dest = &args->intervalusec;
+    options[utilmath_log2(ARGS_FLAG_LISTENER)].dest = &args->listener;
     options[utilmath_log2(ARGS_FLAG_LEN)].dest = &args->buflen;
+    options[utilmath_log2(ARGS_FLAG_BATCH)].dest = &args->batch;
     args->opts.nodelay = true;
     options[utilmath_log2(ARGS_FLAG_NUM)].dest = &args->datalimitbyte;
     options[utilmath_log2(ARGS_FLAG_PARALLEL)].dest = &args->maxcon;
+    options[utilmath_log2(ARGS_FLAG_REQUEST)].dest = &args->reqlen;
+    options[utilmath_log2(ARGS_FLAG_RESPONSE)].dest = &args->resplen;
     options[utilmath_log2(ARGS_FLAG_PORT)].dest = &args->ipport;
     options[utilmath_log2(ARGS_FLAG_BACKLOG)].dest = &args->backlog;
     options[utilmath_log2(ARGS_FLAG_SERVER)].dest = &args->ipaddr;
+    options[utilmath_log2(ARGS_FLAG_SOURCE)].dest = &args->source;
     options[utilmath_log2(ARGS_FLAG_THREADS)].dest = &args->threads;
     options[utilmath_log2(ARGS_FLAG_TIME)].dest = &args->timelimitusec;
     options[utilmath_log2(ARGS_FLAG_VERBOSE)].dest = &args->loglevel;
+    options[utilmath_log2(ARGS_FLAG_WINDOW)].dest = &args->window;
+    options[utilmath_log2(ARGS_FLAG_WORKLOAD)].dest = &args->workload;
+    options[utilmath_log2(ARGS_FLAG_PERTHREAD)].dest = &args->threadbps;
+    options[utilmath_log2(ARGS_FLAG_FORMAT)].dest = &args->format;
+    options[utilmath_log2(ARGS_FLAG_OUTPUT)].dest = &args->output;
+    options[utilmath_log2(ARGS_FLAG_TOP)].dest = &args->top;
+    options[utilmath_log2(ARGS_FLAG_RANK)].dest = &args->rank;
+    options[utilmath_log2(ARGS_FLAG_SPIN)].dest = &args->spinusec;
     args->type = SOCK_STREAM;
+    args->uring = false;
+    args->gso = false;
+    args->zerocopy = false;
+    args->fastopen = false;
+    args->reset = false;
 
     // Copy default options to arguments object.
     for (i = 0; i < sizeof(options) / sizeof(options[0]); i++)
@@ -1311,12 +1370,20 @@ static bool args_validate(struct argsmap * const map,
                     break;
                 case ARGS_FLAG_BIND:
                     break;
+                case ARGS_FLAG_SINK:
+                    break;
+                case ARGS_FLAG_AGGREGATE:
+                    break;
                 case ARGS_FLAG_BANDWIDTH:
                     break;
                 case ARGS_FLAG_CLIENT:
                     args->arch = SOCKOBJ_MODEL_CLIENT;
+                    // A UDP client without any bandwidth limit is limited
+                    // per connection.
                     if ((map->keys & ARGS_FLAG_UDP) &&
-                        !(map->keys & ARGS_FLAG_BANDWIDTH))
+                        !(map->keys & (ARGS_FLAG_AGGREGATE |
+                                       ARGS_FLAG_BANDWIDTH |
+                                       ARGS_FLAG_PERTHREAD)))
                     {
                         opt = &options[utilmath_log2(ARGS_FLAG_BANDWIDTH)];
                         opt->copy(opt, "1Mbps", opt->dest);
@@ -1330,6 +1397,32 @@ static bool args_validate(struct argsmap * const map,
                 case ARGS_FLAG_ECHO:
                     args->echo = true;
                     break;
+                case ARGS_FLAG_FORMAT:
+                    break;
+                case ARGS_FLAG_DEST:
+                    break;
+                case ARGS_FLAG_DEVICE:
+                    break;
+                case ARGS_FLAG_DIRECTION:
+                    break;
+                case ARGS_FLAG_EVENT:
+                    break;
+                case ARGS_FLAG_FASTOPEN:
+                    args->fastopen = true;
+                    break;
+                case ARGS_FLAG_GSO:
+                    args->gso = true;
+                    if ((map->keys & ARGS_FLAG_BATCH) == 0)
+                    {
+                        opt = &options[utilmath_log2(ARGS_FLAG_BATCH)];
+                        opt->copy(opt, "64", opt->dest);
+                    }
+                    break;
+                case ARGS_FLAG_LISTENER:
+                    break;
+                case ARGS_FLAG_RESET:
+                    args->reset = true;
+                    break;
                 case ARGS_FLAG_HELP:
                     args_usage(stdout);
                     ret = false;
@@ -1338,6 +1431,8 @@ static bool args_validate(struct argsmap * const map,
                     break;
                 case ARGS_FLAG_LEN:
                     break;
+                case ARGS_FLAG_BATCH:
+                    break;
                 case ARGS_FLAG_OPTNODELAY:
                     args->opts.nodelay = true;
                     break;
@@ -1356,8 +1451,18 @@ static bool args_validate(struct argsmap * const map,
                     break;
                 case ARGS_FLAG_PARALLEL:
                     break;
+                case ARGS_FLAG_CONNRATE:
+                    break;
+                case ARGS_FLAG_CONNWINDOW:
+                    break;
+                case ARGS_FLAG_REQUEST:
+                    break;
+                case ARGS_FLAG_RESPONSE:
+                    break;
                 case ARGS_FLAG_PORT:
                     break;
+                case ARGS_FLAG_SOURCE:
+                    break;
                 case ARGS_FLAG_BACKLOG:
                     break;
                 case ARGS_FLAG_THREADS:
@@ -1368,6 +1473,9 @@ static bool args_validate(struct argsmap * const map,
                         args->datalimitbyte = 0;
                     }
                     break;
+                case ARGS_FLAG_URING:
+                    args->uring = true;
+                    break;
                 case ARGS_FLAG_UDP:
                     args->type = SOCK_DGRAM;
                     if ((map->keys & ARGS_FLAG_LEN) == 0)
@@ -1379,6 +1487,23 @@ static bool args_validate(struct argsmap * const map,
                     break;
                 case ARGS_FLAG_VERBOSE:
                     break;
+                case ARGS_FLAG_WINDOW:
+                    break;
+                case ARGS_FLAG_WORKLOAD:
+                    break;
+                case ARGS_FLAG_PERTHREAD:
+                    break;
+                case ARGS_FLAG_OUTPUT:
+                    break;
+                case ARGS_FLAG_TOP:
+                    break;
+                case ARGS_FLAG_RANK:
+                    break;
+                case ARGS_FLAG_SPIN:
+                    break;
+                case ARGS_FLAG_ZEROCOPY:
+                    args->zerocopy = true;
+                    break;
                 case ARGS_FLAG_VERSION:
                     fprintf(stdout,
                             "bottlerocket version %u.%u.%u (%s)\n",
@@ -1401,6 +1526,17 @@ static bool args_validate(struct argsmap * const map,
         }
     }
 
+    // A connection per transaction is only possible with TCP.
+    if ((ret) &&
+        (args->workload == ARGS_WORKLOAD_CRR) &&
+        (args->type == SOCK_DGRAM))
+    {
+        fprintf(stderr,
+                "\nincompatible option '%s'\n",
+                map->key[utilmath_log2(ARGS_FLAG_WORKLOAD)]);
+        ret = false;
+    }
+
     return ret;
 }
 
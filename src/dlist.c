@@ -9,6 +9,7 @@
 
 #include "dlist.h"
 #include "logger.h"
+#include "mem_pool.h"
 #include "util_debug.h"
 #include "util_mem.h"
 
@@ -23,7 +24,9 @@ bool dlist_insertafter(struct dlist * const list,
 
     if (UTILDEBUG_VERIFY(list != NULL))
     {
-        new = UTILMEM_MALLOC(struct dlist_node, sizeof(struct dlist_node), 1);
+        new = (list->pool == NULL ?
+               UTILMEM_MALLOC(struct dlist_node, sizeof(struct dlist_node), 1) :
+               mempool_get(list->pool));
 
         if (new == NULL)
         {
@@ -74,7 +77,9 @@ bool dlist_insertbefore(struct dlist * const list,
 
     if (UTILDEBUG_VERIFY(list != NULL))
     {
-        new = UTILMEM_MALLOC(struct dlist_node, sizeof(struct dlist_node), 1);
+        new = (list->pool == NULL ?
+               UTILMEM_MALLOC(struct dlist_node, sizeof(struct dlist_node), 1) :
+               mempool_get(list->pool));
 
         if (new == NULL)
         {
@@ -152,7 +157,14 @@ bool dlist_remove(struct dlist * const list, struct dlist_node * const node)
             (node->prev)->next = node->next;
         }
 
-        UTILMEM_FREE(node);
+        if (list->pool == NULL)
+        {
+            UTILMEM_FREE(node);
+        }
+        else
+        {
+            mempool_free(list->pool, node);
+        }
 
         list->size--;
         ret = true;
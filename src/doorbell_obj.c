@@ -0,0 +1,179 @@
+/**
+ * @file      doorbell_obj.c
+ * @brief     Doorbell (cross-thread wakeup) object implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "doorbell_obj.h"
+#include "logger.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+struct doorbellobj_priv
+{
+    int32_t  rfd;     // File descriptor to watch for wakeups
+    int32_t  wfd;     // File descriptor to write wakeups to
+    uint32_t waiting; // Non-zero if the waiting thread armed the doorbell
+};
+
+bool doorbellobj_create(struct doorbellobj * const obj)
+{
+    bool ret = false;
+#if !defined(__linux__)
+    int32_t fds[2];
+#endif
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv == NULL)))
+    {
+        if ((obj->priv = UTILMEM_CALLOC(struct doorbellobj_priv,
+                                        sizeof(struct doorbellobj_priv),
+                                        1)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate private memory (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+#if defined(__linux__)
+        else if ((obj->priv->rfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+#else
+        else if ((pipe(fds) != 0) ||
+                 (fcntl(obj->priv->rfd = fds[0], F_SETFL, O_NONBLOCK) != 0) ||
+                 (fcntl(obj->priv->wfd = fds[1], F_SETFL, O_NONBLOCK) != 0))
+#endif
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to create doorbell (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            UTILMEM_FREE(obj->priv);
+            obj->priv = NULL;
+        }
+        else
+        {
+#if defined(__linux__)
+            obj->priv->wfd = obj->priv->rfd;
+#endif
+            obj->ringcnt = 0;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool doorbellobj_destroy(struct doorbellobj * const obj)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        if (obj->priv->wfd != obj->priv->rfd)
+        {
+            close(obj->priv->wfd);
+        }
+
+        close(obj->priv->rfd);
+        UTILMEM_FREE(obj->priv);
+        obj->priv = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+int32_t doorbellobj_getfd(const struct doorbellobj * const obj)
+{
+    int32_t ret = -1;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        ret = obj->priv->rfd;
+    }
+
+    return ret;
+}
+
+bool doorbellobj_arm(struct doorbellobj * const obj)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        __atomic_store_n(&obj->priv->waiting, 1, __ATOMIC_SEQ_CST);
+        // Order the store before the caller checks its wakeup condition.
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool doorbellobj_ring(struct doorbellobj * const obj)
+{
+    bool ret = false;
+    uint64_t val = 1;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        // Order the caller's wakeup condition before the armed check.
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&obj->priv->waiting, __ATOMIC_RELAXED) == 0)
+        {
+            // Do nothing.
+        }
+        else if (__atomic_exchange_n(&obj->priv->waiting,
+                                     0,
+                                     __ATOMIC_SEQ_CST) == 0)
+        {
+            // Do nothing (another thread rang the doorbell).
+        }
+        else if (write(obj->priv->wfd, &val, sizeof(val)) < 0)
+        {
+            if (errno != EAGAIN)
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: failed to ring doorbell (%d)\n",
+                              __FUNCTION__,
+                              errno);
+            }
+        }
+        else
+        {
+            __atomic_add_fetch(&obj->ringcnt, 1, __ATOMIC_RELAXED);
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool doorbellobj_clear(struct doorbellobj * const obj)
+{
+    bool ret = false;
+    uint64_t val;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        __atomic_store_n(&obj->priv->waiting, 0, __ATOMIC_SEQ_CST);
+
+        while (read(obj->priv->rfd, &val, sizeof(val)) > 0)
+        {
+            ret = true;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,653 @@
+/**
+ * @file      fion_epoll.c
+ * @brief     File I/O event notification epoll implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "fion_epoll.h"
+#include "logger.h"
+#include "util_debug.h"
+
+#include <errno.h>
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#define FIONEPOLL_READY_MIN   64
+#define FIONEPOLL_READY_MAX 8192
+
+// File descriptor state kept by position within the group, as in the poll
+// model. The position of each file descriptor is indexed by file descriptor so
+// that insert, delete and event lookup operations are O(1), and a deleted file
+// descriptor is replaced by the last file descriptor of the group.
+struct fionepoll_fd
+{
+    int32_t  fd;      // File descriptor
+    uint32_t pevents; // File I/O event flags to handle (interest mask)
+    uint32_t revents; // Latest epoll events
+};
+
+/**
+ * @brief Convert file I/O event flags to epoll events.
+ *
+ * @param[in] obj     A pointer to a file I/O event notification object.
+ * @param[in] pevents The file I/O event flags to handle.
+ *
+ * @return The epoll events to request for a file descriptor.
+ */
+static uint32_t fionepoll_getflags(const struct fionobj * const obj,
+                                   const uint32_t pevents)
+{
+    uint32_t ret = EPOLLPRI | EPOLLRDHUP;
+
+#if defined(EPOLLEXCLUSIVE)
+    // Exclusive wakeups only allow input, output and edge-triggered events.
+    if (pevents & FIONOBJ_PEVENT_EXCL)
+    {
+        ret = EPOLLEXCLUSIVE;
+    }
+#endif
+
+    if (pevents & FIONOBJ_PEVENT_IN)
+    {
+        ret |= EPOLLIN;
+    }
+
+    if (pevents & FIONOBJ_PEVENT_OUT)
+    {
+        ret |= EPOLLOUT;
+    }
+
+    if ((pevents & FIONOBJ_PEVENT_EDGE) ||
+        (obj->model == FIONOBJ_MODEL_EPOLLET))
+    {
+        ret |= EPOLLET;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the state of a registered file descriptor.
+ *
+ * @param[in,out] obj A pointer to a file I/O event notification object.
+ * @param[in]     fd  A file descriptor.
+ *
+ * @return A pointer to the file descriptor state (NULL if the file descriptor
+ *         is not registered).
+ */
+static struct fionepoll_fd *fionepoll_getfd(struct fionobj * const obj,
+                                            const int32_t fd)
+{
+    struct fionepoll_fd *ret = NULL;
+    uint32_t *slot = NULL;
+
+    if ((fd >= 0) && ((uint32_t)fd < vector_getsize(&obj->slots)))
+    {
+        slot = (uint32_t *)vector_getval(&obj->slots, (uint32_t)fd);
+
+        if (*slot > 0)
+        {
+            ret = (struct fionepoll_fd *)vector_getval(&obj->fds, *slot - 1);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Convert the latest epoll events of a file descriptor to file I/O
+ *        event flags.
+ *
+ * @param[in] state A pointer to the file descriptor state.
+ *
+ * @return The latest poll events returned for the file descriptor.
+ */
+static uint32_t fionepoll_getrevents(const struct fionepoll_fd * const state)
+{
+    uint32_t ret = 0;
+
+    // Check for error events.
+    if ((state->revents & EPOLLERR) ||
+        (state->revents & EPOLLHUP))
+    {
+        ret |= FIONOBJ_REVENT_ERROR;
+    }
+
+    // A peer that shut down its side may have left input to read, which is
+    // read until the end of the stream.
+    if (state->revents & EPOLLRDHUP)
+    {
+        ret |= FIONOBJ_REVENT_INREADY | FIONOBJ_REVENT_HANGUP;
+    }
+
+    // Check for input event.
+    if (state->revents & EPOLLIN)
+    {
+        ret |= FIONOBJ_REVENT_INREADY;
+    }
+
+    // Check for output event.
+    if (state->revents & EPOLLOUT)
+    {
+        ret |= FIONOBJ_REVENT_OUTREADY;
+    }
+
+    // Assume a timeout if no events received.
+    if (ret == 0)
+    {
+        ret = FIONOBJ_REVENT_TIMEOUT;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Modify the epoll events requested for a registered file descriptor.
+ *
+ * @param[in,out] obj     A pointer to a file I/O event notification object.
+ * @param[in]     fd      A file descriptor.
+ * @param[in,out] state   A pointer to the file descriptor state.
+ * @param[in]     pevents The file I/O event flags to handle.
+ *
+ * @return True on success.
+ */
+static bool fionepoll_modify(struct fionobj * const obj,
+                             const int32_t fd,
+                             struct fionepoll_fd * const state,
+                             const uint32_t pevents)
+{
+    bool ret = false;
+    struct epoll_event event;
+
+    if (state->pevents == pevents)
+    {
+        // Avoid a system call if the interest mask has not changed.
+        ret = true;
+    }
+    else
+    {
+        event.events  = fionepoll_getflags(obj, pevents);
+        event.data.fd = fd;
+
+        if (epoll_ctl(obj->efd, EPOLL_CTL_MOD, fd, &event) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d modification failed (%d)\n",
+                          __FUNCTION__,
+                          fd,
+                          errno);
+        }
+        else
+        {
+            state->pevents = pevents;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_create(struct fionobj * const obj)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (vector_getsize(&obj->fds) == 0)))
+    {
+        obj->ops.fion_create     = fionepoll_create;
+        obj->ops.fion_destroy    = fionepoll_destroy;
+        obj->ops.fion_insertfd   = fionepoll_insertfd;
+        obj->ops.fion_deletefd   = fionepoll_deletefd;
+        obj->ops.fion_setflags   = fionepoll_setflags;
+        obj->ops.fion_setfdflags = fionepoll_setfdflags;
+        obj->ops.fion_poll       = fionepoll_poll;
+        obj->ops.fion_getevents  = fionepoll_getevents;
+        obj->ops.fion_getready   = fionepoll_getready;
+        obj->model               = FIONOBJ_MODEL_EPOLL;
+        obj->timeoutms           = 0;
+        obj->pevents             = 0;
+        obj->revents             = 0;
+        obj->readycount          = 0;
+
+        if ((obj->efd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: epoll creation failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else if (!vector_create(&obj->fds, 0, sizeof(struct fionepoll_fd)))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: vector allocation failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            close(obj->efd);
+            obj->efd = -1;
+        }
+        else if (!vector_create(&obj->slots, 0, sizeof(uint32_t)))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: vector allocation failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            vector_destroy(&obj->fds);
+            close(obj->efd);
+            obj->efd = -1;
+        }
+        else if (!vector_create(&obj->ready,
+                                FIONEPOLL_READY_MIN,
+                                sizeof(struct epoll_event)))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: vector allocation failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            vector_destroy(&obj->slots);
+            vector_destroy(&obj->fds);
+            close(obj->efd);
+            obj->efd = -1;
+        }
+        else
+        {
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_destroy(struct fionobj * const obj)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY(obj != NULL))
+    {
+        if (obj->efd >= 0)
+        {
+            close(obj->efd);
+            obj->efd = -1;
+        }
+
+        vector_destroy(&obj->fds);
+        vector_destroy(&obj->slots);
+        vector_destroy(&obj->ready);
+
+        obj->ops.fion_create     = NULL;
+        obj->ops.fion_destroy    = NULL;
+        obj->ops.fion_insertfd   = NULL;
+        obj->ops.fion_deletefd   = NULL;
+        obj->ops.fion_setflags   = NULL;
+        obj->ops.fion_setfdflags = NULL;
+        obj->ops.fion_poll       = NULL;
+        obj->ops.fion_getevents  = NULL;
+        obj->ops.fion_getready   = NULL;
+        obj->readycount          = 0;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool fionepoll_insertfd(struct fionobj * const obj, const int32_t fd)
+{
+    bool ret = false;
+    struct fionepoll_fd val = {.fd = fd, .pevents = 0, .revents = 0};
+    struct epoll_event event;
+    uint32_t *slot = NULL;
+    uint32_t size;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (fd >= 0)))
+    {
+        size = vector_getsize(&obj->slots);
+
+        if (fionepoll_getfd(obj, fd) != NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d is already in the list\n",
+                          __FUNCTION__,
+                          fd);
+        }
+        else if (((uint32_t)fd >= size) &&
+                 (!vector_resize(&obj->slots, (uint32_t)fd + 1)))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: vector allocation failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            // Clear the positions of any file descriptors added by the resize.
+            while (size <= (uint32_t)fd)
+            {
+                slot = (uint32_t *)vector_getval(&obj->slots, size++);
+                *slot = 0;
+            }
+
+            slot = (uint32_t *)vector_getval(&obj->slots, (uint32_t)fd);
+            event.events  = fionepoll_getflags(obj, obj->pevents);
+            event.data.fd = fd;
+            val.pevents   = obj->pevents;
+
+            if (epoll_ctl(obj->efd, EPOLL_CTL_ADD, fd, &event) != 0)
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: fd %d insertion failed (%d)\n",
+                              __FUNCTION__,
+                              fd,
+                              errno);
+            }
+            else if (!vector_inserttail(&obj->fds, &val))
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: vector allocation failed (%d)\n",
+                              __FUNCTION__,
+                              errno);
+                epoll_ctl(obj->efd, EPOLL_CTL_DEL, fd, &event);
+            }
+            else
+            {
+                *slot = vector_getsize(&obj->fds);
+                ret = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_deletefd(struct fionobj * const obj, const int32_t fd)
+{
+    bool ret = false;
+    struct fionepoll_fd *state = NULL, *last = NULL;
+    struct epoll_event event;
+    uint32_t *slot = NULL;
+
+    if (UTILDEBUG_VERIFY(obj != NULL))
+    {
+        if ((state = fionepoll_getfd(obj, fd)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d is not in the list\n",
+                          __FUNCTION__,
+                          fd);
+        }
+        else
+        {
+            // A closed file descriptor is removed from the epoll interest list
+            // automatically.
+            if ((epoll_ctl(obj->efd, EPOLL_CTL_DEL, fd, &event) != 0) &&
+                (errno != EBADF) &&
+                (errno != ENOENT))
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: fd %d deletion failed (%d)\n",
+                              __FUNCTION__,
+                              fd,
+                              errno);
+            }
+            else
+            {
+                ret = true;
+            }
+
+            // Move the last file descriptor of the group into the position of
+            // the deleted file descriptor.
+            slot = (uint32_t *)vector_getval(&obj->slots, (uint32_t)fd);
+            last = (struct fionepoll_fd *)vector_gettail(&obj->fds);
+
+            if (last != state)
+            {
+                *state = *last;
+                *(uint32_t *)vector_getval(&obj->slots, (uint32_t)state->fd) = *slot;
+            }
+
+            *slot = 0;
+            vector_deletetail(&obj->fds);
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_setflags(struct fionobj * const obj)
+{
+    bool ret = false;
+    struct fionepoll_fd *state = NULL;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (vector_getsize(&obj->fds) > 0)))
+    {
+        ret = true;
+
+        for (i = 0; i < vector_getsize(&obj->fds); i++)
+        {
+            state = (struct fionepoll_fd *)vector_getval(&obj->fds, i);
+
+            if (!fionepoll_modify(obj, state->fd, state, obj->pevents))
+            {
+                ret = false;
+            }
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_setfdflags(struct fionobj * const obj,
+                          const int32_t fd,
+                          const uint32_t pevents)
+{
+    bool ret = false;
+    struct fionepoll_fd *state = NULL;
+
+    if (UTILDEBUG_VERIFY(obj != NULL))
+    {
+        if ((state = fionepoll_getfd(obj, fd)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d is not in the list\n",
+                          __FUNCTION__,
+                          fd);
+        }
+        else
+        {
+            ret = fionepoll_modify(obj, fd, state, pevents);
+        }
+    }
+
+    return ret;
+}
+
+bool fionepoll_poll(struct fionobj * const obj)
+{
+    bool ret = false;
+    struct epoll_event *event = NULL;
+    struct fionepoll_fd *state = NULL;
+    int32_t err;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->efd >= 0)))
+    {
+        // Clear the events of the file descriptors that were ready after the
+        // previous poll.
+        for (i = 0; i < obj->readycount; i++)
+        {
+            event = (struct epoll_event *)vector_getval(&obj->ready, i);
+
+            if ((state = fionepoll_getfd(obj, event->data.fd)) != NULL)
+            {
+                state->revents = 0;
+            }
+        }
+
+        obj->revents    = 0;
+        obj->readycount = 0;
+        err = epoll_wait(obj->efd,
+                         (struct epoll_event *)vector_getval(&obj->ready, 0),
+                         (int32_t)vector_getsize(&obj->ready),
+                         obj->timeoutms);
+
+        if (err == 0)
+        {
+            // No event on any file descriptor.
+            obj->revents = FIONOBJ_REVENT_TIMEOUT;
+            ret = true;
+        }
+        else if (err > 0)
+        {
+            obj->readycount = (uint32_t)err;
+
+            for (i = 0; i < obj->readycount; i++)
+            {
+                event = (struct epoll_event *)vector_getval(&obj->ready, i);
+
+                if ((state = fionepoll_getfd(obj, event->data.fd)) != NULL)
+                {
+                    state->revents = event->events;
+                    obj->revents |= fionepoll_getrevents(state);
+                }
+            }
+
+            // Grow the ready list if it was filled so that more events can be
+            // reaped per system call.
+            if ((obj->readycount == vector_getsize(&obj->ready)) &&
+                (obj->readycount < FIONEPOLL_READY_MAX))
+            {
+                vector_resize(&obj->ready, obj->readycount * 2);
+            }
+
+            ret = true;
+        }
+        else if (errno == EINTR)
+        {
+            obj->revents = FIONOBJ_REVENT_TIMEOUT;
+            ret = true;
+        }
+        else
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: epoll wait failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+    }
+
+    return ret;
+}
+
+uint32_t fionepoll_getevents(struct fionobj * const obj, const uint32_t pos)
+{
+    uint32_t ret = 0;
+
+    if (UTILDEBUG_VERIFY(obj != NULL) && (pos < vector_getsize(&obj->fds)))
+    {
+        ret = fionepoll_getrevents((struct fionepoll_fd *)vector_getval(&obj->fds, pos));
+    }
+
+    return ret;
+}
+
+uint32_t fionepoll_getready(struct fionobj * const obj,
+                            const uint32_t pos,
+                            int32_t * const fd)
+{
+    uint32_t ret = 0;
+    struct epoll_event *event = NULL;
+    struct fionepoll_fd *state = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (fd != NULL)) &&
+        (pos < obj->readycount))
+    {
+        event = (struct epoll_event *)vector_getval(&obj->ready, pos);
+        *fd = event->data.fd;
+
+        if ((state = fionepoll_getfd(obj, event->data.fd)) != NULL)
+        {
+            ret = fionepoll_getrevents(state);
+        }
+    }
+
+    return ret;
+}
+
+#else
+
+bool fionepoll_create(struct fionobj * const obj)
+{
+    (void)obj;
+
+    logger_printf(LOGGER_LEVEL_ERROR,
+                  "%s: epoll is not supported on this platform\n",
+                  __FUNCTION__);
+
+    return false;
+}
+
+bool fionepoll_destroy(struct fionobj * const obj)
+{
+    (void)obj;
+    return false;
+}
+
+bool fionepoll_insertfd(struct fionobj * const obj, const int32_t fd)
+{
+    (void)obj;
+    (void)fd;
+    return false;
+}
+
+bool fionepoll_deletefd(struct fionobj * const obj, const int32_t fd)
+{
+    (void)obj;
+    (void)fd;
+    return false;
+}
+
+bool fionepoll_setflags(struct fionobj * const obj)
+{
+    (void)obj;
+    return false;
+}
+
+bool fionepoll_setfdflags(struct fionobj * const obj,
+                          const int32_t fd,
+                          const uint32_t pevents)
+{
+    (void)obj;
+    (void)fd;
+    (void)pevents;
+    return false;
+}
+
+bool fionepoll_poll(struct fionobj * const obj)
+{
+    (void)obj;
+    return false;
+}
+
+uint32_t fionepoll_getevents(struct fionobj * const obj, const uint32_t pos)
+{
+    (void)obj;
+    (void)pos;
+    return 0;
+}
+
+uint32_t fionepoll_getready(struct fionobj * const obj,
+                            const uint32_t pos,
+                            int32_t * const fd)
+{
+    (void)obj;
+    (void)pos;
+    (void)fd;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file      fion_obj.c
+ * @brief     File I/O event notification object implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "fion_epoll.h"
+#include "fion_obj.h"
+#include "fion_poll.h"
+#include "logger.h"
+#include "util_debug.h"
+
+bool fionobj_create(struct fionobj * const obj, const enum fionobj_model model)
+{
+    bool ret = false;
+
+    if (!UTILDEBUG_VERIFY(obj != NULL))
+    {
+        // Do nothing.
+    }
+    else if (model == FIONOBJ_MODEL_POLL)
+    {
+        ret = fionpoll_create(obj);
+    }
+    else if ((model == FIONOBJ_MODEL_EPOLL) ||
+             (model == FIONOBJ_MODEL_EPOLLET))
+    {
+        if ((ret = fionepoll_create(obj)))
+        {
+            obj->model = model;
+        }
+    }
+    else
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: unknown event model (%d)\n",
+                      __FUNCTION__,
+                      model);
+    }
+
+    return ret;
+}
@@ -16,23 +16,87 @@
 #include <poll.h>
 #include <sys/socket.h>
 
+/**
+ * @brief Convert file I/O event flags to poll events.
+ *
+ * @param[in] pevents The file I/O event flags to handle.
+ *
+ * @return The poll events to request for a file descriptor.
+ */
+static int16_t fionpoll_getflags(const uint32_t pevents)
+{
+    int16_t ret = POLLPRI | POLLERR | POLLHUP | POLLNVAL;
+
+#if defined(__linux__)
+    ret |= POLLRDHUP;
+#endif
+    if (pevents & FIONOBJ_PEVENT_IN)
+    {
+        ret |= POLLIN;
+    }
+
+    if (pevents & FIONOBJ_PEVENT_OUT)
+    {
+        ret |= POLLOUT;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find the position of a file descriptor within a file I/O event
+ *        notification object.
+ *
+ * @param[in,out] obj A pointer to a file I/O event notification object.
+ * @param[in]     fd  A file descriptor.
+ *
+ * @return The position of the file descriptor (the file descriptor count if
+ *         the file descriptor was not found).
+ */
+static uint32_t fionpoll_findfd(struct fionobj * const obj, const int32_t fd)
+{
+    struct pollfd *pfd = NULL;
+    uint32_t i;
+
+    for (i = 0; i < vector_getsize(&obj->fds); i++)
+    {
+        pfd = (struct pollfd *)vector_getval(&obj->fds, i);
+
+        if (pfd->fd == fd)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
 bool fionpoll_create(struct fionobj * const obj)
 {
     bool ret = false;
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (vector_getsize(&obj->fds) == 0)))
     {
-        obj->ops.fion_create    = fionpoll_create;
-        obj->ops.fion_destroy   = fionpoll_destroy;
-        obj->ops.fion_insertfd  = fionpoll_insertfd;
-        obj->ops.fion_deletefd  = fionpoll_deletefd;
-        obj->ops.fion_setflags  = fionpoll_setflags;
-        obj->ops.fion_poll      = fionpoll_poll;
-        obj->ops.fion_getevents = fionpoll_getevents;
-        obj->timeoutms          = 0;
-        obj->pevents            = 0;
-        obj->revents            = 0;
-
+        obj->ops.fion_create     = fionpoll_create;
+        obj->ops.fion_destroy    = fionpoll_destroy;
+        obj->ops.fion_insertfd   = fionpoll_insertfd;
+        obj->ops.fion_deletefd   = fionpoll_deletefd;
+        obj->ops.fion_setflags   = fionpoll_setflags;
+        obj->ops.fion_setfdflags = fionpoll_setfdflags;
+        obj->ops.fion_poll       = fionpoll_poll;
+        obj->ops.fion_getevents  = fionpoll_getevents;
+        obj->ops.fion_getready   = fionpoll_getready;
+        obj->model               = FIONOBJ_MODEL_POLL;
+        obj->efd                 = -1;
+        obj->timeoutms           = 0;
+        obj->pevents             = 0;
+        obj->revents             = 0;
+        obj->readycount          = 0;
+        obj->readypos            = UINT32_MAX;
+        obj->readyindex          = 0;
+
+        // The ready file descriptors are found from the poll results, so no
+        // ready list is allocated.
         if (!vector_create(&obj->fds, 0, sizeof(struct pollfd)))
         {
             logger_printf(LOGGER_LEVEL_ERROR,
@@ -57,13 +121,16 @@ bool fionpoll_destroy(struct fionobj * const obj)
     {
         vector_destroy(&obj->fds);
 
-        obj->ops.fion_create    = NULL;
-        obj->ops.fion_destroy   = NULL;
-        obj->ops.fion_insertfd  = NULL;
-        obj->ops.fion_deletefd  = NULL;
-        obj->ops.fion_setflags  = NULL;
-        obj->ops.fion_poll      = NULL;
-        obj->ops.fion_getevents = NULL;
+        obj->ops.fion_create     = NULL;
+        obj->ops.fion_destroy    = NULL;
+        obj->ops.fion_insertfd   = NULL;
+        obj->ops.fion_deletefd   = NULL;
+        obj->ops.fion_setflags   = NULL;
+        obj->ops.fion_setfdflags = NULL;
+        obj->ops.fion_poll       = NULL;
+        obj->ops.fion_getevents  = NULL;
+        obj->ops.fion_getready   = NULL;
+        obj->readycount          = 0;
 
         ret = true;
     }
@@ -73,35 +140,24 @@ bool fionpoll_destroy(struct fionobj * const obj)
 
 bool fionpoll_insertfd(struct fionobj * const obj, const int32_t fd)
 {
-    bool ret = false, found = false;
-    struct pollfd *pfd = NULL;
+    bool ret = false;
     struct pollfd val = {.fd = fd, .events = 0, .revents = 0};
-    uint32_t i;
 
     if (UTILDEBUG_VERIFY(obj != NULL))
     {
-        for (i = 0; i < vector_getsize(&obj->fds); i++)
+        if (fionpoll_findfd(obj, fd) < vector_getsize(&obj->fds))
         {
-            pfd = (struct pollfd *)vector_getval(&obj->fds, i);
-
-            if (pfd->fd == fd)
-            {
-                logger_printf(LOGGER_LEVEL_ERROR,
-                              "%s: fd %d is already in the list\n",
-                              __FUNCTION__,
-                              fd);
-                found = true;
-                break;
-            }
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d is already in the list\n",
+                          __FUNCTION__,
+                          fd);
         }
-
-        if (!found)
+        else
         {
-            if ((vector_inserttail(&obj->fds, &val)) &&
-                (obj->ops.fion_setflags(obj)))
-            {
-                ret = true;
-            }
+            // Only set the flags of the new file descriptor in order to
+            // preserve the interest masks of the existing file descriptors.
+            val.events = fionpoll_getflags(obj->pevents);
+            ret = vector_inserttail(&obj->fds, &val);
         }
     }
 
@@ -110,24 +166,12 @@ bool fionpoll_insertfd(struct fionobj * const obj, const int32_t fd)
 
 bool fionpoll_deletefd(struct fionobj * const obj, const int32_t fd)
 {
-    bool ret = false, found = false;
-    struct pollfd *pfd = NULL;
-    uint32_t i;
+    bool ret = false;
+    uint32_t pos;
 
     if (UTILDEBUG_VERIFY(obj != NULL))
     {
-        for (i = 0; i < vector_getsize(&obj->fds); i++)
-        {
-            pfd = (struct pollfd *)vector_getval(&obj->fds, i);
-
-            if (pfd->fd == fd)
-            {
-                found = true;
-                break;
-            }
-        }
-
-        if (!found)
+        if ((pos = fionpoll_findfd(obj, fd)) >= vector_getsize(&obj->fds))
         {
             logger_printf(LOGGER_LEVEL_ERROR,
                           "%s: fd %d is not in the list\n",
@@ -136,7 +180,7 @@ bool fionpoll_deletefd(struct fionobj * const obj, const int32_t fd)
         }
         else
         {
-            ret = vector_delete(&obj->fds, i);
+            ret = vector_delete(&obj->fds, pos);
         }
     }
 
@@ -154,20 +198,35 @@ bool fionpoll_setflags(struct fionobj * const obj)
         for (i = 0; i < vector_getsize(&obj->fds); i++)
         {
             pfd = (struct pollfd *)vector_getval(&obj->fds, i);
-            pfd->events = POLLPRI | POLLERR | POLLHUP | POLLNVAL;
-#if defined(__linux__)
-            pfd->events |= POLLRDHUP;
-#endif
-            if (obj->pevents & FIONOBJ_PEVENT_IN)
-            {
-                pfd->events |= POLLIN;
-            }
+            pfd->events = fionpoll_getflags(obj->pevents);
+            ret = true;
+        }
+    }
 
-            if (obj->pevents & FIONOBJ_PEVENT_OUT)
-            {
-                pfd->events |= POLLOUT;
-            }
+    return ret;
+}
 
+bool fionpoll_setfdflags(struct fionobj * const obj,
+                         const int32_t fd,
+                         const uint32_t pevents)
+{
+    bool ret = false;
+    struct pollfd *pfd = NULL;
+    uint32_t pos;
+
+    if (UTILDEBUG_VERIFY(obj != NULL))
+    {
+        if ((pos = fionpoll_findfd(obj, fd)) >= vector_getsize(&obj->fds))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: fd %d is not in the list\n",
+                          __FUNCTION__,
+                          fd);
+        }
+        else
+        {
+            pfd = (struct pollfd *)vector_getval(&obj->fds, pos);
+            pfd->events = fionpoll_getflags(pevents);
             ret = true;
         }
     }
@@ -178,12 +237,15 @@ bool fionpoll_setflags(struct fionobj * const obj)
 bool fionpoll_poll(struct fionobj * const obj)
 {
     bool ret = false;
+    struct pollfd *pfd = NULL;
     int32_t err;
     uint32_t i;
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (vector_getsize(&obj->fds) > 0)))
     {
-        obj->revents = 0;
+        obj->revents    = 0;
+        obj->readycount = 0;
+        obj->readypos   = UINT32_MAX;
         err = poll((struct pollfd *)vector_getval(&obj->fds, 0),
                    vector_getsize(&obj->fds),
                    obj->timeoutms);
@@ -198,7 +260,13 @@ bool fionpoll_poll(struct fionobj * const obj)
         {
             for (i = 0; i < vector_getsize(&obj->fds); i++)
             {
-                obj->revents |= fionpoll_getevents(obj, i);
+                pfd = (struct pollfd *)vector_getval(&obj->fds, i);
+
+                if (pfd->revents != 0)
+                {
+                    obj->readycount++;
+                    obj->revents |= fionpoll_getevents(obj, i);
+                }
             }
 
             ret = true;
@@ -226,15 +294,21 @@ uint32_t fionpoll_getevents(struct fionobj * const obj, const uint32_t pos)
 
         // Check for error events.
         if ((pfd->revents & POLLERR) ||
-#if defined(__linux__)
-            (pfd->revents & POLLRDHUP) ||
-#endif
             (pfd->revents & POLLHUP) ||
             (pfd->revents & POLLNVAL))
         {
             ret |= FIONOBJ_REVENT_ERROR;
         }
 
+#if defined(__linux__)
+        // A peer that shut down its side may have left input to read, which
+        // is read until the end of the stream.
+        if (pfd->revents & POLLRDHUP)
+        {
+            ret |= FIONOBJ_REVENT_INREADY | FIONOBJ_REVENT_HANGUP;
+        }
+#endif
+
         // Check for input event.
         if (pfd->revents & POLLIN)
         {
@@ -256,3 +330,39 @@ uint32_t fionpoll_getevents(struct fionobj * const obj, const uint32_t pos)
 
     return ret;
 }
+
+uint32_t fionpoll_getready(struct fionobj * const obj,
+                           const uint32_t pos,
+                           int32_t * const fd)
+{
+    uint32_t ret = 0, index = 0, next = 0;
+    struct pollfd *pfd = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (fd != NULL)) &&
+        (pos < obj->readycount))
+    {
+        // Ready positions are usually visited in order, so the search
+        // continues from the last position visited.
+        if ((obj->readypos != UINT32_MAX) && (pos >= obj->readypos))
+        {
+            index = obj->readyindex;
+            next  = obj->readypos;
+        }
+
+        for (; index < vector_getsize(&obj->fds); index++)
+        {
+            pfd = (struct pollfd *)vector_getval(&obj->fds, index);
+
+            if ((pfd->revents != 0) && (next++ == pos))
+            {
+                obj->readypos   = pos;
+                obj->readyindex = index;
+                *fd = pfd->fd;
+                ret = fionpoll_getevents(obj, index);
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
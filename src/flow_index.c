@@ -0,0 +1,740 @@
+/**
+ * @file      flow_index.c
+ * @brief     Flow index implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "flow_index.h"
+#include "logger.h"
+#include "util_debug.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Get the tree link of a node.
+ *
+ * @param[in] node  A pointer to a flow index node.
+ * @param[in] tuple True for the five-tuple tree (false for the flow id tree).
+ *
+ * @return A pointer to the tree link of the node.
+ */
+static struct flowindex_link *flowindex_getlink(struct flowindex_node * const node,
+                                                const bool tuple)
+{
+    return (tuple ? &node->tuplelink : &node->idlink);
+}
+
+/**
+ * @brief Get the node of a tree link.
+ *
+ * @param[in] link  A pointer to a tree link.
+ * @param[in] tuple True for the five-tuple tree (false for the flow id tree).
+ *
+ * @return A pointer to the node of the tree link.
+ */
+static struct flowindex_node *flowindex_getnode(const struct flowindex_link * const link,
+                                                const bool tuple)
+{
+    return (struct flowindex_node *)((uintptr_t)link -
+                                     (tuple ?
+                                      offsetof(struct flowindex_node, tuplelink) :
+                                      offsetof(struct flowindex_node, idlink)));
+}
+
+/**
+ * @brief Compare two five-tuples field by field, so that addresses and ports
+ *        are ordered by value.
+ *
+ * @param[in] tuple1 A pointer to a first five-tuple.
+ * @param[in] tuple2 A pointer to a second five-tuple.
+ *
+ * @return Less than, equal to or greater than zero if the first five-tuple is
+ *         less than, equal to or greater than the second five-tuple.
+ */
+static int32_t flowindex_comparetuple(const struct flowindex_tuple * const tuple1,
+                                      const struct flowindex_tuple * const tuple2)
+{
+    int32_t ret = (int32_t)tuple1->proto - (int32_t)tuple2->proto;
+
+    if (ret == 0)
+    {
+        ret = (int32_t)tuple1->family - (int32_t)tuple2->family;
+    }
+
+    if (ret == 0)
+    {
+        ret = memcmp(tuple1->client, tuple2->client, sizeof(tuple1->client));
+    }
+
+    if (ret == 0)
+    {
+        ret = (int32_t)tuple1->clientport - (int32_t)tuple2->clientport;
+    }
+
+    if (ret == 0)
+    {
+        ret = memcmp(tuple1->server, tuple2->server, sizeof(tuple1->server));
+    }
+
+    if (ret == 0)
+    {
+        ret = (int32_t)tuple1->serverport - (int32_t)tuple2->serverport;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Compare the keys of two nodes in a tree.
+ *
+ * @param[in] node1 A pointer to a first node.
+ * @param[in] node2 A pointer to a second node.
+ * @param[in] tuple True for the five-tuple tree (false for the flow id tree).
+ *
+ * @return Less than, equal to or greater than zero if the key of the first
+ *         node is less than, equal to or greater than the key of the second.
+ */
+static int32_t flowindex_compare(const struct flowindex_node * const node1,
+                                 const struct flowindex_node * const node2,
+                                 const bool tuple)
+{
+    int32_t ret = (tuple ? flowindex_comparetuple(&node1->tuple, &node2->tuple) : 0);
+
+    if (ret == 0)
+    {
+        ret = (node1->id < node2->id ? -1 : (node1->id > node2->id ? 1 : 0));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the height of a subtree.
+ *
+ * @param[in] link A pointer to the root link of a subtree (NULL if empty).
+ *
+ * @return The height of the subtree.
+ */
+static int32_t flowindex_getheight(const struct flowindex_link * const link)
+{
+    return (link == NULL ? 0 : link->height);
+}
+
+/**
+ * @brief Update the height of a subtree from the heights of its children.
+ *
+ * @param[in,out] link A pointer to the root link of a subtree.
+ *
+ * @return Void.
+ */
+static void flowindex_setheight(struct flowindex_link * const link)
+{
+    const int32_t left = flowindex_getheight(link->left);
+    const int32_t right = flowindex_getheight(link->right);
+
+    link->height = 1 + (left > right ? left : right);
+}
+
+/**
+ * @brief Put a subtree in the place of another subtree in its parent.
+ *
+ * @param[in,out] root A pointer to the root link pointer of a tree.
+ * @param[in]     old  A pointer to the root link of the replaced subtree.
+ * @param[in,out] link A pointer to the root link of the new subtree (NULL if
+ *                     empty).
+ *
+ * @return Void.
+ */
+static void flowindex_replace(struct flowindex_link ** const root,
+                              const struct flowindex_link * const old,
+                              struct flowindex_link * const link)
+{
+    if (old->parent == NULL)
+    {
+        *root = link;
+    }
+    else if (old->parent->left == old)
+    {
+        old->parent->left = link;
+    }
+    else
+    {
+        old->parent->right = link;
+    }
+
+    if (link != NULL)
+    {
+        link->parent = old->parent;
+    }
+}
+
+/**
+ * @brief Rotate a subtree so that a child of its root becomes its root.
+ *
+ * @param[in,out] root A pointer to the root link pointer of a tree.
+ * @param[in,out] link A pointer to the root link of a subtree.
+ * @param[in]     left True to rotate the right child up to the left (false to
+ *                     rotate the left child up to the right).
+ *
+ * @return A pointer to the new root link of the subtree.
+ */
+static struct flowindex_link *flowindex_rotate(struct flowindex_link ** const root,
+                                               struct flowindex_link * const link,
+                                               const bool left)
+{
+    struct flowindex_link *child = (left ? link->right : link->left);
+    struct flowindex_link *inner = (left ? child->left : child->right);
+
+    if (left)
+    {
+        link->right = inner;
+        child->left = link;
+    }
+    else
+    {
+        link->left   = inner;
+        child->right = link;
+    }
+
+    if (inner != NULL)
+    {
+        inner->parent = link;
+    }
+
+    flowindex_replace(root, link, child);
+    link->parent = child;
+    flowindex_setheight(link);
+    flowindex_setheight(child);
+
+    return child;
+}
+
+/**
+ * @brief Restore the heights and the balance of a tree from a link up to the
+ *        root of the tree.
+ *
+ * @param[in,out] root A pointer to the root link pointer of a tree.
+ * @param[in,out] link A pointer to the lowest changed link (NULL if none).
+ *
+ * @return Void.
+ */
+static void flowindex_rebalance(struct flowindex_link ** const root,
+                                struct flowindex_link *link)
+{
+    int32_t balance;
+
+    while (link != NULL)
+    {
+        flowindex_setheight(link);
+        balance = flowindex_getheight(link->left) - flowindex_getheight(link->right);
+
+        if (balance > 1)
+        {
+            if (flowindex_getheight(link->left->left) < flowindex_getheight(link->left->right))
+            {
+                flowindex_rotate(root, link->left, true);
+            }
+
+            link = flowindex_rotate(root, link, false);
+        }
+        else if (balance < -1)
+        {
+            if (flowindex_getheight(link->right->right) < flowindex_getheight(link->right->left))
+            {
+                flowindex_rotate(root, link->right, false);
+            }
+
+            link = flowindex_rotate(root, link, true);
+        }
+        else
+        {
+            // Do nothing.
+        }
+
+        link = link->parent;
+    }
+}
+
+/**
+ * @brief Add a node to a tree.
+ *
+ * @param[in,out] root  A pointer to the root link pointer of a tree.
+ * @param[in,out] node  A pointer to a node.
+ * @param[in]     tuple True for the five-tuple tree (false for the flow id
+ *                      tree).
+ *
+ * @return True if a node was added (false if its key is already in the tree).
+ */
+static bool flowindex_add(struct flowindex_link ** const root,
+                          struct flowindex_node * const node,
+                          const bool tuple)
+{
+    struct flowindex_link *link = flowindex_getlink(node, tuple);
+    struct flowindex_link *parent = NULL, *cur = *root;
+    int32_t cmp = 0;
+    bool ret = true;
+
+    while ((ret) && (cur != NULL))
+    {
+        parent = cur;
+        cmp = flowindex_compare(node, flowindex_getnode(cur, tuple), tuple);
+        ret = (cmp != 0);
+        cur = (cmp < 0 ? cur->left : cur->right);
+    }
+
+    if (ret)
+    {
+        link->parent = parent;
+        link->left   = NULL;
+        link->right  = NULL;
+        link->height = 1;
+
+        if (parent == NULL)
+        {
+            *root = link;
+        }
+        else if (cmp < 0)
+        {
+            parent->left = link;
+        }
+        else
+        {
+            parent->right = link;
+        }
+
+        flowindex_rebalance(root, parent);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the lowest link of a subtree.
+ *
+ * @param[in] link A pointer to the root link of a subtree (NULL if empty).
+ *
+ * @return A pointer to the lowest link (NULL if empty).
+ */
+static struct flowindex_link *flowindex_getlowest(struct flowindex_link *link)
+{
+    while ((link != NULL) && (link->left != NULL))
+    {
+        link = link->left;
+    }
+
+    return link;
+}
+
+/**
+ * @brief Get the next link of a tree in order.
+ *
+ * @param[in] link A pointer to a link of a tree.
+ *
+ * @return A pointer to the next link (NULL if none).
+ */
+static struct flowindex_link *flowindex_getnext(const struct flowindex_link *link)
+{
+    struct flowindex_link *ret = NULL;
+
+    if (link->right != NULL)
+    {
+        ret = flowindex_getlowest(link->right);
+    }
+    else
+    {
+        while ((link->parent != NULL) && (link->parent->right == link))
+        {
+            link = link->parent;
+        }
+
+        ret = link->parent;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Remove a node from a tree.
+ *
+ * @param[in,out] root  A pointer to the root link pointer of a tree.
+ * @param[in,out] node  A pointer to a node of the tree.
+ * @param[in]     tuple True for the five-tuple tree (false for the flow id
+ *                      tree).
+ *
+ * @return Void.
+ */
+static void flowindex_delete(struct flowindex_link ** const root,
+                             struct flowindex_node * const node,
+                             const bool tuple)
+{
+    struct flowindex_link *link = flowindex_getlink(node, tuple);
+    struct flowindex_link *next = NULL, *start = NULL;
+
+    if ((link->left != NULL) && (link->right != NULL))
+    {
+        // The next link (which has no left child) takes the place of the
+        // removed link.
+        next = flowindex_getlowest(link->right);
+
+        if (next->parent == link)
+        {
+            start = next;
+        }
+        else
+        {
+            start = next->parent;
+            start->left = next->right;
+
+            if (next->right != NULL)
+            {
+                next->right->parent = start;
+            }
+
+            next->right = link->right;
+            link->right->parent = next;
+        }
+
+        next->left = link->left;
+        link->left->parent = next;
+        flowindex_replace(root, link, next);
+        next->height = link->height;
+    }
+    else
+    {
+        start = link->parent;
+        flowindex_replace(root, link, link->left != NULL ? link->left : link->right);
+    }
+
+    flowindex_rebalance(root, start);
+    link->parent = link->left = link->right = NULL;
+}
+
+/**
+ * @brief Remove a node from the age list of a flow index.
+ *
+ * @param[in,out] index A pointer to a flow index.
+ * @param[in,out] node  A pointer to a node in the age list.
+ *
+ * @return Void.
+ */
+static void flowindex_unlinkage(struct flowindex * const index,
+                                struct flowindex_node * const node)
+{
+    if (node->older == NULL)
+    {
+        index->oldest = node->newer;
+    }
+    else
+    {
+        node->older->newer = node->newer;
+    }
+
+    if (node->newer == NULL)
+    {
+        index->newest = node->older;
+    }
+    else
+    {
+        node->newer->older = node->older;
+    }
+
+    node->older = node->newer = NULL;
+}
+
+/**
+ * @brief Add a node to the age list of a flow index.
+ *
+ * @param[in,out] index  A pointer to a flow index.
+ * @param[in,out] node   A pointer to a node not in the age list.
+ * @param[in]     newest True to add the node as the newest node (false to add
+ *                       it as the oldest node).
+ *
+ * @return Void.
+ */
+static void flowindex_linkage(struct flowindex * const index,
+                              struct flowindex_node * const node,
+                              const bool newest)
+{
+    node->older = (newest ? index->newest : NULL);
+    node->newer = (newest ? NULL : index->oldest);
+
+    if (index->newest == NULL)
+    {
+        index->oldest = index->newest = node;
+    }
+    else if (newest)
+    {
+        index->newest->newer = node;
+        index->newest = node;
+    }
+    else
+    {
+        index->oldest->older = node;
+        index->oldest = node;
+    }
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool flowindex_create(struct flowindex * const index)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY(index != NULL))
+    {
+        memset(index, 0, sizeof(*index));
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool flowindex_destroy(struct flowindex * const index)
+{
+    return flowindex_create(index);
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool flowindex_insert(struct flowindex * const index,
+                      struct flowindex_node * const node)
+{
+    bool ret = false;
+
+    if (!UTILDEBUG_VERIFY((index != NULL) && (node != NULL)))
+    {
+        // Do nothing.
+    }
+    else if (!flowindex_add(&index->idroot, node, false))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: flow %u is already indexed\n",
+                      __FUNCTION__,
+                      node->id);
+    }
+    else
+    {
+        // The flow id breaks five-tuple ties, so the add cannot fail.
+        flowindex_add(&index->tupleroot, node, true);
+        flowindex_linkage(index, node, false);
+        index->count++;
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool flowindex_remove(struct flowindex * const index,
+                      struct flowindex_node * const node)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((index != NULL) && (node != NULL) && (index->count > 0)))
+    {
+        flowindex_delete(&index->idroot, node, false);
+        flowindex_delete(&index->tupleroot, node, true);
+        flowindex_unlinkage(index, node);
+        index->count--;
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool flowindex_settuple(struct flowindex * const index,
+                        struct flowindex_node * const node,
+                        const struct flowindex_tuple * const tuple)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((index != NULL) && (node != NULL) && (tuple != NULL)))
+    {
+        if (flowindex_comparetuple(&node->tuple, tuple) != 0)
+        {
+            flowindex_delete(&index->tupleroot, node, true);
+            memcpy(&node->tuple, tuple, sizeof(node->tuple));
+            flowindex_add(&index->tupleroot, node, true);
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+void flowindex_touch(struct flowindex * const index,
+                     struct flowindex_node * const node,
+                     const uint64_t tsus)
+{
+    if (UTILDEBUG_VERIFY((index != NULL) && (node != NULL)))
+    {
+        node->ageus = tsus;
+
+        if (index->newest != node)
+        {
+            flowindex_unlinkage(index, node);
+            flowindex_linkage(index, node, true);
+        }
+    }
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_getid(const struct flowindex * const index,
+                                       const uint32_t id)
+{
+    struct flowindex_node *ret = NULL, *node = NULL;
+    const struct flowindex_link *link = NULL;
+
+    if (UTILDEBUG_VERIFY(index != NULL))
+    {
+        link = index->idroot;
+
+        while ((ret == NULL) && (link != NULL))
+        {
+            node = flowindex_getnode(link, false);
+
+            if (id < node->id)
+            {
+                link = link->left;
+            }
+            else if (id > node->id)
+            {
+                link = link->right;
+            }
+            else
+            {
+                ret = node;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_gettuple(const struct flowindex * const index,
+                                          const struct flowindex_tuple * const tuple)
+{
+    struct flowindex_node *ret = NULL, *node = NULL;
+    const struct flowindex_link *link = NULL;
+    int32_t cmp;
+
+    if (UTILDEBUG_VERIFY((index != NULL) && (tuple != NULL)))
+    {
+        link = index->tupleroot;
+
+        // Keep looking to the left of a match for a lower flow id.
+        while (link != NULL)
+        {
+            node = flowindex_getnode(link, true);
+            cmp = flowindex_comparetuple(tuple, &node->tuple);
+
+            if (cmp == 0)
+            {
+                ret = node;
+            }
+
+            link = (cmp <= 0 ? link->left : link->right);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_getoldest(const struct flowindex * const index)
+{
+    return (UTILDEBUG_VERIFY(index != NULL) ? index->oldest : NULL);
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_firstid(const struct flowindex * const index)
+{
+    struct flowindex_link *link = NULL;
+
+    if (UTILDEBUG_VERIFY(index != NULL))
+    {
+        link = flowindex_getlowest(index->idroot);
+    }
+
+    return (link == NULL ? NULL : flowindex_getnode(link, false));
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_nextid(const struct flowindex_node * const node)
+{
+    struct flowindex_link *link = NULL;
+
+    if (UTILDEBUG_VERIFY(node != NULL))
+    {
+        link = flowindex_getnext(&node->idlink);
+    }
+
+    return (link == NULL ? NULL : flowindex_getnode(link, false));
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_firsttuple(const struct flowindex * const index)
+{
+    struct flowindex_link *link = NULL;
+
+    if (UTILDEBUG_VERIFY(index != NULL))
+    {
+        link = flowindex_getlowest(index->tupleroot);
+    }
+
+    return (link == NULL ? NULL : flowindex_getnode(link, true));
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+struct flowindex_node *flowindex_nexttuple(const struct flowindex_node * const node)
+{
+    struct flowindex_link *link = NULL;
+
+    if (UTILDEBUG_VERIFY(node != NULL))
+    {
+        link = flowindex_getnext(&node->tuplelink);
+    }
+
+    return (link == NULL ? NULL : flowindex_getnode(link, true));
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+uint32_t flowindex_getcount(const struct flowindex * const index)
+{
+    return (UTILDEBUG_VERIFY(index != NULL) ? index->count : 0);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file      flow_rank.c
+ * @brief     Bounded flow ranking implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "flow_rank.h"
+#include "logger.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+#include <string.h>
+
+/**
+ * @brief Check if a value ranks worse than another value.
+ *
+ * @param[in] rank A pointer to a flow ranking.
+ * @param[in] val1 A first value.
+ * @param[in] val2 A second value.
+ *
+ * @return True if the first value ranks worse than the second value.
+ */
+static bool flowrank_isworse(const struct flowrank * const rank,
+                             const uint64_t val1,
+                             const uint64_t val2)
+{
+    return (rank->lowest ? val1 > val2 : val1 < val2);
+}
+
+/**
+ * @brief Swap two entries of a flow ranking.
+ *
+ * @param[in,out] rank A pointer to a flow ranking.
+ * @param[in]     i    A first entry index.
+ * @param[in]     j    A second entry index.
+ *
+ * @return Void.
+ */
+static void flowrank_swap(struct flowrank * const rank,
+                          const uint32_t i,
+                          const uint32_t j)
+{
+    struct flowrank_entry entry;
+
+    memcpy(&entry, &rank->entries[i], sizeof(entry));
+    memcpy(&rank->entries[i], &rank->entries[j], sizeof(entry));
+    memcpy(&rank->entries[j], &entry, sizeof(entry));
+}
+
+/**
+ * @brief Move an entry toward the root of a ranking heap until its parent
+ *        ranks no better than it.
+ *
+ * @param[in,out] rank A pointer to a flow ranking.
+ * @param[in]     i    An entry index.
+ *
+ * @return Void.
+ */
+static void flowrank_siftup(struct flowrank * const rank, uint32_t i)
+{
+    uint32_t parent;
+
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+
+        if (flowrank_isworse(rank,
+                             rank->entries[i].val,
+                             rank->entries[parent].val))
+        {
+            flowrank_swap(rank, i, parent);
+            i = parent;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Move an entry away from the root of a ranking heap until its
+ *        children rank no worse than it.
+ *
+ * @param[in,out] rank  A pointer to a flow ranking.
+ * @param[in]     i     An entry index.
+ * @param[in]     count The number of entries in the heap.
+ *
+ * @return Void.
+ */
+static void flowrank_siftdown(struct flowrank * const rank,
+                              uint32_t i,
+                              const uint32_t count)
+{
+    uint32_t child, worst;
+
+    for (;;)
+    {
+        worst = i;
+        child = 2 * i + 1;
+
+        if ((child < count) &&
+            (flowrank_isworse(rank,
+                              rank->entries[child].val,
+                              rank->entries[worst].val)))
+        {
+            worst = child;
+        }
+
+        if ((child + 1 < count) &&
+            (flowrank_isworse(rank,
+                              rank->entries[child + 1].val,
+                              rank->entries[worst].val)))
+        {
+            worst = child + 1;
+        }
+
+        if (worst == i)
+        {
+            break;
+        }
+
+        flowrank_swap(rank, i, worst);
+        i = worst;
+    }
+}
+
+bool flowrank_create(struct flowrank * const rank,
+                     const uint32_t size,
+                     const bool lowest)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((rank != NULL) && (rank->entries == NULL) && (size > 0)))
+    {
+        if ((rank->entries = UTILMEM_CALLOC(struct flowrank_entry,
+                                            sizeof(struct flowrank_entry),
+                                            size)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate entries (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            rank->size   = size;
+            rank->count  = 0;
+            rank->lowest = lowest;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool flowrank_destroy(struct flowrank * const rank)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY(rank != NULL))
+    {
+        UTILMEM_FREE(rank->entries);
+        rank->entries = NULL;
+        rank->size    = 0;
+        rank->count   = 0;
+        ret = true;
+    }
+
+    return ret;
+}
+
+void flowrank_clear(struct flowrank * const rank)
+{
+    if (UTILDEBUG_VERIFY(rank != NULL))
+    {
+        rank->count = 0;
+    }
+}
+
+bool flowrank_isranked(const struct flowrank * const rank, const uint64_t val)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((rank != NULL) && (rank->entries != NULL)))
+    {
+        ret = ((rank->count < rank->size) ||
+               (flowrank_isworse(rank, rank->entries[0].val, val)));
+    }
+
+    return ret;
+}
+
+bool flowrank_offer(struct flowrank * const rank,
+                    const struct flowrank_entry * const entry)
+{
+    bool ret = false;
+
+    if (!UTILDEBUG_VERIFY((rank != NULL) &&
+                          (rank->entries != NULL) &&
+                          (entry != NULL)))
+    {
+        // Do nothing.
+    }
+    else if (rank->count < rank->size)
+    {
+        memcpy(&rank->entries[rank->count], entry, sizeof(*entry));
+        flowrank_siftup(rank, rank->count++);
+        ret = true;
+    }
+    else if (flowrank_isworse(rank, rank->entries[0].val, entry->val))
+    {
+        memcpy(&rank->entries[0], entry, sizeof(*entry));
+        flowrank_siftdown(rank, 0, rank->count);
+        ret = true;
+    }
+    else
+    {
+        // Do nothing.
+    }
+
+    return ret;
+}
+
+uint32_t flowrank_merge(struct flowrank * const dst,
+                        const struct flowrank * const src)
+{
+    uint32_t ret = 0, i;
+
+    if (UTILDEBUG_VERIFY((dst != NULL) && (src != NULL)))
+    {
+        for (i = 0; i < src->count; i++)
+        {
+            ret += (flowrank_offer(dst, &src->entries[i]) ? 1 : 0);
+        }
+    }
+
+    return ret;
+}
+
+uint32_t flowrank_sort(struct flowrank * const rank)
+{
+    uint32_t ret = 0, i;
+
+    if (UTILDEBUG_VERIFY((rank != NULL) && (rank->entries != NULL)))
+    {
+        // Move the worst entry of the heap to its end until the heap is empty.
+        for (i = rank->count; i > 1; i--)
+        {
+            flowrank_swap(rank, 0, i - 1);
+            flowrank_siftdown(rank, 0, i - 1);
+        }
+
+        ret = rank->count;
+    }
+
+    return ret;
+}
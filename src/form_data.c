@@ -0,0 +1,538 @@
+/**
+ * @file      form_data.c
+ * @brief     Machine-readable presentation layer format implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "form_data.h"
+#include "util_debug.h"
+#include "util_unit.h"
+
+#include <string.h>
+
+// The largest formatted record: every field name plus a 20-digit value and its
+// separators.
+#define FORMDATA_RECORDMAX 2048
+
+#define FORMDATA_LAYOUT(name) { name, sizeof(name) - 1, ",\"" name "\":", sizeof(",\"" name "\":") - 1 }
+
+// The precomputed layout of a record. A record is formatted by copying these
+// strings and converting the field values, so no field is ever parsed from a
+// format string.
+struct formdata_layout
+{
+    const char *name;    // Field name (CSV column)
+    uint32_t    namelen;
+    const char *key;     // Separator and field key (JSON member)
+    uint32_t    keylen;
+};
+
+static const struct formdata_layout layout[FORMDATA_FIELDS] =
+{
+    FORMDATA_LAYOUT("type"),
+    FORMDATA_LAYOUT("tid"),
+    FORMDATA_LAYOUT("aggregate"),
+    FORMDATA_LAYOUT("sid"),
+    FORMDATA_LAYOUT("tsus"),
+    FORMDATA_LAYOUT("elapsedus"),
+    FORMDATA_LAYOUT("recvbytes"),
+    FORMDATA_LAYOUT("sendbytes"),
+    FORMDATA_LAYOUT("recvbps"),
+    FORMDATA_LAYOUT("sendbps"),
+    FORMDATA_LAYOUT("syscalls"),
+    FORMDATA_LAYOUT("datagrams"),
+    FORMDATA_LAYOUT("cpu"),
+    FORMDATA_LAYOUT("rrcount"),
+    FORMDATA_LAYOUT("rrlost"),
+    FORMDATA_LAYOUT("rrp50ns"),
+    FORMDATA_LAYOUT("rrp90ns"),
+    FORMDATA_LAYOUT("rrp99ns"),
+    FORMDATA_LAYOUT("rrp999ns"),
+    FORMDATA_LAYOUT("rrmaxns"),
+    FORMDATA_LAYOUT("conncount"),
+    FORMDATA_LAYOUT("connfail"),
+    FORMDATA_LAYOUT("connp50ns"),
+    FORMDATA_LAYOUT("connp90ns"),
+    FORMDATA_LAYOUT("connp99ns"),
+    FORMDATA_LAYOUT("connp999ns"),
+    FORMDATA_LAYOUT("connmaxns")
+};
+
+static const char *types[] = { "interval", "summary" };
+
+/**
+ * @brief Copy a string to a record buffer.
+ *
+ * @param[in,out] dst A pointer to a record buffer position.
+ * @param[in]     src A pointer to a string.
+ * @param[in]     len The length of the string in bytes.
+ *
+ * @return A pointer to the record buffer position after the string.
+ */
+static char *formdata_putstr(char * const dst,
+                             const char * const src,
+                             const uint32_t len)
+{
+    memcpy(dst, src, len);
+
+    return dst + len;
+}
+
+/**
+ * @brief Convert an unsigned integer to decimal digits in a record buffer.
+ *
+ * @param[in,out] dst A pointer to a record buffer position.
+ * @param[in]     val An unsigned integer.
+ *
+ * @return A pointer to the record buffer position after the digits.
+ */
+static char *formdata_putuint(char * const dst, uint64_t val)
+{
+    char digits[20];
+    uint32_t len = 0;
+
+    do
+    {
+        digits[sizeof(digits) - ++len] = (char)('0' + val % 10);
+        val /= 10;
+    } while (val > 0);
+
+    return formdata_putstr(dst, digits + sizeof(digits) - len, len);
+}
+
+/**
+ * @brief Store an unsigned integer in little-endian byte order in a record
+ *        buffer.
+ *
+ * @param[in,out] dst A pointer to a record buffer position.
+ * @param[in]     val An unsigned integer.
+ * @param[in]     len The size of the integer in bytes.
+ *
+ * @return A pointer to the record buffer position after the integer.
+ */
+static char *formdata_putle(char * const dst,
+                            const uint64_t val,
+                            const uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        dst[i] = (char)(val >> (i * 8));
+    }
+
+    return dst + len;
+}
+
+/**
+ * @brief Get a bit rate.
+ *
+ * @param[in] bytes The bytes transferred.
+ * @param[in] usec  The time in microseconds that the transfer took.
+ *
+ * @return The bit rate in bits per second (0 if no time elapsed).
+ */
+static uint64_t formdata_getrate(const uint64_t bytes, const uint64_t usec)
+{
+    return (usec == 0 ? 0 : bytes * 8 * UNIT_TIME_USEC / usec);
+}
+
+/**
+ * @brief Get the field values of an interval or summary record of the socket
+ *        of a format object.
+ *
+ * @param[in]  obj     A pointer to a format object.
+ * @param[in]  summary True for a summary record of the whole run.
+ * @param[out] vals    A pointer to an array of field values.
+ *
+ * @return Void.
+ */
+static void formdata_getrecord(const struct formobj * const obj,
+                               const bool summary,
+                               uint64_t * const vals)
+{
+    const struct sockobj_info *info = &obj->sock->info;
+    const struct sockobj_latency *rr = (summary ? &info->rrtotal : &info->rr);
+    const struct sockobj_latency *conn = (summary ? &info->conntotal : &info->conn);
+    uint64_t elapsedusec = (obj->tsus > info->startusec ?
+                            obj->tsus - info->startusec :
+                            0);
+
+    vals[FORMDATA_FIELD_TYPE]      = (summary ? 1 : 0);
+    vals[FORMDATA_FIELD_TID]       = obj->sock->tid;
+    vals[FORMDATA_FIELD_AGGREGATE] = (obj->aggregate ? 1 : 0);
+    vals[FORMDATA_FIELD_SID]       = obj->sock->sid;
+    vals[FORMDATA_FIELD_TSUS]      = obj->tsus;
+    vals[FORMDATA_FIELD_ELAPSEDUS] = elapsedusec;
+    vals[FORMDATA_FIELD_RECVBYTES] = (uint64_t)info->recv.buflen.sum;
+    vals[FORMDATA_FIELD_SENDBYTES] = (uint64_t)info->send.buflen.sum;
+
+    if (summary)
+    {
+        vals[FORMDATA_FIELD_RECVBPS] = formdata_getrate((uint64_t)info->recv.buflen.sum,
+                                                        elapsedusec);
+        vals[FORMDATA_FIELD_SENDBPS] = formdata_getrate((uint64_t)info->send.buflen.sum,
+                                                        elapsedusec);
+    }
+    else
+    {
+        vals[FORMDATA_FIELD_RECVBPS] = formdata_getrate((uint64_t)(info->recv.buflen.sum -
+                                                                   info->snaprecv.buflen.sum),
+                                                        obj->intervalusec);
+        vals[FORMDATA_FIELD_SENDBPS] = formdata_getrate((uint64_t)(info->send.buflen.sum -
+                                                                   info->snapsend.buflen.sum),
+                                                        obj->intervalusec);
+    }
+
+    vals[FORMDATA_FIELD_SYSCALLS]   = info->syscalls;
+    vals[FORMDATA_FIELD_DATAGRAMS]  = info->datagrams;
+    vals[FORMDATA_FIELD_CPU]        = (uint64_t)(obj->sock->cpu.usage < 0 ?
+                                                 0 :
+                                                 obj->sock->cpu.usage);
+    vals[FORMDATA_FIELD_RRCOUNT]    = rr->cnt;
+    vals[FORMDATA_FIELD_RRLOST]     = rr->lost;
+    vals[FORMDATA_FIELD_RRP50NS]    = rr->p50;
+    vals[FORMDATA_FIELD_RRP90NS]    = rr->p90;
+    vals[FORMDATA_FIELD_RRP99NS]    = rr->p99;
+    vals[FORMDATA_FIELD_RRP999NS]   = rr->p999;
+    vals[FORMDATA_FIELD_RRMAXNS]    = rr->max;
+    vals[FORMDATA_FIELD_CONNCOUNT]  = conn->cnt;
+    vals[FORMDATA_FIELD_CONNFAIL]   = conn->lost;
+    vals[FORMDATA_FIELD_CONNP50NS]  = conn->p50;
+    vals[FORMDATA_FIELD_CONNP90NS]  = conn->p90;
+    vals[FORMDATA_FIELD_CONNP99NS]  = conn->p99;
+    vals[FORMDATA_FIELD_CONNP999NS] = conn->p999;
+    vals[FORMDATA_FIELD_CONNMAXNS]  = conn->max;
+}
+
+/**
+ * @brief Format a record as a JSON object on a line of its own.
+ *
+ * @param[in,out] dst  A pointer to a record buffer.
+ * @param[in]     vals A pointer to an array of field values.
+ *
+ * @return The number of formatted bytes.
+ */
+static int32_t formdata_putjson(char * const dst, const uint64_t * const vals)
+{
+    char *pos = dst;
+    uint32_t i;
+
+    pos = formdata_putstr(pos, "{\"type\":\"", 9);
+    pos = formdata_putstr(pos,
+                          types[vals[FORMDATA_FIELD_TYPE]],
+                          (uint32_t)strlen(types[vals[FORMDATA_FIELD_TYPE]]));
+    *pos++ = '"';
+
+    for (i = FORMDATA_FIELD_TYPE + 1; i < FORMDATA_FIELDS; i++)
+    {
+        pos = formdata_putstr(pos, layout[i].key, layout[i].keylen);
+        pos = formdata_putuint(pos, vals[i]);
+    }
+
+    *pos++ = '}';
+    *pos++ = '\n';
+    *pos   = '\0';
+
+    return (int32_t)(pos - dst);
+}
+
+/**
+ * @brief Format a record as a line of comma-separated values.
+ *
+ * @param[in,out] dst  A pointer to a record buffer.
+ * @param[in]     vals A pointer to an array of field values.
+ *
+ * @return The number of formatted bytes.
+ */
+static int32_t formdata_putcsv(char * const dst, const uint64_t * const vals)
+{
+    char *pos = dst;
+    uint32_t i;
+
+    pos = formdata_putstr(pos,
+                          types[vals[FORMDATA_FIELD_TYPE]],
+                          (uint32_t)strlen(types[vals[FORMDATA_FIELD_TYPE]]));
+
+    for (i = FORMDATA_FIELD_TYPE + 1; i < FORMDATA_FIELDS; i++)
+    {
+        *pos++ = ',';
+        pos = formdata_putuint(pos, vals[i]);
+    }
+
+    *pos++ = '\n';
+    *pos   = '\0';
+
+    return (int32_t)(pos - dst);
+}
+
+/**
+ * @brief Format a record as an array of 64-bit little-endian field values.
+ *
+ * @param[in,out] dst  A pointer to a record buffer.
+ * @param[in]     vals A pointer to an array of field values.
+ *
+ * @return The number of formatted bytes.
+ */
+static int32_t formdata_putbinary(char * const dst, const uint64_t * const vals)
+{
+    char *pos = dst;
+    uint32_t i;
+
+    for (i = 0; i < FORMDATA_FIELDS; i++)
+    {
+        pos = formdata_putle(pos, vals[i], sizeof(vals[i]));
+    }
+
+    return (int32_t)(pos - dst);
+}
+
+/**
+ * @brief Format an interval or summary record in the format object
+ *        destination buffer.
+ *
+ * @param[in,out] obj     A pointer to a format object.
+ * @param[in]     summary True for a summary record of the whole run.
+ * @param[in]     put     A pointer to a record format function.
+ *
+ * @return The number of formatted bytes in the format object destination
+ *         buffer (-1 on error).
+ */
+static int32_t formdata_record(struct formobj * const obj,
+                               const bool summary,
+                               int32_t (*put)(char * const, const uint64_t * const))
+{
+    int32_t retval = -1;
+    uint64_t vals[FORMDATA_FIELDS];
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->sock != NULL) &&
+                         (obj->dstbuf != NULL) &&
+                         (obj->dstlen >= FORMDATA_RECORDMAX)))
+    {
+        if (summary)
+        {
+            obj->tsus = obj->sock->info.stopusec;
+        }
+
+        if (obj->tsus > obj->sock->info.startusec)
+        {
+            formdata_getrecord(obj, summary, vals);
+            retval = put((char *)obj->dstbuf, vals);
+            obj->records++;
+
+            obj->sock->info.snaprecv.buflen.sum = obj->sock->info.recv.buflen.sum;
+            obj->sock->info.snapsend.buflen.sum = obj->sock->info.send.buflen.sum;
+        }
+        else
+        {
+            retval = 0;
+        }
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Format the CSV header line once per format object.
+ *
+ * @see form_head() for interface comments.
+ */
+static int32_t formdata_csvhead(struct formobj * const obj)
+{
+    int32_t retval = -1;
+    char *pos = NULL;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->dstbuf != NULL) &&
+                         (obj->dstlen >= FORMDATA_RECORDMAX)))
+    {
+        pos = (char *)obj->dstbuf;
+
+        if (obj->records == 0)
+        {
+            for (i = 0; i < FORMDATA_FIELDS; i++)
+            {
+                if (i > 0)
+                {
+                    *pos++ = ',';
+                }
+
+                pos = formdata_putstr(pos, layout[i].name, layout[i].namelen);
+            }
+
+            *pos++ = '\n';
+            obj->records++;
+        }
+
+        *pos   = '\0';
+        retval = (int32_t)(pos - (char *)obj->dstbuf);
+    }
+
+    return retval;
+}
+
+/**
+ * @brief Format the binary stream header once per format object.
+ *
+ * @see form_head() for interface comments.
+ */
+static int32_t formdata_binaryhead(struct formobj * const obj)
+{
+    int32_t retval = -1;
+    char *pos = NULL;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->dstbuf != NULL) &&
+                         (obj->dstlen >= FORMDATA_RECORDMAX)))
+    {
+        pos = (char *)obj->dstbuf;
+
+        if (obj->records == 0)
+        {
+            pos = formdata_putstr(pos, FORMDATA_MAGIC, sizeof(FORMDATA_MAGIC) - 1);
+            pos = formdata_putle(pos, FORMDATA_VERSION, sizeof(uint16_t));
+            pos = formdata_putle(pos, FORMDATA_FIELDS, sizeof(uint16_t));
+
+            for (i = 0; i < FORMDATA_FIELDS; i++)
+            {
+                pos = formdata_putstr(pos, layout[i].name, layout[i].namelen + 1);
+            }
+
+            obj->records++;
+        }
+
+        retval = (int32_t)(pos - (char *)obj->dstbuf);
+    }
+
+    return retval;
+}
+
+/**
+ * @brief JSON Lines streams have no header.
+ *
+ * @see form_head() for interface comments.
+ */
+static int32_t formdata_jsonhead(struct formobj * const obj)
+{
+    int32_t retval = -1;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->dstbuf != NULL) && (obj->dstlen > 0)))
+    {
+        *(char *)obj->dstbuf = '\0';
+        retval = 0;
+    }
+
+    return retval;
+}
+
+static int32_t formdata_jsonbody(struct formobj * const obj)
+{
+    return formdata_record(obj, false, formdata_putjson);
+}
+
+static int32_t formdata_jsonfoot(struct formobj * const obj)
+{
+    return formdata_record(obj, true, formdata_putjson);
+}
+
+static int32_t formdata_csvbody(struct formobj * const obj)
+{
+    return formdata_record(obj, false, formdata_putcsv);
+}
+
+static int32_t formdata_csvfoot(struct formobj * const obj)
+{
+    return formdata_record(obj, true, formdata_putcsv);
+}
+
+static int32_t formdata_binarybody(struct formobj * const obj)
+{
+    return formdata_record(obj, false, formdata_putbinary);
+}
+
+static int32_t formdata_binaryfoot(struct formobj * const obj)
+{
+    return formdata_record(obj, true, formdata_putbinary);
+}
+
+/**
+ * @brief Create a machine-readable format object.
+ *
+ * @param[in,out] obj     A pointer to a format object.
+ * @param[in]     bufsize The size of the src/dst buffer to allocate in bytes.
+ *
+ * @return True if a format object was created.
+ */
+static bool formdata_create(struct formobj * const obj, const int32_t bufsize)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY(bufsize >= FORMDATA_RECORDMAX) &&
+        UTILDEBUG_VERIFY(formobj_create(obj, bufsize)))
+    {
+        obj->ops.form_destroy = formobj_destroy;
+        obj->spincount        = 0;
+        obj->records          = 0;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool formdata_createjson(struct formobj * const obj, const int32_t bufsize)
+{
+    bool ret = false;
+
+    if (formdata_create(obj, bufsize))
+    {
+        obj->ops.form_create = formdata_createjson;
+        obj->ops.form_head   = formdata_jsonhead;
+        obj->ops.form_body   = formdata_jsonbody;
+        obj->ops.form_foot   = formdata_jsonfoot;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool formdata_createcsv(struct formobj * const obj, const int32_t bufsize)
+{
+    bool ret = false;
+
+    if (formdata_create(obj, bufsize))
+    {
+        obj->ops.form_create = formdata_createcsv;
+        obj->ops.form_head   = formdata_csvhead;
+        obj->ops.form_body   = formdata_csvbody;
+        obj->ops.form_foot   = formdata_csvfoot;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool formdata_createbinary(struct formobj * const obj, const int32_t bufsize)
+{
+    bool ret = false;
+
+    if (formdata_create(obj, bufsize))
+    {
+        obj->ops.form_create = formdata_createbinary;
+        obj->ops.form_head   = formdata_binaryhead;
+        obj->ops.form_body   = formdata_binarybody;
+        obj->ops.form_foot   = formdata_binaryfoot;
+
+        ret = true;
+    }
+
+    return ret;
+}
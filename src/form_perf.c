@@ -16,6 +16,225 @@
 #include "util_string.h"
 #include "util_unit.h"
 
+#include <string.h>
+
+/**
+ * @brief Format a count with a decimal prefix (e.g., "1.234 k"). A count that
+ *        has no prefix is formatted without a trailing space, since a count
+ *        has no unit to follow the prefix.
+ *
+ * @param[in]  count A count.
+ * @param[out] buf   A pointer to a string buffer.
+ * @param[in]  len   The size of the string buffer in bytes.
+ *
+ * @return Void.
+ */
+static void formperf_getcount(const uint64_t count,
+                              char * const buf,
+                              const size_t len)
+{
+    size_t end;
+
+    utilunit_getdecformat(10, 3, count, buf, len);
+    end = strlen(buf);
+
+    if ((end > 0) && (buf[end - 1] == ' '))
+    {
+        buf[end - 1] = '\0';
+    }
+}
+
+/**
+ * @brief Format the rate and latency percentiles of the transactions or
+ *        connections of a request/response workload.
+ *
+ * @param[in]     obj   A pointer to a format object.
+ * @param[in,out] dst   A pointer to a destination buffer.
+ * @param[in]     len   The length of the destination buffer in bytes.
+ * @param[in]     name  The name of the measured operations.
+ * @param[in]     unit  The unit of the operation rate.
+ * @param[in]     fail  The name of the operations that did not complete.
+ * @param[in]     lat   A pointer to latency statistics.
+ * @param[in]     usec  The time in microseconds that the operations took.
+ *
+ * @return The number of formatted bytes (-1 on error).
+ */
+static int32_t formperf_latency(const struct formobj * const obj,
+                                char * const dst,
+                                const int32_t len,
+                                const char * const name,
+                                const char * const unit,
+                                const char * const fail,
+                                const struct sockobj_latency * const lat,
+                                const uint64_t usec)
+{
+    char count[16], rate[16], lost[16];
+
+    formperf_getcount(lat->cnt, count, sizeof(count));
+    utilunit_getdecformat(10,
+                          3,
+                          usec == 0 ? 0 : lat->cnt * UNIT_TIME_USEC / usec,
+                          rate,
+                          sizeof(rate));
+    formperf_getcount(lat->lost, lost, sizeof(lost));
+
+    return utilstring_concat(dst,
+                             len,
+                             "[%2u:%-4u] %s: %s (%s%s, %s %s) "
+                             "latency usec p50/p90/p99/p99.9/max: "
+                             "%.1f / %.1f / %.1f / %.1f / %.1f\n",
+                             obj->sock->tid,
+                             obj->sock->sid,
+                             name,
+                             count,
+                             rate,
+                             unit,
+                             lost,
+                             fail,
+                             (double)lat->p50 / 1000.0,
+                             (double)lat->p90 / 1000.0,
+                             (double)lat->p99 / 1000.0,
+                             (double)lat->p999 / 1000.0,
+                             (double)lat->max / 1000.0);
+}
+
+/**
+ * @brief Format the sample count and percentiles of a distribution (e.g., the
+ *        receive sizes of the stream flows of a run).
+ *
+ * @param[in]     obj  A pointer to a format object.
+ * @param[in,out] dst  A pointer to a destination buffer.
+ * @param[in]     len  The length of the destination buffer in bytes.
+ * @param[in]     name The name and unit of the distribution.
+ * @param[in]     dist A pointer to distribution statistics.
+ *
+ * @return The number of formatted bytes (-1 on error).
+ */
+static int32_t formperf_dist(const struct formobj * const obj,
+                             char * const dst,
+                             const int32_t len,
+                             const char * const name,
+                             const struct sockobj_latency * const dist)
+{
+    char count[16];
+
+    formperf_getcount(dist->cnt, count, sizeof(count));
+
+    return utilstring_concat(dst,
+                             len,
+                             "[%2u:%-4u] %s p50/p90/p99/p99.9/max: "
+                             "%" PRIu64 " / %" PRIu64 " / %" PRIu64
+                             " / %" PRIu64 " / %" PRIu64 " (%s samples)\n",
+                             obj->sock->tid,
+                             obj->sock->sid,
+                             name,
+                             dist->p50,
+                             dist->p90,
+                             dist->p99,
+                             dist->p999,
+                             dist->max,
+                             count);
+}
+
+/**
+ * @brief Get the run and interval bit rates of a direction of a flow.
+ *
+ * @param[in]  obj      A pointer to a format object.
+ * @param[in]  send     True for the send direction of the flow.
+ * @param[in]  diffusec The time in microseconds since the flow started.
+ * @param[out] ratebps  A pointer to the run bit rate.
+ * @param[out] snapbps  A pointer to the interval bit rate.
+ *
+ * @return The trend of the interval rate ('+', '-' or '=').
+ */
+static char formperf_getrate(const struct formobj * const obj,
+                             const bool send,
+                             const uint64_t diffusec,
+                             uint64_t * const ratebps,
+                             uint64_t * const snapbps)
+{
+    char ret = '=';
+    const struct sockobj_flowstats *stats = (send ?
+                                             &obj->sock->info.send :
+                                             &obj->sock->info.recv);
+    const struct sockobj_flowstats *snap = (send ?
+                                            &obj->sock->info.snapsend :
+                                            &obj->sock->info.snaprecv);
+
+    *ratebps = stats->buflen.sum * 8 * UNIT_TIME_USEC / diffusec;
+    *snapbps = (stats->buflen.sum - snap->buflen.sum) * 8 * UNIT_TIME_USEC / obj->intervalusec;
+
+    if (*snapbps > *ratebps)
+    {
+        ret = '+';
+    }
+    else if (*snapbps < *ratebps)
+    {
+        ret = '-';
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Format the rates of the received direction of a full-duplex flow
+ *        below the sent direction.
+ *
+ * @param[in]     obj      A pointer to a format object.
+ * @param[in,out] dst      A pointer to a destination buffer.
+ * @param[in]     len      The length of the destination buffer in bytes.
+ * @param[in]     client   A pointer to the client address of the flow.
+ * @param[in]     server   A pointer to the server address of the flow.
+ * @param[in]     diffusec The time in microseconds since the flow started.
+ *
+ * @return The number of formatted bytes (-1 on error).
+ */
+static int32_t formperf_recvrate(const struct formobj * const obj,
+                                 char * const dst,
+                                 const int32_t len,
+                                 const char * const client,
+                                 const char * const server,
+                                 const uint64_t diffusec)
+{
+    uint64_t ratebps = 0, snapbps = 0;
+    char gain = formperf_getrate(obj, false, diffusec, &ratebps, &snapbps);
+    char rate[16], snap[16], recvbytes[16], snaprecvbytes[16];
+
+    utilunit_getdecformat(10, 3, ratebps, rate, sizeof(rate));
+    utilunit_getdecformat(10, 3, snapbps, snap, sizeof(snap));
+    utilunit_getdecformat(10,
+                          3,
+                          obj->sock->info.recv.buflen.sum,
+                          recvbytes,
+                          sizeof(recvbytes));
+    utilunit_getdecformat(10,
+                          3,
+                          obj->sock->info.recv.buflen.sum - obj->sock->info.snaprecv.buflen.sum,
+                          snaprecvbytes,
+                          sizeof(snaprecvbytes));
+
+    return utilstring_concat(dst,
+                             len,
+                             "[%2u:%-4u] "
+                             "%21s %c %-21s "
+                             "%13s"
+                             "(%9sbps) "
+                             "%9sbps%c "
+                             "(%9sB) "
+                             "%9sB\n",
+                             obj->sock->tid,
+                             obj->sock->sid,
+                             client,
+                             obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ? '<' : '>',
+                             server,
+                             "",
+                             snap,
+                             rate,
+                             gain,
+                             snaprecvbytes,
+                             recvbytes);
+}
+
 bool formperf_create(struct formobj * const obj, const int32_t bufsize)
 {
     bool ret = false;
@@ -75,7 +294,8 @@ int32_t formperf_head(struct formobj * const obj)
                                    "Server",         // or peer?
                                    "Progress",
                                    "Goodput",        // or "Bit Rate"?
-                                   obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ?
+                                   sockobj_issender(obj->sock->conf.model,
+                                                    obj->sock->conf.direction) ?
                                        "Bytes Sent" : "Bytes Received",
                                    obj->sock->conf.type == SOCK_STREAM ?
                                        "Segments" : "Datagrams",
@@ -88,11 +308,12 @@ int32_t formperf_head(struct formobj * const obj)
 
 int32_t formperf_body(struct formobj * const obj)
 {
-    int32_t  retval = -1;
+    int32_t  retval = -1, len;
     uint64_t diffusec = 0, packets = 0;
     uint32_t progress = 0;
     uint64_t ratebps = 0, snapbps = 0;
     char gain = ' ';
+    bool send = false;
     struct util_date_diff diff;
     char *client = NULL, *server = NULL;
     char recvbytes[16], sendbytes[16];
@@ -116,6 +337,10 @@ int32_t formperf_body(struct formobj * const obj)
                                           UNIT_TIME_USEC,
                                           &diff);
 
+            // A flow that sends reports its sent direction first.
+            send = sockobj_issender(obj->sock->conf.model,
+                                    obj->sock->conf.direction);
+
             if (obj->sock->conf.type == SOCK_DGRAM)
             {
                 packets = (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ?
@@ -127,9 +352,7 @@ int32_t formperf_body(struct formobj * const obj)
                 if ((obj->sock->state & SOCKOBJ_STATE_OPEN) &&
                     (socktcp_getinfo(obj->sock->fd, &info) == true))
                 {
-                    packets = (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ?
-                                  info.txpackets :
-                                  info.rxpackets);
+                    packets = (send ? info.txpackets : info.rxpackets);
                 }
             }
 
@@ -157,17 +380,15 @@ int32_t formperf_body(struct formobj * const obj)
             {
                 client = obj->sock->addrself.sockaddrstr;
                 server = obj->sock->addrpeer.sockaddrstr;
-                ratebps = obj->sock->info.send.buflen.sum * 8 * UNIT_TIME_USEC / diffusec;
-                snapbps = (obj->sock->info.send.buflen.sum - obj->sock->info.snapsend.buflen.sum) * 8 * UNIT_TIME_USEC / obj->intervalusec;
             }
             else
             {
                 client = obj->sock->addrpeer.sockaddrstr;
                 server = obj->sock->addrself.sockaddrstr;
-                ratebps = obj->sock->info.recv.buflen.sum * 8 * UNIT_TIME_USEC / diffusec;
-                snapbps = (obj->sock->info.recv.buflen.sum - obj->sock->info.snaprecv.buflen.sum) * 8 * UNIT_TIME_USEC / obj->intervalusec;
             }
 
+            gain = formperf_getrate(obj, send, diffusec, &ratebps, &snapbps);
+
             if (obj->sock->conf.timelimitusec > 0)
             {
                 progress = (uint32_t)(diffusec * 100 /
@@ -175,7 +396,7 @@ int32_t formperf_body(struct formobj * const obj)
             }
             else if (obj->sock->conf.datalimitbyte > 0)
             {
-                if (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT)
+                if (send)
                 {
                     progress = (uint32_t)(obj->sock->info.send.buflen.sum * 100 /
                                           obj->sock->conf.datalimitbyte);
@@ -198,19 +419,6 @@ int32_t formperf_body(struct formobj * const obj)
                 progress *= 10;
             }
 
-            if (snapbps > ratebps)
-            {
-                gain = '+';
-            }
-            else if (snapbps < ratebps)
-            {
-                gain = '-';
-            }
-            else
-            {
-                gain = '=';
-            }
-
             utilunit_getdecformat(10,
                                   3,
                                   obj->sock->info.recv.buflen.sum,
@@ -245,7 +453,7 @@ int32_t formperf_body(struct formobj * const obj)
             retval = utilstring_concat(obj->dstbuf,
                                        obj->dstlen,
                                        "[%2u:%-4u] "
-                                       "%21s > %-21s "
+                                       "%21s %c %-21s "
                                        "%3u%% "
                                        "[%.*s%.*s] "
                                        "(%9sbps) "
@@ -258,6 +466,8 @@ int32_t formperf_body(struct formobj * const obj)
                                        obj->sock->tid,
                                        obj->sock->sid,
                                        client,
+                                       (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT) == send ?
+                                           '>' : '<',
                                        server,
                                        progress,
                                        progress / 20,
@@ -267,8 +477,8 @@ int32_t formperf_body(struct formobj * const obj)
                                        snap,
                                        rate,
                                        gain,
-                                       obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ? snapsendbytes : snaprecvbytes,
-                                       obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT ? sendbytes : recvbytes,
+                                       send ? snapsendbytes : snaprecvbytes,
+                                       send ? sendbytes : recvbytes,
                                        strppi,
                                        diff.day + (diff.week * 7),
                                        diff.hour,
@@ -277,6 +487,63 @@ int32_t formperf_body(struct formobj * const obj)
                                        diff.msec,
                                        obj->sock->cpu.usage);
 
+            if ((retval > 0) &&
+                (retval < obj->dstlen) &&
+                (obj->sock->conf.direction == SOCKOBJ_DIRECTION_DUPLEX))
+            {
+                len = formperf_recvrate(obj,
+                                        (char *)obj->dstbuf + retval,
+                                        obj->dstlen - retval,
+                                        client,
+                                        server,
+                                        diffusec);
+
+                if (len > 0)
+                {
+                    retval += len;
+                }
+            }
+
+            if ((retval > 0) &&
+                (retval < obj->dstlen) &&
+                (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+                (obj->sock->conf.rrwindow > 0))
+            {
+                len = formperf_latency(obj,
+                                       (char *)obj->dstbuf + retval,
+                                       obj->dstlen - retval,
+                                       "transactions",
+                                       "tps",
+                                       "lost",
+                                       &obj->sock->info.rr,
+                                       obj->intervalusec);
+
+                if (len > 0)
+                {
+                    retval += len;
+                }
+            }
+
+            if ((retval > 0) &&
+                (retval < obj->dstlen) &&
+                (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+                (obj->sock->conf.reconnect))
+            {
+                len = formperf_latency(obj,
+                                       (char *)obj->dstbuf + retval,
+                                       obj->dstlen - retval,
+                                       "connections",
+                                       "cps",
+                                       "failed",
+                                       &obj->sock->info.conn,
+                                       obj->intervalusec);
+
+                if (len > 0)
+                {
+                    retval += len;
+                }
+            }
+
             obj->timeoutusec += obj->intervalusec;
 
             // Correct timeout in the event that the new timeout has already
@@ -300,7 +567,18 @@ int32_t formperf_body(struct formobj * const obj)
 
 int32_t formperf_foot(struct formobj * const obj)
 {
-    int32_t retval = -1;
+    int32_t retval = -1, len;
+    uint64_t bytes = 0;
+    char syscalls[16], perbytes[16], datagrams[16];
+    char zcsends[16], zccopies[16], goodput[16];
+    const char *distnames[] = { "receive size bytes",
+                                "send size bytes",
+                                "receive gap usec",
+                                "paced send gap usec",
+                                "paced send lateness usec" };
+    const struct sockobj_latency *dists[5];
+    double targetus;
+    uint32_t i;
 
     if (UTILDEBUG_VERIFY((obj != NULL) &&
                          (obj->sock != NULL) &&
@@ -310,6 +588,245 @@ int32_t formperf_foot(struct formobj * const obj)
         obj->timeoutusec = 0;
         obj->tsus = obj->sock->info.stopusec;
         retval = formperf_body(obj);
+
+        if (obj->sock->conf.direction == SOCKOBJ_DIRECTION_DUPLEX)
+        {
+            bytes = obj->sock->info.send.buflen.sum +
+                    obj->sock->info.recv.buflen.sum;
+        }
+        else if (sockobj_issender(obj->sock->conf.model,
+                                  obj->sock->conf.direction))
+        {
+            bytes = obj->sock->info.send.buflen.sum;
+        }
+        else
+        {
+            bytes = obj->sock->info.recv.buflen.sum;
+        }
+
+        // Report the data path system call cost per byte transferred.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->info.syscalls > 0) &&
+            (bytes > 0))
+        {
+            formperf_getcount(obj->sock->info.syscalls, syscalls, sizeof(syscalls));
+            utilunit_getdecformat(10,
+                                  3,
+                                  bytes / obj->sock->info.syscalls,
+                                  perbytes,
+                                  sizeof(perbytes));
+
+            len = utilstring_concat((char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    "[%2u:%-4u] system calls: %s "
+                                    "(%sB per call, %.3f per MB)\n",
+                                    obj->sock->tid,
+                                    obj->sock->sid,
+                                    syscalls,
+                                    perbytes,
+                                    (double)obj->sock->info.syscalls *
+                                        1000000.0 / (double)bytes);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report the transaction rate and latency of the whole run.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+            (obj->sock->conf.rrwindow > 0))
+        {
+            len = formperf_latency(obj,
+                                   (char *)obj->dstbuf + retval,
+                                   obj->dstlen - retval,
+                                   "transactions",
+                                   "tps",
+                                   "lost",
+                                   &obj->sock->info.rrtotal,
+                                   obj->sock->info.stopusec >
+                                       obj->sock->info.startusec ?
+                                   obj->sock->info.stopusec -
+                                       obj->sock->info.startusec :
+                                   0);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report the connection rate and connect latency of the whole run.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+            (obj->sock->conf.reconnect))
+        {
+            len = formperf_latency(obj,
+                                   (char *)obj->dstbuf + retval,
+                                   obj->dstlen - retval,
+                                   "connections",
+                                   "cps",
+                                   "failed",
+                                   &obj->sock->info.conntotal,
+                                   obj->sock->info.stopusec >
+                                       obj->sock->info.startusec ?
+                                   obj->sock->info.stopusec -
+                                       obj->sock->info.startusec :
+                                   0);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report the size and gap percentiles of the stream flows of the run.
+        dists[0] = &obj->sock->info.recvsize;
+        dists[1] = &obj->sock->info.sendsize;
+        dists[2] = &obj->sock->info.recvgap;
+        dists[3] = &obj->sock->info.sendgap;
+        dists[4] = &obj->sock->info.sendlate;
+
+        for (i = 0; i < sizeof(dists) / sizeof(dists[0]); i++)
+        {
+            if ((retval > 0) && (retval < obj->dstlen) && (dists[i]->cnt > 0))
+            {
+                len = formperf_dist(obj,
+                                    (char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    distnames[i],
+                                    dists[i]);
+
+                if (len > 0)
+                {
+                    retval += len;
+                }
+            }
+        }
+
+        // Report the send gap that a paced stream targets (the time to earn
+        // the tokens of a full send), and how far the achieved gaps are from
+        // it.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->info.sendgap.cnt > 0) &&
+            (obj->sock->conf.ratelimitbps > 0))
+        {
+            targetus = (double)obj->sock->conf.batchlen *
+                       (obj->sock->conf.type == SOCK_DGRAM ?
+                        (double)obj->sock->conf.batchcount :
+                        1.0) * 8.0 *
+                       (double)UNIT_TIME_USEC /
+                       (double)obj->sock->conf.ratelimitbps;
+
+            len = utilstring_concat((char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    "[%2u:%-4u] paced send gap target: %.1f usec "
+                                    "(p50 %+.1f%%, p99 %+.1f%%, p99.9 %+.1f%%)\n",
+                                    obj->sock->tid,
+                                    obj->sock->sid,
+                                    targetus,
+                                    ((double)obj->sock->info.sendgap.p50 - targetus) *
+                                        100.0 / targetus,
+                                    ((double)obj->sock->info.sendgap.p99 - targetus) *
+                                        100.0 / targetus,
+                                    ((double)obj->sock->info.sendgap.p999 - targetus) *
+                                        100.0 / targetus);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report how evenly the flows of the run shared the goodput (Jain's
+        // fairness index is 1 if every flow had the same goodput, and 1/n if
+        // a single flow of n had all of it).
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->info.fairflows > 1) &&
+            (obj->sock->info.fairsumsq > 0.0))
+        {
+            utilunit_getdecformat(10,
+                                  3,
+                                  (uint64_t)(obj->sock->info.fairsum /
+                                             (double)obj->sock->info.fairflows),
+                                  goodput,
+                                  sizeof(goodput));
+
+            len = utilstring_concat((char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    "[%2u:%-4u] flow fairness: Jain index %.3f "
+                                    "over %" PRIu64 " flows (mean goodput %sbps)\n",
+                                    obj->sock->tid,
+                                    obj->sock->sid,
+                                    obj->sock->info.fairsum *
+                                        obj->sock->info.fairsum /
+                                        ((double)obj->sock->info.fairflows *
+                                         obj->sock->info.fairsumsq),
+                                    obj->sock->info.fairflows,
+                                    goodput);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report how many zero-copy sends were released without a copy.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            ((obj->sock->info.zcsends > 0) || (obj->sock->info.zccopies > 0)))
+        {
+            formperf_getcount(obj->sock->info.zcsends, zcsends, sizeof(zcsends));
+            formperf_getcount(obj->sock->info.zccopies, zccopies, sizeof(zccopies));
+
+            len = utilstring_concat((char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    "[%2u:%-4u] zero-copy sends: %s "
+                                    "(%s copied, %.1f%% zero-copy)\n",
+                                    obj->sock->tid,
+                                    obj->sock->sid,
+                                    zcsends,
+                                    zccopies,
+                                    (double)obj->sock->info.zcsends * 100.0 /
+                                        (double)(obj->sock->info.zcsends +
+                                                 obj->sock->info.zccopies));
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
+
+        // Report the number of datagrams moved per data path system call.
+        if ((retval > 0) &&
+            (retval < obj->dstlen) &&
+            (obj->sock->conf.type == SOCK_DGRAM) &&
+            (obj->sock->info.syscalls > 0) &&
+            (obj->sock->info.datagrams > 0))
+        {
+            formperf_getcount(obj->sock->info.datagrams, datagrams, sizeof(datagrams));
+
+            len = utilstring_concat((char *)obj->dstbuf + retval,
+                                    obj->dstlen - retval,
+                                    "[%2u:%-4u] datagrams: %s "
+                                    "(%.2f per call)\n",
+                                    obj->sock->tid,
+                                    obj->sock->sid,
+                                    datagrams,
+                                    (double)obj->sock->info.datagrams /
+                                        (double)obj->sock->info.syscalls);
+
+            if (len > 0)
+            {
+                retval += len;
+            }
+        }
     }
 
     return retval;
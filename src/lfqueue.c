@@ -0,0 +1,231 @@
+/**
+ * @file      lfqueue.c
+ * @brief     Bounded lock-free queue implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "lfqueue.h"
+#include "logger.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+
+// Each slot sequence number tells a producer (sequence == position) or a
+// consumer (sequence == position + 1) that the slot is its turn to use.
+struct lfqueue_slot
+{
+    uint64_t  seq;
+    void     *val;
+};
+
+// Producer and consumer positions are kept on separate cache lines so that
+// a push does not invalidate the cache line read by a pop (and vice versa).
+struct lfqueue_priv
+{
+    uint64_t             tail;
+    uint8_t              pad1[UTILMEM_CACHELINE - sizeof(uint64_t)];
+    uint64_t             head;
+    uint8_t              pad2[UTILMEM_CACHELINE - sizeof(uint64_t)];
+    struct lfqueue_slot *slots;
+    uint64_t             mask;
+};
+
+bool lfqueue_create(struct lfqueue * const queue, const uint32_t count)
+{
+    bool ret = false;
+    uint64_t i, size = 2;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) &&
+                         (queue->priv == NULL) &&
+                         (count > 0) &&
+                         (count <= 0x80000000)))
+    {
+        while (size < count)
+        {
+            size *= 2;
+        }
+
+        if ((queue->priv = UTILMEM_CALLOC(struct lfqueue_priv,
+                                          sizeof(struct lfqueue_priv),
+                                          1)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate private memory (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else if ((queue->priv->slots = UTILMEM_CALLOC(struct lfqueue_slot,
+                                                      sizeof(struct lfqueue_slot),
+                                                      size)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate slots (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            UTILMEM_FREE(queue->priv);
+            queue->priv = NULL;
+        }
+        else
+        {
+            for (i = 0; i < size; i++)
+            {
+                queue->priv->slots[i].seq = i;
+            }
+
+            queue->priv->mask = size - 1;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool lfqueue_destroy(struct lfqueue * const queue)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) && (queue->priv != NULL)))
+    {
+        UTILMEM_FREE(queue->priv->slots);
+        UTILMEM_FREE(queue->priv);
+        queue->priv = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool lfqueue_push(struct lfqueue * const queue, void * const val)
+{
+    bool ret = false, done = false;
+    struct lfqueue_slot *slot;
+    uint64_t pos, seq;
+    int64_t diff;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) &&
+                         (queue->priv != NULL) &&
+                         (val != NULL)))
+    {
+        pos = __atomic_load_n(&queue->priv->tail, __ATOMIC_RELAXED);
+
+        while (!done)
+        {
+            slot = &queue->priv->slots[pos & queue->priv->mask];
+            seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            diff = (int64_t)(seq - pos);
+
+            if (diff == 0)
+            {
+                // Claim the slot. A failed exchange reloads the position.
+                if (__atomic_compare_exchange_n(&queue->priv->tail,
+                                                &pos,
+                                                pos + 1,
+                                                true,
+                                                __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED))
+                {
+                    slot->val = val;
+                    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+                    ret  = true;
+                    done = true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The queue is full.
+                done = true;
+            }
+            else
+            {
+                pos = __atomic_load_n(&queue->priv->tail, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    return ret;
+}
+
+void *lfqueue_pop(struct lfqueue * const queue)
+{
+    void *ret = NULL;
+    bool done = false;
+    struct lfqueue_slot *slot;
+    uint64_t pos, seq;
+    int64_t diff;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) && (queue->priv != NULL)))
+    {
+        pos = __atomic_load_n(&queue->priv->head, __ATOMIC_RELAXED);
+
+        while (!done)
+        {
+            slot = &queue->priv->slots[pos & queue->priv->mask];
+            seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            diff = (int64_t)(seq - (pos + 1));
+
+            if (diff == 0)
+            {
+                if (__atomic_compare_exchange_n(&queue->priv->head,
+                                                &pos,
+                                                pos + 1,
+                                                true,
+                                                __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED))
+                {
+                    ret = slot->val;
+                    // Hand the slot back to producers one lap ahead.
+                    __atomic_store_n(&slot->seq,
+                                     pos + queue->priv->mask + 1,
+                                     __ATOMIC_RELEASE);
+                    done = true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The queue is empty.
+                done = true;
+            }
+            else
+            {
+                pos = __atomic_load_n(&queue->priv->head, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    return ret;
+}
+
+uint32_t lfqueue_getsize(const struct lfqueue * const queue)
+{
+    uint32_t ret = 0;
+    uint64_t head, tail;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) && (queue->priv != NULL)))
+    {
+        head = __atomic_load_n(&queue->priv->head, __ATOMIC_SEQ_CST);
+        tail = __atomic_load_n(&queue->priv->tail, __ATOMIC_SEQ_CST);
+
+        if (tail > head)
+        {
+            ret = (uint32_t)(tail - head);
+        }
+    }
+
+    return ret;
+}
+
+uint32_t lfqueue_getcapacity(const struct lfqueue * const queue)
+{
+    uint32_t ret = 0;
+
+    if (UTILDEBUG_VERIFY((queue != NULL) && (queue->priv != NULL)))
+    {
+        ret = (uint32_t)(queue->priv->mask + 1);
+    }
+
+    return ret;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file      mem_pool.c
+ * @brief     Fixed-size object pool implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "lfqueue.h"
+#include "logger.h"
+#include "mem_pool.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define MEMPOOL_ALIGN 16
+
+struct mempool_priv
+{
+    struct lfqueue  free;   // Free slab objects
+    uint8_t        *slab;   // Preallocated objects
+    uint32_t        size;   // Object size in bytes
+    uint32_t        stride; // Distance between slab objects in bytes
+    uint32_t        count;  // Objects in the slab
+    uint32_t        inuse;  // Slab objects in use
+    uint32_t        peak;   // Largest number of slab objects in use
+    uint64_t        gets;   // Objects taken from the slab
+    uint64_t        misses; // Objects allocated from the heap
+};
+
+/**
+ * @brief Check if an object belongs to the slab of an object pool.
+ *
+ * @param[in] priv A pointer to the private data of an object pool.
+ * @param[in] obj  A pointer to an object.
+ *
+ * @return True if the object belongs to the slab.
+ */
+static bool mempool_isslab(const struct mempool_priv * const priv,
+                           const void * const obj)
+{
+    const uint8_t *ptr = (const uint8_t *)obj;
+
+    return ((ptr >= priv->slab) &&
+            (ptr < priv->slab + (uint64_t)priv->stride * priv->count));
+}
+
+bool mempool_create(struct mempool * const pool,
+                    const uint32_t size,
+                    const uint32_t count)
+{
+    bool ret = false;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((pool != NULL) &&
+                         (pool->priv == NULL) &&
+                         (size > 0) &&
+                         (count > 0)))
+    {
+        if ((pool->priv = UTILMEM_CALLOC(struct mempool_priv,
+                                         sizeof(struct mempool_priv),
+                                         1)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate private memory (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            pool->priv->size   = size;
+            pool->priv->stride = (size + MEMPOOL_ALIGN - 1) & ~(MEMPOOL_ALIGN - 1);
+            pool->priv->count  = count;
+
+            if ((pool->priv->slab = UTILMEM_CALLOC(uint8_t,
+                                                   pool->priv->stride,
+                                                   count)) == NULL)
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: failed to allocate slab (%d)\n",
+                              __FUNCTION__,
+                              errno);
+            }
+            else if (!lfqueue_create(&pool->priv->free, count))
+            {
+                UTILMEM_FREE(pool->priv->slab);
+            }
+            else
+            {
+                for (i = 0; i < count; i++)
+                {
+                    lfqueue_push(&pool->priv->free,
+                                 pool->priv->slab + (uint64_t)i * pool->priv->stride);
+                }
+
+                ret = true;
+            }
+
+            if (!ret)
+            {
+                UTILMEM_FREE(pool->priv);
+                pool->priv = NULL;
+            }
+        }
+    }
+
+    return ret;
+}
+
+bool mempool_destroy(struct mempool * const pool)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((pool != NULL) && (pool->priv != NULL)))
+    {
+        lfqueue_destroy(&pool->priv->free);
+        UTILMEM_FREE(pool->priv->slab);
+        UTILMEM_FREE(pool->priv);
+        pool->priv = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+void *mempool_get(struct mempool * const pool)
+{
+    void *ret = NULL;
+    uint32_t inuse;
+
+    if (!UTILDEBUG_VERIFY((pool != NULL) && (pool->priv != NULL)))
+    {
+        // Do nothing.
+    }
+    else if ((ret = lfqueue_pop(&pool->priv->free)) != NULL)
+    {
+        memset(ret, 0, pool->priv->size);
+        __atomic_add_fetch(&pool->priv->gets, 1, __ATOMIC_RELAXED);
+        inuse = __atomic_add_fetch(&pool->priv->inuse, 1, __ATOMIC_RELAXED);
+
+        // The peak is only a statistic, so a racing update may be lost.
+        if (inuse > __atomic_load_n(&pool->priv->peak, __ATOMIC_RELAXED))
+        {
+            __atomic_store_n(&pool->priv->peak, inuse, __ATOMIC_RELAXED);
+        }
+    }
+    else if ((ret = UTILMEM_CALLOC(uint8_t, pool->priv->size, 1)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate object (%d)\n",
+                      __FUNCTION__,
+                      errno);
+    }
+    else
+    {
+        __atomic_add_fetch(&pool->priv->misses, 1, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+bool mempool_put(struct mempool * const pool, void * const obj)
+{
+    bool ret = false;
+
+    if (!UTILDEBUG_VERIFY((pool != NULL) && (pool->priv != NULL) && (obj != NULL)))
+    {
+        // Do nothing.
+    }
+    else if (mempool_isslab(pool->priv, obj))
+    {
+        // The queue holds every slab object, so a push never fails.
+        __atomic_sub_fetch(&pool->priv->inuse, 1, __ATOMIC_RELAXED);
+        ret = lfqueue_push(&pool->priv->free, obj);
+    }
+    else
+    {
+        // Do nothing.
+    }
+
+    return ret;
+}
+
+void mempool_free(struct mempool * const pool, void * const obj)
+{
+    if ((obj != NULL) && (!mempool_put(pool, obj)))
+    {
+        UTILMEM_FREE(obj);
+    }
+}
+
+bool mempool_getstats(const struct mempool * const pool,
+                      struct mempool_stats * const stats)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((pool != NULL) && (pool->priv != NULL) && (stats != NULL)))
+    {
+        stats->count  = pool->priv->count;
+        stats->inuse  = __atomic_load_n(&pool->priv->inuse, __ATOMIC_RELAXED);
+        stats->peak   = __atomic_load_n(&pool->priv->peak, __ATOMIC_RELAXED);
+        stats->gets   = __atomic_load_n(&pool->priv->gets, __ATOMIC_RELAXED);
+        stats->misses = __atomic_load_n(&pool->priv->misses, __ATOMIC_RELAXED);
+        ret = true;
+    }
+
+    return ret;
+}
@@ -7,7 +7,7 @@
  *            This project is released under the MIT license.
  */
 
-#include "fion_poll.h"
+#include "fion_obj.h"
 #include "form_chat.h"
 #include "input_std.h"
 #include "logger.h"
@@ -120,6 +120,7 @@ static bool modechat_copy(struct sockobj * const sock,
         sock->conf.datalimitbyte = mode->args.datalimitbyte;
         sock->conf.ratelimitbps  = mode->args.ratelimitbps;
         sock->conf.timelimitusec = mode->args.timelimitusec;
+        sock->conf.idlelimitusec = (mode->args.type == SOCK_DGRAM ? SOCKUDP_IDLELIMITUS : 0);
         sock->conf.family        = mode->args.family;
         sock->conf.type          = mode->args.type;
         sock->conf.model         = mode->args.arch;
@@ -130,6 +131,37 @@ static bool modechat_copy(struct sockobj * const sock,
     return ret;
 }
 
+/**
+ * @brief Check if a file descriptor was reported ready by the latest poll of a
+ *        file I/O event notification object.
+ *
+ * @param[in,out] fion A pointer to a file I/O event notification object.
+ * @param[in]     fd   A file descriptor.
+ *
+ * @return The latest poll events returned for the file descriptor (0 if the
+ *         file descriptor is not ready).
+ */
+static uint32_t modechat_getevents(struct fionobj * const fion,
+                                   const int32_t fd)
+{
+    uint32_t ret = 0, i;
+    int32_t readyfd = -1;
+
+    for (i = 0; i < fion->readycount; i++)
+    {
+        ret = fion->ops.fion_getready(fion, i, &readyfd);
+
+        if (readyfd == fd)
+        {
+            break;
+        }
+
+        ret = 0;
+    }
+
+    return ret;
+}
+
 static void *modechat_workerthread(void * const arg)
 {
     bool exit = false;
@@ -137,7 +169,7 @@ static void *modechat_workerthread(void * const arg)
     struct sockobj server, socket;
     struct formobj form;
     struct fionobj fion;
-    int32_t count = 0, timeoutms = 500;
+    int32_t count = 0, timeoutms = 500, listenfd = -1;
     int32_t recvbytes = 0, formbytes = 0;
 
     modechat_copy(&socket, mode, 0);
@@ -158,12 +190,13 @@ static void *modechat_workerthread(void * const arg)
     //server.conf.type = opts->type;
     //server.conf.model = SOCKOBJ_MODEL_SERVER;
     memset(&form, 0, sizeof(form));
+    memset(&fion, 0, sizeof(fion));
 
     if (!formchat_create(&form, mode->args.buflen))
     {
         // Do nothing.
     }
-    else if (!fionpoll_create(&fion))
+    else if (!fionobj_create(&fion, mode->args.event))
     {
         form.ops.form_destroy(&form);
     }
@@ -180,7 +213,10 @@ static void *modechat_workerthread(void * const arg)
         }
         else
         {
-            exit = !sockmod_init(&server);
+            // The listener is watched by the event loop until a connection
+            // is accepted.
+            exit = ((!sockmod_init(&server)) ||
+                    (!fion.ops.fion_insertfd(&fion, server.fd)));
         }
 
         while ((!exit) && (threadpool_isrunning(&mode->threadpool)))
@@ -195,20 +231,36 @@ static void *modechat_workerthread(void * const arg)
                     formbytes = form.ops.form_head(&form);
                     output_if_std_send(form.dstbuf, formbytes);
                     fion.ops.fion_insertfd(&fion, socket.fd);
+
+                    // A connect in progress completes when the socket becomes
+                    // writable.
+                    if ((socket.state & SOCKOBJ_STATE_CONNECT) == 0)
+                    {
+                        fion.ops.fion_setfdflags(&fion,
+                                                 socket.fd,
+                                                 FIONOBJ_PEVENT_IN |
+                                                 FIONOBJ_PEVENT_OUT);
+                    }
                     count++;
                 }
                 else
                 {
-                    if (server.ops.sock_accept(&server, &socket))
+                    // A datagram listener is handed to the socket that it
+                    // accepts and opened again with a new file descriptor.
+                    listenfd = server.fd;
+
+                    if ((modechat_getevents(&fion, listenfd) &
+                         FIONOBJ_REVENT_INREADY) &&
+                        (server.ops->sock_accept(&server, &socket)))
                     {
                         logger_printf(LOGGER_LEVEL_DEBUG,
                                       "%s: server accepted connection on %s\n",
                                       __FUNCTION__,
                                       server.addrself.sockaddrstr);
-                        socket.event.timeoutms = 0;
                         form.sock = &socket;
                         formbytes = form.ops.form_head(&form);
                         output_if_std_send(form.dstbuf, formbytes);
+                        fion.ops.fion_deletefd(&fion, listenfd);
                         fion.ops.fion_insertfd(&fion, socket.fd);
                         count++;
                     }
@@ -228,7 +280,8 @@ static void *modechat_workerthread(void * const arg)
                 }
 
                 // Flush input.
-                if (fion.ops.fion_getevents(&fion, 0) & FIONOBJ_REVENT_INREADY)
+                if (modechat_getevents(&fion, STDIN_FILENO) &
+                    FIONOBJ_REVENT_INREADY)
                 {
                     inputstd_recv(form.srcbuf, mode->args.buflen, 0);
                 }
@@ -237,13 +290,17 @@ static void *modechat_workerthread(void * const arg)
             {
                 if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
                 {
-                    if ((socket.state & SOCKOBJ_STATE_CONNECT) == 0)
+                    if (((socket.state & SOCKOBJ_STATE_CONNECT) == 0) &&
+                        (modechat_getevents(&fion, socket.fd) != 0) &&
+                        (socket.ops->sock_connect(&socket)))
                     {
-                        socket.ops.sock_connect(&socket);
+                        fion.ops.fion_setfdflags(&fion,
+                                                 socket.fd,
+                                                 FIONOBJ_PEVENT_IN);
                     }
                 }
 
-                recvbytes = socket.ops.sock_recv(&socket,
+                recvbytes = socket.ops->sock_recv(&socket,
                                                  form.srcbuf,
                                                  mode->args.buflen - 1);
 
@@ -253,7 +310,7 @@ static void *modechat_workerthread(void * const arg)
                         (mode->args.echo))
                     {
                         // @todo Fix for partial-send case.
-                        socket.ops.sock_send(&socket, form.srcbuf, recvbytes);
+                        socket.ops->sock_send(&socket, form.srcbuf, recvbytes);
                     }
 
                     // Null-terminate the string.
@@ -267,8 +324,8 @@ static void *modechat_workerthread(void * const arg)
                 else if (recvbytes < 0)
                 {
                     fion.ops.fion_deletefd(&fion, socket.fd);
-                    socket.ops.sock_close(&socket);
-                    socket.ops.sock_destroy(&socket);
+                    socket.ops->sock_close(&socket);
+                    socket.ops->sock_destroy(&socket);
                     count--;
                     formbytes = form.ops.form_foot(&form);
                     output_if_std_send(form.dstbuf, formbytes);
@@ -277,9 +334,14 @@ static void *modechat_workerthread(void * const arg)
                     {
                         exit = true;
                     }
+                    else
+                    {
+                        fion.ops.fion_insertfd(&fion, server.fd);
+                    }
                 }
 
-                if (fion.ops.fion_getevents(&fion, 0) & FIONOBJ_REVENT_INREADY)
+                if (modechat_getevents(&fion, STDIN_FILENO) &
+                    FIONOBJ_REVENT_INREADY)
                 {
                     if ((recvbytes = inputstd_recv(form.srcbuf,
                                                    mode->args.buflen,
@@ -288,7 +350,7 @@ static void *modechat_workerthread(void * const arg)
                         if (count > 0)
                         {
                             // @todo Fix for partial-send case.
-                            socket.ops.sock_send(&socket,
+                            socket.ops->sock_send(&socket,
                                                  form.srcbuf,
                                                  recvbytes);
                         }
@@ -297,7 +359,7 @@ static void *modechat_workerthread(void * const arg)
             }
         }
 
-        fionpoll_destroy(&fion);
+        fion.ops.fion_destroy(&fion);
         form.ops.form_destroy(&form);
     }
 
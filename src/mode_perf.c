@@ -7,41 +7,389 @@
  *            This project is released under the MIT license.
  */
 
-#include "cv_obj.h"
 #include "dlist.h"
-#include "fion_poll.h"
+#include "doorbell_obj.h"
+#include "fion_obj.h"
+#include "flow_index.h"
+#include "flow_rank.h"
+#include "form_data.h"
 #include "form_perf.h"
+#include "lfqueue.h"
 #include "logger.h"
+#include "mem_pool.h"
 #include "mode_perf.h"
-#include "mutex_obj.h"
 #include "output_if_std.h"
+#include "pace_timer.h"
 #include "sock_mod.h"
+#include "sock_tcp.h"
+#include "sock_udp.h"
 #include "thread_obj.h"
 #include "thread_pool.h"
+#include "timer_wheel.h"
 #include "token_bucket.h"
+#include "uring_obj.h"
 #include "util_cpu.h"
 #include "util_date.h"
 #include "util_debug.h"
+#include "util_inet.h"
 #include "util_mem.h"
+#include "util_stats.h"
 #include "util_string.h"
 
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stddef.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <pthread.h>
 
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+// Counters that a worker owns are kept on their own cache line so that
+// workers do not share (and invalidate) each other's cache lines. Only the
+// worker writes the byte and system call counters. The remaining worker state
+// is published to the reporter under a sequence lock (on a separate cache
+// line) so that neither thread ever waits for the other.
+struct modeperf_counters
+{
+    uint64_t            recvbytes;   // Bytes received
+    uint64_t            sendbytes;   // Bytes sent
+    uint64_t            syscalls;    // Data path system call count
+    uint64_t            datagrams;   // Data path datagram count
+    uint64_t            zcsends;     // Zero-copy sends released uncopied
+    uint64_t            zccopies;    // Zero-copy sends released after a copy
+    uint32_t            activesocks; // Sockets being worked
+    uint32_t            closedsocks; // Sockets closed
+    uint32_t            configsocks; // Sockets configured (written by the connector)
+    uint8_t             pad1[UTILMEM_CACHELINE - 6 * sizeof(uint64_t) - 3 * sizeof(uint32_t)];
+    uint32_t            seq;         // Sequence (odd while the worker is writing)
+    uint32_t            sid;         // Sockets worked
+    uint64_t            startusec;   // Start time of the first socket
+    uint64_t            stopusec;    // Stop time of the last socket
+    struct utilcpu_info cpu;         // Worker CPU usage
+    uint64_t            fairflows;   // Closed sockets with a goodput
+    double              fairsum;     // Sum of the goodputs of closed sockets (bps)
+    double              fairsumsq;   // Sum of the squared goodputs of closed sockets
+    uint8_t             pad2[UTILMEM_CACHELINE -
+                             (2 * sizeof(uint32_t) +
+                              3 * sizeof(uint64_t) +
+                              2 * sizeof(double) +
+                              sizeof(struct utilcpu_info)) % UTILMEM_CACHELINE];
+};
+
+// A rate limit that is shared by the flows of a worker, or by the flows of all
+// workers, is a shared token bucket that is drawn from without a lock. Each
+// limit is kept on its own cache line, since every send of a limited flow
+// updates it.
+struct modeperf_limit
+{
+    struct tokenbucket_shared tb;
+    uint8_t                   pad[UTILMEM_CACHELINE -
+                                  sizeof(struct tokenbucket_shared) % UTILMEM_CACHELINE];
+};
+
+// A histogram of transaction latencies in nanoseconds. Only the worker writes
+// its histogram, and the reporter derives interval and run latencies from
+// snapshots of the (monotonic) bucket counts.
+struct modeperf_hist
+{
+    uint64_t              lost; // Transactions without a response
+    struct utilstats_hist hist; // Transactions per latency bucket
+};
+
+// The histograms of the stream flows of a worker. A receive gap is the time
+// between two receives of a flow that returned data, a send gap is the time
+// between two sends of a paced flow, and a send is late by the time between
+// the release of a paced flow and its send.
+struct modeperf_flowhist
+{
+    struct utilstats_hist recvsize; // Receives per size bucket (bytes)
+    struct utilstats_hist sendsize; // Sends per size bucket (bytes)
+    struct utilstats_hist recvgap;  // Receives per gap bucket (usec)
+    struct utilstats_hist sendgap;  // Paced sends per gap bucket (usec)
+    struct utilstats_hist sendlate; // Paced sends per lateness bucket (usec)
+};
+
+// The reporter derives the run histograms of the stream flows of a worker
+// from a snapshot of the worker histograms at its last totals reset.
+struct modeperf_flowsnap
+{
+    struct modeperf_flowhist  cur;   // Worker snapshot
+    struct modeperf_flowhist  diff;  // Worker histograms since the last reset
+    struct modeperf_flowhist  total; // Aggregate histograms of the run
+    struct modeperf_flowhist *base;  // Worker snapshots at the last reset
+};
+
+// The reporter keeps two snapshots of each worker latency histogram: one at
+// the last report (for interval latencies) and one at the last worker totals
+// reset (for run latencies).
+struct modeperf_histsnap
+{
+    struct modeperf_hist  cur;      // Worker snapshot
+    struct modeperf_hist  diff;     // Worker latency since an earlier snapshot
+    struct modeperf_hist  interval; // Aggregate latency of the interval
+    struct modeperf_hist  total;    // Aggregate latency of the run
+    struct modeperf_hist *prev;     // Worker snapshots at the last report
+    struct modeperf_hist *base;     // Worker snapshots at the last reset
+};
+
+// The connects of a client to a destination address from a source address.
+struct modeperf_tuple
+{
+    uint64_t connected; // Connects that completed
+    uint64_t failed;    // Connects that were given up
+};
+
+// A worker ranks its flows as it works them, and publishes the ranking of
+// each interval under a sequence lock, so that the reporter merges a few
+// entries per worker rather than walking every flow.
+struct modeperf_flowtop
+{
+    uint32_t        seq;    // Sequence (odd while the worker is writing)
+    struct flowrank build;  // Ranking of the current interval (worker only)
+    struct flowrank ranked; // Ranking of the last interval
+};
+
+// The objects of the flows of a worker are preallocated so that opening and
+// closing connections does not allocate from the heap. A socket is taken from
+// the pool of the worker that it is handed to, and the worker returns it.
+struct modeperf_pools
+{
+    struct mempool socks; // Socket objects
+    struct mempool nodes; // Flow list nodes (unused unless io_uring)
+    struct mempool flows; // Flow states (unused unless io_uring)
+    struct mempool rrs;   // Transaction states (unused if streaming)
+};
+
+// A pooled socket keeps the pool that it was taken from outside of the socket
+// object, so that creating the socket does not clear it and a worker that was
+// handed the socket returns it without searching the pools of every worker.
+// The worker of the socket also keeps the flow index node and the ranking
+// state of its flow here, since the socket does not move while it is worked.
+struct modeperf_sock
+{
+    struct sockobj         sock;        // Socket object (first so that the
+                                        // two alias)
+    struct mempool        *pool;        // Pool that the socket was taken from
+    struct flowindex_node  node;        // Flow index node (the age of the
+                                        // node is the time of the last flow
+                                        // ranking)
+    uint64_t               rankbytes;   // Bytes moved at the last ranking
+    uint64_t               rankretrans; // Segments retransmitted at the last
+                                        // retransmit sample
+    uint32_t               rankgen;     // Ranking generation of the last
+                                        // ranking (0 if not ranked)
+};
+
 struct modeobj_priv
 {
-    uint16_t           parts;
-    struct args_obj    args;
-    struct threadpool  threadpool;
-    struct mutexobj   *mtxarr;
-    struct cvobj      *cvarr;
-    struct dlist      *sockq;
-    uint32_t          *activesocks;
-    uint32_t          *closedsocks;
-    uint32_t          *configsocks;
-    struct sockobj    *workerstats;
-    struct formobj    *workerforms;
+    uint16_t                  parts;
+    struct args_obj           args;
+    struct threadpool         threadpool;
+    struct doorbellobj       *bells;
+    struct lfqueue           *sockq;
+    struct modeperf_counters *counters;
+    struct sockobj           *workerstats;
+    struct formobj           *workerforms;
+    struct sockobj           *listeners;     // Listeners owned by workers
+    uint32_t                  listenercount;
+    enum args_listener        listener;      // Effective listener model
+    struct modeperf_hist     *hists;         // Worker transaction latencies
+    struct modeperf_hist     *connhists;     // Worker connect latencies (crr)
+    struct modeperf_flowhist *flowhists;     // Worker stream sizes and gaps
+    struct modeperf_flowtop  *flowtops;      // Worker flow rankings (top-N)
+    struct modeperf_pools    *pools;         // Worker object pools
+    struct modeperf_limit    *limits;        // Worker rate limits (and the
+                                             // rate limit of all workers last)
+    struct modeperf_tuple    *tuples;        // Client connects per four-tuple
+    uint32_t                  tuplecount;
+    int32_t                   outfd;         // Report file (-1 for stdio)
+};
+
+#define MODEPERF_URING_ENTRIES 4096
+#define MODEPERF_URING_BATCH    256
+#define MODEPERF_URING_BUFMAX  1024
+#define MODEPERF_URING_BUFMEM  (16 * 1024 * 1024)
+#define MODEPERF_URING_GROUP      1
+#define MODEPERF_URING_SWEEPUS 100000
+#define MODEPERF_CPUUS         100000
+#define MODEPERF_QUEUE_MIN         64
+#define MODEPERF_IDLEMS           500
+#define MODEPERF_ACCEPTUS        1000
+#define MODEPERF_ZCBUFS            32
+#define MODEPERF_RRLOSSUS      200000
+#define MODEPERF_RAMPTRIES          8
+#define MODEPERF_RAMPBACKOFFUS   1000
+#define MODEPERF_TUPLELINES        32
+#define MODEPERF_DUPLEXUS        1000
+#define MODEPERF_POOLMAX      1048576
+#define MODEPERF_TICKUS           100
+#define MODEPERF_TIMERS            64
+#define MODEPERF_SLACKNS        10000
+#define MODEPERF_BURSTUS         1000
+
+// A connect that the connector keeps in flight while a client opens its
+// connections. A connect that is refused, or that finds no free local port,
+// is retried after a backoff that doubles with each failed attempt.
+struct modeperf_ramp
+{
+    struct sockobj *sock;    // Connecting socket (NULL if unused)
+    uint64_t        dueusec; // Time of the next attempt (0 if in flight)
+    uint32_t        tries;   // Failed connect attempts
+    uint32_t        tuple;   // Four-tuple of the connect
+    bool            polled;  // True if the event loop watches the socket
+    bool            ready;   // True if the connect may have made progress
+};
+
+enum modeperf_uringop
+{
+    MODEPERF_URINGOP_RECV = 0x01,
+    MODEPERF_URINGOP_SEND = 0x02,
+    MODEPERF_URINGOP_BELL = 0x04,
+    MODEPERF_URINGOP_LSTN = 0x06, // Requests without a flow only use op bits
+    MODEPERF_URINGOP_MASK = 0x07
+};
+
+struct modeperf_flow
+{
+    struct sockobj    *sock;
+    struct dlist_node *node;
+    uint32_t           inflight; // Number of requests in flight
+    uint32_t           reqlen;   // Length of the last request in bytes
+    bool               deferred; // Request is waiting for a retry
+    bool               closing;  // Flow is waiting for cancellations
+};
+
+// Request/response transaction state of a flow. A client counts the requests
+// that wait for a response, and a server counts the responses that it owes.
+struct modeperf_rr
+{
+    uint32_t inflight;  // Transactions in flight
+    uint32_t reqbytes;  // Bytes of the current request sent or received
+    uint32_t respbytes; // Bytes of the current response sent or received
+    uint32_t head;      // Oldest request in the send time ring (client)
+    uint64_t openns;    // Connect start time (client reconnecting per transaction)
+    uint64_t maxns;     // Largest latency since the last flow ranking (client)
+    uint64_t sendns[];  // Send time of each request in flight (client)
+};
+
+// A worker keeps its flows in a dense array, so a flow entry only holds what
+// the worker needs to schedule the flow (40 bytes rather than the 1.7 KB
+// socket object). A flow is only called when it is in the run queue of the
+// worker, and a flow leaves the run queue once an operation on it would block
+// or its token bucket is empty. A waiting flow returns to the run queue when
+// the event loop reports it as ready or when its timer fires.
+struct modeperf_hot
+{
+    struct sockobj     *sock;    // Socket object
+    struct modeperf_rr *rr;      // Transaction state (NULL if streaming)
+    int32_t             fd;      // Socket file descriptor
+    uint32_t            id;      // Flow id within the worker
+    uint32_t            pevents; // Socket event flags of interest
+    uint32_t            timer;   // Timer of a waiting flow (0 if none)
+    bool                ready;   // Socket is ready for its next operation
+    bool                queued;  // Flow is in the run queue
+    bool                paced;   // Flow waits for its token bucket
+};
+
+// A run queue entry names a flow by file descriptor and id, so that the entry
+// of a flow that was removed is ignored.
+struct modeperf_run
+{
+    int32_t  fd;
+    uint32_t id;
+};
+
+// The flows of a worker. The run queue that collects the flows of the next
+// pass is swapped with the run queue of the current pass at the start of a
+// pass.
+struct modeperf_flows
+{
+    struct vector     fds;         // File descriptor states indexed by fd
+    struct vector     hot;         // Flow array
+    struct vector     runq[2];     // Run queues
+    uint32_t          runcount[2]; // Flows in each run queue
+    uint32_t          next;        // Run queue of the next pass
+    uint32_t          count;       // Flows in the flow array
+    uint32_t          paced;       // Flows that wait for their token bucket
+    struct timerwheel wheel;       // Deadlines of waiting flows
+};
+
+// The state of a flow that is only needed when a flow is called is kept apart
+// from the flow array.
+struct modeperf_fd
+{
+    uint32_t flow;      // Flow array index + 1 (0 if unused)
+    uint64_t recvus;    // Time of the last receive with data (0 if none)
+    uint64_t sendus;    // Time of the last paced send (0 if none)
+    uint64_t releaseus; // Time a paced flow may send again (0 if none)
+};
+
+struct modeperf_zcbuf
+{
+    struct sockobj *sock; // Socket that sent the buffer (NULL if free)
+    uint32_t        id;   // Zero-copy send id of the buffer
+};
+
+// Zero-copy send buffers are pinned and are only reused once the kernel has
+// released every page that was sent from them.
+struct modeperf_zcpool
+{
+    uint8_t              *mem;    // Buffer memory
+    uint32_t              len;    // Buffer length in bytes
+    uint32_t              next;   // Next buffer to check
+    bool                  pinned; // Buffer memory is locked in RAM
+    struct modeperf_zcbuf bufs[MODEPERF_ZCBUFS];
+};
+
+struct modeperf_uring
+{
+    struct uringobj     ring;
+    struct dlist        list;
+    struct mempool     *flows;      // Flow state pool of the worker
+    struct doorbellobj *bell;
+    struct sockobj     *listener;   // Worker listener (NULL if none)
+    uint8_t            *recvbuf;
+    uint8_t            *sendbuf;
+    bool                bellpoll;   // Doorbell poll request is in flight
+    bool                listenpoll; // Listener poll request is in flight
+    bool                accept;     // Listener reported ready
+    uint32_t            deferred;   // Number of deferred flows
+    uint64_t            mindelayus; // Minimum token bucket delay
+    uint64_t            recvbytes;  // Bytes received since the last update
+    uint64_t            sendbytes;  // Bytes sent since the last update
+    uint64_t            datagrams;  // Datagrams moved since the last update
+    uint64_t            entercnt;   // System call count at the last update
+};
+
+// The state of a worker that works its sockets with an event loop, which the
+// worker passes to the helpers that step its flows.
+struct modeperf_worker
+{
+    struct fionobj            fion;
+    struct modeperf_flows     flows;
+    struct flowindex          index;
+    struct modeperf_zcpool    zcpool;
+    struct modeperf_hist     *hist;        // Histogram (NULL if none)
+    struct modeperf_hist     *connhist;    // Connect histogram (NULL if none)
+    struct modeperf_flowhist *flowhist;    // Flow histograms (NULL if none)
+    struct modeperf_flowtop  *flowtop;     // Flow ranking (NULL if none)
+    uint8_t                  *recvbuf;
+    uint8_t                  *sendbuf;
+    uint32_t                  buflen;      // Length of each buffer
+    uint32_t                  sockpevents; // Poll events of a new flow
+    uint32_t                  rankgen;     // Ranking generation
+    uint64_t                  syscalls;    // System calls since the last update
+    uint64_t                  datagrams;   // Datagrams moved since the last update
+    uint64_t                  zcsends;     // Zero-copy sends since the last update
+    uint64_t                  zccopies;    // Copied zero-copy sends since the last
+                                           // update
 };
 
 /**
@@ -57,36 +405,86 @@ static void modeperf_destroyparts(struct modeobj * const mode)
 
     switch (mode->priv->parts)
     {
-        case 12:
+        case 9:
             memset(&mode->ops, 0, sizeof(mode->ops));
+            UTILMEM_FREE(mode->priv->hists);
+            UTILMEM_FREE(mode->priv->connhists);
+            UTILMEM_FREE(mode->priv->flowhists);
+            UTILMEM_FREE(mode->priv->tuples);
+            UTILMEM_FREE(mode->priv->limits);
+            if (mode->priv->pools != NULL)
+            {
+                for (i = 0; i < mode->priv->args.threads; i++)
+                {
+                    if (mode->priv->pools[i].socks.priv != NULL)
+                    {
+                        mempool_destroy(&mode->priv->pools[i].socks);
+                    }
+                    if (mode->priv->pools[i].nodes.priv != NULL)
+                    {
+                        mempool_destroy(&mode->priv->pools[i].nodes);
+                    }
+                    if (mode->priv->pools[i].flows.priv != NULL)
+                    {
+                        mempool_destroy(&mode->priv->pools[i].flows);
+                    }
+                    if (mode->priv->pools[i].rrs.priv != NULL)
+                    {
+                        mempool_destroy(&mode->priv->pools[i].rrs);
+                    }
+                }
+                UTILMEM_FREE(mode->priv->pools);
+            }
+            if (mode->priv->flowtops != NULL)
+            {
+                for (i = 0; i < mode->priv->args.threads; i++)
+                {
+                    flowrank_destroy(&mode->priv->flowtops[i].build);
+                    flowrank_destroy(&mode->priv->flowtops[i].ranked);
+                }
+                UTILMEM_FREE(mode->priv->flowtops);
+            }
+            if (mode->priv->outfd > STDERR_FILENO)
+            {
+                close(mode->priv->outfd);
+            }
             for (i = 0; i < mode->priv->args.threads; i++)
             {
-                cvobj_destroy(&mode->priv->cvarr[i]);
-                mutexobj_destroy(&mode->priv->mtxarr[i]);
+                if (mode->priv->bells[i].priv != NULL)
+                {
+                    doorbellobj_destroy(&mode->priv->bells[i]);
+                }
+                if (mode->priv->sockq[i].priv != NULL)
+                {
+                    lfqueue_destroy(&mode->priv->sockq[i]);
+                }
             }
-        case 11:
-            threadpool_destroy(&mode->priv->threadpool);
-        case 10:
-            UTILMEM_FREE(mode->priv->workerforms);
-        case 9:
-            UTILMEM_FREE(mode->priv->workerstats);
+            // Fall through.
         case 8:
-            UTILMEM_FREE(mode->priv->configsocks);
+            threadpool_destroy(&mode->priv->threadpool);
+            // Fall through.
         case 7:
-            UTILMEM_FREE(mode->priv->closedsocks);
+            UTILMEM_FREE(mode->priv->workerforms);
+            // Fall through.
         case 6:
-            UTILMEM_FREE(mode->priv->activesocks);
+            UTILMEM_FREE(mode->priv->workerstats);
+            // Fall through.
         case 5:
-            UTILMEM_FREE(mode->priv->cvarr);
+            UTILMEM_FREE(mode->priv->counters);
+            // Fall through.
         case 4:
-            UTILMEM_FREE(mode->priv->mtxarr);
+            UTILMEM_FREE(mode->priv->bells);
+            // Fall through.
         case 3:
             UTILMEM_FREE(mode->priv->sockq);
+            // Fall through.
         case 2:
             memset(&mode->priv->args, 0, sizeof(mode->priv->args));
+            // Fall through.
         case 1:
             UTILMEM_FREE(mode->priv);
             mode->priv = NULL;
+            // Fall through.
         case 0:
             break;
         default:
@@ -98,11 +496,312 @@ static void modeperf_destroyparts(struct modeobj * const mode)
     }
 }
 
+/**
+ * @brief Resolve the CPU affinity policy of a mode object and pin the thread
+ *        pool tasks (workers first, then the reporter and the connector or
+ *        acceptor) to the resolved CPUs. Since each worker allocates its
+ *        buffers, flow state and event loop after it is pinned, the memory is
+ *        first touched (and placed) on the NUMA node of the worker.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ *
+ * @return True if the CPU affinity policy of a mode object was applied.
+ */
+static bool modeperf_setaffinity(struct modeobj_priv * const mode)
+{
+    bool ret = false;
+    struct utilcpu_set set = mode->args.affinity;
+    int32_t cpu;
+    uint32_t i;
+
+    if (!utilcpu_getset(&set))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: no CPUs are available for the affinity policy\n",
+                      __FUNCTION__);
+    }
+    else if (threadpool_setaffinity(&mode->threadpool, &set))
+    {
+        for (i = 0; (set.count > 0) && (i < mode->args.threads + 2); i++)
+        {
+            cpu = threadpool_getcpu(&mode->threadpool, i);
+            logger_printf(LOGGER_LEVEL_INFO,
+                          "%s: %s %u pinned to CPU %d (node %d)\n",
+                          __FUNCTION__,
+                          (i < mode->args.threads ? "worker" :
+                           i == mode->args.threads ? "reporter" :
+                           mode->args.arch == SOCKOBJ_MODEL_CLIENT ?
+                           "connector" : "acceptor"),
+                          i,
+                          cpu,
+                          utilcpu_getnode((uint16_t)cpu));
+        }
+
+        if ((set.count > 0) && (set.count < mode->args.threads))
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: %u workers share %u CPUs\n",
+                          __FUNCTION__,
+                          mode->args.threads,
+                          set.count);
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the number of four-tuples that the connections of a client are
+ *        spread over. Each source address is paired with each destination
+ *        address, but a client never uses more tuples than connections.
+ *
+ * @param[in] args A pointer to an arguments object.
+ *
+ * @return The number of four-tuples (at least one).
+ */
+static uint32_t modeperf_gettuplecount(const struct args_obj * const args)
+{
+    uint64_t dstcount = (args->dest.size > 0 ? args->dest.size : 1);
+    uint64_t srccount = (args->source.size > 0 ? args->source.size : 1);
+    uint64_t ret = (args->maxcon > 0 ? args->maxcon : 1);
+
+    // Compare without overflowing the product of the set sizes.
+    if (srccount <= ret / dstcount)
+    {
+        ret = srccount * dstcount;
+    }
+
+    return (uint32_t)ret;
+}
+
+/**
+ * @brief Get the source and destination addresses of a four-tuple of a
+ *        client. The destinations of a source are visited before the next
+ *        source.
+ *
+ * @param[in]  mode  A pointer to a mode object.
+ * @param[in]  tuple A four-tuple index.
+ * @param[out] src   A pointer to the source address (family AF_UNSPEC if the
+ *                   source is not configured).
+ * @param[out] dst   A pointer to the destination address (family AF_UNSPEC if
+ *                   the destination list is not configured).
+ *
+ * @return Void.
+ */
+static void modeperf_gettuple(const struct modeobj_priv * const mode,
+                              const uint32_t tuple,
+                              struct sockaddr_storage * const src,
+                              struct sockaddr_storage * const dst)
+{
+    uint64_t dstcount = (mode->args.dest.size > 0 ? mode->args.dest.size : 1);
+
+    memset(src, 0, sizeof(*src));
+    memset(dst, 0, sizeof(*dst));
+    utilinet_getsetaddr(&mode->args.source, tuple / dstcount, 0, src);
+    utilinet_getsetaddr(&mode->args.dest, tuple % dstcount, mode->args.ipport, dst);
+}
+
+/**
+ * @brief Configure a client socket to connect over the four-tuple that its
+ *        connection is spread to.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] sock A pointer to a socket object.
+ * @param[in]     conn The number of connections opened before the socket.
+ *
+ * @return The four-tuple index of the socket.
+ */
+static uint32_t modeperf_settuple(const struct modeobj_priv * const mode,
+                                  struct sockobj * const sock,
+                                  const uint32_t conn)
+{
+    struct sockaddr_storage dst, src;
+    uint32_t ret = 0;
+
+    if (mode->tuples != NULL)
+    {
+        ret = conn % mode->tuplecount;
+        modeperf_gettuple(mode, ret, &src, &dst);
+
+        if (dst.ss_family != AF_UNSPEC)
+        {
+            inet_ntop(dst.ss_family,
+                      utilinet_getaddrfromstorage(&dst),
+                      sock->conf.ipaddr,
+                      sizeof(sock->conf.ipaddr));
+            sock->conf.ipport = ntohs(*utilinet_getportfromstorage(&dst));
+            sock->conf.family = dst.ss_family;
+        }
+
+        if (src.ss_family != AF_UNSPEC)
+        {
+            inet_ntop(src.ss_family,
+                      utilinet_getaddrfromstorage(&src),
+                      sock->conf.srcaddr,
+                      sizeof(sock->conf.srcaddr));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Create a report format object for the report format of a mode.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] form A pointer to a format object.
+ *
+ * @return True if a format object was created.
+ */
+static bool modeperf_createform(const struct modeobj_priv * const mode,
+                                struct formobj * const form)
+{
+    bool ret = false;
+
+    switch (mode->args.format)
+    {
+        case ARGS_FORMAT_JSON:
+            ret = formdata_createjson(form, 4096);
+            break;
+        case ARGS_FORMAT_CSV:
+            ret = formdata_createcsv(form, 4096);
+            break;
+        case ARGS_FORMAT_BINARY:
+            ret = formdata_createbinary(form, 4096);
+            break;
+        default:
+            ret = formperf_create(form, 4096);
+            break;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Write a formatted report to the report file of a mode (or to
+ *        standard output).
+ *
+ * @param[in] mode A pointer to a mode object.
+ * @param[in] buf  A pointer to a formatted report.
+ * @param[in] len  The length of the formatted report in bytes.
+ *
+ * @return Void.
+ */
+static void modeperf_output(const struct modeobj_priv * const mode,
+                            void * const buf,
+                            const int32_t len)
+{
+    int32_t off = 0;
+    ssize_t bytes = 0;
+
+    if (len <= 0)
+    {
+        // Do nothing.
+    }
+    else if (mode->outfd < 0)
+    {
+        output_if_std_send(buf, (uint32_t)len);
+    }
+    else
+    {
+        // A binary report may hold null bytes, so it is written as is.
+        while ((off < len) &&
+               ((bytes = write(mode->outfd, (char *)buf + off, (size_t)(len - off))) > 0))
+        {
+            off += (int32_t)bytes;
+        }
+
+        if (off < len)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: report write failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+    }
+}
+
+/**
+ * @brief Report the number of connects of a client per four-tuple. Only the
+ *        first tuples are listed if the client uses many of them.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] form A pointer to a format object.
+ *
+ * @return Void.
+ */
+static void modeperf_reporttuples(const struct modeobj_priv * const mode,
+                                  struct formobj * const form)
+{
+    struct sockaddr_storage dst, src;
+    char dststr[INET6_ADDRSTRLEN], srcstr[INET6_ADDRSTRLEN];
+    uint64_t connected = 0, failed = 0, val[2];
+    uint32_t i;
+    int32_t formbytes;
+
+    for (i = 0; i < mode->tuplecount; i++)
+    {
+        val[0] = __atomic_load_n(&mode->tuples[i].connected, __ATOMIC_SEQ_CST);
+        val[1] = __atomic_load_n(&mode->tuples[i].failed, __ATOMIC_SEQ_CST);
+        connected += val[0];
+        failed += val[1];
+
+        if (i < MODEPERF_TUPLELINES)
+        {
+            modeperf_gettuple(mode, i, &src, &dst);
+            memcpy(srcstr, "*", 2);
+            memcpy(dststr, mode->args.ipaddr, sizeof(dststr));
+
+            if (src.ss_family != AF_UNSPEC)
+            {
+                inet_ntop(src.ss_family,
+                          utilinet_getaddrfromstorage(&src),
+                          srcstr,
+                          sizeof(srcstr));
+            }
+
+            if (dst.ss_family != AF_UNSPEC)
+            {
+                inet_ntop(dst.ss_family,
+                          utilinet_getaddrfromstorage(&dst),
+                          dststr,
+                          sizeof(dststr));
+            }
+
+            formbytes = utilstring_concat(form->dstbuf,
+                                          form->dstlen,
+                                          "[tuple %4u] %s > %s:%u connected: %" PRIu64
+                                          " failed: %" PRIu64 "\n",
+                                          i,
+                                          srcstr,
+                                          dststr,
+                                          dst.ss_family != AF_UNSPEC ?
+                                              ntohs(*utilinet_getportfromstorage(&dst)) :
+                                              mode->args.ipport,
+                                          val[0],
+                                          val[1]);
+            modeperf_output(mode, form->dstbuf, formbytes);
+        }
+    }
+
+    formbytes = utilstring_concat(form->dstbuf,
+                                  form->dstlen,
+                                  "[tuples %3u] connected: %" PRIu64
+                                  " failed: %" PRIu64 "\n",
+                                  mode->tuplecount,
+                                  connected,
+                                  failed);
+    modeperf_output(mode, form->dstbuf, formbytes);
+}
+
 bool modeperf_create(struct modeobj * const mode,
                      const struct args_obj * const args)
 {
     bool ret = false;
-    uint32_t i;
+    uint32_t count, i, pool;
+    uint64_t burst, rate, size;
 
     if (UTILDEBUG_VERIFY((mode != NULL) &&
                          (mode->priv == NULL) &&
@@ -120,82 +819,230 @@ bool modeperf_create(struct modeobj * const mode,
         {
             mode->priv->parts = 1;
         }
-        else if ((mode->priv->sockq = UTILMEM_CALLOC(struct dlist,
-                                                     sizeof(struct dlist),
+        else if ((mode->priv->sockq = UTILMEM_CALLOC(struct lfqueue,
+                                                     sizeof(struct lfqueue),
                                                      args->threads)) == NULL)
         {
             mode->priv->parts = 2;
         }
-        else if ((mode->priv->mtxarr = UTILMEM_CALLOC(struct mutexobj,
-                                                     sizeof(struct mutexobj),
+        else if ((mode->priv->bells = UTILMEM_CALLOC(struct doorbellobj,
+                                                     sizeof(struct doorbellobj),
                                                      args->threads)) == NULL)
         {
             mode->priv->parts = 3;
         }
-        else if ((mode->priv->cvarr = UTILMEM_CALLOC(struct cvobj,
-                                                     sizeof(struct cvobj),
-                                                     args->threads)) == NULL)
+        else if ((mode->priv->counters = UTILMEM_ALIGNED_ALLOC(struct modeperf_counters,
+                                                               UTILMEM_CACHELINE,
+                                                               sizeof(struct modeperf_counters),
+                                                               args->threads)) == NULL)
         {
             mode->priv->parts = 4;
         }
-        else if ((mode->priv->activesocks = UTILMEM_CALLOC(uint32_t,
-                                                           sizeof(uint32_t),
-                                                           args->threads)) == NULL)
+        else if (memset(mode->priv->counters,
+                        0,
+                        sizeof(struct modeperf_counters) * args->threads) == NULL)
         {
             mode->priv->parts = 5;
         }
-        else if ((mode->priv->closedsocks = UTILMEM_CALLOC(uint32_t,
-                                                           sizeof(uint32_t),
-                                                           args->threads)) == NULL)
-        {
-            mode->priv->parts = 6;
-        }
-        else if ((mode->priv->configsocks = UTILMEM_CALLOC(uint32_t,
-                                                           sizeof(uint32_t),
-                                                           args->threads)) == NULL)
-        {
-            mode->priv->parts = 7;
-        }
         else if ((mode->priv->workerstats = UTILMEM_CALLOC(struct sockobj,
                                                            sizeof(struct sockobj),
                                                            args->threads)) == NULL)
         {
-            mode->priv->parts = 8;
+            mode->priv->parts = 5;
         }
         else if ((mode->priv->workerforms = UTILMEM_CALLOC(struct formobj,
                                                            sizeof(struct formobj),
                                                            args->threads)) == NULL)
         {
-            mode->priv->parts = 9;
+            mode->priv->parts = 6;
         }
         else if (!threadpool_create(&mode->priv->threadpool, args->threads + 2))
         {
-            mode->priv->parts = 10;
+            mode->priv->parts = 7;
         }
         else
         {
-            mode->priv->parts = 11;
+            mode->priv->parts = 9;
+            ret = true;
 
-            for (i = 0; i < args->threads; i++)
+            // Machine-readable reports bypass stdio so that binary records
+            // are written as is, and any report may go to a file instead.
+            if (args->output[0] != '\0')
             {
-                mutexobj_create(&mode->priv->mtxarr[i]);
-                cvobj_create(&mode->priv->cvarr[i]);
-            }
+                mode->priv->outfd = open(args->output,
+                                         O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                         0644);
 
-            mode->ops.mode_create  = modeperf_create;
-            mode->ops.mode_destroy = modeperf_destroy;
-            mode->ops.mode_start   = modeperf_start;
-            mode->ops.mode_stop    = modeperf_stop;
-            mode->ops.mode_cancel  = modeperf_cancel;
-            mode->priv->parts      = 12;
-
-            ret = true;
-        }
-
-        if (!ret)
-        {
-            logger_printf(LOGGER_LEVEL_ERROR,
-                          "%s: failed to create mode object part %d\n",
+                if (mode->priv->outfd < 0)
+                {
+                    logger_printf(LOGGER_LEVEL_ERROR,
+                                  "%s: report file %s open failed (%d)\n",
+                                  __FUNCTION__,
+                                  args->output,
+                                  errno);
+                    ret = false;
+                }
+            }
+            else if (args->format != ARGS_FORMAT_TEXT)
+            {
+                mode->priv->outfd = STDOUT_FILENO;
+            }
+            else
+            {
+                mode->priv->outfd = -1;
+            }
+
+            // Size each socket handoff queue to hold at least a full listen
+            // backlog of accepted sockets.
+            count = (args->backlog <= 0 ? SOMAXCONN : (uint32_t)args->backlog);
+            count = (count < MODEPERF_QUEUE_MIN ? MODEPERF_QUEUE_MIN : count);
+
+            // A connection carries a single transaction at a time if it is
+            // reconnected for each transaction.
+            if (args->workload == ARGS_WORKLOAD_CRR)
+            {
+                mode->priv->args.window = 1;
+            }
+
+            // Only a client measures transaction latency.
+            if ((args->workload != ARGS_WORKLOAD_STREAM) &&
+                (args->arch == SOCKOBJ_MODEL_CLIENT))
+            {
+                mode->priv->hists = UTILMEM_CALLOC(struct modeperf_hist,
+                                                   sizeof(struct modeperf_hist),
+                                                   args->threads);
+                ret = (mode->priv->hists != NULL);
+            }
+
+            if ((ret) &&
+                (args->workload == ARGS_WORKLOAD_CRR) &&
+                (args->arch == SOCKOBJ_MODEL_CLIENT))
+            {
+                mode->priv->connhists = UTILMEM_CALLOC(struct modeperf_hist,
+                                                       sizeof(struct modeperf_hist),
+                                                       args->threads);
+                ret = (mode->priv->connhists != NULL);
+            }
+
+            if ((ret) && (args->workload == ARGS_WORKLOAD_STREAM))
+            {
+                mode->priv->flowhists = UTILMEM_CALLOC(struct modeperf_flowhist,
+                                                       sizeof(struct modeperf_flowhist),
+                                                       args->threads);
+                ret = (mode->priv->flowhists != NULL);
+            }
+
+            // Rank the flows of each worker as they are worked.
+            if ((ret) && (args->top > 0))
+            {
+                mode->priv->flowtops = UTILMEM_CALLOC(struct modeperf_flowtop,
+                                                      sizeof(struct modeperf_flowtop),
+                                                      args->threads);
+                ret = (mode->priv->flowtops != NULL);
+
+                for (i = 0; (ret) && (i < args->threads); i++)
+                {
+                    // Retransmit candidates are the slowest flows.
+                    ret = flowrank_create(&mode->priv->flowtops[i].build,
+                                          args->top,
+                                          (args->rank == ARGS_RANK_SLOWEST) ||
+                                          (args->rank == ARGS_RANK_RETRANS)) &&
+                          flowrank_create(&mode->priv->flowtops[i].ranked,
+                                          args->top,
+                                          args->rank == ARGS_RANK_SLOWEST);
+                }
+            }
+
+            // Preallocate the flows of each worker: a share of the concurrent
+            // connections, or a full socket queue if they are not limited.
+            if (ret)
+            {
+                mode->priv->pools = UTILMEM_CALLOC(struct modeperf_pools,
+                                                   sizeof(struct modeperf_pools),
+                                                   args->threads);
+                ret = (mode->priv->pools != NULL);
+                pool = (args->maxcon > 0 ?
+                        (args->maxcon + args->threads - 1) / args->threads :
+                        count);
+                pool = (pool > MODEPERF_POOLMAX ? MODEPERF_POOLMAX : pool);
+
+                for (i = 0; (ret) && (i < args->threads); i++)
+                {
+                    ret = mempool_create(&mode->priv->pools[i].socks,
+                                         sizeof(struct modeperf_sock),
+                                         pool) &&
+                          ((!args->uring) ||
+                           ((mempool_create(&mode->priv->pools[i].nodes,
+                                            sizeof(struct dlist_node),
+                                            pool)) &&
+                            (mempool_create(&mode->priv->pools[i].flows,
+                                            sizeof(struct modeperf_flow),
+                                            pool)))) &&
+                          ((args->workload == ARGS_WORKLOAD_STREAM) ||
+                           (mempool_create(&mode->priv->pools[i].rrs,
+                                           sizeof(struct modeperf_rr) +
+                                           sizeof(uint64_t) * mode->priv->args.window,
+                                           pool)));
+                }
+            }
+
+            // The flows of a worker, and the flows of all workers, share a
+            // rate limit that holds the tokens of a short burst, or at least
+            // those of a full send.
+            if (ret)
+            {
+                mode->priv->limits = UTILMEM_ALIGNED_ALLOC(struct modeperf_limit,
+                                                           UTILMEM_CACHELINE,
+                                                           sizeof(struct modeperf_limit),
+                                                           (args->threads + 1));
+                ret = (mode->priv->limits != NULL);
+                burst = args->buflen * 8 * (args->type == SOCK_DGRAM ? args->batch : 1);
+
+                for (i = 0; (ret) && (i <= args->threads); i++)
+                {
+                    rate = (i < args->threads ? args->threadbps : args->aggregatebps);
+                    size = rate / (UNIT_TIME_USEC / MODEPERF_BURSTUS);
+                    ret = tokenbucket_sharedinit(&mode->priv->limits[i].tb,
+                                                 rate,
+                                                 size > burst ? size : burst);
+                }
+            }
+
+            // Spread the connections of a client over its source and
+            // destination addresses.
+            if ((ret) &&
+                (args->arch == SOCKOBJ_MODEL_CLIENT) &&
+                ((args->source.size > 0) || (args->dest.size > 0)))
+            {
+                mode->priv->tuplecount = modeperf_gettuplecount(args);
+                mode->priv->tuples = UTILMEM_CALLOC(struct modeperf_tuple,
+                                                    sizeof(struct modeperf_tuple),
+                                                    mode->priv->tuplecount);
+                ret = (mode->priv->tuples != NULL);
+            }
+
+            for (i = 0; i < args->threads; i++)
+            {
+                ret &= lfqueue_create(&mode->priv->sockq[i], count);
+                ret &= doorbellobj_create(&mode->priv->bells[i]);
+            }
+
+            ret = ret && modeperf_setaffinity(mode->priv);
+
+            if (ret)
+            {
+                mode->ops.mode_create  = modeperf_create;
+                mode->ops.mode_destroy = modeperf_destroy;
+                mode->ops.mode_start   = modeperf_start;
+                mode->ops.mode_stop    = modeperf_stop;
+                mode->ops.mode_cancel  = modeperf_cancel;
+            }
+        }
+
+        if (!ret)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to create mode object part %d\n",
                           __FUNCTION__,
                           mode->priv == NULL ? 1 : mode->priv->parts);
 
@@ -243,9 +1090,232 @@ static void modeperf_copy(struct modeobj_priv * const mode,
     sock->conf.datalimitbyte = mode->args.datalimitbyte;
     sock->conf.ratelimitbps  = mode->args.ratelimitbps;
     sock->conf.timelimitusec = mode->args.timelimitusec;
+    sock->conf.idlelimitusec = (mode->args.type == SOCK_DGRAM ? SOCKUDP_IDLELIMITUS : 0);
+    sock->conf.batchcount    = mode->args.batch;
+    sock->conf.batchlen      = (uint32_t)mode->args.buflen;
+    sock->conf.segmentlen    = (mode->args.gso ? (uint32_t)mode->args.buflen : 0);
+    sock->conf.zerocopy      = mode->args.zerocopy;
+    sock->conf.sink          = mode->args.sink;
+    sock->conf.direction     = mode->args.direction;
+    sock->conf.rrwindow      = (mode->args.workload == ARGS_WORKLOAD_STREAM ?
+                                0 :
+                                mode->args.window);
+    sock->conf.reconnect     = (mode->args.workload == ARGS_WORKLOAD_CRR);
+    sock->conf.reset         = mode->args.reset;
+    sock->conf.fastopen      = mode->args.fastopen;
     sock->conf.family        = mode->args.family;
     sock->conf.type          = mode->args.type;
     sock->conf.model         = mode->args.arch;
+    memcpy(sock->conf.device, mode->args.device, sizeof(sock->conf.device));
+}
+
+/**
+ * @brief Check if a mode socket is paced by its token bucket or by a rate
+ *        limit that it shares with other sockets.
+ *
+ * @param[in] mode A pointer to a mode object.
+ * @param[in] sock A pointer to a socket object.
+ *
+ * @return True if the socket is paced.
+ */
+static bool modeperf_ispaced(const struct modeobj_priv * const mode,
+                             const struct sockobj * const sock)
+{
+    return ((sock->tb.rate > 0) ||
+            (mode->limits[sock->tid].tb.rate > 0) ||
+            (mode->limits[mode->args.threads].tb.rate > 0));
+}
+
+/**
+ * @brief Take a number of tokens for a mode socket from its token bucket and
+ *        from the rate limits of its worker and of all workers.
+ *
+ *        The tokens of a shared rate limit are taken even if they have not
+ *        been earned yet, so that the sockets that share a limit are served in
+ *        turn rather than racing for each token as it is earned. A socket
+ *        holds the tokens that it took early until they are earned, and does
+ *        not take any others meanwhile.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] sock   A pointer to a socket object.
+ * @param[in]     tokens The number of tokens to take.
+ *
+ * @return The number of tokens taken (0 if the tokens are not available yet).
+ */
+static uint64_t modeperf_take(struct modeobj_priv * const mode,
+                              struct sockobj * const sock,
+                              const uint64_t tokens)
+{
+    struct tokenbucket_shared *thread = &mode->limits[sock->tid].tb;
+    struct tokenbucket_shared *all = &mode->limits[mode->args.threads].tb;
+    uint64_t ret = tokenbucket_remove(&sock->tb, tokens), allns, readyns, tsns;
+
+    if ((ret == 0) || ((thread->rate == 0) && (all->rate == 0)))
+    {
+        // Do nothing.
+    }
+    else if (sock->tbheld > 0)
+    {
+        if (utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC) < sock->tbreleaseus)
+        {
+            tokenbucket_return(&sock->tb, ret);
+            ret = 0;
+        }
+        else
+        {
+            // Never use more tokens than are held.
+            if (ret > sock->tbheld)
+            {
+                tokenbucket_return(&sock->tb, ret - sock->tbheld);
+                ret = sock->tbheld;
+            }
+            else
+            {
+                tokenbucket_sharedreturn(thread, sock->tbheld - ret);
+                tokenbucket_sharedreturn(all, sock->tbheld - ret);
+            }
+
+            sock->tbheld = 0;
+        }
+    }
+    else
+    {
+        tsns = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC);
+        readyns = tokenbucket_sharedtake(thread, ret, tsns);
+        allns = tokenbucket_sharedtake(all, ret, tsns);
+        readyns = (allns > readyns ? allns : readyns);
+
+        if (readyns > tsns)
+        {
+            sock->tbheld      = ret;
+            sock->tbreleaseus = (readyns + 999) / 1000;
+            tokenbucket_return(&sock->tb, ret);
+            ret = 0;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Return a number of unused tokens of a mode socket to its token bucket
+ *        and to the rate limits of its worker and of all workers.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] sock   A pointer to a socket object.
+ * @param[in]     tokens The number of unused tokens.
+ *
+ * @return Void.
+ */
+static void modeperf_return(struct modeobj_priv * const mode,
+                            struct sockobj * const sock,
+                            const uint64_t tokens)
+{
+    tokenbucket_return(&sock->tb, tokens);
+    tokenbucket_sharedreturn(&mode->limits[sock->tid].tb, tokens);
+    tokenbucket_sharedreturn(&mode->limits[mode->args.threads].tb, tokens);
+}
+
+/**
+ * @brief Get the time that a paced mode socket may receive or send a full
+ *        buffer again.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] sock A pointer to a socket object.
+ * @param[in]     tsus The current monotonic time in microseconds.
+ *
+ * @return The time that the socket may receive or send again (0 if it may
+ *         now).
+ */
+static uint64_t modeperf_getrelease(const struct modeobj_priv * const mode,
+                                    struct sockobj * const sock,
+                                    const uint64_t tsus)
+{
+    uint64_t ret = tokenbucket_delay(&sock->tb, mode->args.buflen * 8);
+
+    // The delay counts from the last fill of the token bucket.
+    ret = (ret > 0 ? sock->tb.tsus + ret : 0);
+
+    if ((sock->tbheld > 0) && (sock->tbreleaseus > ret))
+    {
+        ret = sock->tbreleaseus;
+    }
+
+    return (ret > tsus ? ret : 0);
+}
+
+/**
+ * @brief Get the number of bytes that a mode socket may receive or send next
+ *        based on its data limit, token bucket and shared rate limits. The
+ *        tokens are taken from the token bucket and the rate limits.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in]     stats  Function-specific socket statistics.
+ * @param[in,out] sock   A pointer to a socket object.
+ * @param[in]     buflen The maximum size of a buffer in bytes.
+ * @param[in]     paced  True if the bytes are taken from the token bucket.
+ *
+ * @return The number of bytes that may be received or sent (0 if none).
+ */
+static uint64_t modeperf_getlen(struct modeobj_priv * const mode,
+                                const struct sockobj_flowstats * const stats,
+                                struct sockobj * const sock,
+                                const uint32_t buflen,
+                                const bool paced)
+{
+    uint64_t ret = 0;
+
+    if (mode->args.datalimitbyte > 0)
+    {
+        if ((uint64_t)stats->buflen.sum < mode->args.datalimitbyte)
+        {
+            ret = mode->args.datalimitbyte - stats->buflen.sum;
+
+            if (ret > buflen)
+            {
+                ret = buflen;
+            }
+
+            ret = (paced ? modeperf_take(mode, sock, ret * 8) / 8 : ret);
+        }
+    }
+    else
+    {
+        ret = (paced ? modeperf_take(mode, sock, (uint64_t)buflen * 8) / 8 : buflen);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check if a mode socket has reached its time or data limit.
+ *
+ * @param[in] mode  A pointer to a mode object.
+ * @param[in] stats Function-specific socket statistics.
+ * @param[in] sock  A pointer to a socket object.
+ * @param[in] tsus  The current Unix time in microseconds.
+ *
+ * @return True if the socket has reached a limit.
+ */
+static bool modeperf_islimit(const struct modeobj_priv * const mode,
+                             const struct sockobj_flowstats * const stats,
+                             const struct sockobj * const sock,
+                             const uint64_t tsus)
+{
+    bool ret = false;
+
+    if ((mode->args.timelimitusec > 0) &&
+        ((tsus - sock->info.startusec) >= mode->args.timelimitusec))
+    {
+        ret = true;
+    }
+    else if ((mode->args.datalimitbyte > 0) &&
+             ((uint64_t)stats->buflen.sum >= mode->args.datalimitbyte))
+    {
+        ret = true;
+    }
+
+    return ret;
 }
 
 /**
@@ -273,78 +1343,136 @@ static int32_t modeperf_call(struct modeobj_priv * const mode,
                              const uint64_t tsus)
 {
     int32_t ret = 0;
-    uint64_t len = 0;
+    // The rate of a full-duplex flow is the rate of each direction, so only
+    // its sends are paced.
+    const bool paced = ((sock->conf.direction != SOCKOBJ_DIRECTION_DUPLEX) ||
+                        (stats == &sock->info.send));
+    uint64_t len = modeperf_getlen(mode, stats, sock, buflen, paced);
+    uint64_t cnt = stats->buflen.cnt;
 
-    if (mode->args.datalimitbyte > 0)
+    if (len > 0)
     {
-        if ((uint64_t)stats->buflen.sum < mode->args.datalimitbyte)
-        {
-            len = mode->args.datalimitbyte - stats->buflen.sum;
-
-            if (len > buflen)
-            {
-                len = buflen;
-            }
+        sock->info.syscalls++;
+        ret = call(sock, buf, len);
 
-            len = tokenbucket_remove(&sock->tb, len * 8) / 8;
+        if (sock->conf.type == SOCK_DGRAM)
+        {
+            sock->info.datagrams += stats->buflen.cnt - cnt;
         }
     }
-    else
-    {
-        len = tokenbucket_remove(&sock->tb, buflen * 8) / 8;
-    }
 
-    if (len > 0)
+    if (ret < 0)
     {
-        ret = call(sock, buf, len);
+        sock->ops->sock_close(sock);
+        sock->ops->sock_destroy(sock);
     }
-    else
+    else if (modeperf_islimit(mode, stats, sock, tsus))
     {
-        if ((!sock->event.ops.fion_poll(&sock->event)) ||
-            (sock->event.ops.fion_getevents(&sock->event, 0) & FIONOBJ_REVENT_ERROR))
-        {
-            sock->ops.sock_close(sock);
-            sock->ops.sock_destroy(sock);
-        }
+        sock->ops->sock_close(sock);
+        sock->ops->sock_destroy(sock);
     }
 
-    if (ret < 0)
+    if (paced)
     {
-        sock->ops.sock_close(sock);
-        sock->ops.sock_destroy(sock);
+        modeperf_return(mode, sock, ret < 0 ? 0 : (len - (uint32_t)ret) * 8);
     }
-    else if ((mode->args.timelimitusec > 0) &&
-             ((tsus - sock->info.startusec) >= mode->args.timelimitusec))
+
+    return ret;
+}
+
+/**
+ * @brief Allocate a zeroed socket from the object pool of a worker.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ * @param[in]     qid  The socket queue id of the worker that will work the
+ *                     socket.
+ *
+ * @return A pointer to a socket object (NULL on error).
+ */
+static struct sockobj *modeperf_allocsock(struct modeobj_priv * const mode,
+                                          const uint32_t qid)
+{
+    struct mempool *pool = &mode->pools[qid % mode->args.threads].socks;
+    struct modeperf_sock *obj = (struct modeperf_sock *)mempool_get(pool);
+
+    if (obj != NULL)
     {
-        sock->ops.sock_close(sock);
-        sock->ops.sock_destroy(sock);
+        obj->pool = pool;
     }
-    else if ((mode->args.datalimitbyte > 0) &&
-             ((uint64_t)stats->buflen.sum >= mode->args.datalimitbyte))
+
+    return (obj == NULL ? NULL : &obj->sock);
+}
+
+/**
+ * @brief Free a socket to the object pool that it was taken from (or to the
+ *        heap if the pool had no free socket). A client socket may be handed
+ *        to another worker than the one whose pool it was taken from.
+ *
+ * @param[in] sock A pointer to a destroyed socket object.
+ *
+ * @return Void.
+ */
+static void modeperf_freesock(struct sockobj * const sock)
+{
+    struct modeperf_sock *obj = (struct modeperf_sock *)sock;
+
+    mempool_free(obj->pool, obj);
+}
+
+/**
+ * @brief Hand a new socket to a worker through its socket queue without
+ *        taking a lock, and wake the worker if it is waiting for sockets.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] thread A pointer to the calling scheduler thread.
+ * @param[in]     qid    A socket queue id.
+ * @param[in]     sock   A pointer to a new socket.
+ *
+ * @return True if the socket was inserted into the socket queue.
+ */
+static bool modeperf_putsock(struct modeobj_priv * const mode,
+                             struct threadobj * const thread,
+                             const uint32_t qid,
+                             struct sockobj * const sock)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((mode != NULL) &&
+                         (qid < mode->args.threads) &&
+                         (sock != NULL)))
     {
-        sock->ops.sock_close(sock);
-        sock->ops.sock_destroy(sock);
-    }
+        // A full queue means the worker is behind, so back off until it
+        // catches up rather than dropping the socket.
+        while ((!(ret = lfqueue_push(&mode->sockq[qid], sock))) &&
+               (threadobj_isrunning(thread)))
+        {
+            doorbellobj_ring(&mode->bells[qid]);
+            threadobj_sleepusec(1000);
+        }
 
-    tokenbucket_return(&sock->tb, ret < 0 ? 0 : len - (uint32_t)ret);
+        if (ret)
+        {
+            doorbellobj_ring(&mode->bells[qid]);
+        }
+    }
 
     return ret;
 }
 
 /**
- * @brief Get a new socket from a socket queue.
+ * @brief Get a new socket from a socket queue without taking a lock. A worker
+ *        waits for new sockets in its event loop by watching the socket queue
+ *        doorbell.
  *
- * @param[in,out] mode  A pointer to a mode object.
- * @param[in] qid       A socket queue id.
- * @param[in] timeoutms The maximum amount of time in milliseconds to wait for a
- *                      new socket.
+ * @param[in,out] mode     A pointer to a mode object.
+ * @param[in]     qid      A socket queue id.
+ * @param[out]    shutdown True if a client worker has no sockets left to work.
  *
  * @return A pointer to a new socket on success. Otherwise, a null pointer is
  *         returned.
  */
 static struct sockobj *modeperf_getsock(struct modeobj_priv * const mode,
                                         const uint32_t qid,
-                                        const uint32_t timeoutms,
                                         bool * const shutdown)
 {
     struct sockobj *ret = NULL;
@@ -355,35 +1483,33 @@ static struct sockobj *modeperf_getsock(struct modeobj_priv * const mode,
     {
         *shutdown = false;
 
-        mutexobj_lock(&mode->mtxarr[qid]);
-
-        if ((mode->sockq[qid].tail == NULL) && (timeoutms > 0))
-        {
-            cvobj_timedwait(&mode->cvarr[qid],
-                            &mode->mtxarr[qid],
-                            timeoutms * 1000);
-        }
-
-        if ((mode->sockq[qid].tail != NULL) &&
-            ((ret = mode->sockq[qid].tail->val) != NULL))
+        if ((ret = lfqueue_pop(&mode->sockq[qid])) != NULL)
         {
-            dlist_removetail(&mode->sockq[qid]);
-            mode->activesocks[qid]++;
+            __atomic_add_fetch(&mode->counters[qid].activesocks, 1, __ATOMIC_SEQ_CST);
         }
 
         if ((mode->args.arch == SOCKOBJ_MODEL_CLIENT) &&
-            (mode->activesocks[qid] == 0) &&
-            (mode->closedsocks[qid] == mode->configsocks[qid]))
+            (__atomic_load_n(&mode->counters[qid].activesocks, __ATOMIC_SEQ_CST) == 0) &&
+            (__atomic_load_n(&mode->counters[qid].closedsocks, __ATOMIC_SEQ_CST) ==
+             __atomic_load_n(&mode->counters[qid].configsocks, __ATOMIC_SEQ_CST)))
         {
             *shutdown = true;
         }
-
-        mutexobj_unlock(&mode->mtxarr[qid]);
     }
 
     return ret;
 }
 
+/**
+ * @brief Return a closed socket to a mode object. The tokens that the socket
+ *        held from shared rate limits are returned to them.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ * @param[in,out] sock A pointer to a closed socket to free.
+ * @param[in]     qid  A socket queue id.
+ *
+ * @return True if the socket was freed.
+ */
 static bool modeperf_retsock(struct modeobj_priv * const mode,
                              struct sockobj * const sock,
                              uint32_t qid)
@@ -394,12 +1520,19 @@ static bool modeperf_retsock(struct modeobj_priv * const mode,
                          (sock != NULL) &&
                          (qid < mode->args.threads)))
     {
-        UTILMEM_FREE(sock);
+        if (sock->tbheld > 0)
+        {
+            tokenbucket_sharedreturn(&mode->limits[sock->tid].tb, sock->tbheld);
+            tokenbucket_sharedreturn(&mode->limits[mode->args.threads].tb, sock->tbheld);
+            sock->tbheld = 0;
+        }
 
-        mutexobj_lock(&mode->mtxarr[qid]);
-        mode->activesocks[qid]--;
-        mode->closedsocks[qid]++;
-        mutexobj_unlock(&mode->mtxarr[qid]);
+        modeperf_freesock(sock);
+
+        // Count the socket as closed before it is no longer active so that a
+        // reader never sees a socket that is neither.
+        __atomic_add_fetch(&mode->counters[qid].closedsocks, 1, __ATOMIC_SEQ_CST);
+        __atomic_sub_fetch(&mode->counters[qid].activesocks, 1, __ATOMIC_SEQ_CST);
 
         ret = true;
     }
@@ -408,46 +1541,247 @@ static bool modeperf_retsock(struct modeobj_priv * const mode,
 }
 
 /**
- * @brief A scheduler that accepts new sockets and inserts them into queue(s)
- *        based on a round-robin algorithm.
+ * @brief Wait for a connection accepted by an io_uring (multishot) accept
+ *        request on a listener socket and initialize a socket object with it.
  *
- * @param[in,out] arg A pointer to a mode object.
+ * @param[in,out] ring   A pointer to an asynchronous I/O ring object.
+ * @param[in,out] server A pointer to a listener socket object.
+ * @param[in,out] sock   A pointer to a socket object to initialize.
  *
- * @return NULL.
+ * @return True if a new socket was accepted.
  */
-static void *modeperf_acceptorthread(void *arg)
+static bool modeperf_uringaccept(struct uringobj * const ring,
+                                 struct sockobj * const server,
+                                 struct sockobj * const sock)
 {
-    struct modeobj_priv *mode = (struct modeobj_priv*)arg;
-    struct threadobj *thread = threadpool_getthread(&mode->threadpool);
-    struct sockobj server, *sock = NULL;
-    bool exit = true;
-    uint32_t acceptsocks = 0, activesocks = 0, i = 0, qid = 0, tid = 0;
-
-    memset(&server, 0, sizeof(server));
+    bool ret = false;
+    struct uringobj_cqe cqe;
 
-    modeperf_copy(mode, &server, 50);
-    exit = !sockmod_init(&server);
+    uringobj_submit(ring, 1, (uint64_t)server->conf.timeoutms * 1000);
 
-    if (exit)
+    if (uringobj_reap(ring, &cqe, 1) == 0)
     {
-        // @todo Call modeperf_call() instead.
-        threadpool_wake(&mode->threadpool);
+        // Do nothing.
     }
     else
     {
-        tid = threadpool_getid(&mode->threadpool);
-        logger_printf(LOGGER_LEVEL_INFO,
+        // A multishot request stops generating completions on error.
+        if ((cqe.flags & URINGOBJ_CQEFLAG_MORE) == 0)
+        {
+            uringobj_accept(ring, server->fd, cqe.data);
+        }
+
+        if (cqe.res < 0)
+        {
+            logger_printf(LOGGER_LEVEL_DEBUG,
+                          "%s: accept failed (%d)\n",
+                          __FUNCTION__,
+                          -cqe.res);
+        }
+        else if (!socktcp_acceptfd(server, sock, cqe.res))
+        {
+            close(cqe.res);
+        }
+        else
+        {
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Accept the sockets that are pending on a worker listener without
+ *        blocking and queue them to the worker (i.e., the worker picks them up
+ *        from its own socket queue). A datagram listener becomes the accepted
+ *        socket and is replaced by a new listener with a new file descriptor.
+ *
+ * @param[in,out] mode     A pointer to a mode object.
+ * @param[in]     tid      A worker thread id.
+ * @param[in,out] listener A pointer to a listener socket object.
+ * @param[in]     limit    The maximum number of sockets to accept.
+ *
+ * @return The number of sockets accepted.
+ */
+static uint32_t modeperf_acceptshard(struct modeobj_priv * const mode,
+                                     const uint32_t tid,
+                                     struct sockobj * const listener,
+                                     const uint32_t limit)
+{
+    uint32_t ret = 0;
+    struct sockobj *sock = NULL;
+    bool done = false;
+    int32_t fd = -1;
+
+    while ((!done) && (ret < limit))
+    {
+        if ((sock = modeperf_allocsock(mode, tid)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate memory\n",
+                          __FUNCTION__);
+            done = true;
+        }
+        else if (listener->conf.type == SOCK_DGRAM)
+        {
+            done = true;
+
+            if (!listener->ops->sock_accept(listener, sock))
+            {
+                modeperf_freesock(sock);
+                sock = NULL;
+            }
+        }
+#if defined(__linux__)
+        else if ((fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK)) < 0)
+#else
+        else if (((fd = accept(listener->fd, NULL, NULL)) < 0) ||
+                 (fcntl(fd, F_SETFL, O_NONBLOCK) != 0))
+#endif
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                logger_printf(LOGGER_LEVEL_DEBUG,
+                              "%s: accept failed (%d)\n",
+                              __FUNCTION__,
+                              errno);
+            }
+
+            if (fd > -1)
+            {
+                close(fd);
+            }
+
+            modeperf_freesock(sock);
+            sock = NULL;
+            done = true;
+        }
+        else if (!socktcp_acceptfd(listener, sock, fd))
+        {
+            close(fd);
+            modeperf_freesock(sock);
+            sock = NULL;
+        }
+
+        if (sock == NULL)
+        {
+            // Do nothing.
+        }
+        else if (lfqueue_push(&mode->sockq[tid], sock))
+        {
+            logger_printf(LOGGER_LEVEL_INFO,
+                          "%s: accepted socket on queue %u\n",
+                          __FUNCTION__,
+                          tid);
+            ret++;
+        }
+        else
+        {
+            sock->ops->sock_close(sock);
+            sock->ops->sock_destroy(sock);
+            modeperf_freesock(sock);
+            done = true;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the listener that a worker accepts sockets from.
+ *
+ * @param[in] mode A pointer to a mode object.
+ * @param[in] tid  A worker thread id.
+ *
+ * @return A pointer to a listener socket object (NULL if the worker does not
+ *         accept sockets).
+ */
+static struct sockobj *modeperf_getlistener(struct modeobj_priv * const mode,
+                                            const uint32_t tid)
+{
+    struct sockobj *ret = NULL;
+
+    if (mode->listenercount == 0)
+    {
+        // Do nothing.
+    }
+    else if (mode->listener == ARGS_LISTENER_EXCLUSIVE)
+    {
+        ret = &mode->listeners[0];
+    }
+    else if (tid < mode->listenercount)
+    {
+        ret = &mode->listeners[tid];
+    }
+
+    return ret;
+}
+
+/**
+ * @brief A scheduler that accepts new sockets and inserts them into queue(s)
+ *        based on a round-robin algorithm.
+ *
+ * @param[in,out] arg A pointer to a mode object.
+ *
+ * @return NULL.
+ */
+static void *modeperf_acceptorthread(void *arg)
+{
+    struct modeobj_priv *mode = (struct modeobj_priv*)arg;
+    struct threadobj *thread = threadpool_getthread(&mode->threadpool);
+    struct sockobj server, *sock = NULL;
+    struct uringobj ring;
+    struct fionobj fion;
+    bool exit = true, uring = false;
+    uint32_t acceptsocks = 0, activesocks = 0, i = 0, qid = 0, tid = 0;
+    int32_t listenfd = -1;
+
+    memset(&server, 0, sizeof(server));
+    memset(&ring, 0, sizeof(ring));
+    memset(&fion, 0, sizeof(fion));
+
+    modeperf_copy(mode, &server, 50);
+
+    // The listener is watched by a poll event object, which waits for the
+    // socket timeout so that the thread notices when it is stopped.
+    if ((fionobj_create(&fion, FIONOBJ_MODEL_POLL)) &&
+        (sockmod_init(&server)))
+    {
+        fion.timeoutms = server.conf.timeoutms;
+        fion.pevents   = FIONOBJ_PEVENT_IN;
+        listenfd       = server.fd;
+        exit           = !fion.ops.fion_insertfd(&fion, listenfd);
+    }
+
+    if (exit)
+    {
+        // @todo Call modeperf_call() instead.
+        threadpool_wake(&mode->threadpool);
+    }
+    else
+    {
+        tid = threadpool_getid(&mode->threadpool);
+        logger_printf(LOGGER_LEVEL_INFO,
                       "Accepting sockets on thread id %u\n",
                       tid);
+
+        if ((mode->args.uring) &&
+            (mode->args.type == SOCK_STREAM) &&
+            (uringobj_create(&ring, 64)))
+        {
+            if (!(uring = uringobj_accept(&ring, server.fd, 1)))
+            {
+                uringobj_destroy(&ring);
+            }
+        }
     }
 
     while ((!exit) && (threadobj_isrunning(thread)))
     {
         if (sock == NULL)
         {
-            sock = UTILMEM_CALLOC(struct sockobj,
-                                  sizeof(struct sockobj),
-                                  1);
+            sock = modeperf_allocsock(mode, qid);
         }
 
         if (sock == NULL)
@@ -456,8 +1790,21 @@ static void *modeperf_acceptorthread(void *arg)
                           "%s: failed to allocate memory\n",
                           __FUNCTION__);
         }
-        else if (server.ops.sock_accept(&server, sock))
+        else if ((uring) ?
+                 modeperf_uringaccept(&ring, &server, sock) :
+                 ((fion.ops.fion_poll(&fion)) &&
+                  ((fion.revents & FIONOBJ_REVENT_INREADY) != 0) &&
+                  (server.ops->sock_accept(&server, sock))))
         {
+            // A datagram listener is handed to the socket that it accepts
+            // and opened again with a new file descriptor.
+            if ((!uring) && (server.fd != listenfd))
+            {
+                fion.ops.fion_deletefd(&fion, listenfd);
+                listenfd = server.fd;
+                fion.ops.fion_insertfd(&fion, listenfd);
+            }
+
             if (sock != NULL)
             {
                 if ((mode->args.maxcon > 0) &&
@@ -467,8 +1814,8 @@ static void *modeperf_acceptorthread(void *arg)
                                   "%s: rejected socket on queue %u\n",
                                   __FUNCTION__,
                                   qid);
-                    sock->ops.sock_close(sock);
-                    sock->ops.sock_destroy(sock);
+                    sock->ops->sock_close(sock);
+                    sock->ops->sock_destroy(sock);
                     continue;
                 }
                 else
@@ -479,23 +1826,16 @@ static void *modeperf_acceptorthread(void *arg)
                                   qid);
                 }
 
-                mutexobj_lock(&mode->mtxarr[qid]);
-
-                if (dlist_inserttail(&mode->sockq[qid], sock))
+                if (modeperf_putsock(mode, thread, qid, sock))
                 {
                     sock = NULL;
                 }
                 else
                 {
-                    sock->ops.sock_close(sock);
-                    sock->ops.sock_destroy(sock);
+                    sock->ops->sock_close(sock);
+                    sock->ops->sock_destroy(sock);
                 }
 
-                mutexobj_unlock(&mode->mtxarr[qid]);
-                // @todo Use semaphore instead since thread being signaled
-                //       may not be blocking waiting for a signal.
-                cvobj_signalone(&mode->cvarr[qid]);
-
                 if (sock == NULL)
                 {
                     acceptsocks++;
@@ -503,10 +1843,10 @@ static void *modeperf_acceptorthread(void *arg)
                 }
             }
         }
-        else if (server.event.revents & FIONOBJ_REVENT_ERROR)
+        else if ((!uring) && (fion.revents & FIONOBJ_REVENT_ERROR))
         {
-            server.ops.sock_close(&server);
-            server.ops.sock_destroy(&server);
+            server.ops->sock_close(&server);
+            server.ops->sock_destroy(&server);
             exit = true;
         }
         else
@@ -515,9 +1855,8 @@ static void *modeperf_acceptorthread(void *arg)
 
             for (i = 0; i < mode->args.threads; i++)
             {
-                mutexobj_lock(&mode->mtxarr[i]);
-                activesocks += mode->activesocks[i];
-                mutexobj_unlock(&mode->mtxarr[i]);
+                activesocks += __atomic_load_n(&mode->counters[i].activesocks,
+                                               __ATOMIC_RELAXED);
             }
 
             if (activesocks == 0)
@@ -529,10 +1868,20 @@ static void *modeperf_acceptorthread(void *arg)
 
     if (sock != NULL)
     {
-        UTILMEM_FREE(sock);
+        modeperf_freesock(sock);
         sock = NULL;
     }
 
+    if (uring)
+    {
+        uringobj_destroy(&ring);
+    }
+
+    if (fion.ops.fion_destroy != NULL)
+    {
+        fion.ops.fion_destroy(&fion);
+    }
+
     logger_printf(LOGGER_LEVEL_INFO,
                   "Finished accepting sockets on thread id %u\n",
                   tid);
@@ -541,331 +1890,3857 @@ static void *modeperf_acceptorthread(void *arg)
 }
 
 /**
- * @brief A scheduler that connects new sockets and inserts them into queue(s)
- *        based on a round-robin algorithm.
+ * @brief Hand a connected socket to a worker. Sockets are assigned to the
+ *        worker socket queues with a round-robin algorithm.
  *
- * @param[in,out] arg A pointer to a mode object.
+ * @param[in,out] mode         A pointer to a mode object.
+ * @param[in,out] thread       A pointer to the calling scheduler thread.
+ * @param[in,out] sock         A pointer to a connected socket.
+ * @param[in,out] connectsocks A pointer to the number of sockets handed to
+ *                             the workers.
  *
- * @return NULL.
+ * @return True if the socket was handed to a worker.
  */
-static void *modeperf_connectorthread(void *arg)
+static bool modeperf_rampput(struct modeobj_priv * const mode,
+                             struct threadobj * const thread,
+                             struct sockobj * const sock,
+                             uint32_t * const connectsocks)
 {
-    struct modeobj_priv *mode = (struct modeobj_priv*)arg;
-    struct threadobj *thread = threadpool_getthread(&mode->threadpool);
-    struct sockobj *sock = NULL;
-    uint32_t connectsocks = 0, i = 0, qid = 0, tid = 0;
+    bool ret = false;
+    uint32_t qid = *connectsocks % mode->args.threads;
 
-    tid = threadpool_getid(&mode->threadpool);
     logger_printf(LOGGER_LEVEL_INFO,
-                  "Connecting sockets on thread id %u\n",
-                  tid);
+                  "%s: connected socket on queue %u\n",
+                  __FUNCTION__,
+                  qid);
 
-    for (i = 0;
-         (threadobj_isrunning(thread)) &&
-         (i < mode->args.maxcon);
-         i++)
+    // Count the socket as configured before a worker can close it.
+    if (*connectsocks < mode->args.threads)
     {
-        if (sock == NULL)
-        {
-            sock = UTILMEM_CALLOC(struct sockobj,
-                                  sizeof(struct sockobj),
-                                  1);
-        }
+        __atomic_store_n(&mode->counters[qid].configsocks, 1, __ATOMIC_SEQ_CST);
+    }
+    else
+    {
+        __atomic_add_fetch(&mode->counters[qid].configsocks, 1, __ATOMIC_SEQ_CST);
+    }
 
-        if (sock == NULL)
-        {
-            logger_printf(LOGGER_LEVEL_ERROR,
-                          "%s: failed to allocate memory\n",
-                          __FUNCTION__);
-        }
-        else
-        {
-            modeperf_copy(mode, sock, 0);
+    if (!modeperf_putsock(mode, thread, qid, sock))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to store allocated memory\n",
+                      __FUNCTION__);
 
-            if (!sockmod_init(sock))
-            {
-                break; // @todo Only for multiple connections?
-            }
-            else
-            {
-                sock->ops.sock_connect(sock);
-                logger_printf(LOGGER_LEVEL_INFO,
-                              "%s: connected socket on queue %u\n",
-                              __FUNCTION__,
-                              qid);
+        __atomic_sub_fetch(&mode->counters[qid].configsocks, 1, __ATOMIC_SEQ_CST);
+        sock->ops->sock_close(sock);
+        sock->ops->sock_destroy(sock);
+        modeperf_freesock(sock);
+    }
+    else
+    {
+        (*connectsocks)++;
+        ret = true;
+    }
 
-                mutexobj_lock(&mode->mtxarr[qid]);
+    return ret;
+}
 
-                if (!dlist_inserttail(&mode->sockq[qid], sock))
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: failed to store allocated memory\n",
-                                  __FUNCTION__);
+/**
+ * @brief Start or stop watching the socket of a connect in flight for connect
+ *        progress.
+ *
+ * @param[in,out] fion    A pointer to the connector event object.
+ * @param[in,out] fdslots A pointer to a vector of connect positions (plus one)
+ *                        indexed by file descriptor.
+ * @param[in,out] ramp    A pointer to a connect in flight.
+ * @param[in]     pos     The position of the connect in flight.
+ * @param[in]     watch   True to start watching the socket.
+ *
+ * @return Void.
+ */
+static void modeperf_rampwatch(struct fionobj * const fion,
+                               struct vector * const fdslots,
+                               struct modeperf_ramp * const ramp,
+                               const uint32_t pos,
+                               const bool watch)
+{
+    const int32_t fd = ramp->sock->fd;
+    uint32_t size = vector_getsize(fdslots);
 
-                    sock->ops.sock_close(sock);
-                    sock->ops.sock_destroy(sock);
-                }
-                else
+    if ((watch) && (!ramp->polled) && (fd >= 0))
+    {
+        if ((uint32_t)fd >= size)
+        {
+            if (vector_resize(fdslots, (uint32_t)fd + 1))
+            {
+                while (size <= (uint32_t)fd)
                 {
-                    if (connectsocks < mode->args.threads)
-                    {
-                        mode->configsocks[qid] = 1;
-                    }
-                    else
-                    {
-                        mode->configsocks[qid]++;
-                    }
+                    *(uint32_t *)vector_getval(fdslots, size++) = 0;
+                }
+            }
+        }
 
-                    utilstring_concat(mode->workerstats[qid].addrself.sockaddrstr,
-                                      sizeof(mode->workerstats[qid].addrself.sockaddrstr),
-                                      "%s:*",
-                                      sock->conf.ipaddr);
-                    utilstring_concat(mode->workerstats[qid].addrpeer.sockaddrstr,
-                                      sizeof(mode->workerstats[qid].addrpeer.sockaddrstr),
-                                      "%s:%u",
-                                      sock->conf.ipaddr, sock->conf.ipport);
+        if ((uint32_t)fd < vector_getsize(fdslots))
+        {
+            *(uint32_t *)vector_getval(fdslots, (uint32_t)fd) = pos + 1;
+            fion->ops.fion_insertfd(fion, fd);
+            ramp->polled = true;
+        }
+    }
+    else if ((!watch) && (ramp->polled))
+    {
+        *(uint32_t *)vector_getval(fdslots, (uint32_t)fd) = 0;
+        fion->ops.fion_deletefd(fion, fd);
+        ramp->polled = false;
+    }
+}
 
-                    sock = NULL;
-                }
+/**
+ * @brief Check the progress of a connect in flight after a connect attempt.
+ *        A connected socket is handed to a worker, a connect that is still in
+ *        progress is watched by the event loop, and a connect that failed is
+ *        either retried after a backoff or given up.
+ *
+ * @param[in,out] mode         A pointer to a mode object.
+ * @param[in,out] thread       A pointer to the calling scheduler thread.
+ * @param[in,out] fion         A pointer to the connector event object.
+ * @param[in,out] fdslots      A pointer to a vector of connect positions (plus
+ *                             one) indexed by file descriptor.
+ * @param[in,out] ramp         A pointer to a connect in flight.
+ * @param[in]     pos          The position of the connect in flight.
+ * @param[in]     tsus         The current time in microseconds.
+ * @param[in,out] connectsocks A pointer to the number of sockets handed to
+ *                             the workers.
+ *
+ * @return True if the connect is no longer in flight.
+ */
+static bool modeperf_rampcheck(struct modeobj_priv * const mode,
+                               struct threadobj * const thread,
+                               struct fionobj * const fion,
+                               struct vector * const fdslots,
+                               struct modeperf_ramp * const ramp,
+                               const uint32_t pos,
+                               const uint64_t tsus,
+                               uint32_t * const connectsocks)
+{
+    bool ret = true;
+    struct sockobj *sock = ramp->sock;
 
-                mutexobj_unlock(&mode->mtxarr[qid]);
-                // @todo Use semaphore instead since thread being signaled
-                //       may not be blocking waiting for a signal.
-                cvobj_signalone(&mode->cvarr[qid]);
+    if (sock->state & SOCKOBJ_STATE_CONNECT)
+    {
+        modeperf_rampwatch(fion, fdslots, ramp, pos, false);
+        modeperf_rampput(mode, thread, sock, connectsocks);
 
-                if (sock == NULL)
-                {
-                    connectsocks++;
-                    qid = connectsocks % mode->args.threads;
-                }
-            }
+        if (mode->tuples != NULL)
+        {
+            __atomic_add_fetch(&mode->tuples[ramp->tuple].connected, 1, __ATOMIC_SEQ_CST);
         }
     }
-
-    if (sock != NULL)
+    else if ((!(sock->state & SOCKOBJ_STATE_CLOSE)) &&
+             ((sock->info.connerr == EINPROGRESS) ||
+              (sock->info.connerr == EALREADY)))
     {
-        UTILMEM_FREE(sock);
-        sock = NULL;
+        modeperf_rampwatch(fion, fdslots, ramp, pos, true);
+        ret = false;
     }
-
-    for (i = 0; i < mode->args.threads; i++)
+    else
     {
-        if (mode->configsocks[i] == 0xFFFFFFFF)
+        modeperf_rampwatch(fion, fdslots, ramp, pos, false);
+
+        if ((sock->state & SOCKOBJ_STATE_CLOSE) == 0)
+        {
+            sock->ops->sock_close(sock);
+        }
+
+        // A server that is not keeping up with its accept queue refuses a
+        // connect, and a client that is out of local ports cannot connect
+        // until one is released. Both are worth another attempt.
+        ramp->tries++;
+
+        if (((sock->info.connerr == ECONNREFUSED) ||
+             (sock->info.connerr == EADDRNOTAVAIL)) &&
+            (ramp->tries < MODEPERF_RAMPTRIES))
+        {
+            ramp->dueusec = tsus + (MODEPERF_RAMPBACKOFFUS << (ramp->tries - 1));
+            ret = false;
+        }
+        else
         {
-            mode->configsocks[i] = 0;
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u connect failed after %u attempts (%d)\n",
+                          __FUNCTION__,
+                          sock->sid,
+                          ramp->tries,
+                          sock->info.connerr);
+            sock->ops->sock_destroy(sock);
+            modeperf_freesock(sock);
+
+            if (mode->tuples != NULL)
+            {
+                __atomic_add_fetch(&mode->tuples[ramp->tuple].failed, 1, __ATOMIC_SEQ_CST);
+            }
         }
     }
 
-    logger_printf(LOGGER_LEVEL_INFO,
-                  "Finished connecting sockets on thread id %u\n",
-                  tid);
+    if (ret)
+    {
+        memset(ramp, 0, sizeof(*ramp));
+    }
 
-    return NULL;
+    return ret;
 }
 
 /**
- * @brief A socket statistics reporter.
+ * @brief A scheduler that connects new sockets and inserts them into queue(s)
+ *        based on a round-robin algorithm. Connects are pipelined: a window of
+ *        nonblocking connects is kept in flight and completed through an event
+ *        loop, and new connects are opened at the configured ramp rate.
  *
  * @param[in,out] arg A pointer to a mode object.
  *
  * @return NULL.
  */
-static void *modeperf_reporterthread(void *arg)
+static void *modeperf_connectorthread(void *arg)
 {
     struct modeobj_priv *mode = (struct modeobj_priv*)arg;
     struct threadobj *thread = threadpool_getthread(&mode->threadpool);
-    struct sockobj stats;
-    struct formobj form;
-    bool exit = false, active = false;
-    uint32_t activesocks, configsocks, closedsocks, i;
-    int32_t formbytes;
-    uint64_t tvus;
-    // @todo Use a tree that contains total socket stats that can be broken down
-    //       by thread and by individual port numbers.
+    struct sockobj *sock = NULL;
+    struct modeperf_ramp *ramp = NULL, *slot = NULL;
+    struct fionobj fion;
+    struct vector fdslots;
+    bool check = false, open = true;
+    int32_t fd;
+    uint32_t config, connectsocks = 0, i = 0, tid = 0, *pos;
+    uint32_t inflight = 0, opened = 0, watched = 0, window;
+    uint64_t dueusec, startusec, tsus;
+
+    tid = threadpool_getid(&mode->threadpool);
     logger_printf(LOGGER_LEVEL_INFO,
-                  "Started reporting sockets on thread id %u\n",
-                  threadpool_getid(&mode->threadpool));
+                  "Connecting sockets on thread id %u\n",
+                  tid);
 
-    memset(&stats, 0, sizeof(stats));
-    memset(&form, 0, sizeof(form));
-    modeperf_copy(mode, &stats, 0);
-    formperf_create(&form, 4096);
-
-    stats.tid = mode->args.threads;
+    memset(&fion, 0, sizeof(fion));
+    memset(&fdslots, 0, sizeof(fdslots));
+    window = (mode->args.connwindow < mode->args.maxcon ?
+              mode->args.connwindow :
+              mode->args.maxcon);
+    window = (window == 0 ? 1 : window);
 
-    for (i = 0; i < mode->args.threads; i++)
+    if (!fionobj_create(&fion, mode->args.event))
     {
-        formperf_create(&mode->workerforms[i], 4096);
-        modeperf_copy(mode, &mode->workerstats[i], 0);
-        mode->workerforms[i].sock = &mode->workerstats[i];
-        mode->workerforms[i].intervalusec = mode->args.intervalusec;
-        mode->workerstats[i].tid = i;
+        // Do nothing.
     }
-
-    while (!exit && threadobj_isrunning(thread))
+    else if (!vector_create(&fdslots, 0, sizeof(uint32_t)))
     {
-        activesocks = 0;
-        closedsocks = 0;
-        configsocks = 0;
-        stats.cpu.usage = 0;
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: connect state allocation failed\n",
+                      __FUNCTION__);
+        fion.ops.fion_destroy(&fion);
+    }
+    else if ((ramp = UTILMEM_CALLOC(struct modeperf_ramp,
+                                    sizeof(struct modeperf_ramp),
+                                    window)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: connect state allocation failed\n",
+                      __FUNCTION__);
+        vector_destroy(&fdslots);
+        fion.ops.fion_destroy(&fion);
+    }
+    else
+    {
+        fion.pevents = FIONOBJ_PEVENT_OUT;
+        startusec = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
 
-        for (i = 0; i < mode->args.threads; i++)
+        while ((threadobj_isrunning(thread)) &&
+               (((open) && (opened < mode->args.maxcon)) || (inflight > 0)))
         {
-            mutexobj_lock(&mode->mtxarr[i]);
-            activesocks += mode->activesocks[i];
-            closedsocks += mode->closedsocks[i];
-            configsocks += mode->configsocks[i];
-            stats.conf.datalimitbyte = mode->args.datalimitbyte * configsocks;
-            stats.cpu.usage += mode->workerstats[i].cpu.usage;
-            mutexobj_unlock(&mode->mtxarr[i]);
-        }
+            tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+            dueusec = UINT64_MAX;
+
+            // Open new connects while the window has room, and pace them at
+            // the ramp rate.
+            for (i = 0;
+                 (open) &&
+                 (opened < mode->args.maxcon) &&
+                 (inflight < window) &&
+                 (i < window);
+                 i++)
+            {
+                slot = &ramp[i];
 
-        logger_printf(LOGGER_LEVEL_INFO,
-                      "%s: socket counts: active %u closed %u config %u\n",
-                      __FUNCTION__,
-                      activesocks,
-                      closedsocks,
-                      configsocks);
+                if (slot->sock != NULL)
+                {
+                    // Do nothing.
+                }
+                else if ((mode->args.connrate > 0) &&
+                         (tsus < startusec +
+                                 (uint64_t)opened * 1000000 / mode->args.connrate))
+                {
+                    dueusec = startusec +
+                              (uint64_t)opened * 1000000 / mode->args.connrate;
+                    break;
+                }
+                else if ((sock = modeperf_allocsock(mode, opened)) == NULL)
+                {
+                    logger_printf(LOGGER_LEVEL_ERROR,
+                                  "%s: failed to allocate memory\n",
+                                  __FUNCTION__);
+                    open = false;
+                }
+                else
+                {
+                    modeperf_copy(mode, sock, 0);
+                    slot->tuple = modeperf_settuple(mode, sock, opened);
 
-        stats.sid = activesocks;
+                    if (!sockmod_init(sock))
+                    {
+                        modeperf_freesock(sock);
+                        open = false; // @todo Only for multiple connections?
 
-        if ((!active) && (activesocks > 0))
-        {
-            mutexobj_lock(&mode->mtxarr[0]);
-            if (mode->activesocks[i])
-            {
-                formbytes = mode->workerforms[0].ops.form_head(&mode->workerforms[0]);
-                output_if_std_send(mode->workerforms[0].dstbuf, formbytes);
+                        if (mode->tuples != NULL)
+                        {
+                            __atomic_add_fetch(&mode->tuples[slot->tuple].failed, 1, __ATOMIC_SEQ_CST);
+                        }
+                    }
+                    else
+                    {
+                        slot->sock = sock;
+                        slot->ready = true;
+                        opened++;
+                        inflight++;
+                    }
+                }
             }
-            mutexobj_unlock(&mode->mtxarr[0]);
-        }
-        else if ((active) && (activesocks == 0))
-        {
-            tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
-            stats.info.recv.buflen.sum = 0;
-            stats.info.send.buflen.sum = 0;
-            for (i = 0; i < mode->args.threads; i++)
+
+            // Make progress on the connects in flight.
+            for (i = 0, watched = 0; i < window; i++)
             {
-                mutexobj_lock(&mode->mtxarr[i]);
-                if (mode->workerstats[i].info.startusec > 0)
+                slot = &ramp[i];
+                check = false;
+
+                if (slot->sock == NULL)
+                {
+                    // Do nothing.
+                }
+                else if (slot->dueusec > tsus)
+                {
+                    dueusec = (slot->dueusec < dueusec ? slot->dueusec : dueusec);
+                }
+                else if (slot->dueusec > 0)
                 {
-                    if ((stats.info.startusec == 0) ||
-                        (stats.info.startusec > mode->workerstats[i].info.startusec))
+                    slot->dueusec = 0;
+                    check = true;
+
+                    if (!slot->sock->ops->sock_open(slot->sock))
                     {
-                        if (mode->workerstats[i].info.startusec > 0)
-                        {
-                            stats.info.startusec = mode->workerstats[i].info.startusec;
-                        }
+                        slot->sock->info.connerr = 0;
+                    }
+                    else
+                    {
+                        slot->sock->ops->sock_connect(slot->sock);
                     }
-                    if (stats.info.stopusec < mode->workerstats[i].info.stopusec)
+                }
+                else if (slot->ready)
+                {
+                    // A second connect reports the result of a connect that
+                    // completed.
+                    if ((slot->sock->state & SOCKOBJ_STATE_CONNECT) == 0)
                     {
-                        stats.info.stopusec = mode->workerstats[i].info.stopusec;
+                        slot->sock->ops->sock_connect(slot->sock);
                     }
-                    stats.info.recv.buflen.sum += mode->workerstats[i].info.recv.buflen.sum;
-                    stats.info.send.buflen.sum += mode->workerstats[i].info.send.buflen.sum;
 
-                    formbytes = mode->workerforms[i].ops.form_foot(&mode->workerforms[i]);
-                    output_if_std_send(mode->workerforms[i].dstbuf, formbytes);
-                    memset(&mode->workerstats[i].info, 0, sizeof(mode->workerstats[i].info));
+                    check = true;
+                }
+
+                if (check)
+                {
+                    slot->ready = false;
+
+                    if (modeperf_rampcheck(mode,
+                                           thread,
+                                           &fion,
+                                           &fdslots,
+                                           slot,
+                                           i,
+                                           tsus,
+                                           &connectsocks))
+                    {
+                        inflight--;
+                    }
+                    else if ((slot->dueusec > 0) && (slot->dueusec < dueusec))
+                    {
+                        dueusec = slot->dueusec;
+                    }
                 }
-                mutexobj_unlock(&mode->mtxarr[i]);
+
+                watched += (slot->polled ? 1 : 0);
             }
 
-            if (stats.info.startusec > 0)
+            // Wait for connect progress, but no longer than until the next
+            // connect is due.
+            if ((open) &&
+                (opened < mode->args.maxcon) &&
+                (inflight < window) &&
+                (mode->args.connrate == 0))
             {
-                form.sock = &stats;
-                form.tsus = tvus;
-                form.intervalusec = mode->args.intervalusec;
-                formbytes = form.ops.form_foot(&form);
-                output_if_std_send(form.dstbuf, formbytes);
-                memset(&stats.info, 0, sizeof(stats.info));
+                fion.timeoutms = 0;
+            }
+            else
+            {
+                tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+                fion.timeoutms = (dueusec <= tsus ?
+                                  0 :
+                                  (dueusec - tsus >= MODEPERF_IDLEMS * 1000 ?
+                                   MODEPERF_IDLEMS :
+                                   (int32_t)((dueusec - tsus + 999) / 1000)));
             }
-        }
-
-        active = (activesocks > 0);
 
-        if (active)
-        {
-            tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
-            stats.info.recv.buflen.sum = 0;
-            stats.info.send.buflen.sum = 0;
-            for (i = 0; i < mode->args.threads; i++)
+            // Only wait for the next connect that is due if no connect is
+            // being watched.
+            if (watched == 0)
             {
-                mutexobj_lock(&mode->mtxarr[i]);
-                if (mode->activesocks[i] > 0)
+                if ((fion.timeoutms > 0) &&
+                    (((open) && (opened < mode->args.maxcon)) || (inflight > 0)))
                 {
-                    mode->workerforms[i].tsus = tvus;
-                    formbytes = mode->workerforms[i].ops.form_body(&mode->workerforms[i]);
-                    output_if_std_send(mode->workerforms[i].dstbuf, formbytes);
-                    if ((stats.info.startusec == 0) ||
-                        (stats.info.startusec > mode->workerstats[i].info.startusec))
+                    threadobj_sleepusec(fion.timeoutms * 1000);
+                }
+            }
+            else if (fion.ops.fion_poll(&fion))
+            {
+                for (i = 0; i < fion.readycount; i++)
+                {
+                    if ((fion.ops.fion_getready(&fion, i, &fd) != 0) &&
+                        (fd >= 0) &&
+                        ((uint32_t)fd < vector_getsize(&fdslots)) &&
+                        (*(pos = (uint32_t *)vector_getval(&fdslots, (uint32_t)fd)) > 0))
                     {
-                        if (mode->workerstats[i].info.startusec > 0)
-                        {
-                            stats.info.startusec = mode->workerstats[i].info.startusec;
-                        }
+                        ramp[*pos - 1].ready = true;
                     }
-                    stats.info.recv.buflen.sum += mode->workerstats[i].info.recv.buflen.sum;
-                    stats.info.send.buflen.sum += mode->workerstats[i].info.send.buflen.sum;
                 }
-                mutexobj_unlock(&mode->mtxarr[i]);
             }
+        }
 
-            if (stats.info.startusec > 0)
+        // Give up on the connects still in flight if the connector was
+        // stopped.
+        for (i = 0; i < window; i++)
+        {
+            if ((sock = ramp[i].sock) != NULL)
             {
-                form.sock = &stats;
-                form.tsus = tvus;
-                form.intervalusec = mode->args.intervalusec;
-                formbytes = form.ops.form_body(&form);
-                if ((formbytes > 0) && (formbytes < form.dstlen))
+                modeperf_rampwatch(&fion, &fdslots, &ramp[i], i, false);
+
+                if ((sock->state & SOCKOBJ_STATE_CLOSE) == 0)
                 {
-                    *(char*)(form.dstbuf + formbytes)     = '\n';
-                    *(char*)(form.dstbuf + formbytes + 1) = '\0';
-                    formbytes++;
+                    sock->ops->sock_close(sock);
                 }
-                output_if_std_send(form.dstbuf, formbytes);
+
+                sock->ops->sock_destroy(sock);
+                modeperf_freesock(sock);
             }
         }
-        else
+
+        UTILMEM_FREE(ramp);
+        vector_destroy(&fdslots);
+        fion.ops.fion_destroy(&fion);
+    }
+
+    for (i = 0; i < mode->args.threads; i++)
+    {
+        config = 0xFFFFFFFF;
+        __atomic_compare_exchange_n(&mode->counters[i].configsocks,
+                                    &config,
+                                    0,
+                                    false,
+                                    __ATOMIC_SEQ_CST,
+                                    __ATOMIC_SEQ_CST);
+    }
+
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "Finished connecting sockets on thread id %u\n",
+                  tid);
+
+    return NULL;
+}
+
+/**
+ * @brief Add a value to a counter owned by the calling worker. A counter has a
+ *        single writer, so a relaxed load and store is enough (no locked
+ *        read-modify-write) and readers never see a torn value.
+ *
+ * @param[in,out] counter A pointer to a worker counter.
+ * @param[in]     val     The value to add.
+ *
+ * @return Void.
+ */
+static void modeperf_count(uint64_t * const counter, const uint64_t val)
+{
+    __atomic_store_n(counter,
+                     __atomic_load_n(counter, __ATOMIC_RELAXED) + val,
+                     __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Record a transaction latency in the histogram of the calling worker.
+ *
+ * @param[in,out] hist A pointer to a worker latency histogram.
+ * @param[in]     ns   A latency in nanoseconds.
+ *
+ * @return Void.
+ */
+static void modeperf_histrecord(struct modeperf_hist * const hist,
+                                const uint64_t ns)
+{
+    utilstats_histrecord(&hist->hist, ns);
+}
+
+/**
+ * @brief Take a snapshot of a worker latency histogram without a lock.
+ *
+ * @param[out] dst A pointer to a histogram snapshot.
+ * @param[in]  src A pointer to a worker latency histogram.
+ *
+ * @return Void.
+ */
+static void modeperf_histcopy(struct modeperf_hist * const dst,
+                              const struct modeperf_hist * const src)
+{
+    dst->lost = __atomic_load_n(&src->lost, __ATOMIC_RELAXED);
+    utilstats_histcopy(&dst->hist, &src->hist);
+}
+
+/**
+ * @brief Add the difference between two snapshots of a latency histogram to
+ *        another latency histogram.
+ *
+ * @param[in,out] dst  A pointer to a latency histogram.
+ * @param[in]     cur  A pointer to a histogram snapshot.
+ * @param[in]     prev A pointer to an earlier snapshot of the same histogram
+ *                     (NULL to add all of the current snapshot).
+ *
+ * @return Void.
+ */
+static void modeperf_histmerge(struct modeperf_hist * const dst,
+                               const struct modeperf_hist * const cur,
+                               const struct modeperf_hist * const prev)
+{
+    dst->lost += cur->lost - (prev == NULL ? 0 : prev->lost);
+    utilstats_histmerge(&dst->hist, &cur->hist, prev == NULL ? NULL : &prev->hist);
+}
+
+/**
+ * @brief Get the sample count and percentiles of a histogram.
+ *
+ * @param[in]  hist A pointer to a histogram.
+ * @param[out] lat  A pointer to sample statistics.
+ *
+ * @return Void.
+ */
+static void modeperf_histquantiles(const struct utilstats_hist * const hist,
+                                   struct sockobj_latency * const lat)
+{
+    const uint32_t permille[] = { 500, 900, 990, 999, 1000 };
+    uint64_t vals[sizeof(permille) / sizeof(permille[0])];
+
+    memset(lat, 0, sizeof(*lat));
+    lat->cnt  = utilstats_histget(hist,
+                                  permille,
+                                  vals,
+                                  sizeof(permille) / sizeof(permille[0]));
+    lat->p50  = vals[0];
+    lat->p90  = vals[1];
+    lat->p99  = vals[2];
+    lat->p999 = vals[3];
+    lat->max  = vals[4];
+}
+
+/**
+ * @brief Get the transaction count and latency percentiles of a histogram.
+ *
+ * @param[in]  hist A pointer to a latency histogram.
+ * @param[out] lat  A pointer to transaction latency statistics.
+ *
+ * @return Void.
+ */
+static void modeperf_histget(const struct modeperf_hist * const hist,
+                             struct sockobj_latency * const lat)
+{
+    modeperf_histquantiles(&hist->hist, lat);
+    lat->lost = hist->lost;
+}
+
+/**
+ * @brief Report the use of the object pools of the workers. A pool that ran
+ *        out of objects allocated the rest from the heap.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] form A pointer to a format object.
+ *
+ * @return Void.
+ */
+static void modeperf_reportpools(const struct modeobj_priv * const mode,
+                                 struct formobj * const form)
+{
+    const char *names[] = {"sockets", "nodes", "flows", "buffers"};
+    const struct mempool *pool = NULL;
+    struct mempool_stats stats, total;
+    uint32_t i, j;
+    int32_t formbytes;
+
+    for (j = 0; j < sizeof(names) / sizeof(names[0]); j++)
+    {
+        memset(&total, 0, sizeof(total));
+
+        for (i = 0; i < mode->args.threads; i++)
         {
-            switch (mode->args.arch)
+            pool = (j == 0 ? &mode->pools[i].socks :
+                    j == 1 ? &mode->pools[i].nodes :
+                    j == 2 ? &mode->pools[i].flows :
+                             &mode->pools[i].rrs);
+
+            if ((pool->priv != NULL) && (mempool_getstats(pool, &stats)))
             {
-                case SOCKOBJ_MODEL_CLIENT:
-                    if ((activesocks == 0) && (closedsocks == configsocks))
-                    {
-                        exit = true;
-                    }
-                    break;
-                case SOCKOBJ_MODEL_SERVER:
-                    mutexobj_lock(&mode->mtxarr[0]);
-                    formbytes = formobj_idle(&mode->workerforms[0]);
-                    output_if_std_send(mode->workerforms[0].dstbuf, formbytes);
-                    formbytes = utilstring_concat(mode->workerforms[0].dstbuf,
-                                                  mode->workerforms[0].dstlen,
-                                                  "%c",
-                                                  '\r');
-                    output_if_std_send(mode->workerforms[0].dstbuf, formbytes);
-                    mutexobj_unlock(&mode->mtxarr[0]);
-                    break;
-                default:
-                    exit = true;
-                    break;
+                total.count  += stats.count;
+                total.inuse  += stats.inuse;
+                total.peak   += stats.peak;
+                total.gets   += stats.gets;
+                total.misses += stats.misses;
+            }
+        }
+
+        if (total.count > 0)
+        {
+            formbytes = utilstring_concat(form->dstbuf,
+                                          form->dstlen,
+                                          "[pool %-7s] preallocated: %u in use: %u"
+                                          " peak: %u pooled: %" PRIu64
+                                          " heap: %" PRIu64 "\n",
+                                          names[j],
+                                          total.count,
+                                          total.inuse,
+                                          total.peak,
+                                          total.gets,
+                                          total.misses);
+
+            if (mode->args.format == ARGS_FORMAT_TEXT)
+            {
+                modeperf_output(mode, form->dstbuf, formbytes);
+            }
+            else
+            {
+                logger_printf(LOGGER_LEVEL_INFO, "%s: %s", __FUNCTION__, form->dstbuf);
             }
         }
+    }
+}
+
+/**
+ * @brief Begin or end an update of the worker state published to the reporter.
+ *        The worker never waits for the reporter, since the reporter retries
+ *        its snapshot if the state changed while it was being copied.
+ *
+ * @param[in,out] counters A pointer to the counters of the calling worker.
+ * @param[in]     begin    True to begin an update, false to end it.
+ *
+ * @return Void.
+ */
+static void modeperf_publish(struct modeperf_counters * const counters,
+                             const bool begin)
+{
+    uint32_t seq = __atomic_load_n(&counters->seq, __ATOMIC_RELAXED);
+
+    if (begin)
+    {
+        __atomic_store_n(&counters->seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    else
+    {
+        __atomic_store_n(&counters->seq, seq + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Sample the CPU time of the calling worker and publish it to the
+ *        reporter. The sample is taken outside of the update. The CPU time of
+ *        the thread and the real time are both measured from the first sample,
+ *        which the worker takes as it starts, so that the reporter can take
+ *        the CPU usage of any period between two samples.
+ *
+ * @param[in,out] counters A pointer to the counters of the calling worker.
+ *
+ * @return Void.
+ */
+static void modeperf_publishcpu(struct modeperf_counters * const counters)
+{
+    struct utilcpu_info cpu;
+
+    memset(&cpu, 0, sizeof(cpu));
+    cpu.startusec = (counters->cpu.startusec > 0 ?
+                     counters->cpu.startusec :
+                     utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC));
+    utilcpu_getinfo(&cpu);
+
+    modeperf_publish(counters, true);
+    counters->cpu = cpu;
+    modeperf_publish(counters, false);
+}
+
+/**
+ * @brief Get the CPU usage of a worker between two of its CPU samples.
+ *
+ * @param[in] cur  A pointer to a CPU sample of a worker.
+ * @param[in] prev A pointer to an earlier CPU sample of the same worker (zeroed
+ *                 for the usage since the worker started).
+ *
+ * @return The CPU usage as a percentage.
+ */
+static int16_t modeperf_getcpu(const struct utilcpu_info * const cur,
+                               const struct utilcpu_info * const prev)
+{
+    const uint64_t curus = (uint64_t)(cur->systime.tv_sec + cur->usrtime.tv_sec) * UNIT_TIME_USEC +
+                           (uint64_t)(cur->systime.tv_usec + cur->usrtime.tv_usec);
+    const uint64_t prevus = (uint64_t)(prev->systime.tv_sec + prev->usrtime.tv_sec) * UNIT_TIME_USEC +
+                            (uint64_t)(prev->systime.tv_usec + prev->usrtime.tv_usec);
+    const uint64_t currealus = (uint64_t)cur->realtime.tv_sec * UNIT_TIME_USEC +
+                               (uint64_t)cur->realtime.tv_usec;
+    const uint64_t prevrealus = (uint64_t)prev->realtime.tv_sec * UNIT_TIME_USEC +
+                                (uint64_t)prev->realtime.tv_usec;
+    uint64_t ret = 0;
+
+    if ((currealus > prevrealus) && (curus > prevus))
+    {
+        ret = (curus - prevus) * 100 / (currealus - prevrealus);
+    }
+
+    return (int16_t)(ret > INT16_MAX ? INT16_MAX : ret);
+}
+
+/**
+ * @brief Take a consistent snapshot of the counters and published state of a
+ *        worker without a lock, and update the worker totals from it. The CPU
+ *        usage is taken over the period since the previous snapshot.
+ *
+ * @param[in,out] mode    A pointer to a mode object.
+ * @param[in]     tid     A worker thread id.
+ * @param[in]     base    The counter values at the last worker totals reset.
+ * @param[out]    retries Incremented for each snapshot retry.
+ *
+ * @return Void.
+ */
+static void modeperf_getcounters(struct modeobj_priv * const mode,
+                                 const uint32_t tid,
+                                 const struct modeperf_counters * const base,
+                                 uint64_t * const retries)
+{
+    struct modeperf_counters *counters = &mode->counters[tid];
+    struct sockobj *stats = &mode->workerstats[tid];
+    struct utilcpu_info cpu = stats->cpu;
+    uint32_t seq;
+
+    stats->info.recv.buflen.sum = (int64_t)(__atomic_load_n(&counters->recvbytes,
+                                                            __ATOMIC_RELAXED) -
+                                            base->recvbytes);
+    stats->info.send.buflen.sum = (int64_t)(__atomic_load_n(&counters->sendbytes,
+                                                            __ATOMIC_RELAXED) -
+                                            base->sendbytes);
+    stats->info.syscalls = __atomic_load_n(&counters->syscalls,
+                                           __ATOMIC_RELAXED) -
+                           base->syscalls;
+    stats->info.datagrams = __atomic_load_n(&counters->datagrams,
+                                            __ATOMIC_RELAXED) -
+                            base->datagrams;
+    stats->info.zcsends = __atomic_load_n(&counters->zcsends,
+                                          __ATOMIC_RELAXED) -
+                          base->zcsends;
+    stats->info.zccopies = __atomic_load_n(&counters->zccopies,
+                                           __ATOMIC_RELAXED) -
+                           base->zccopies;
+
+    // Datagrams that were sent or received in batches or offload buffers are
+    // counted individually.
+    if (mode->args.type == SOCK_DGRAM)
+    {
+        stats->info.recv.buflen.cnt = (mode->args.arch == SOCKOBJ_MODEL_CLIENT ?
+                                       0 :
+                                       stats->info.datagrams);
+        stats->info.send.buflen.cnt = (mode->args.arch == SOCKOBJ_MODEL_CLIENT ?
+                                       stats->info.datagrams :
+                                       0);
+    }
+
+    for (;;)
+    {
+        seq = __atomic_load_n(&counters->seq, __ATOMIC_ACQUIRE);
+
+        if ((seq & 1) == 0)
+        {
+            stats->sid = counters->sid;
+            stats->cpu = counters->cpu;
+            stats->info.fairflows = counters->fairflows - base->fairflows;
+            stats->info.fairsum   = counters->fairsum - base->fairsum;
+            stats->info.fairsumsq = counters->fairsumsq - base->fairsumsq;
+
+            // Only take the times of the current run (totals are reset at the
+            // end of each run).
+            if (counters->startusec > base->startusec)
+            {
+                stats->info.startusec = counters->startusec;
+                stats->info.stopusec  = counters->stopusec;
+            }
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+            if (__atomic_load_n(&counters->seq, __ATOMIC_RELAXED) == seq)
+            {
+                break;
+            }
+        }
+
+        (*retries)++;
+    }
+
+    stats->cpu.usage = modeperf_getcpu(&stats->cpu, &cpu);
+}
+
+/**
+ * @brief Create the reporter snapshots of the latency histograms of the
+ *        workers.
+ *
+ * @param[in] hists   A pointer to the worker latency histograms (NULL if
+ *                    latencies are not measured).
+ * @param[in] threads The number of worker threads.
+ *
+ * @return A pointer to the histogram snapshots (NULL if unavailable).
+ */
+static struct modeperf_histsnap *modeperf_createsnap(const struct modeperf_hist * const hists,
+                                                     const uint32_t threads)
+{
+    struct modeperf_histsnap *ret = NULL;
+
+    if ((hists != NULL) &&
+        ((ret = UTILMEM_CALLOC(struct modeperf_histsnap,
+                               sizeof(struct modeperf_histsnap),
+                               1)) != NULL))
+    {
+        if ((ret->prev = UTILMEM_CALLOC(struct modeperf_hist,
+                                        sizeof(struct modeperf_hist),
+                                        threads * 2)) == NULL)
+        {
+            UTILMEM_FREE(ret);
+            ret = NULL;
+        }
+        else
+        {
+            ret->base = ret->prev + threads;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Destroy the reporter snapshots of the latency histograms of the
+ *        workers.
+ *
+ * @param[in,out] snap A pointer to the histogram snapshots (may be NULL).
+ *
+ * @return Void.
+ */
+static void modeperf_destroysnap(struct modeperf_histsnap * const snap)
+{
+    if (snap != NULL)
+    {
+        UTILMEM_FREE(snap->prev);
+        UTILMEM_FREE(snap);
+    }
+}
+
+/**
+ * @brief Take a snapshot of a latency histogram of a worker, update the
+ *        interval and run latencies of the worker from it, and add them to the
+ *        aggregate latencies.
+ *
+ * @param[in]     hists    A pointer to the worker latency histograms.
+ * @param[in]     tid      A worker thread id.
+ * @param[in,out] snap     A pointer to the reporter histogram snapshots.
+ * @param[out]    interval A pointer to the interval latencies of the worker.
+ * @param[out]    total    A pointer to the run latencies of the worker.
+ *
+ * @return Void.
+ */
+static void modeperf_gethists(const struct modeperf_hist * const hists,
+                              const uint32_t tid,
+                              struct modeperf_histsnap * const snap,
+                              struct sockobj_latency * const interval,
+                              struct sockobj_latency * const total)
+{
+    modeperf_histcopy(&snap->cur, &hists[tid]);
+
+    memset(&snap->diff, 0, sizeof(snap->diff));
+    modeperf_histmerge(&snap->diff, &snap->cur, &snap->prev[tid]);
+    modeperf_histmerge(&snap->interval, &snap->cur, &snap->prev[tid]);
+    modeperf_histget(&snap->diff, interval);
+
+    memset(&snap->diff, 0, sizeof(snap->diff));
+    modeperf_histmerge(&snap->diff, &snap->cur, &snap->base[tid]);
+    modeperf_histmerge(&snap->total, &snap->cur, &snap->base[tid]);
+    modeperf_histget(&snap->diff, total);
+
+    memcpy(&snap->prev[tid], &snap->cur, sizeof(snap->cur));
+}
+
+/**
+ * @brief Create the reporter snapshots of the stream flow histograms of the
+ *        workers.
+ *
+ * @param[in] hists   A pointer to the worker flow histograms (NULL if flows are
+ *                    not measured).
+ * @param[in] threads The number of worker threads.
+ *
+ * @return A pointer to the histogram snapshots (NULL if unavailable).
+ */
+static struct modeperf_flowsnap *modeperf_createflowsnap(const struct modeperf_flowhist * const hists,
+                                                         const uint32_t threads)
+{
+    struct modeperf_flowsnap *ret = NULL;
+
+    if ((hists != NULL) &&
+        ((ret = UTILMEM_CALLOC(struct modeperf_flowsnap,
+                               sizeof(struct modeperf_flowsnap),
+                               1)) != NULL))
+    {
+        if ((ret->base = UTILMEM_CALLOC(struct modeperf_flowhist,
+                                        sizeof(struct modeperf_flowhist),
+                                        threads)) == NULL)
+        {
+            UTILMEM_FREE(ret);
+            ret = NULL;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Destroy the reporter snapshots of the stream flow histograms of the
+ *        workers.
+ *
+ * @param[in,out] snap A pointer to the histogram snapshots (may be NULL).
+ *
+ * @return Void.
+ */
+static void modeperf_destroyflowsnap(struct modeperf_flowsnap * const snap)
+{
+    if (snap != NULL)
+    {
+        UTILMEM_FREE(snap->base);
+        UTILMEM_FREE(snap);
+    }
+}
+
+/**
+ * @brief Get the run statistics of the stream flows of a worker since its last
+ *        totals reset, add them to the aggregate histograms, and restart the
+ *        worker totals.
+ *
+ * @param[in]     hists A pointer to the worker flow histograms.
+ * @param[in]     tid   A worker thread id.
+ * @param[in,out] snap  A pointer to the reporter histogram snapshots.
+ * @param[out]    info  A pointer to the run statistics of the worker.
+ *
+ * @return Void.
+ */
+static void modeperf_getflowhists(const struct modeperf_flowhist * const hists,
+                                  const uint32_t tid,
+                                  struct modeperf_flowsnap * const snap,
+                                  struct sockobj_info * const info)
+{
+    utilstats_histcopy(&snap->cur.recvsize, &hists[tid].recvsize);
+    utilstats_histcopy(&snap->cur.sendsize, &hists[tid].sendsize);
+    utilstats_histcopy(&snap->cur.recvgap, &hists[tid].recvgap);
+    utilstats_histcopy(&snap->cur.sendgap, &hists[tid].sendgap);
+    utilstats_histcopy(&snap->cur.sendlate, &hists[tid].sendlate);
+
+    memset(&snap->diff, 0, sizeof(snap->diff));
+    utilstats_histmerge(&snap->diff.recvsize, &snap->cur.recvsize, &snap->base[tid].recvsize);
+    utilstats_histmerge(&snap->diff.sendsize, &snap->cur.sendsize, &snap->base[tid].sendsize);
+    utilstats_histmerge(&snap->diff.recvgap, &snap->cur.recvgap, &snap->base[tid].recvgap);
+    utilstats_histmerge(&snap->diff.sendgap, &snap->cur.sendgap, &snap->base[tid].sendgap);
+    utilstats_histmerge(&snap->diff.sendlate, &snap->cur.sendlate, &snap->base[tid].sendlate);
+
+    modeperf_histquantiles(&snap->diff.recvsize, &info->recvsize);
+    modeperf_histquantiles(&snap->diff.sendsize, &info->sendsize);
+    modeperf_histquantiles(&snap->diff.recvgap, &info->recvgap);
+    modeperf_histquantiles(&snap->diff.sendgap, &info->sendgap);
+    modeperf_histquantiles(&snap->diff.sendlate, &info->sendlate);
+
+    utilstats_histmerge(&snap->total.recvsize, &snap->diff.recvsize, NULL);
+    utilstats_histmerge(&snap->total.sendsize, &snap->diff.sendsize, NULL);
+    utilstats_histmerge(&snap->total.recvgap, &snap->diff.recvgap, NULL);
+    utilstats_histmerge(&snap->total.sendgap, &snap->diff.sendgap, NULL);
+    utilstats_histmerge(&snap->total.sendlate, &snap->diff.sendlate, NULL);
+
+    memcpy(&snap->base[tid], &snap->cur, sizeof(snap->cur));
+}
+
+/**
+ * @brief Merge the flow rankings that the workers published for their last
+ *        interval, and report the ranked flows. Only a few entries per worker
+ *        are merged, however many flows are worked. Rankings are not reported
+ *        again until a worker publishes a new one.
+ *
+ * @param[in]     mode    A pointer to a mode object.
+ * @param[in,out] form    A pointer to a format object.
+ * @param[in,out] top     A pointer to the merged flow ranking.
+ * @param[in,out] copy    A pointer to a flow ranking for worker snapshots.
+ * @param[in,out] gen     The sum of the ranking sequences of the last report.
+ * @param[out]    retries Incremented for each snapshot retry.
+ *
+ * @return Void.
+ */
+static void modeperf_reportflows(const struct modeobj_priv * const mode,
+                                 struct formobj * const form,
+                                 struct flowrank * const top,
+                                 struct flowrank * const copy,
+                                 uint64_t * const gen,
+                                 uint64_t * const retries)
+{
+    struct modeperf_flowtop *flowtop = NULL;
+    struct flowrank_entry *entry = NULL;
+    char goodput[16], latency[32], retrans[40];
+    uint64_t sum = 0;
+    uint32_t count, i, seq;
+    int32_t formbytes;
+
+    flowrank_clear(top);
+
+    for (i = 0; i < mode->args.threads; i++)
+    {
+        flowtop = &mode->flowtops[i];
+
+        for (;;)
+        {
+            seq = __atomic_load_n(&flowtop->seq, __ATOMIC_ACQUIRE);
+
+            if ((seq & 1) == 0)
+            {
+                copy->count = __atomic_load_n(&flowtop->ranked.count, __ATOMIC_RELAXED);
+                copy->count = (copy->count > copy->size ? copy->size : copy->count);
+                memcpy(copy->entries,
+                       flowtop->ranked.entries,
+                       sizeof(struct flowrank_entry) * copy->count);
+
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+                if (__atomic_load_n(&flowtop->seq, __ATOMIC_RELAXED) == seq)
+                {
+                    break;
+                }
+            }
+
+            (*retries)++;
+        }
+
+        sum += seq;
+        flowrank_merge(top, copy);
+    }
+
+    count = flowrank_sort(top);
+
+    if ((sum != *gen) && (count > 0))
+    {
+        *gen = sum;
+
+        for (i = 0; i < count; i++)
+        {
+            entry = &top->entries[i];
+            utilunit_getdecformat(10, 3, entry->goodputbps, goodput, sizeof(goodput));
+
+            latency[0] = retrans[0] = '\0';
+
+            // A stream flow has no transactions to time.
+            if (mode->args.workload != ARGS_WORKLOAD_STREAM)
+            {
+                utilstring_concat(latency,
+                                  sizeof(latency),
+                                  " latency usec: %.1f",
+                                  (double)entry->latencyns / 1000.0);
+            }
+
+            if (mode->args.rank == ARGS_RANK_RETRANS)
+            {
+                utilstring_concat(retrans,
+                                  sizeof(retrans),
+                                  " retransmits: %" PRIu64,
+                                  entry->retrans);
+            }
+
+            formbytes = utilstring_concat(form->dstbuf,
+                                          form->dstlen,
+                                          "[rank %4u] [%2u:%-4u] %s > %s goodput: %sbps%s%s\n",
+                                          i + 1,
+                                          entry->tid,
+                                          entry->sid,
+                                          entry->client,
+                                          entry->server,
+                                          goodput,
+                                          latency,
+                                          retrans);
+
+            modeperf_output(mode, form->dstbuf, formbytes);
+        }
+
+        formbytes = utilstring_concat(form->dstbuf, form->dstlen, "%c", '\n');
+        modeperf_output(mode, form->dstbuf, formbytes);
+    }
+}
+
+/**
+ * @brief Clear the counters of the aggregate statistics of all workers before
+ *        the counters of the workers are added. The start time and the
+ *        interval snapshots are kept.
+ *
+ * @param[in,out] stats A pointer to the aggregate statistics.
+ *
+ * @return Void.
+ */
+static void modeperf_clearstats(struct sockobj_info * const stats)
+{
+    stats->recv.buflen.sum = 0;
+    stats->send.buflen.sum = 0;
+    stats->recv.buflen.cnt = 0;
+    stats->send.buflen.cnt = 0;
+    stats->syscalls        = 0;
+    stats->datagrams       = 0;
+    stats->zcsends         = 0;
+    stats->zccopies        = 0;
+    stats->fairflows       = 0;
+    stats->fairsum         = 0.0;
+    stats->fairsumsq       = 0.0;
+}
+
+/**
+ * @brief Add the counters of a worker to the aggregate statistics of all
+ *        workers.
+ *
+ * @param[in,out] stats  A pointer to the aggregate statistics.
+ * @param[in]     worker A pointer to the statistics of a worker.
+ *
+ * @return Void.
+ */
+static void modeperf_addstats(struct sockobj_info * const stats,
+                              const struct sockobj_info * const worker)
+{
+    if ((worker->startusec > 0) &&
+        ((stats->startusec == 0) || (stats->startusec > worker->startusec)))
+    {
+        stats->startusec = worker->startusec;
+    }
+
+    if (stats->stopusec < worker->stopusec)
+    {
+        stats->stopusec = worker->stopusec;
+    }
+
+    stats->recv.buflen.sum += worker->recv.buflen.sum;
+    stats->send.buflen.sum += worker->send.buflen.sum;
+    stats->recv.buflen.cnt += worker->recv.buflen.cnt;
+    stats->send.buflen.cnt += worker->send.buflen.cnt;
+    stats->syscalls        += worker->syscalls;
+    stats->datagrams       += worker->datagrams;
+    stats->zcsends         += worker->zcsends;
+    stats->zccopies        += worker->zccopies;
+    stats->fairflows       += worker->fairflows;
+    stats->fairsum         += worker->fairsum;
+    stats->fairsumsq       += worker->fairsumsq;
+}
+
+/**
+ * @brief A socket statistics reporter.
+ *
+ * @param[in,out] arg A pointer to a mode object.
+ *
+ * @return NULL.
+ */
+static void *modeperf_reporterthread(void *arg)
+{
+    struct modeobj_priv *mode = (struct modeobj_priv*)arg;
+    struct threadobj *thread = threadpool_getthread(&mode->threadpool);
+    struct sockobj stats;
+    struct formobj form;
+    struct modeperf_counters *base = NULL;
+    struct modeperf_histsnap *snap = NULL, *connsnap = NULL;
+    struct modeperf_flowsnap *flowsnap = NULL;
+    struct flowrank top, copy;
+    bool exit = false, active = false;
+    uint32_t activesocks, configsocks, closedsocks, i;
+    int32_t formbytes;
+    uint64_t rankgen = 0, retries = 0, snapus = 0, tvus;
+    // The flows of each worker are indexed by five-tuple and by flow id in
+    // the worker, which ranks its top-N flows (see modeperf_rankflow()), so
+    // the reporter only merges a few entries per worker.
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "Started reporting sockets on thread id %u\n",
+                  threadpool_getid(&mode->threadpool));
+
+    memset(&stats, 0, sizeof(stats));
+    memset(&form, 0, sizeof(form));
+    memset(&top, 0, sizeof(top));
+    memset(&copy, 0, sizeof(copy));
+    modeperf_copy(mode, &stats, 0);
+    modeperf_createform(mode, &form);
+
+    form.aggregate = true;
+    stats.tid = mode->args.threads;
+    base = UTILMEM_CALLOC(struct modeperf_counters,
+                          sizeof(struct modeperf_counters),
+                          mode->args.threads);
+
+    snap = modeperf_createsnap(mode->hists, mode->args.threads);
+    connsnap = modeperf_createsnap(mode->connhists, mode->args.threads);
+    flowsnap = modeperf_createflowsnap(mode->flowhists, mode->args.threads);
+
+    exit = ((base == NULL) ||
+            ((mode->hists != NULL) && (snap == NULL)) ||
+            ((mode->connhists != NULL) && (connsnap == NULL)) ||
+            ((mode->flowhists != NULL) && (flowsnap == NULL)));
+
+    // Flow rankings are only listed in a terminal report.
+    if ((!exit) &&
+        (mode->flowtops != NULL) &&
+        (mode->args.format == ARGS_FORMAT_TEXT))
+    {
+        exit = !(flowrank_create(&top,
+                                 mode->args.top,
+                                 mode->args.rank == ARGS_RANK_SLOWEST) &&
+                 flowrank_create(&copy,
+                                 mode->args.top,
+                                 mode->args.rank == ARGS_RANK_SLOWEST));
+    }
+
+    for (i = 0; i < mode->args.threads; i++)
+    {
+        modeperf_createform(mode, &mode->workerforms[i]);
+        modeperf_copy(mode, &mode->workerstats[i], 0);
+        mode->workerforms[i].sock = &mode->workerstats[i];
+        mode->workerforms[i].intervalusec = mode->args.intervalusec;
+        mode->workerstats[i].tid = i;
+
+        if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
+        {
+            utilstring_concat(mode->workerstats[i].addrself.sockaddrstr,
+                              sizeof(mode->workerstats[i].addrself.sockaddrstr),
+                              "%s:*",
+                              mode->args.ipaddr);
+            utilstring_concat(mode->workerstats[i].addrpeer.sockaddrstr,
+                              sizeof(mode->workerstats[i].addrpeer.sockaddrstr),
+                              "%s:%u",
+                              mode->args.ipaddr,
+                              mode->args.ipport);
+        }
+    }
+
+    while (!exit && threadobj_isrunning(thread))
+    {
+        activesocks = 0;
+        closedsocks = 0;
+        configsocks = 0;
+        stats.cpu.usage = 0;
+
+        // Snapshot all workers up front, and then format the reports from
+        // the snapshots without touching any worker state.
+        tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+        if (snap != NULL)
+        {
+            memset(&snap->interval, 0, sizeof(snap->interval));
+            memset(&snap->total, 0, sizeof(snap->total));
+        }
+
+        if (connsnap != NULL)
+        {
+            memset(&connsnap->interval, 0, sizeof(connsnap->interval));
+            memset(&connsnap->total, 0, sizeof(connsnap->total));
+        }
+
+        for (i = 0; i < mode->args.threads; i++)
+        {
+            activesocks += __atomic_load_n(&mode->counters[i].activesocks, __ATOMIC_SEQ_CST);
+            closedsocks += __atomic_load_n(&mode->counters[i].closedsocks, __ATOMIC_SEQ_CST);
+            configsocks += __atomic_load_n(&mode->counters[i].configsocks, __ATOMIC_SEQ_CST);
+            modeperf_getcounters(mode, i, &base[i], &retries);
+            stats.conf.datalimitbyte = mode->args.datalimitbyte * configsocks;
+            stats.cpu.usage += mode->workerstats[i].cpu.usage;
+
+            if (snap != NULL)
+            {
+                modeperf_gethists(mode->hists,
+                                  i,
+                                  snap,
+                                  &mode->workerstats[i].info.rr,
+                                  &mode->workerstats[i].info.rrtotal);
+            }
+
+            if (connsnap != NULL)
+            {
+                modeperf_gethists(mode->connhists,
+                                  i,
+                                  connsnap,
+                                  &mode->workerstats[i].info.conn,
+                                  &mode->workerstats[i].info.conntotal);
+            }
+        }
+
+        if (snap != NULL)
+        {
+            modeperf_histget(&snap->interval, &stats.info.rr);
+            modeperf_histget(&snap->total, &stats.info.rrtotal);
+        }
+
+        if (connsnap != NULL)
+        {
+            modeperf_histget(&connsnap->interval, &stats.info.conn);
+            modeperf_histget(&connsnap->total, &stats.info.conntotal);
+        }
+
+        tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC) - tvus;
+        snapus = (tvus > snapus ? tvus : snapus);
+
+        logger_printf(LOGGER_LEVEL_INFO,
+                      "%s: socket counts: active %u closed %u config %u\n",
+                      __FUNCTION__,
+                      activesocks,
+                      closedsocks,
+                      configsocks);
+
+        stats.sid = activesocks;
+
+        if ((!active) && (activesocks > 0))
+        {
+            // The CPU usage of a run is taken from the samples at its start.
+            for (i = 0; i < mode->args.threads; i++)
+            {
+                base[i].cpu = mode->workerstats[i].cpu;
+            }
+
+            formbytes = mode->workerforms[0].ops.form_head(&mode->workerforms[0]);
+            modeperf_output(mode, mode->workerforms[0].dstbuf, formbytes);
+        }
+        else if ((active) && (activesocks == 0))
+        {
+            tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+            modeperf_clearstats(&stats.info);
+            stats.cpu.usage = 0;
+            if (flowsnap != NULL)
+            {
+                memset(&flowsnap->total, 0, sizeof(flowsnap->total));
+            }
+            for (i = 0; i < mode->args.threads; i++)
+            {
+                if (mode->workerstats[i].info.startusec > 0)
+                {
+                    modeperf_addstats(&stats.info, &mode->workerstats[i].info);
+                    mode->workerstats[i].cpu.usage = modeperf_getcpu(&mode->workerstats[i].cpu,
+                                                                     &base[i].cpu);
+                    stats.cpu.usage += mode->workerstats[i].cpu.usage;
+
+                    if (flowsnap != NULL)
+                    {
+                        modeperf_getflowhists(mode->flowhists,
+                                              i,
+                                              flowsnap,
+                                              &mode->workerstats[i].info);
+                    }
+
+                    formbytes = mode->workerforms[i].ops.form_foot(&mode->workerforms[i]);
+                    modeperf_output(mode, mode->workerforms[i].dstbuf, formbytes);
+
+                    // Restart the worker totals from the reported counters.
+                    base[i].recvbytes += (uint64_t)mode->workerstats[i].info.recv.buflen.sum;
+                    base[i].sendbytes += (uint64_t)mode->workerstats[i].info.send.buflen.sum;
+                    base[i].syscalls  += mode->workerstats[i].info.syscalls;
+                    base[i].datagrams += mode->workerstats[i].info.datagrams;
+                    base[i].zcsends   += mode->workerstats[i].info.zcsends;
+                    base[i].zccopies  += mode->workerstats[i].info.zccopies;
+                    base[i].fairflows += mode->workerstats[i].info.fairflows;
+                    base[i].fairsum   += mode->workerstats[i].info.fairsum;
+                    base[i].fairsumsq += mode->workerstats[i].info.fairsumsq;
+                    base[i].startusec  = mode->workerstats[i].info.startusec;
+                    if (snap != NULL)
+                    {
+                        memcpy(&snap->base[i], &snap->prev[i], sizeof(snap->prev[i]));
+                    }
+                    if (connsnap != NULL)
+                    {
+                        memcpy(&connsnap->base[i], &connsnap->prev[i], sizeof(connsnap->prev[i]));
+                    }
+                    memset(&mode->workerstats[i].info, 0, sizeof(mode->workerstats[i].info));
+                }
+            }
+
+            if (flowsnap != NULL)
+            {
+                modeperf_histquantiles(&flowsnap->total.recvsize, &stats.info.recvsize);
+                modeperf_histquantiles(&flowsnap->total.sendsize, &stats.info.sendsize);
+                modeperf_histquantiles(&flowsnap->total.recvgap, &stats.info.recvgap);
+                modeperf_histquantiles(&flowsnap->total.sendgap, &stats.info.sendgap);
+                modeperf_histquantiles(&flowsnap->total.sendlate, &stats.info.sendlate);
+            }
+
+            if (stats.info.startusec > 0)
+            {
+                form.sock = &stats;
+                form.tsus = tvus;
+                form.intervalusec = mode->args.intervalusec;
+                formbytes = form.ops.form_foot(&form);
+                modeperf_output(mode, form.dstbuf, formbytes);
+                memset(&stats.info, 0, sizeof(stats.info));
+            }
+        }
+
+        active = (activesocks > 0);
+
+        if (active)
+        {
+            tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+            modeperf_clearstats(&stats.info);
+            for (i = 0; i < mode->args.threads; i++)
+            {
+                if (__atomic_load_n(&mode->counters[i].activesocks, __ATOMIC_SEQ_CST) > 0)
+                {
+                    mode->workerforms[i].tsus = tvus;
+                    formbytes = mode->workerforms[i].ops.form_body(&mode->workerforms[i]);
+                    modeperf_output(mode, mode->workerforms[i].dstbuf, formbytes);
+                    modeperf_addstats(&stats.info, &mode->workerstats[i].info);
+                }
+            }
+
+            if (stats.info.startusec > 0)
+            {
+                form.sock = &stats;
+                form.tsus = tvus;
+                form.intervalusec = mode->args.intervalusec;
+                formbytes = form.ops.form_body(&form);
+                if ((mode->args.format == ARGS_FORMAT_TEXT) &&
+                    (formbytes > 0) &&
+                    (formbytes < form.dstlen))
+                {
+                    *(char*)(form.dstbuf + formbytes)     = '\n';
+                    *(char*)(form.dstbuf + formbytes + 1) = '\0';
+                    formbytes++;
+                }
+                modeperf_output(mode, form.dstbuf, formbytes);
+            }
+
+            if (top.entries != NULL)
+            {
+                modeperf_reportflows(mode, &form, &top, &copy, &rankgen, &retries);
+            }
+        }
+        else
+        {
+            switch (mode->args.arch)
+            {
+                case SOCKOBJ_MODEL_CLIENT:
+                    if ((activesocks == 0) && (closedsocks == configsocks))
+                    {
+                        exit = true;
+                    }
+                    break;
+                case SOCKOBJ_MODEL_SERVER:
+                    // Only a terminal report shows that a server is idle.
+                    if (mode->args.format == ARGS_FORMAT_TEXT)
+                    {
+                        formbytes = formobj_idle(&mode->workerforms[0]);
+                        modeperf_output(mode, mode->workerforms[0].dstbuf, formbytes);
+                        formbytes = utilstring_concat(mode->workerforms[0].dstbuf,
+                                                      mode->workerforms[0].dstlen,
+                                                      "%c",
+                                                      '\r');
+                        modeperf_output(mode, mode->workerforms[0].dstbuf, formbytes);
+                    }
+                    break;
+                default:
+                    exit = true;
+                    break;
+            }
+        }
+
+        threadobj_sleepusec(1000000);
+    }
+
+    if ((mode->tuples != NULL) && (mode->args.format == ARGS_FORMAT_TEXT))
+    {
+        modeperf_reporttuples(mode, &form);
+    }
+
+    modeperf_reportpools(mode, &form);
+
+    for (i = 0; i < mode->args.threads; i++)
+    {
+        mode->workerforms[i].ops.form_destroy(&mode->workerforms[i]);
+    }
+
+    form.ops.form_destroy(&form);
+    UTILMEM_FREE(base);
+
+    modeperf_destroysnap(snap);
+    modeperf_destroysnap(connsnap);
+    modeperf_destroyflowsnap(flowsnap);
+    flowrank_destroy(&top);
+    flowrank_destroy(&copy);
+
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "%s: snapshot retries %" PRIu64 " max snapshot time usec %" PRIu64 "\n",
+                  __FUNCTION__,
+                  retries,
+                  snapus);
+
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "Finished reporting sockets on thread id %u\n",
+                  threadpool_getid(&mode->threadpool));
+
+    return NULL;
+}
+
+/**
+ * @brief Log the final statistics of a closed mode socket and update the
+ *        worker statistics.
+ *
+ * @param[in,out] mode  A pointer to a mode object.
+ * @param[in]     sock  A pointer to a closed socket object.
+ * @param[in]     stats Function-specific socket statistics.
+ * @param[in]     tid   A worker thread id.
+ * @param[in]     last  True if the socket is the last socket of the worker.
+ *
+ * @return Void.
+ */
+static void modeperf_endsock(struct modeobj_priv * const mode,
+                             const struct sockobj * const sock,
+                             const struct sockobj_flowstats * const stats,
+                             const uint32_t tid,
+                             const bool last)
+{
+    struct utilcpu_info info;
+    double goodput = 0.0;
+
+    // The goodputs of the sockets of a run show how fairly the sockets
+    // shared a rate limit (or the network).
+    if (sock->info.stopusec > sock->info.startusec)
+    {
+        goodput = (double)(sock->info.recv.buflen.sum + sock->info.send.buflen.sum) *
+                  8.0 * (double)UNIT_TIME_USEC /
+                  (double)(sock->info.stopusec - sock->info.startusec);
+    }
+
+    if ((last) || (goodput > 0.0))
+    {
+        modeperf_publish(&mode->counters[tid], true);
+
+        if (last)
+        {
+            mode->counters[tid].stopusec = sock->info.stopusec;
+        }
+
+        if (goodput > 0.0)
+        {
+            mode->counters[tid].fairflows++;
+            mode->counters[tid].fairsum   += goodput;
+            mode->counters[tid].fairsumsq += goodput * goodput;
+        }
+
+        modeperf_publish(&mode->counters[tid], false);
+    }
+
+    utilcpu_getinfo(&info);
+    logger_printf(LOGGER_LEVEL_DEBUG,
+                  "%s: tid: %u cpu load: %d usr/sys time sec: %u.%06u / %u.%06u\n",
+                  __FUNCTION__,
+                  tid,
+                  info.usage,
+                  info.usrtime.tv_sec,
+                  info.usrtime.tv_usec,
+                  info.systime.tv_sec,
+                  info.systime.tv_usec);
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "%s: buflen avg/min/max: %" PRIi64
+                  " / %" PRIi64
+                  " / %" PRIi64 "\n",
+                  __FUNCTION__,
+                  utilstats_getavg(&stats->buflen),
+                  stats->buflen.min,
+                  stats->buflen.max);
+}
+
+/**
+ * @brief Get the flow statistics of a mode socket for its direction of
+ *        transfer.
+ *
+ * @param[in]     mode A pointer to a mode object.
+ * @param[in,out] sock A pointer to a socket object.
+ *
+ * @return A pointer to the flow statistics.
+ */
+static struct sockobj_flowstats *modeperf_getstats(
+    const struct modeobj_priv * const mode,
+    struct sockobj * const sock)
+{
+    return (sockobj_issender(mode->args.arch, mode->args.direction) ?
+            &sock->info.send :
+            &sock->info.recv);
+}
+
+/**
+ * @brief Queue the next receive or send request of an io_uring engine flow.
+ *        A request that cannot be queued yet (e.g., a connection is still in
+ *        progress or the token bucket is empty) is deferred.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] engine A pointer to an io_uring engine.
+ * @param[in,out] flow   A pointer to an io_uring engine flow.
+ *
+ * @return True if a request was queued or deferred, false if the flow reached
+ *         its data limit.
+ */
+static bool modeperf_uringarm(struct modeobj_priv * const mode,
+                              struct modeperf_uring * const engine,
+                              struct modeperf_flow * const flow)
+{
+    bool ret = true, queued = false;
+    struct sockobj *sock = flow->sock;
+    uint64_t data = (uint64_t)(uintptr_t)flow, delayus, len = 0, tsus;
+
+    if ((sock->state & SOCKOBJ_STATE_CONNECT) == 0)
+    {
+        // Do nothing.
+    }
+    else if ((mode->args.arch == SOCKOBJ_MODEL_SERVER) &&
+             ((engine->ring.features & URINGOBJ_FEATURE_MULTISHOT) != 0) &&
+             ((engine->ring.features & URINGOBJ_FEATURE_BUFRING) != 0) &&
+             (!modeperf_ispaced(mode, sock)) &&
+             (mode->args.datalimitbyte == 0))
+    {
+        // A single multishot request receives until the flow is closed.
+        queued = uringobj_recvmulti(&engine->ring,
+                                    sock->fd,
+                                    MODEPERF_URING_GROUP,
+                                    data | MODEPERF_URINGOP_RECV);
+    }
+    else if ((len = modeperf_getlen(mode,
+                                    modeperf_getstats(mode, sock),
+                                    sock,
+                                    mode->args.buflen,
+                                    true)) == 0)
+    {
+        if ((mode->args.datalimitbyte > 0) &&
+            ((uint64_t)modeperf_getstats(mode, sock)->buflen.sum >= mode->args.datalimitbyte))
+        {
+            ret = false;
+        }
+        else if (modeperf_ispaced(mode, sock))
+        {
+            tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+            delayus = modeperf_getrelease(mode, sock, tsus);
+            delayus = (delayus > 0 ? delayus - tsus : 0);
+
+            if ((delayus < engine->mindelayus) || (engine->mindelayus == 0))
+            {
+                engine->mindelayus = delayus;
+            }
+        }
+    }
+    else if ((mode->args.arch == SOCKOBJ_MODEL_SERVER) &&
+             ((engine->ring.features & URINGOBJ_FEATURE_FIXEDBUFS) == 0))
+    {
+        queued = uringobj_recv(&engine->ring,
+                               sock->fd,
+                               engine->recvbuf,
+                               (uint32_t)len,
+                               data | MODEPERF_URINGOP_RECV);
+    }
+    else if (mode->args.arch == SOCKOBJ_MODEL_SERVER)
+    {
+        queued = uringobj_readfixed(&engine->ring,
+                                    sock->fd,
+                                    engine->recvbuf,
+                                    (uint32_t)len,
+                                    0,
+                                    data | MODEPERF_URINGOP_RECV);
+    }
+    else
+    {
+        queued = uringobj_send(&engine->ring,
+                               sock->fd,
+                               engine->sendbuf,
+                               (uint32_t)len,
+                               MSG_NOSIGNAL,
+                               data | MODEPERF_URINGOP_SEND);
+    }
+
+    if (queued)
+    {
+        flow->inflight++;
+        flow->reqlen = (uint32_t)len;
+
+        if (flow->deferred)
+        {
+            flow->deferred = false;
+            engine->deferred--;
+        }
+    }
+    else
+    {
+        if (len > 0)
+        {
+            modeperf_return(mode, sock, len * 8);
+        }
+
+        if ((ret) && (!flow->deferred))
+        {
+            flow->deferred = true;
+            engine->deferred++;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Close an io_uring engine flow once it has no requests in flight and
+ *        return its socket to the mode object.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] engine A pointer to an io_uring engine.
+ * @param[in,out] flow   A pointer to an io_uring engine flow.
+ * @param[in]     tid    A worker thread id.
+ *
+ * @return Void.
+ */
+static void modeperf_uringclose(struct modeobj_priv * const mode,
+                                struct modeperf_uring * const engine,
+                                struct modeperf_flow * const flow,
+                                const uint32_t tid)
+{
+    struct sockobj *sock = flow->sock;
+
+    if (flow->deferred)
+    {
+        flow->deferred = false;
+        engine->deferred--;
+    }
+
+    if (flow->inflight > 0)
+    {
+        // Wait for the cancellation completions before releasing the flow.
+        if (!flow->closing)
+        {
+            uringobj_cancel(&engine->ring,
+                            (uint64_t)(uintptr_t)flow | MODEPERF_URINGOP_RECV);
+            uringobj_cancel(&engine->ring,
+                            (uint64_t)(uintptr_t)flow | MODEPERF_URINGOP_SEND);
+        }
+
+        flow->closing = true;
+    }
+    else
+    {
+        if ((sock->state & SOCKOBJ_STATE_CLOSE) == 0)
+        {
+            sock->ops->sock_close(sock);
+            sock->ops->sock_destroy(sock);
+        }
+
+        modeperf_endsock(mode,
+                         sock,
+                         modeperf_getstats(mode, sock),
+                         tid,
+                         engine->list.size == 1);
+        modeperf_retsock(mode, sock, tid);
+        dlist_remove(&engine->list, flow->node);
+        mempool_free(engine->flows, flow);
+    }
+}
+
+/**
+ * @brief Handle a completion of an io_uring engine flow request.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] engine A pointer to an io_uring engine.
+ * @param[in]     cqe    A pointer to a completion queue entry.
+ * @param[in]     tid    A worker thread id.
+ * @param[in]     tsus   The current Unix time in microseconds.
+ *
+ * @return Void.
+ */
+static void modeperf_uringcomplete(struct modeobj_priv * const mode,
+                                   struct modeperf_uring * const engine,
+                                   const struct uringobj_cqe * const cqe,
+                                   const uint32_t tid,
+                                   const uint64_t tsus)
+{
+    struct modeperf_flow *flow = NULL;
+    struct sockobj *sock = NULL;
+    struct sockobj_flowstats *stats = NULL;
+    bool close = false;
+
+    if (cqe->data == MODEPERF_URINGOP_BELL)
+    {
+        // The doorbell poll request is single shot.
+        engine->bellpoll = false;
+    }
+    else if (cqe->data == MODEPERF_URINGOP_LSTN)
+    {
+        // The listener poll request is single shot.
+        engine->listenpoll = false;
+        engine->accept     = (cqe->res > 0);
+    }
+    else if (cqe->data != 0)
+    {
+        flow  = (struct modeperf_flow *)(uintptr_t)(cqe->data & ~(uint64_t)MODEPERF_URINGOP_MASK);
+        sock  = flow->sock;
+        stats = ((cqe->data & MODEPERF_URINGOP_MASK) == MODEPERF_URINGOP_RECV ?
+                 &sock->info.recv :
+                 &sock->info.send);
+
+        if ((cqe->flags & URINGOBJ_CQEFLAG_MORE) == 0)
+        {
+            flow->inflight--;
+        }
+
+        if (cqe->res > 0)
+        {
+            utilstats_add(&stats->buflen, cqe->res);
+
+            if (sock->conf.type == SOCK_DGRAM)
+            {
+                engine->datagrams++;
+            }
+
+            if (stats == &sock->info.recv)
+            {
+                engine->recvbytes += (uint64_t)cqe->res;
+                uringobj_returnbuf(&engine->ring, cqe);
+            }
+            else
+            {
+                engine->sendbytes += (uint64_t)cqe->res;
+            }
+
+            if (flow->reqlen > (uint32_t)cqe->res)
+            {
+                modeperf_return(mode,
+                                sock,
+                                (uint64_t)(flow->reqlen - cqe->res) * 8);
+            }
+
+            flow->reqlen = 0;
+        }
+        else if ((cqe->res == 0) && (sock->conf.type == SOCK_STREAM))
+        {
+            // The remote peer closed the connection.
+            close = true;
+        }
+        else if ((cqe->res == 0) ||
+                 (cqe->res == -ENOBUFS) ||
+                 (cqe->res == -EAGAIN) ||
+                 (cqe->res == -EINTR) ||
+                 (cqe->res == -ECANCELED))
+        {
+            // Do nothing.
+        }
+        else if ((cqe->res == -EINVAL) &&
+                 (engine->ring.features & URINGOBJ_FEATURE_MULTISHOT))
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: multishot receive is not supported\n",
+                          __FUNCTION__);
+            engine->ring.features &= ~URINGOBJ_FEATURE_MULTISHOT;
+        }
+        else
+        {
+            logger_printf(LOGGER_LEVEL_DEBUG,
+                          "%s: socket %u request failed (%d)\n",
+                          __FUNCTION__,
+                          sock->sid,
+                          -cqe->res);
+            close = true;
+        }
+
+        if ((close) ||
+            (flow->closing) ||
+            (modeperf_islimit(mode, stats, sock, tsus)))
+        {
+            modeperf_uringclose(mode, engine, flow, tid);
+        }
+        else if ((flow->inflight == 0) &&
+                 (!modeperf_uringarm(mode, engine, flow)))
+        {
+            modeperf_uringclose(mode, engine, flow, tid);
+        }
+    }
+}
+
+/**
+ * @brief Work the sockets of a performance mode worker thread using an io_uring
+ *        engine that keeps a receive or send request in flight for every flow
+ *        and reaps completions in batches.
+ *
+ * @param[in,out] mode    A pointer to a mode object.
+ * @param[in,out] thread  A pointer to the worker thread.
+ * @param[in]     tid     A worker thread id.
+ * @param[in,out] recvbuf A pointer to a receive buffer.
+ * @param[in,out] sendbuf A pointer to a send buffer.
+ *
+ * @return False if the io_uring engine could not be started.
+ */
+static bool modeperf_uringworker(struct modeobj_priv * const mode,
+                                 struct threadobj * const thread,
+                                 const uint32_t tid,
+                                 uint8_t * const recvbuf,
+                                 uint8_t * const sendbuf)
+{
+    bool ret = false, exit = false;
+    struct modeperf_uring engine;
+    struct modeperf_flow *flow = NULL;
+    struct uringobj_cqe *cqes = NULL;
+    struct dlist_node *next = NULL, *node = NULL;
+    struct sockobj *sock = NULL;
+    struct iovec iov;
+    uint32_t bufcount = 2, count = 0, i, n;
+    uint64_t acceptus = 0, sweepus = 0, tsus = 0, waitus;
+    uint32_t burstlimit = mode->args.backlog <= 0 ? SOMAXCONN : mode->args.backlog;
+    int32_t listenfd = -1;
+
+    memset(&engine, 0, sizeof(engine));
+    engine.list.pool = &mode->pools[tid].nodes;
+    engine.flows     = &mode->pools[tid].flows;
+    engine.bell      = &mode->bells[tid];
+    engine.listener  = modeperf_getlistener(mode, tid);
+    engine.accept    = (engine.listener != NULL);
+    engine.recvbuf   = recvbuf;
+    engine.sendbuf   = sendbuf;
+    iov.iov_base     = recvbuf;
+    iov.iov_len      = mode->args.buflen;
+
+    // Size the provided buffer ring to a power of two within a memory budget.
+    while ((bufcount < MODEPERF_URING_BUFMAX) &&
+           ((uint64_t)bufcount * 2 * mode->args.buflen <= MODEPERF_URING_BUFMEM))
+    {
+        bufcount *= 2;
+    }
+
+    if ((cqes = UTILMEM_CALLOC(struct uringobj_cqe,
+                               sizeof(struct uringobj_cqe),
+                               MODEPERF_URING_BATCH)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: completion buffer allocation failed\n",
+                      __FUNCTION__);
+    }
+    else if (!uringobj_create(&engine.ring, MODEPERF_URING_ENTRIES))
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: io_uring is unavailable, falling back to %s\n",
+                      __FUNCTION__,
+                      "the poll engine");
+    }
+    else
+    {
+        ret = true;
+
+        // A server receives into the provided buffer ring with multishot
+        // requests, and otherwise into its receive buffer, which is
+        // registered if the kernel allows it (a plain receive is used if not).
+        if (mode->args.arch == SOCKOBJ_MODEL_SERVER)
+        {
+            uringobj_registerbufs(&engine.ring, &iov, 1);
+
+            if (engine.ring.features & URINGOBJ_FEATURE_MULTISHOT)
+            {
+                uringobj_createbufring(&engine.ring,
+                                       MODEPERF_URING_GROUP,
+                                       (uint16_t)bufcount,
+                                       (uint32_t)mode->args.buflen);
+            }
+        }
+
+        logger_printf(LOGGER_LEVEL_INFO,
+                      "%s: io_uring engine on thread id %u (features 0x%x)\n",
+                      __FUNCTION__,
+                      tid,
+                      engine.ring.features);
+
+        while ((!exit) && (threadobj_isrunning(thread)))
+        {
+            // Accept when the listener is ready, and periodically while
+            // completions keep the engine from waiting.
+            if ((engine.listener != NULL) &&
+                ((engine.accept) || (tsus - acceptus >= MODEPERF_ACCEPTUS)))
+            {
+                acceptus = tsus;
+                listenfd = engine.listener->fd;
+                engine.accept = (modeperf_acceptshard(mode,
+                                                      tid,
+                                                      engine.listener,
+                                                      burstlimit) == burstlimit);
+
+                // A datagram listener was handed to the accepted socket, so
+                // the poll request on its file descriptor is stale.
+                if ((engine.listener->fd != listenfd) && (engine.listenpoll))
+                {
+                    uringobj_cancel(&engine.ring, MODEPERF_URINGOP_LSTN);
+                }
+            }
+
+            for (n = 0; (!exit) && (n < MODEPERF_URING_BATCH); n++)
+            {
+                if ((sock = modeperf_getsock(mode, tid, &exit)) == NULL)
+                {
+                    break;
+                }
+                else if (((mode->args.maxcon > 0) &&
+                          (engine.list.size >= mode->args.maxcon)) ||
+                         ((flow = (struct modeperf_flow *)mempool_get(engine.flows)) == NULL) ||
+                         (!dlist_inserttail(&engine.list, flow)))
+                {
+                    // Refuse connection.
+                    mempool_free(engine.flows, flow);
+                    flow = NULL;
+                    sock->ops->sock_close(sock);
+                    sock->ops->sock_destroy(sock);
+                    modeperf_retsock(mode, sock, tid);
+                }
+                else
+                {
+                    flow->sock = sock;
+                    flow->node = engine.list.tail;
+                    sock->tid  = tid;
+
+                    modeperf_publish(&mode->counters[tid], true);
+                    mode->counters[tid].sid = ++count;
+                    if (engine.list.size == 1)
+                    {
+                        mode->counters[tid].startusec = sock->info.startusec;
+                        mode->counters[tid].stopusec  = 0;
+                    }
+                    modeperf_publish(&mode->counters[tid], false);
+
+                    if (!modeperf_uringarm(mode, &engine, flow))
+                    {
+                        modeperf_uringclose(mode, &engine, flow, tid);
+                    }
+                }
+            }
+
+            tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+            // Retry deferred requests and enforce time limits on idle flows
+            // without visiting every flow on every pass.
+            if ((engine.deferred > 0) ||
+                (tsus - sweepus >= MODEPERF_URING_SWEEPUS))
+            {
+                engine.mindelayus = 0;
+                node = engine.list.head;
+
+                while (node != NULL)
+                {
+                    next = node->next;
+                    flow = node->val;
+                    sock = flow->sock;
+
+                    if (flow->closing)
+                    {
+                        // Do nothing.
+                    }
+                    else if (modeperf_islimit(mode,
+                                              modeperf_getstats(mode, sock),
+                                              sock,
+                                              tsus))
+                    {
+                        modeperf_uringclose(mode, &engine, flow, tid);
+                    }
+                    else if (((sock->state & SOCKOBJ_STATE_CONNECT) == 0) &&
+                             (!sock->ops->sock_connect(sock)))
+                    {
+                        if (!flow->deferred)
+                        {
+                            flow->deferred = true;
+                            engine.deferred++;
+                        }
+                    }
+                    else if ((flow->inflight == 0) &&
+                             (!modeperf_uringarm(mode, &engine, flow)))
+                    {
+                        modeperf_uringclose(mode, &engine, flow, tid);
+                    }
+
+                    node = next;
+                }
+
+                if (tsus - sweepus >= MODEPERF_URING_SWEEPUS)
+                {
+                    sweepus = tsus;
+                    modeperf_publishcpu(&mode->counters[tid]);
+                }
+            }
+
+            if (engine.list.size == 0)
+            {
+                waitus = MODEPERF_IDLEMS * 1000;
+            }
+            else if (engine.deferred == 0)
+            {
+                waitus = MODEPERF_URING_SWEEPUS;
+            }
+            else if ((engine.mindelayus > 0) &&
+                     (engine.mindelayus < MODEPERF_URING_SWEEPUS))
+            {
+                waitus = engine.mindelayus;
+            }
+            else
+            {
+                waitus = 1000;
+            }
+
+            // Keep a poll request in flight on the socket queue doorbell so
+            // that a new socket wakes the engine from a completion wait.
+            if (!engine.bellpoll)
+            {
+                doorbellobj_clear(engine.bell);
+                engine.bellpoll = uringobj_poll(&engine.ring,
+                                                doorbellobj_getfd(engine.bell),
+                                                POLLIN,
+                                                MODEPERF_URINGOP_BELL);
+            }
+
+            if ((engine.listener != NULL) && (!engine.listenpoll))
+            {
+                engine.listenpoll = uringobj_poll(&engine.ring,
+                                                  engine.listener->fd,
+                                                  POLLIN,
+                                                  MODEPERF_URINGOP_LSTN);
+            }
+
+            doorbellobj_arm(engine.bell);
+
+            // Submit all queued requests and wait for completions using a
+            // single system call, then reap the completions in batches.
+            uringobj_submit(&engine.ring,
+                            ((engine.bellpoll) || (engine.list.size > 0)) &&
+                            (!engine.accept) &&
+                            (lfqueue_getsize(&mode->sockq[tid]) == 0) ? 1 : 0,
+                            waitus);
+            tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+            while ((n = uringobj_reap(&engine.ring,
+                                      cqes,
+                                      MODEPERF_URING_BATCH)) > 0)
+            {
+                for (i = 0; i < n; i++)
+                {
+                    modeperf_uringcomplete(mode, &engine, &cqes[i], tid, tsus);
+                }
+            }
+
+            if ((engine.recvbytes > 0) || (engine.sendbytes > 0))
+            {
+                modeperf_count(&mode->counters[tid].recvbytes, engine.recvbytes);
+                modeperf_count(&mode->counters[tid].sendbytes, engine.sendbytes);
+                modeperf_count(&mode->counters[tid].syscalls,
+                               engine.ring.entercnt - engine.entercnt);
+                modeperf_count(&mode->counters[tid].datagrams, engine.datagrams);
+                engine.recvbytes = 0;
+                engine.sendbytes = 0;
+                engine.datagrams = 0;
+                engine.entercnt  = engine.ring.entercnt;
+            }
+
+            // A worker that has not been handed a socket yet keeps waiting.
+            if ((engine.list.size == 0) && (count > 0))
+            {
+                count = 0;
+
+                if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
+                {
+                    exit = true;
+                }
+            }
+        }
+
+        // Cancel and drain all in-flight requests before releasing the flows
+        // and buffers that the kernel may still reference.
+        node = engine.list.head;
+
+        while (node != NULL)
+        {
+            next = node->next;
+            modeperf_uringclose(mode, &engine, node->val, tid);
+            node = next;
+        }
+
+        if (engine.bellpoll)
+        {
+            uringobj_cancel(&engine.ring, MODEPERF_URINGOP_BELL);
+        }
+
+        if (engine.listenpoll)
+        {
+            uringobj_cancel(&engine.ring, MODEPERF_URINGOP_LSTN);
+        }
+
+        for (count = 0;
+             ((engine.list.size > 0) ||
+              (engine.bellpoll) ||
+              (engine.listenpoll)) && (count < 10);
+             count++)
+        {
+            uringobj_submit(&engine.ring, 1, MODEPERF_URING_SWEEPUS);
+
+            while ((n = uringobj_reap(&engine.ring,
+                                      cqes,
+                                      MODEPERF_URING_BATCH)) > 0)
+            {
+                for (i = 0; i < n; i++)
+                {
+                    modeperf_uringcomplete(mode, &engine, &cqes[i], tid, tsus);
+                }
+            }
+        }
+
+        logger_printf(LOGGER_LEVEL_INFO,
+                      "%s: io_uring system calls: %" PRIu64
+                      " submissions: %" PRIu64
+                      " completions: %" PRIu64 "\n",
+                      __FUNCTION__,
+                      engine.ring.entercnt,
+                      engine.ring.sqecnt,
+                      engine.ring.cqecnt);
+
+        uringobj_destroy(&engine.ring);
+    }
+
+    UTILMEM_FREE(cqes);
+
+    return ret;
+}
+
+/**
+ * @brief Create a pool of pinned zero-copy send buffers.
+ *
+ * @param[in,out] pool A pointer to a zero-copy send buffer pool.
+ * @param[in]     len  The length of each buffer in bytes.
+ *
+ * @return True if the pool was created.
+ */
+static bool modeperf_zccreate(struct modeperf_zcpool * const pool,
+                              const uint32_t len)
+{
+    bool ret = false;
+    long page = sysconf(_SC_PAGESIZE);
+    size_t size = 0;
+
+    memset(pool, 0, sizeof(*pool));
+    page = (page > 0 ? page : 4096);
+    pool->len = (uint32_t)((len + page - 1) / page * page);
+    size = (size_t)pool->len * MODEPERF_ZCBUFS;
+
+    if ((pool->mem = UTILMEM_ALIGNED_ALLOC(uint8_t,
+                                           (size_t)page,
+                                           size,
+                                           1)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: zero-copy buffer allocation failed\n",
+                      __FUNCTION__);
+    }
+    else
+    {
+        // Touch every page so that pinning does not fault later.
+        memset(pool->mem, 0, size);
+
+        if (mlock(pool->mem, size) == 0)
+        {
+            pool->pinned = true;
+        }
+        else
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: zero-copy buffers are not pinned (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Destroy a pool of zero-copy send buffers.
+ *
+ * @param[in,out] pool A pointer to a zero-copy send buffer pool.
+ *
+ * @return Void.
+ */
+static void modeperf_zcdestroy(struct modeperf_zcpool * const pool)
+{
+    if (pool->mem != NULL)
+    {
+        if (pool->pinned)
+        {
+            munlock(pool->mem, (size_t)pool->len * MODEPERF_ZCBUFS);
+        }
+
+        UTILMEM_FREE(pool->mem);
+        memset(pool, 0, sizeof(*pool));
+    }
+}
+
+/**
+ * @brief Get a zero-copy send buffer that a socket may send from. A buffer is
+ *        free if it is unused or if the kernel released the socket's send from
+ *        it. If no buffer is free, then the socket's completion notifications
+ *        are reaped once before checking again.
+ *
+ * @param[in,out] pool A pointer to a zero-copy send buffer pool.
+ * @param[in,out] sock A pointer to a socket object.
+ * @param[out]    slot The pool index of the buffer.
+ *
+ * @return A pointer to a free buffer (NULL if none is free).
+ */
+static uint8_t *modeperf_zcget(struct modeperf_zcpool * const pool,
+                               struct sockobj * const sock,
+                               uint32_t * const slot)
+{
+    uint8_t *ret = NULL;
+    struct modeperf_zcbuf *buf = NULL;
+    uint32_t i, pass;
+
+    for (pass = 0; (ret == NULL) && (pass < 2); pass++)
+    {
+        if (pass > 0)
+        {
+            socktcp_reapzerocopy(sock);
+        }
+
+        for (i = 0; (ret == NULL) && (i < MODEPERF_ZCBUFS); i++)
+        {
+            *slot = (pool->next + i) % MODEPERF_ZCBUFS;
+            buf = &pool->bufs[*slot];
+
+            if ((buf->sock == NULL) ||
+                ((buf->sock == sock) &&
+                 ((int32_t)(sock->info.zcdone - buf->id) > 0)))
+            {
+                buf->sock = NULL;
+                pool->next = (*slot + 1) % MODEPERF_ZCBUFS;
+                ret = pool->mem + (size_t)*slot * pool->len;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Release the zero-copy send buffers of a closed socket. The socket
+ *        can no longer report completions, and the buffer contents are never
+ *        modified, so the buffers are returned to the pool.
+ *
+ * @param[in,out] pool A pointer to a zero-copy send buffer pool.
+ * @param[in]     sock A pointer to a closed socket object.
+ *
+ * @return Void.
+ */
+static void modeperf_zcrelease(struct modeperf_zcpool * const pool,
+                               const struct sockobj * const sock)
+{
+    uint32_t i;
+
+    for (i = 0; i < MODEPERF_ZCBUFS; i++)
+    {
+        if (pool->bufs[i].sock == sock)
+        {
+            pool->bufs[i].sock = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Perform the next step of the request/response transactions of a mode
+ *        socket. A client sends the requests that fit in its window and
+ *        records the latency of each response. A server sends the responses
+ *        that it owes and receives the next requests. A datagram carries a
+ *        single request or response.
+ *
+ * @param[in,out] mode      A pointer to a mode object.
+ * @param[in,out] sock      A pointer to a socket object.
+ * @param[in,out] rr        A pointer to the socket transaction state.
+ * @param[in,out] hist      A pointer to the worker latency histogram (NULL if
+ *                          response times are not recorded).
+ * @param[in]     recvbuf   A pointer to a receive buffer.
+ * @param[in]     sendbuf   A pointer to a send buffer.
+ * @param[in]     buflen    The maximum size of a buffer in bytes (0 if the
+ *                          socket may not be called).
+ * @param[in]     tsus      The current Unix time in microseconds.
+ * @param[out]    recvbytes The number of bytes received.
+ * @param[out]    sendbytes The number of bytes sent.
+ *
+ * @return True if the socket has bytes to send but the send would block.
+ */
+static bool modeperf_rrcall(struct modeobj_priv * const mode,
+                            struct sockobj * const sock,
+                            struct modeperf_rr * const rr,
+                            struct modeperf_hist * const hist,
+                            uint8_t * const recvbuf,
+                            uint8_t * const sendbuf,
+                            const uint32_t buflen,
+                            const uint64_t tsus,
+                            int32_t * const recvbytes,
+                            int32_t * const sendbytes)
+{
+    bool ret = false;
+    const bool client = (mode->args.arch == SOCKOBJ_MODEL_CLIENT);
+    const bool dgram = (sock->conf.type == SOCK_DGRAM);
+    const uint32_t reqlen = mode->args.reqlen;
+    const uint32_t resplen = mode->args.resplen;
+    const uint32_t window = mode->args.window;
+    uint64_t len = 0, syscalls = sock->info.syscalls, tsns = 0;
+    uint32_t count = 0;
+
+    *recvbytes = 0;
+    *sendbytes = 0;
+
+    if (client)
+    {
+        len = (uint64_t)(window - rr->inflight) * reqlen - rr->reqbytes;
+        len = ((dgram) && (len > 0) ? reqlen : len);
+    }
+    else
+    {
+        len = (uint64_t)rr->inflight * resplen - rr->respbytes;
+        len = ((dgram) && (len > 0) ? resplen : len);
+    }
+
+    len = (len > buflen ? buflen : len);
+
+    if (len > 0)
+    {
+        tsns = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC);
+        *sendbytes = modeperf_call(mode,
+                                   sock->ops->sock_send,
+                                   &sock->info.send,
+                                   sock,
+                                   sendbuf,
+                                   (uint32_t)len,
+                                   tsus);
+        ret = ((*sendbytes == 0) && (sock->info.syscalls > syscalls));
+
+        if (*sendbytes <= 0)
+        {
+            // Do nothing.
+        }
+        else if (client)
+        {
+            rr->reqbytes = (dgram ? reqlen : rr->reqbytes + (uint32_t)*sendbytes);
+
+            while (rr->reqbytes >= reqlen)
+            {
+                rr->sendns[(rr->head + rr->inflight) % window] = tsns;
+                rr->inflight++;
+                rr->reqbytes -= reqlen;
+            }
+        }
+        else
+        {
+            rr->respbytes = (dgram ? resplen : rr->respbytes + (uint32_t)*sendbytes);
+            count = rr->respbytes / resplen;
+            rr->inflight -= count;
+            rr->respbytes -= count * resplen;
+        }
+    }
+
+    // A server always receives the next requests, which are limited by the
+    // window of the client.
+    len = (client ?
+           (uint64_t)rr->inflight * resplen - rr->respbytes :
+           buflen);
+    len = ((client) && (dgram) && (len > 0) ? resplen : len);
+    len = (len > buflen ? buflen : len);
+
+    if ((len > 0) && ((sock->state & SOCKOBJ_STATE_CLOSE) == 0))
+    {
+        *recvbytes = modeperf_call(mode,
+                                   sock->ops->sock_recv,
+                                   &sock->info.recv,
+                                   sock,
+                                   recvbuf,
+                                   (uint32_t)len,
+                                   tsus);
+
+        if (*recvbytes <= 0)
+        {
+            // Do nothing.
+        }
+        else if (client)
+        {
+            tsns = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC);
+            rr->respbytes = (dgram ? resplen : rr->respbytes + (uint32_t)*recvbytes);
+
+            while ((rr->respbytes >= resplen) && (rr->inflight > 0))
+            {
+                if (hist != NULL)
+                {
+                    modeperf_histrecord(hist, tsns - rr->sendns[rr->head]);
+                }
+                if (tsns - rr->sendns[rr->head] > rr->maxns)
+                {
+                    rr->maxns = tsns - rr->sendns[rr->head];
+                }
+                rr->head = (rr->head + 1) % window;
+                rr->inflight--;
+                rr->respbytes -= resplen;
+            }
+        }
+        else
+        {
+            rr->reqbytes = (dgram ? reqlen : rr->reqbytes + (uint32_t)*recvbytes);
+            count = rr->reqbytes / reqlen;
+            rr->inflight += count;
+            rr->reqbytes -= count * reqlen;
+        }
+    }
+
+    // A datagram request or response may be lost, so a client gives up on a
+    // transaction that is not answered in time.
+    if ((client) && (dgram) && (rr->inflight > 0))
+    {
+        tsns = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC);
+
+        while ((rr->inflight > 0) &&
+               (tsns - rr->sendns[rr->head] >= MODEPERF_RRLOSSUS * 1000ULL))
+        {
+            if (hist != NULL)
+            {
+                modeperf_count(&hist->lost, 1);
+            }
+            rr->head = (rr->head + 1) % window;
+            rr->inflight--;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the worker state of a socket file descriptor.
+ *
+ * @param[in,out] fds  A pointer to a vector of worker file descriptor states
+ *                     indexed by file descriptor.
+ * @param[in]     fd   A file descriptor.
+ * @param[in]     grow True if the vector may grow to include the file
+ *                     descriptor.
+ *
+ * @return A pointer to the file descriptor state (NULL if unavailable).
+ */
+static struct modeperf_fd *modeperf_getfd(struct vector * const fds,
+                                          const int32_t fd,
+                                          const bool grow)
+{
+    struct modeperf_fd *ret = NULL;
+    uint32_t size = vector_getsize(fds);
+
+    if (fd < 0)
+    {
+        // Do nothing.
+    }
+    else if ((uint32_t)fd < size)
+    {
+        ret = (struct modeperf_fd *)vector_getval(fds, (uint32_t)fd);
+    }
+    else if ((grow) && (vector_resize(fds, (uint32_t)fd + 1)))
+    {
+        // Clear the state of any file descriptors added by the resize.
+        while (size <= (uint32_t)fd)
+        {
+            ret = (struct modeperf_fd *)vector_getval(fds, size++);
+            memset(ret, 0, sizeof(*ret));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Move the worker state of a socket file descriptor to another file
+ *        descriptor.
+ *
+ * @param[in,out] fds  A pointer to a vector of worker file descriptor states
+ *                     indexed by file descriptor.
+ * @param[in]     from The file descriptor that has the state.
+ * @param[in]     to   The file descriptor that takes the state.
+ *
+ * @return A pointer to the moved file descriptor state (NULL if unavailable).
+ */
+static struct modeperf_fd *modeperf_movefd(struct vector * const fds,
+                                           const int32_t from,
+                                           const int32_t to)
+{
+    struct modeperf_fd *ret = modeperf_getfd(fds, to, true);
+    struct modeperf_fd *src = NULL;
+
+    // The vector may move its elements when it grows.
+    if ((ret != NULL) &&
+        (from != to) &&
+        ((src = modeperf_getfd(fds, from, false)) != NULL))
+    {
+        memcpy(ret, src, sizeof(*ret));
+        memset(src, 0, sizeof(*src));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Create the flows of a worker.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ * @param[in]     count The number of flows to make room for.
+ * @param[in]     nowus The current time in microseconds.
+ *
+ * @return True if the flows were created.
+ */
+static bool modeperf_createflows(struct modeperf_flows * const flows,
+                                 const uint32_t count,
+                                 const uint64_t nowus)
+{
+    bool ret = false;
+
+    memset(flows, 0, sizeof(*flows));
+
+    if (!vector_create(&flows->fds, 0, sizeof(struct modeperf_fd)))
+    {
+        // Do nothing.
+    }
+    else if (!vector_create(&flows->hot, count, sizeof(struct modeperf_hot)))
+    {
+        vector_destroy(&flows->fds);
+    }
+    else if (!vector_create(&flows->runq[0], count, sizeof(struct modeperf_run)))
+    {
+        vector_destroy(&flows->hot);
+        vector_destroy(&flows->fds);
+    }
+    else if (!vector_create(&flows->runq[1], count, sizeof(struct modeperf_run)))
+    {
+        vector_destroy(&flows->runq[0]);
+        vector_destroy(&flows->hot);
+        vector_destroy(&flows->fds);
+    }
+    else if (!timerwheel_create(&flows->wheel, MODEPERF_TICKUS, nowus))
+    {
+        vector_destroy(&flows->runq[1]);
+        vector_destroy(&flows->runq[0]);
+        vector_destroy(&flows->hot);
+        vector_destroy(&flows->fds);
+    }
+    else
+    {
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Destroy the flows of a worker.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ *
+ * @return Void.
+ */
+static void modeperf_destroyflows(struct modeperf_flows * const flows)
+{
+    timerwheel_destroy(&flows->wheel);
+    vector_destroy(&flows->runq[1]);
+    vector_destroy(&flows->runq[0]);
+    vector_destroy(&flows->hot);
+    vector_destroy(&flows->fds);
+}
+
+/**
+ * @brief Get a flow of a worker.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ * @param[in]     fd    The file descriptor of the flow.
+ *
+ * @return A pointer to the flow entry (NULL if the file descriptor has no
+ *         flow).
+ */
+static struct modeperf_hot *modeperf_getflow(struct modeperf_flows * const flows,
+                                             const int32_t fd)
+{
+    struct modeperf_hot *ret = NULL;
+    struct modeperf_fd *state = modeperf_getfd(&flows->fds, fd, false);
+
+    if ((state != NULL) && (state->flow > 0))
+    {
+        ret = (struct modeperf_hot *)vector_getval(&flows->hot, state->flow - 1);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Add a zeroed entry to the end of the flow array of a worker. The
+ *        entry is only a flow once the flow count includes it. The array only
+ *        grows, so a worker that once had many flows keeps their entries.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ *
+ * @return A pointer to the new flow entry (NULL if unavailable).
+ */
+static struct modeperf_hot *modeperf_addflow(struct modeperf_flows * const flows)
+{
+    struct modeperf_hot *ret = NULL;
+
+    if ((flows->count < vector_getsize(&flows->hot)) ||
+        (vector_resize(&flows->hot, flows->count + 1)))
+    {
+        ret = (struct modeperf_hot *)vector_getval(&flows->hot, flows->count);
+        memset(ret, 0, sizeof(*ret));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Remove an entry from the flow array of a worker by moving the last
+ *        flow into its place. A run queue entry of the moved flow stays valid.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ * @param[in,out] flow  A pointer to the flow entry to remove.
+ *
+ * @return Void.
+ */
+static void modeperf_removeflow(struct modeperf_flows * const flows,
+                                struct modeperf_hot * const flow)
+{
+    const uint32_t index = (uint32_t)(flow -
+                                      (struct modeperf_hot *)vector_getval(&flows->hot, 0));
+    struct modeperf_hot *last = (struct modeperf_hot *)vector_getval(&flows->hot,
+                                                                     flows->count - 1);
+    struct modeperf_fd *state = modeperf_getfd(&flows->fds, flow->fd, false);
+
+    if ((state != NULL) && (state->flow == index + 1))
+    {
+        state->flow = 0;
+    }
+
+    if (flow->timer != 0)
+    {
+        timerwheel_cancel(&flows->wheel, flow->timer);
+    }
+
+    if (flow->paced)
+    {
+        flows->paced--;
+    }
+
+    if (flow != last)
+    {
+        memcpy(flow, last, sizeof(*flow));
+
+        if ((state = modeperf_getfd(&flows->fds, flow->fd, false)) != NULL)
+        {
+            state->flow = index + 1;
+        }
+    }
+
+    memset(last, 0, sizeof(*last));
+    flows->count--;
+}
+
+/**
+ * @brief Add a flow to the run queue of the next pass of a worker.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ * @param[in,out] flow  A pointer to a flow entry.
+ *
+ * @return True if the flow is in the run queue.
+ */
+static bool modeperf_runflow(struct modeperf_flows * const flows,
+                             struct modeperf_hot * const flow)
+{
+    struct vector *runq = &flows->runq[flows->next];
+    uint32_t *count = &flows->runcount[flows->next];
+    struct modeperf_run *run = NULL;
+
+    if ((!flow->queued) &&
+        ((*count < vector_getsize(runq)) || (vector_resize(runq, *count + 1))))
+    {
+        run = (struct modeperf_run *)vector_getval(runq, (*count)++);
+        run->fd = flow->fd;
+        run->id = flow->id;
+        flow->queued = true;
+    }
+
+    return flow->queued;
+}
+
+/**
+ * @brief Return a waiting flow of a worker to the run queue. A flow that waits
+ *        for its token bucket only returns when its timer fires, and a flow
+ *        whose timer fired is treated as ready so that it is checked even if
+ *        the event loop did not report it.
+ *
+ * @param[in,out] flows A pointer to the flows of a worker.
+ * @param[in,out] flow  A pointer to a flow entry.
+ * @param[in]     timer True if the timer of the flow fired.
+ *
+ * @return Void.
+ */
+static void modeperf_wakeflow(struct modeperf_flows * const flows,
+                              struct modeperf_hot * const flow,
+                              const bool timer)
+{
+    if ((flow->paced) && (!timer))
+    {
+        // Do nothing.
+    }
+    else
+    {
+        if (flow->timer != 0)
+        {
+            // A fired timer was already removed from the wheel.
+            if (!timer)
+            {
+                timerwheel_cancel(&flows->wheel, flow->timer);
+            }
+
+            flow->timer = 0;
+        }
+
+        if (flow->paced)
+        {
+            flow->paced = false;
+            flows->paced--;
+        }
+
+        flow->ready = true;
+        modeperf_runflow(flows, flow);
+    }
+}
+
+/**
+ * @brief Handle the file descriptors that the event loop of a worker reported
+ *        as ready.
+ *
+ * @param[in,out] fion     A pointer to the event object of a worker.
+ * @param[in,out] flows    A pointer to the flows of a worker.
+ * @param[in,out] bell     A pointer to the socket queue doorbell of a worker.
+ * @param[in,out] pacer    A pointer to the pacing timer of a worker.
+ * @param[in]     listenfd The listener file descriptor of a worker (-1 if
+ *                         none).
+ * @param[out]    accept   A pointer to a flag set if the listener is ready.
+ *
+ * @return Void.
+ */
+static void modeperf_pollready(struct fionobj * const fion,
+                               struct modeperf_flows * const flows,
+                               struct doorbellobj * const bell,
+                               struct pacetimer * const pacer,
+                               const int32_t listenfd,
+                               bool * const accept)
+{
+    struct modeperf_hot *flow = NULL;
+    int32_t fd = -1;
+    uint32_t i;
+
+    for (i = 0; i < fion->readycount; i++)
+    {
+        if (fion->ops.fion_getready(fion, i, &fd) == 0)
+        {
+            // Do nothing.
+        }
+        else if (fd == doorbellobj_getfd(bell))
+        {
+            doorbellobj_clear(bell);
+        }
+        else if (fd == pacetimer_getfd(pacer))
+        {
+            // The timers that are due are expired in the next pass.
+            pacetimer_clear(pacer);
+        }
+        else if (fd == listenfd)
+        {
+            *accept = true;
+        }
+        else if ((flow = modeperf_getflow(flows, fd)) != NULL)
+        {
+            flow->ready = true;
+            modeperf_wakeflow(flows, flow, false);
+        }
+    }
+}
+
+/**
+ * @brief Schedule the timer of a flow that leaves the run queue of a worker.
+ *        The timer fires at the earliest of the time limit of the flow, the
+ *        idle limit of a datagram flow, the loss timeout of the oldest
+ *        datagram request of a client, and the release time of a paced flow.
+ *
+ * @param[in]     mode      A pointer to a mode object.
+ * @param[in,out] flows     A pointer to the flows of a worker.
+ * @param[in,out] flow      A pointer to a flow entry.
+ * @param[in]     releaseus The time that a paced flow may send again (0 if
+ *                          the flow is not paced).
+ *
+ * @return Void.
+ */
+static void modeperf_waitflow(const struct modeobj_priv * const mode,
+                              struct modeperf_flows * const flows,
+                              struct modeperf_hot * const flow,
+                              const uint64_t releaseus)
+{
+    const struct sockobj *sock = flow->sock;
+    uint64_t dueus = UINT64_MAX, limitus = 0;
+
+    if ((mode->args.timelimitusec > 0) && (sock->info.startusec > 0))
+    {
+        dueus = sock->info.startusec + mode->args.timelimitusec;
+    }
+
+    if ((sock->conf.idlelimitusec > 0) &&
+        (sock->info.idleusec > 0) &&
+        ((limitus = sock->info.idleusec + sock->conf.idlelimitusec) < dueus))
+    {
+        dueus = limitus;
+    }
+
+    if ((flow->rr != NULL) &&
+        (flow->rr->inflight > 0) &&
+        (mode->args.arch == SOCKOBJ_MODEL_CLIENT) &&
+        (sock->conf.type == SOCK_DGRAM) &&
+        ((limitus = flow->rr->sendns[flow->rr->head] / 1000 + MODEPERF_RRLOSSUS) < dueus))
+    {
+        dueus = limitus;
+    }
+
+    if ((releaseus > 0) && (releaseus < dueus))
+    {
+        dueus = releaseus;
+    }
+
+    if (releaseus > 0)
+    {
+        flow->paced = true;
+        flows->paced++;
+    }
+
+    // A flow without a deadline only waits for the event loop.
+    if (dueus < UINT64_MAX)
+    {
+        flow->timer = timerwheel_schedule(&flows->wheel,
+                                          ((uint64_t)flow->id << 32) | (uint32_t)flow->fd,
+                                          dueus);
+    }
+}
+
+/**
+ * @brief Check if a flow has reached its time limit, or if a datagram flow
+ *        has been idle for longer than its idle limit.
+ *
+ * @param[in] mode A pointer to a mode object.
+ * @param[in] sock A pointer to a socket object.
+ * @param[in] tsus The current time in microseconds.
+ *
+ * @return True if the flow has expired.
+ */
+static bool modeperf_isexpired(const struct modeobj_priv * const mode,
+                               const struct sockobj * const sock,
+                               const uint64_t tsus)
+{
+    bool ret = false;
+
+    if ((mode->args.timelimitusec > 0) &&
+        (sock->info.startusec > 0) &&
+        (tsus > sock->info.startusec) &&
+        (tsus - sock->info.startusec >= mode->args.timelimitusec))
+    {
+        ret = true;
+    }
+    else if ((sock->conf.idlelimitusec > 0) &&
+             (sock->info.idleusec > 0) &&
+             (tsus > sock->info.idleusec) &&
+             (tsus - sock->info.idleusec >= sock->conf.idlelimitusec))
+    {
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Perform the next send and receive of a streaming mode socket. An end
+ *        that sends and receives at once (full duplex) sends before it
+ *        receives.
+ *
+ * @param[in,out] mode      A pointer to a mode object.
+ * @param[in,out] sock      A pointer to a socket object.
+ * @param[in,out] zcpool    A pointer to a zero-copy send buffer pool (unused
+ *                          if the pool has no memory).
+ * @param[in]     recvbuf   A pointer to a receive buffer.
+ * @param[in]     sendbuf   A pointer to a send buffer.
+ * @param[in]     buflen    The maximum size of a buffer in bytes (0 if the
+ *                          socket may not be called).
+ * @param[in]     tsus      The current Unix time in microseconds.
+ * @param[out]    recvbytes The number of bytes received.
+ * @param[out]    sendbytes The number of bytes sent.
+ *
+ * @return Void.
+ */
+static void modeperf_streamcall(struct modeobj_priv * const mode,
+                                struct sockobj * const sock,
+                                struct modeperf_zcpool * const zcpool,
+                                uint8_t * const recvbuf,
+                                uint8_t * const sendbuf,
+                                const uint32_t buflen,
+                                const uint64_t tsus,
+                                int32_t * const recvbytes,
+                                int32_t * const sendbytes)
+{
+    uint8_t *zcbuf = NULL;
+    uint32_t zcslot = 0, zcid = 0;
+
+    *recvbytes = 0;
+    *sendbytes = 0;
+
+    if (!sockobj_issender(mode->args.arch, mode->args.direction))
+    {
+        // Do nothing.
+    }
+    else if (zcpool->mem != NULL)
+    {
+        // A zero-copy send waits for a buffer that the kernel has released.
+        zcbuf = modeperf_zcget(zcpool, sock, &zcslot);
+        zcid  = sock->info.zcnext;
+        *sendbytes = modeperf_call(mode,
+                                   sock->ops->sock_send,
+                                   &sock->info.send,
+                                   sock,
+                                   zcbuf == NULL ? sendbuf : zcbuf,
+                                   zcbuf == NULL ? 0 : buflen,
+                                   tsus);
+
+        if (zcbuf == NULL)
+        {
+            // The completion reap is the operation that would block.
+            sock->info.syscalls++;
+        }
+        else if (sock->info.zcnext != zcid)
+        {
+            zcpool->bufs[zcslot].sock = sock;
+            zcpool->bufs[zcslot].id   = zcid;
+        }
+    }
+    else
+    {
+        *sendbytes = modeperf_call(mode,
+                                   sock->ops->sock_send,
+                                   &sock->info.send,
+                                   sock,
+                                   sendbuf,
+                                   buflen,
+                                   tsus);
+    }
+
+    // A send that ended the flow leaves nothing to receive.
+    if ((sockobj_isreceiver(mode->args.arch, mode->args.direction)) &&
+        ((sock->state & SOCKOBJ_STATE_CLOSE) == 0))
+    {
+        *recvbytes = modeperf_call(mode,
+                                   sock->ops->sock_recv,
+                                   &sock->info.recv,
+                                   sock,
+                                   recvbuf,
+                                   buflen,
+                                   tsus);
+    }
+}
+
+/**
+ * @brief Get the flow index node of a worked socket.
+ *
+ * @param[in] sock A pointer to a pooled socket object.
+ *
+ * @return A pointer to the flow index node of the socket.
+ */
+static struct flowindex_node *modeperf_getnode(struct sockobj * const sock)
+{
+    return &((struct modeperf_sock *)sock)->node;
+}
+
+/**
+ * @brief Get the socket of a flow index node.
+ *
+ * @param[in] node A pointer to the flow index node of a pooled socket.
+ *
+ * @return A pointer to the socket object of the node.
+ */
+static struct modeperf_sock *modeperf_getindexed(struct flowindex_node * const node)
+{
+    return (struct modeperf_sock *)((uintptr_t)node -
+                                    offsetof(struct modeperf_sock, node));
+}
+
+/**
+ * @brief Get the five-tuple of a socket.
+ *
+ * @param[in]  sock  A pointer to a socket object.
+ * @param[out] tuple A pointer to a five-tuple.
+ *
+ * @return Void.
+ */
+static void modeperf_getflowtuple(const struct sockobj * const sock,
+                                  struct flowindex_tuple * const tuple)
+{
+    const bool client = (sock->conf.model == SOCKOBJ_MODEL_CLIENT);
+    const struct sockobj_addr *addrs[2];
+    uint8_t *ipaddrs[2];
+    uint32_t i;
+
+    memset(tuple, 0, sizeof(*tuple));
+    tuple->proto      = (sock->conf.type == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP);
+    tuple->family     = (uint8_t)sock->addrself.sockaddr.ss_family;
+    addrs[0]          = (client ? &sock->addrself : &sock->addrpeer);
+    addrs[1]          = (client ? &sock->addrpeer : &sock->addrself);
+    ipaddrs[0]        = tuple->client;
+    ipaddrs[1]        = tuple->server;
+    tuple->clientport = addrs[0]->ipport;
+    tuple->serverport = addrs[1]->ipport;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (addrs[i]->sockaddr.ss_family == AF_INET6)
+        {
+            memcpy(ipaddrs[i],
+                   &((const struct sockaddr_in6 *)&addrs[i]->sockaddr)->sin6_addr,
+                   sizeof(struct in6_addr));
+        }
+        else if (addrs[i]->sockaddr.ss_family == AF_INET)
+        {
+            memcpy(ipaddrs[i],
+                   &((const struct sockaddr_in *)&addrs[i]->sockaddr)->sin_addr,
+                   sizeof(struct in_addr));
+        }
+        else
+        {
+            // Do nothing.
+        }
+    }
+}
+
+/**
+ * @brief Add the flow of a new socket to the flow index of its worker. The
+ *        flow is measured from the time it was added, and is ranked at the end
+ *        of the interval that it was added in.
+ *
+ * @param[in,out] index A pointer to the flow index of the worker.
+ * @param[in,out] sock  A pointer to a pooled socket object with a flow id.
+ * @param[in]     tsus  The current time in microseconds.
+ *
+ * @return True if the flow was indexed.
+ */
+static bool modeperf_indexflow(struct flowindex * const index,
+                               struct sockobj * const sock,
+                               const uint64_t tsus)
+{
+    struct modeperf_sock *obj = (struct modeperf_sock *)sock;
+
+    memset(&obj->node, 0, sizeof(obj->node));
+    obj->node.id     = sock->sid;
+    obj->node.ageus  = tsus;
+    obj->rankbytes   = 0;
+    obj->rankretrans = 0;
+    obj->rankgen     = 0;
+    modeperf_getflowtuple(sock, &obj->node.tuple);
+
+    return flowindex_insert(index, &obj->node);
+}
+
+/**
+ * @brief Index a flow by the five-tuple of its socket again (e.g., once a
+ *        client socket has connected and knows its local port).
+ *
+ * @param[in,out] index A pointer to the flow index of the worker.
+ * @param[in]     sock  A pointer to an indexed socket object.
+ *
+ * @return Void.
+ */
+static void modeperf_reindexflow(struct flowindex * const index,
+                                 struct sockobj * const sock)
+{
+    struct flowindex_tuple tuple;
+
+    modeperf_getflowtuple(sock, &tuple);
+    flowindex_settuple(index, modeperf_getnode(sock), &tuple);
+}
+
+/**
+ * @brief Measure a flow over the time since it was last ranked and offer it
+ *        to the ranking of its worker. The flow entry is only filled in if the
+ *        flow would be ranked.
+ *
+ * @param[in]     mode  A pointer to a mode object.
+ * @param[in,out] index A pointer to the flow index of the worker.
+ * @param[in,out] rank  A pointer to the ranking of the worker.
+ * @param[in,out] sock  A pointer to an indexed socket object.
+ * @param[in,out] rr    A pointer to the transaction state of the socket (NULL
+ *                      if streaming).
+ * @param[in]     gen   The ranking generation of the worker.
+ * @param[in]     tsus  The current time in microseconds.
+ *
+ * @return Void.
+ */
+static void modeperf_rankflow(const struct modeobj_priv * const mode,
+                              struct flowindex * const index,
+                              struct flowrank * const rank,
+                              struct sockobj * const sock,
+                              struct modeperf_rr * const rr,
+                              const uint32_t gen,
+                              const uint64_t tsus)
+{
+    struct modeperf_sock *obj = (struct modeperf_sock *)sock;
+    struct flowrank_entry entry;
+    const uint64_t bytes = (uint64_t)(sock->info.recv.buflen.sum +
+                                      sock->info.send.buflen.sum);
+    uint64_t goodputbps = 0, latencyns = 0, val = 0;
+
+    if (tsus > obj->node.ageus)
+    {
+        goodputbps = (bytes - obj->rankbytes) * 8 * UNIT_TIME_USEC /
+                     (tsus - obj->node.ageus);
+    }
+
+    if (rr != NULL)
+    {
+        latencyns = rr->maxns;
+        rr->maxns = 0;
+    }
+
+    flowindex_touch(index, &obj->node, tsus);
+    obj->rankbytes = bytes;
+    obj->rankgen   = gen;
+
+    // The slowest flows are the retransmit candidates, and only they pay for
+    // a TCP information call when the ranking is published.
+    switch (mode->args.rank)
+    {
+        case ARGS_RANK_LATENCY:
+            val = latencyns;
+            break;
+        case ARGS_RANK_RETRANS:
+        case ARGS_RANK_SLOWEST:
+        case ARGS_RANK_GOODPUT:
+        default:
+            val = goodputbps;
+            break;
+    }
+
+    if (flowrank_isranked(rank, val))
+    {
+        memset(&entry, 0, sizeof(entry));
+        entry.val        = val;
+        entry.goodputbps = goodputbps;
+        entry.latencyns  = latencyns;
+        entry.tid        = sock->tid;
+        entry.sid        = sock->sid;
+
+        if (sock->conf.model == SOCKOBJ_MODEL_CLIENT)
+        {
+            memcpy(entry.client, sock->addrself.sockaddrstr, sizeof(entry.client));
+            memcpy(entry.server, sock->addrpeer.sockaddrstr, sizeof(entry.server));
+        }
+        else
+        {
+            memcpy(entry.client, sock->addrpeer.sockaddrstr, sizeof(entry.client));
+            memcpy(entry.server, sock->addrself.sockaddrstr, sizeof(entry.server));
+        }
+
+        flowrank_offer(rank, &entry);
+    }
+}
+
+/**
+ * @brief Take the retransmits of the flows of a worker ranking since each
+ *        flow was last sampled, and rank the flows by them.
+ *
+ * @param[in]     index A pointer to the flow index of the worker.
+ * @param[in,out] rank  A pointer to the ranking of the worker.
+ *
+ * @return Void.
+ */
+static void modeperf_rankretrans(const struct flowindex * const index,
+                                 struct flowrank * const rank)
+{
+    struct flowrank_entry *entry = NULL;
+    struct flowindex_node *node = NULL;
+    struct modeperf_sock *obj = NULL;
+    struct socktcp_info info;
+    uint32_t i;
+
+    for (i = 0; i < rank->count; i++)
+    {
+        entry = &rank->entries[i];
+        entry->val = 0;
+        memset(&info, 0, sizeof(info));
+
+        // A flow that ended since it was ranked is no longer indexed.
+        if (((node = flowindex_getid(index, entry->sid)) != NULL) &&
+            ((obj = modeperf_getindexed(node))->sock.conf.type == SOCK_STREAM) &&
+            (socktcp_getinfo(obj->sock.fd, &info)))
+        {
+            // A reconnected flow restarts its retransmit count.
+            entry->retrans = (info.retrans >= obj->rankretrans ?
+                              info.retrans - obj->rankretrans :
+                              info.retrans);
+            entry->val = entry->retrans;
+            obj->rankretrans = info.retrans;
+        }
+    }
+}
+
+/**
+ * @brief Publish the flow ranking of the ending interval of a worker to the
+ *        reporter and start the ranking of the next interval.
+ *
+ * @param[in]     mode  A pointer to a mode object.
+ * @param[in,out] top   A pointer to the flow rankings of the calling worker.
+ * @param[in]     index A pointer to the flow index of the calling worker.
+ *
+ * @return Void.
+ */
+static void modeperf_publishrank(const struct modeobj_priv * const mode,
+                                 struct modeperf_flowtop * const top,
+                                 const struct flowindex * const index)
+{
+    uint32_t seq = __atomic_load_n(&top->seq, __ATOMIC_RELAXED);
+
+    if (mode->args.rank == ARGS_RANK_RETRANS)
+    {
+        modeperf_rankretrans(index, &top->build);
+    }
+
+    __atomic_store_n(&top->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    // Retransmit candidates are ranked again by their retransmits.
+    if (top->ranked.lowest == top->build.lowest)
+    {
+        memcpy(top->ranked.entries,
+               top->build.entries,
+               sizeof(struct flowrank_entry) * top->build.count);
+        top->ranked.count = top->build.count;
+    }
+    else
+    {
+        flowrank_clear(&top->ranked);
+        flowrank_merge(&top->ranked, &top->build);
+    }
+
+    __atomic_store_n(&top->seq, seq + 2, __ATOMIC_RELEASE);
+
+    flowrank_clear(&top->build);
+}
+
+/**
+ * @brief Close a client socket and connect it again with a new file
+ *        descriptor. The socket keeps its statistics.
+ *
+ * @param[in,out] sock A pointer to a connected client socket.
+ *
+ * @return True if the socket was opened again and is connecting.
+ */
+static bool modeperf_reconnect(struct sockobj * const sock)
+{
+    bool ret = false;
+    const int32_t fd = sock->fd;
+
+    sock->ops->sock_close(sock);
+
+    if (!sock->ops->sock_open(sock))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket %u could not be opened again\n",
+                      __FUNCTION__,
+                      sock->sid);
+        // The worker removes the old file descriptor when the socket ends.
+        sock->fd    = fd;
+        sock->state = SOCKOBJ_STATE_CLOSE;
+        sock->ops->sock_destroy(sock);
+    }
+    else
+    {
+        sock->info.syscalls++;
+        sock->ops->sock_connect(sock);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Connect a connection-per-transaction flow again once the response of
+ *        its transaction has been received, and measure the transaction from
+ *        the connect.
+ *
+ * @param[in,out] worker A pointer to the state of a worker.
+ * @param[in,out] flow   A pointer to a connected client transaction flow.
+ *
+ * @return Void.
+ */
+static void modeperf_crrnext(struct modeperf_worker * const worker,
+                             struct modeperf_hot * const flow)
+{
+    struct sockobj *sock = flow->sock;
+    struct modeperf_fd *moved = NULL;
+    const int32_t fd = sock->fd;
+    const uint64_t tsns = utildate_gettstime(DATE_CLOCK_MONOTONIC,
+                                             UNIT_TIME_NSEC);
+
+    modeperf_histrecord(worker->hist, tsns - flow->rr->openns);
+
+    if (tsns - flow->rr->openns > flow->rr->maxns)
+    {
+        flow->rr->maxns = tsns - flow->rr->openns;
+    }
+
+    if (!modeperf_reconnect(sock))
+    {
+        modeperf_count(&worker->connhist->lost, 1);
+    }
+    else
+    {
+        worker->fion.ops.fion_deletefd(&worker->fion, fd);
+
+        if ((moved = modeperf_movefd(&worker->flows.fds, fd, sock->fd)) == NULL)
+        {
+            // The old state is removed with the socket.
+            sock->ops->sock_close(sock);
+            sock->ops->sock_destroy(sock);
+        }
+        else
+        {
+            // The connect completes when the socket becomes writable.
+            worker->fion.pevents = FIONOBJ_PEVENT_IN | FIONOBJ_PEVENT_OUT;
+            worker->fion.ops.fion_insertfd(&worker->fion, sock->fd);
+            flow->fd         = sock->fd;
+            flow->ready      = true;
+            flow->pevents    = worker->fion.pevents;
+            flow->rr->openns = tsns;
+
+            if (sock->state & SOCKOBJ_STATE_CONNECT)
+            {
+                modeperf_histrecord(worker->connhist,
+                                    utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC) -
+                                    tsns);
+                modeperf_reindexflow(&worker->index, sock);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Call a flow of a worker. A client flow is connected first, and a
+ *        flow that reached its time or idle limit is closed instead.
+ *
+ * @param[in,out] mode      A pointer to a mode object.
+ * @param[in,out] worker    A pointer to the state of a worker.
+ * @param[in,out] flow      A pointer to a flow.
+ * @param[in]     tsus      The current time in microseconds.
+ * @param[out]    recvbytes A pointer to the number of bytes received.
+ * @param[out]    sendbytes A pointer to the number of bytes sent.
+ *
+ * @return True if a transaction flow waits to send.
+ */
+static bool modeperf_callflow(struct modeobj_priv * const mode,
+                              struct modeperf_worker * const worker,
+                              struct modeperf_hot * const flow,
+                              const uint64_t tsus,
+                              int32_t * const recvbytes,
+                              int32_t * const sendbytes)
+{
+    struct sockobj *sock = flow->sock;
+    const bool client = (mode->args.arch == SOCKOBJ_MODEL_CLIENT);
+    const uint32_t buflen = (flow->ready ? worker->buflen : 0);
+    bool sendwait = false;
+
+    if (modeperf_isexpired(mode, sock, tsus))
+    {
+        sock->ops->sock_close(sock);
+        sock->ops->sock_destroy(sock);
+    }
+    else
+    {
+        // A flow whose connect completes makes its first call in the same
+        // pass.
+        if ((client) &&
+            ((sock->state & SOCKOBJ_STATE_CONNECT) == 0) &&
+            (flow->ready))
+        {
+            sock->info.syscalls++;
+            sock->ops->sock_connect(sock);
+
+            if ((worker->connhist != NULL) &&
+                (sock->state & SOCKOBJ_STATE_CONNECT))
+            {
+                modeperf_histrecord(worker->connhist,
+                                    utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_NSEC) -
+                                    flow->rr->openns);
+            }
+
+            // A connected client knows its local port.
+            if (sock->state & SOCKOBJ_STATE_CONNECT)
+            {
+                modeperf_reindexflow(&worker->index, sock);
+            }
+        }
+
+        if ((client) && ((sock->state & SOCKOBJ_STATE_CONNECT) == 0))
+        {
+            // Do nothing.
+        }
+        else if (flow->rr != NULL)
+        {
+            sendwait = modeperf_rrcall(mode,
+                                       sock,
+                                       flow->rr,
+                                       (client) && (worker->connhist != NULL) ?
+                                       NULL :
+                                       worker->hist,
+                                       worker->recvbuf,
+                                       worker->sendbuf,
+                                       buflen,
+                                       tsus,
+                                       recvbytes,
+                                       sendbytes);
+
+            // A connection-per-transaction flow ends its connection once the
+            // response has been received.
+            if ((client) &&
+                (worker->connhist != NULL) &&
+                (*recvbytes > 0) &&
+                (flow->rr->inflight == 0) &&
+                (flow->rr->respbytes == 0) &&
+                ((sock->state & SOCKOBJ_STATE_CLOSE) == 0))
+            {
+                modeperf_crrnext(worker, flow);
+            }
+        }
+        else
+        {
+            modeperf_streamcall(mode,
+                                sock,
+                                &worker->zcpool,
+                                worker->recvbuf,
+                                worker->sendbuf,
+                                buflen,
+                                tsus,
+                                recvbytes,
+                                sendbytes);
+        }
+    }
+
+    return sendwait;
+}
+
+/**
+ * @brief Record the receive and send sizes and gaps of a stream flow in the
+ *        flow histograms of its worker.
+ *
+ * @param[in]     mode      A pointer to a mode object.
+ * @param[in,out] worker    A pointer to the state of a worker with flow
+ *                          histograms.
+ * @param[in]     flow      A pointer to a stream flow.
+ * @param[in]     tsus      The current time in microseconds.
+ * @param[in]     recvbytes The number of bytes received by the last call.
+ * @param[in]     sendbytes The number of bytes sent by the last call.
+ *
+ * @return Void.
+ */
+static void modeperf_recordflow(const struct modeobj_priv * const mode,
+                                struct modeperf_worker * const worker,
+                                const struct modeperf_hot * const flow,
+                                const uint64_t tsus,
+                                const int32_t recvbytes,
+                                const int32_t sendbytes)
+{
+    struct modeperf_flowhist *flowhist = worker->flowhist;
+    struct modeperf_fd *state = modeperf_getfd(&worker->flows.fds,
+                                               flow->fd,
+                                               false);
+
+    if ((recvbytes > 0) && (state != NULL))
+    {
+        utilstats_histrecord(&flowhist->recvsize, (uint64_t)recvbytes);
+
+        if (state->recvus > 0)
+        {
+            utilstats_histrecord(&flowhist->recvgap, tsus - state->recvus);
+        }
+
+        state->recvus = tsus;
+    }
+
+    if (sendbytes > 0)
+    {
+        utilstats_histrecord(&flowhist->sendsize, (uint64_t)sendbytes);
+
+        if ((state != NULL) && (modeperf_ispaced(mode, flow->sock)))
+        {
+            if (state->sendus > 0)
+            {
+                utilstats_histrecord(&flowhist->sendgap, tsus - state->sendus);
+            }
+
+            if (state->releaseus > 0)
+            {
+                utilstats_histrecord(&flowhist->sendlate,
+                                     tsus > state->releaseus ?
+                                     tsus - state->releaseus :
+                                     0);
+            }
+
+            state->sendus    = tsus;
+            state->releaseus = 0;
+        }
+    }
+}
+
+/**
+ * @brief Remove a closed flow from its worker and return its socket.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] worker A pointer to the state of a worker.
+ * @param[in,out] flow   A pointer to a flow with a closed socket.
+ * @param[in]     stats  Function-specific socket statistics.
+ * @param[in]     tid    A worker thread id.
+ *
+ * @return Void.
+ */
+static void modeperf_closeflow(struct modeobj_priv * const mode,
+                               struct modeperf_worker * const worker,
+                               struct modeperf_hot * const flow,
+                               const struct sockobj_flowstats * const stats,
+                               const uint32_t tid)
+{
+    struct sockobj *sock = flow->sock;
+
+    sock->info.syscalls = 0;
+    modeperf_endsock(mode, sock, stats, tid, worker->flows.count == 1);
+    modeperf_zcrelease(&worker->zcpool, sock);
+    worker->fion.ops.fion_deletefd(&worker->fion, sock->fd);
+
+    if (flow->rr != NULL)
+    {
+        mempool_free(&mode->pools[tid].rrs, flow->rr);
+    }
+
+    flowindex_remove(&worker->index, modeperf_getnode(sock));
+    modeperf_retsock(mode, sock, tid);
+    // The last flow takes the place of the removed flow.
+    modeperf_removeflow(&worker->flows, flow);
+}
+
+/**
+ * @brief Schedule the next call of an open flow: a paced flow waits for its
+ *        timer, a flow that would block waits for the event loop (or a
+ *        deadline), and any other flow is called again in the next pass.
+ *
+ * @param[in]     mode     A pointer to a mode object.
+ * @param[in,out] worker   A pointer to the state of a worker.
+ * @param[in,out] flow     A pointer to an open flow.
+ * @param[in]     tsus     The current time in microseconds.
+ * @param[in]     moved    True if the last call moved any bytes.
+ * @param[in]     sendwait True if a transaction flow waits to send.
+ *
+ * @return Void.
+ */
+static void modeperf_scheduleflow(const struct modeobj_priv * const mode,
+                                  struct modeperf_worker * const worker,
+                                  struct modeperf_hot * const flow,
+                                  const uint64_t tsus,
+                                  const bool moved,
+                                  const bool sendwait)
+{
+    struct sockobj *sock = flow->sock;
+    struct modeperf_fd *state = NULL;
+    uint64_t releaseus = 0;
+    uint32_t flowpevents = 0;
+
+    // Prevent thread spin when no bytes are available.
+    if (!moved)
+    {
+        if (((sock->state & SOCKOBJ_STATE_CONNECT) != 0) &&
+            (modeperf_ispaced(mode, sock)))
+        {
+            releaseus = modeperf_getrelease(mode, sock, tsus);
+
+            // A full-duplex flow keeps receiving while its sends are paced.
+            if ((sock->conf.direction == SOCKOBJ_DIRECTION_DUPLEX) &&
+                (releaseus > tsus + MODEPERF_DUPLEXUS))
+            {
+                releaseus = tsus + MODEPERF_DUPLEXUS;
+            }
+        }
+
+        // Only an operation that would block waits for the event loop to
+        // report the socket as ready.
+        if ((sock->info.syscalls > 0) || (!flow->ready))
+        {
+            flow->ready = false;
+        }
+    }
+    else
+    {
+        flow->ready = true;
+    }
+
+    sock->info.syscalls = 0;
+
+    // A transaction flow waits for its peer, and only waits to send if a send
+    // would block. A paced socket is usually writable, so a paced flow does
+    // not wait to send (or the event loop would not block until its timer),
+    // and only waits again once a send would block.
+    flowpevents = flow->pevents;
+
+    if ((sock->state & SOCKOBJ_STATE_CONNECT) == 0)
+    {
+        // Do nothing (a connect in progress waits to become writable).
+    }
+    else if (flow->rr != NULL)
+    {
+        flowpevents = FIONOBJ_PEVENT_IN | (sendwait ? FIONOBJ_PEVENT_OUT : 0);
+    }
+    else if (!flow->ready)
+    {
+        flowpevents = worker->sockpevents;
+    }
+
+    if (releaseus > 0)
+    {
+        flowpevents &= ~(uint32_t)FIONOBJ_PEVENT_OUT;
+    }
+
+    if (flowpevents != flow->pevents)
+    {
+        worker->fion.ops.fion_setfdflags(&worker->fion, sock->fd, flowpevents);
+        flow->pevents = flowpevents;
+    }
+
+    if (releaseus > 0)
+    {
+        modeperf_waitflow(mode, &worker->flows, flow, releaseus);
+
+        if ((worker->flowhist != NULL) &&
+            (flow->rr == NULL) &&
+            ((state = modeperf_getfd(&worker->flows.fds, flow->fd, false)) != NULL))
+        {
+            state->releaseus = releaseus;
+        }
+    }
+    else if (flow->ready)
+    {
+        modeperf_runflow(&worker->flows, flow);
+    }
+    else
+    {
+        modeperf_waitflow(mode, &worker->flows, flow, 0);
+    }
+}
+
+/**
+ * @brief Perform one step of a flow of a worker: call the flow, account for
+ *        what it moved, and then either remove it if it closed or schedule
+ *        its next call.
+ *
+ * @param[in,out] mode   A pointer to a mode object.
+ * @param[in,out] worker A pointer to the state of a worker.
+ * @param[in,out] flow   A pointer to a flow taken from the run queue.
+ * @param[in]     tid    A worker thread id.
+ * @param[in]     tsus   The current time in microseconds.
+ *
+ * @return True if the flow was closed and removed.
+ */
+static bool modeperf_stepflow(struct modeobj_priv * const mode,
+                              struct modeperf_worker * const worker,
+                              struct modeperf_hot * const flow,
+                              const uint32_t tid,
+                              const uint64_t tsus)
+{
+    bool ret = false, sendwait = false;
+    struct sockobj *sock = flow->sock;
+    const struct sockobj_flowstats *stats = modeperf_getstats(mode, sock);
+    int32_t recvbytes = 0, sendbytes = 0;
+
+    sendwait = modeperf_callflow(mode, worker, flow, tsus, &recvbytes, &sendbytes);
+
+    if (recvbytes > 0)
+    {
+        modeperf_count(&mode->counters[tid].recvbytes, (uint64_t)recvbytes);
+    }
+
+    if (sendbytes > 0)
+    {
+        modeperf_count(&mode->counters[tid].sendbytes, (uint64_t)sendbytes);
+    }
 
-        threadobj_sleepusec(1000000);
+    if ((worker->flowhist != NULL) && (flow->rr == NULL))
+    {
+        modeperf_recordflow(mode, worker, flow, tsus, recvbytes, sendbytes);
     }
 
-    for (i = 0; i < mode->args.threads; i++)
+    worker->syscalls += sock->info.syscalls;
+    worker->datagrams += sock->info.datagrams;
+    worker->zcsends += sock->info.zcsends;
+    worker->zccopies += sock->info.zccopies;
+    sock->info.datagrams = 0;
+    sock->info.zcsends = 0;
+    sock->info.zccopies = 0;
+
+    if (sock->state & SOCKOBJ_STATE_CLOSE)
     {
-        mode->workerforms[i].ops.form_destroy(&mode->workerforms[i]);
+        modeperf_closeflow(mode, worker, flow, stats, tid);
+        ret = true;
     }
+    else
+    {
+        // A flow ranks itself once per interval if it was measured for long
+        // enough (a flow that was just added or ranked at the end of the last
+        // interval is ranked at the end of this one).
+        if ((worker->flowtop != NULL) &&
+            (((struct modeperf_sock *)sock)->rankgen != worker->rankgen) &&
+            (tsus - modeperf_getnode(sock)->ageus >= mode->args.intervalusec / 2))
+        {
+            modeperf_rankflow(mode,
+                              &worker->index,
+                              &worker->flowtop->build,
+                              sock,
+                              flow->rr,
+                              worker->rankgen,
+                              tsus);
+        }
 
-    logger_printf(LOGGER_LEVEL_INFO,
-                  "Finished reporting sockets on thread id %u\n",
-                  threadpool_getid(&mode->threadpool));
+        modeperf_scheduleflow(mode,
+                              worker,
+                              flow,
+                              tsus,
+                              (recvbytes != 0) || (sendbytes != 0),
+                              sendwait);
+    }
 
-    return NULL;
+    return ret;
 }
 
 /**
@@ -879,95 +5754,240 @@ static void *modeperf_workerthread(void *arg)
 {
     struct modeobj_priv *mode = (struct modeobj_priv*)arg;
     struct threadobj *thread = threadpool_getthread(&mode->threadpool);
-    bool exit = true;
-    struct fionobj fion;
-    struct dlist list;
-    struct sockobj *sock = NULL;
-    uint8_t *recvbuf = NULL, *sendbuf = NULL;
-    int32_t recvbytes = 0, sendbytes = 0;
-    uint32_t count = 0, tid = 0;
-
-    struct dlist_node *next = NULL, *node = NULL;
-    struct sockobj_flowstats *stats = NULL;
-    struct utilcpu_info info;
-    uint64_t delayus = 0, mindelayus = 0;
-    uint64_t tsus = 0;
+    bool exit = true, accept = true;
+    struct modeperf_worker worker;
+    struct sockobj *sock = NULL, *listener = NULL;
+    struct modeperf_hot *flow = NULL;
+    struct modeperf_fd *state = NULL;
+    struct modeperf_run *run = NULL;
+    struct doorbellobj *bell = NULL;
+    struct mempool_stats poolstats;
+    struct timerwheel_timer timers[MODEPERF_TIMERS];
+    struct pacetimer pacer;
+    struct flowindex_node *node = NULL;
+    int32_t bellfd = -1, listenfd = -1;
+    uint32_t count = 0, i, n, tid = 0, listenpevents, queue;
+    uint64_t nextus = 0, arms = 0, acceptusec = 0, cpuusec = 0, tsus = 0;
+    uint64_t rankusec = 0;
     uint32_t burstlimit = mode->args.backlog <= 0 ? SOMAXCONN : mode->args.backlog;
     uint32_t burst = 0;
-    memset(&fion, 0, sizeof(fion));
-
+    memset(&worker, 0, sizeof(worker));
+    memset(&poolstats, 0, sizeof(poolstats));
+    memset(&pacer, 0, sizeof(pacer));
+    flowindex_create(&worker.index);
+
+    // A batched UDP call fills or drains several datagrams at once, and a
+    // receive offload buffer must hold the largest coalesced buffer.
+    worker.buflen = (uint32_t)mode->args.buflen *
+                    (mode->args.type == SOCK_DGRAM ? mode->args.batch : 1);
+    worker.buflen = ((mode->args.gso) && (worker.buflen < UINT16_MAX) ?
+                     UINT16_MAX :
+                     worker.buflen);
+    worker.rankgen = 1;
     tid = threadpool_getid(&mode->threadpool);
+    worker.hist = (mode->hists == NULL ? NULL : &mode->hists[tid]);
+    worker.connhist = (mode->connhists == NULL ? NULL : &mode->connhists[tid]);
+    worker.flowhist = (mode->flowhists == NULL ? NULL : &mode->flowhists[tid]);
+    worker.flowtop = (mode->flowtops == NULL ? NULL : &mode->flowtops[tid]);
+    bell = &mode->bells[tid];
+    bellfd = doorbellobj_getfd(bell);
+    listener = modeperf_getlistener(mode, tid);
+    listenfd = (listener == NULL ? -1 : listener->fd);
+    accept = (listener != NULL);
+    listenpevents = FIONOBJ_PEVENT_IN |
+                    (mode->listener == ARGS_LISTENER_EXCLUSIVE ?
+                     FIONOBJ_PEVENT_EXCL :
+                     0);
+    worker.sockpevents = (sockobj_issender(mode->args.arch, mode->args.direction) ?
+                          FIONOBJ_PEVENT_OUT :
+                          0) |
+                         (sockobj_isreceiver(mode->args.arch, mode->args.direction) ?
+                          FIONOBJ_PEVENT_IN :
+                          0);
+    tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
     logger_printf(LOGGER_LEVEL_INFO,
                   "Working sockets on thread id %u\n",
                   tid);
 
-    if (!fionpoll_create(&fion))
+    if (!fionobj_create(&worker.fion, mode->args.event))
     {
         // Do nothing.
     }
-    else if ((recvbuf = UTILMEM_CALLOC(uint8_t,
-                                       sizeof(uint8_t),
-                                       mode->args.buflen)) == NULL)
+    else if ((worker.recvbuf = UTILMEM_CALLOC(uint8_t,
+                                              sizeof(uint8_t),
+                                              worker.buflen)) == NULL)
     {
         logger_printf(LOGGER_LEVEL_ERROR,
                       "%s: receive buffer allocation failed\n",
                       __FUNCTION__);
     }
-    else if ((sendbuf = UTILMEM_CALLOC(uint8_t,
-                                       sizeof(uint8_t),
-                                       mode->args.buflen)) == NULL)
+    else if ((worker.sendbuf = UTILMEM_CALLOC(uint8_t,
+                                              sizeof(uint8_t),
+                                              worker.buflen)) == NULL)
     {
         logger_printf(LOGGER_LEVEL_ERROR,
                       "%s: send buffer allocation failed\n",
                       __FUNCTION__);
 
-        UTILMEM_FREE(recvbuf);
-        recvbuf = NULL;
+        UTILMEM_FREE(worker.recvbuf);
+        worker.recvbuf = NULL;
+    }
+    else if ((mode->args.uring) &&
+             (modeperf_uringworker(mode,
+                                   thread,
+                                   tid,
+                                   worker.recvbuf,
+                                   worker.sendbuf)))
+    {
+        UTILMEM_FREE(worker.recvbuf);
+        UTILMEM_FREE(worker.sendbuf);
+        worker.fion.ops.fion_destroy(&worker.fion);
+    }
+    // The flow array starts with room for every preallocated socket.
+    else if ((!mempool_getstats(&mode->pools[tid].socks, &poolstats)) ||
+             (!modeperf_createflows(&worker.flows, poolstats.count, tsus)))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket state allocation failed\n",
+                      __FUNCTION__);
+
+        UTILMEM_FREE(worker.recvbuf);
+        UTILMEM_FREE(worker.sendbuf);
+        worker.fion.ops.fion_destroy(&worker.fion);
+    }
+    else if ((mode->args.zerocopy) &&
+             (sockobj_issender(mode->args.arch, mode->args.direction)) &&
+             (!modeperf_zccreate(&worker.zcpool, worker.buflen)))
+    {
+        UTILMEM_FREE(worker.recvbuf);
+        UTILMEM_FREE(worker.sendbuf);
+        modeperf_destroyflows(&worker.flows);
+        worker.fion.ops.fion_destroy(&worker.fion);
+    }
+    // Spinning for a paced send only helps if the wakeup before it is not
+    // delayed by the timer slack of the worker.
+    else if (!pacetimer_create(&pacer,
+                               mode->args.spinusec,
+                               mode->args.spinusec > 0 ? 1 : MODEPERF_SLACKNS))
+    {
+        UTILMEM_FREE(worker.recvbuf);
+        UTILMEM_FREE(worker.sendbuf);
+        modeperf_zcdestroy(&worker.zcpool);
+        modeperf_destroyflows(&worker.flows);
+        worker.fion.ops.fion_destroy(&worker.fion);
     }
     else
     {
         exit = false;
-        fion.timeoutms = 0;
-        fion.pevents = FIONOBJ_PEVENT_IN;
-        memset(&list, 0, sizeof(list));
+        worker.fion.timeoutms = 0;
+        // Watch the socket queue doorbell so that the worker waits for new
+        // sockets in its event loop, and the pacing timer so that it waits
+        // for its next timer with microsecond resolution.
+        worker.fion.pevents = FIONOBJ_PEVENT_IN;
+        worker.fion.ops.fion_insertfd(&worker.fion, bellfd);
+
+        if (pacetimer_getfd(&pacer) >= 0)
+        {
+            worker.fion.ops.fion_insertfd(&worker.fion, pacetimer_getfd(&pacer));
+        }
+
+        // A worker that owns a listener also waits for new connections in
+        // its event loop.
+        if (listener != NULL)
+        {
+            worker.fion.pevents = listenpevents;
+            worker.fion.ops.fion_insertfd(&worker.fion, listenfd);
+        }
+
+        worker.fion.pevents = worker.sockpevents;
+        rankusec = tsus;
 
         while ((!exit) && (threadobj_isrunning(thread)))
         {
             burst = count;
 
+            // Accept when the listener is ready, and periodically while busy
+            // sockets keep the worker from waiting in its event loop.
+            if ((listener != NULL) &&
+                ((accept) || (tsus - acceptusec >= MODEPERF_ACCEPTUS)))
+            {
+                acceptusec = tsus;
+                accept = (modeperf_acceptshard(mode,
+                                               tid,
+                                               listener,
+                                               burstlimit) == burstlimit);
+                worker.syscalls++;
+
+                // A datagram listener was handed to the accepted socket.
+                if (listener->fd != listenfd)
+                {
+                    worker.fion.ops.fion_deletefd(&worker.fion, listenfd);
+                    listenfd = listener->fd;
+                    worker.fion.pevents = listenpevents;
+                    worker.fion.ops.fion_insertfd(&worker.fion, listenfd);
+                    worker.fion.pevents = worker.sockpevents;
+                }
+            }
+
             while ((!exit) && ((count - burst) < burstlimit))
             {
-                if ((sock = modeperf_getsock(mode,
-                                             tid,
-                                             list.size > 0 ? 0 : 500,
-                                             &exit)) != NULL)
+                if ((sock = modeperf_getsock(mode, tid, &exit)) != NULL)
                 {
-                    dlist_inserttail(&list, sock);
-                    if ((mode->args.maxcon == 0) ||
-                        (list.size <= mode->args.maxcon))
+                    if (((mode->args.maxcon == 0) ||
+                         (worker.flows.count < mode->args.maxcon)) &&
+                        ((state = modeperf_getfd(&worker.flows.fds, sock->fd, true)) != NULL) &&
+                        ((flow = modeperf_addflow(&worker.flows)) != NULL) &&
+                        ((mode->args.workload == ARGS_WORKLOAD_STREAM) ||
+                         ((flow->rr = mempool_get(&mode->pools[tid].rrs)) != NULL)))
                     {
-                        fion.ops.fion_insertfd(&fion, sock->fd);
-                        mutexobj_lock(&mode->mtxarr[tid]);
-                        mode->workerstats[tid].sid = ++count;
-                        mutexobj_unlock(&mode->mtxarr[tid]);
-                        //??sock->sid = ++count;
-                        sock->tid = tid;
-                        sock->event.timeoutms = 0;
+                        // A new socket is ready until an operation on it
+                        // would block.
+                        worker.fion.ops.fion_insertfd(&worker.fion, sock->fd);
+                        flow->sock    = sock;
+                        flow->fd      = sock->fd;
+                        flow->id      = count + 1;
+                        flow->ready   = true;
+                        flow->pevents = worker.sockpevents;
+                        state->flow   = ++worker.flows.count;
+                        state->recvus = 0;
+                        state->sendus = 0;
+                        state->releaseus = 0;
+                        modeperf_runflow(&worker.flows, flow);
+
+                        // The datagram that created an accepted datagram
+                        // socket was its first request.
+                        if ((flow->rr != NULL) &&
+                            (mode->args.arch == SOCKOBJ_MODEL_SERVER) &&
+                            (mode->args.type == SOCK_DGRAM))
+                        {
+                            flow->rr->inflight = 1;
+                        }
 
-                        if (list.size == 1)
+                        if (worker.connhist != NULL)
+                        {
+                            flow->rr->openns = sock->info.startusec * 1000ULL;
+                        }
+                        modeperf_publish(&mode->counters[tid], true);
+                        mode->counters[tid].sid = ++count;
+                        if (worker.flows.count == 1)
                         {
-                            mutexobj_lock(&mode->mtxarr[tid]);
-                            mode->workerstats[tid].info.startusec = sock->info.startusec;
-                            mutexobj_unlock(&mode->mtxarr[tid]);
+                            mode->counters[tid].startusec = sock->info.startusec;
+                            mode->counters[tid].stopusec  = 0;
                         }
+                        modeperf_publish(&mode->counters[tid], false);
+                        sock->sid = count;
+                        sock->tid = tid;
+                        modeperf_indexflow(&worker.index,
+                                           sock,
+                                           utildate_gettstime(DATE_CLOCK_MONOTONIC,
+                                                              UNIT_TIME_USEC));
                     }
                     else
                     {
                         // Refuse connection.
-                        sock->ops.sock_close(sock);
-                        sock->ops.sock_destroy(sock);
-                        modeperf_retsock(mode, list.tail->val, tid);
-                        dlist_removetail(&list);
+                        sock->ops->sock_close(sock);
+                        sock->ops->sock_destroy(sock);
+                        modeperf_retsock(mode, sock, tid);
                         sock = NULL;
                     }
                 }
@@ -977,199 +5997,204 @@ static void *modeperf_workerthread(void *arg)
                 }
             }
 
-            node = list.head;
+            // Take one timestamp per pass, and return the flows whose timers
+            // fired to the run queue.
+            tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
 
-            while (node != NULL)
+            do
             {
-                sock = node->val;
-
-                // @todo Perform once per iteration?
-                tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+                n = timerwheel_expire(&worker.flows.wheel, tsus, timers, MODEPERF_TIMERS);
 
-                if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
+                for (i = 0; i < n; i++)
                 {
-                    stats = &sock->info.send;
-
-                    if ((sock->state & SOCKOBJ_STATE_CONNECT) == 0)
-                    {
-                        sock->ops.sock_connect(sock);
-                        sendbytes = 0;
-                    }
-                    else
-                    {
-                        sendbytes = modeperf_call(mode,
-                                                  sock->ops.sock_send,
-                                                  &sock->info.send,
-                                                  sock,
-                                                  sendbuf,
-                                                  mindelayus > 0 ? 0 : mode->args.buflen,
-                                                  tsus);
-                    }
-
-                    if (sendbytes > 0)
+                    if (((flow = modeperf_getflow(&worker.flows, (int32_t)(uint32_t)timers[i].key)) != NULL) &&
+                        (flow->id == (uint32_t)(timers[i].key >> 32)))
                     {
-                        mutexobj_lock(&mode->mtxarr[tid]);
-                        mode->workerstats[tid].info.send.buflen.sum += sendbytes;
-                        mutexobj_unlock(&mode->mtxarr[tid]);
-                    }
-
-                    if ((sock->state & SOCKOBJ_STATE_CLOSE) == 0)
-                    {
-                        // Prevent thread spin when no bytes are available.
-                        if (sendbytes == 0)
-                        {
-                            if (sock->tb.rate > 0)
-                            {
-                                delayus = tokenbucket_delay(&sock->tb,
-                                                            mode->args.buflen * 8);
-
-                                if ((delayus < mindelayus) || (mindelayus == 0))
-                                {
-                                    mindelayus = delayus;
-                                }
-                            }
-                            else
-                            {
-                                fion.timeoutms++;
-                                fion.pevents = FIONOBJ_PEVENT_OUT;
-                            }
-                        }
-                        else
-                        {
-                            fion.timeoutms = 0;
-                            fion.pevents = FIONOBJ_PEVENT_IN;
-                        }
+                        modeperf_wakeflow(&worker.flows, flow, true);
                     }
                 }
-                else
+            }
+            while (n == MODEPERF_TIMERS);
+
+            // Rank every flow once per report interval without visiting
+            // every flow: a flow that is called ranks itself (see
+            // modeperf_stepflow()), and only the flows that were not ranked
+            // in the ending interval (e.g., new or starved flows) are ranked
+            // here. A ranking moves a flow to the newest end of the flow
+            // index, so these flows are the oldest flows.
+            if ((worker.flowtop != NULL) &&
+                (tsus - rankusec >= mode->args.intervalusec))
+            {
+                while (((node = flowindex_getoldest(&worker.index)) != NULL) &&
+                       (modeperf_getindexed(node)->rankgen != worker.rankgen))
                 {
-                    stats = &sock->info.recv;
+                    sock = &modeperf_getindexed(node)->sock;
+                    flow = modeperf_getflow(&worker.flows, sock->fd);
+                    modeperf_rankflow(mode,
+                                      &worker.index,
+                                      &worker.flowtop->build,
+                                      sock,
+                                      flow == NULL ? NULL : flow->rr,
+                                      worker.rankgen,
+                                      tsus);
+                }
 
-                    recvbytes = modeperf_call(mode,
-                                              sock->ops.sock_recv,
-                                              &sock->info.recv,
-                                              sock,
-                                              recvbuf,
-                                              mindelayus > 0 ? 0 : mode->args.buflen,
-                                              tsus);
+                modeperf_publishrank(mode, worker.flowtop, &worker.index);
+                rankusec = tsus;
+                worker.rankgen = (worker.rankgen == UINT32_MAX ?
+                                  1 :
+                                  worker.rankgen + 1);
+            }
 
-                    if (recvbytes > 0)
-                    {
-                        mutexobj_lock(&mode->mtxarr[tid]);
-                        mode->workerstats[tid].info.recv.buflen.sum += recvbytes;
-                        mutexobj_unlock(&mode->mtxarr[tid]);
-                    }
+            // The flows that are called in this pass only return to the run
+            // queue for the next pass.
+            queue = worker.flows.next;
+            worker.flows.next ^= 1;
+            worker.flows.runcount[worker.flows.next] = 0;
 
-                    if ((sock->state & SOCKOBJ_STATE_CLOSE) == 0)
-                    {
-                        // Prevent thread spin when no bytes are available.
-                        if (recvbytes == 0)
-                        {
-                            if (sock->tb.rate > 0)
-                            {
-                                delayus = tokenbucket_delay(&sock->tb,
-                                                            mode->args.buflen * 8);
-
-                                if ((delayus < mindelayus) || (mindelayus == 0))
-                                {
-                                    mindelayus = delayus;
-                                }
-                            }
-                            else
-                            {
-                                fion.timeoutms++;
-                            }
-                        }
-                        else
-                        {
-                            fion.timeoutms = 0;
-                        }
-                    }
+            for (n = 0; n < worker.flows.runcount[queue]; n++)
+            {
+                run = (struct modeperf_run *)vector_getval(&worker.flows.runq[queue], n);
+
+                if (((flow = modeperf_getflow(&worker.flows, run->fd)) == NULL) ||
+                    (flow->id != run->id) ||
+                    (!flow->queued))
+                {
+                    // The flow was removed.
+                    continue;
+                }
+
+                flow->queued = false;
+
+                // A receive gap is measured per flow.
+                if (worker.flowhist != NULL)
+                {
+                    tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
                 }
 
-                if (sock->state & SOCKOBJ_STATE_CLOSE)
+                if ((modeperf_stepflow(mode, &worker, flow, tid, tsus)) &&
+                    (worker.flows.count == 0))
                 {
-                    if (list.size == 1)
+                    count = 0;
+
+                    if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
                     {
-                        mutexobj_lock(&mode->mtxarr[tid]);
-                        mode->workerstats[tid].info.stopusec = sock->info.stopusec;
-                        mutexobj_unlock(&mode->mtxarr[tid]);
+                        exit = true;
                     }
+                }
+            }
 
-                    utilcpu_getinfo(&info);
-                    logger_printf(LOGGER_LEVEL_DEBUG,
-                                  "%s: tid: %u cpu load: %d usr/sys time sec: %u.%06u / %u.%06u\n",
-                                  __FUNCTION__,
-                                  tid,
-                                  info.usage,
-                                  info.usrtime.tv_sec,
-                                  info.usrtime.tv_usec,
-                                  info.systime.tv_sec,
-                                  info.systime.tv_usec);
-                    logger_printf(LOGGER_LEVEL_INFO,
-                                  "%s: buflen avg/min/max: %" PRIi64
-                                  " / %" PRIi64
-                                  " / %" PRIi64 "\n",
-                                  __FUNCTION__,
-                                  stats->buflen.avg,
-                                  stats->buflen.min,
-                                  stats->buflen.max);
-
-                    next = node->next;
-                    modeperf_retsock(mode, node->val, tid);
-                    dlist_remove(&list, node);
-                    node = next;
-                    fion.ops.fion_deletefd(&fion, sock->fd);
+            if (exit)
+            {
+                // Do nothing.
+            }
+            else if (worker.flows.runcount[worker.flows.next] > 0)
+            {
+                // Check the flows that wait for the event loop without
+                // blocking, and only if there are any.
+                if (worker.flows.count > worker.flows.runcount[worker.flows.next] + worker.flows.paced)
+                {
+                    worker.syscalls++;
 
-                    if (list.size == 0)
+                    if (worker.fion.ops.fion_poll(&worker.fion))
                     {
-                        count = 0;
-
-                        if (mode->args.arch == SOCKOBJ_MODEL_CLIENT)
-                        {
-                            exit = true;
-                        }
+                        modeperf_pollready(&worker.fion,
+                                           &worker.flows,
+                                           bell,
+                                           &pacer,
+                                           listenfd,
+                                           &accept);
                     }
                 }
+            }
+            else
+            {
+                // Wait for readiness until the next timer, and only block if
+                // no new socket is queued after the doorbell is armed. A
+                // worker without sockets waits for its doorbell. The pacing
+                // timer wakes the worker for its next timer (the event loop
+                // timeout only backs it up), and a timer that is due within
+                // the spin time is spun for instead.
+                nextus = timerwheel_getnext(&worker.flows.wheel);
+                arms = pacer.arms;
+
+                if ((nextus <= tsus) || (pacetimer_spin(&pacer, nextus)))
+                {
+                    worker.fion.timeoutms = 0;
+                }
+                else if ((nextus - tsus < MODEPERF_IDLEMS * 1000ULL) &&
+                         (!pacetimer_arm(&pacer, nextus)))
+                {
+                    worker.fion.timeoutms = (int32_t)((nextus - tsus + 999) / 1000);
+                }
                 else
                 {
-                    node = node->next;
+                    worker.fion.timeoutms = MODEPERF_IDLEMS;
                 }
-            }
 
-            if (mindelayus > 0)
-            {
-                // @todo Replace with semaphore.
-                if (mindelayus > 100000)
+                worker.syscalls += pacer.arms - arms;
+
+                if (worker.fion.timeoutms > 0)
                 {
-                    //usleep(100000);
-                    mindelayus -= 100000;
+                    doorbellobj_arm(bell);
+
+                    if ((accept) || (lfqueue_getsize(&mode->sockq[tid]) > 0))
+                    {
+                        worker.fion.timeoutms = 0;
+                    }
                 }
-                else
+
+                worker.syscalls += (worker.flows.count > 0 ? 1 : 0);
+
+                if (worker.fion.ops.fion_poll(&worker.fion))
                 {
-                    usleep((uint32_t)mindelayus);
-                    mindelayus = 0;
+                    modeperf_pollready(&worker.fion,
+                                       &worker.flows,
+                                       bell,
+                                       &pacer,
+                                       listenfd,
+                                       &accept);
                 }
+
+                worker.fion.timeoutms = 0;
             }
-            else if ((list.size > 0) && ((uint32_t)fion.timeoutms == list.size))
+
+            modeperf_count(&mode->counters[tid].syscalls, worker.syscalls);
+            modeperf_count(&mode->counters[tid].datagrams, worker.datagrams);
+            modeperf_count(&mode->counters[tid].zcsends, worker.zcsends);
+            modeperf_count(&mode->counters[tid].zccopies, worker.zccopies);
+            worker.syscalls = 0;
+            worker.datagrams = 0;
+            worker.zcsends = 0;
+            worker.zccopies = 0;
+
+            // Sample CPU usage periodically rather than on every pass.
+            if (tsus - cpuusec >= MODEPERF_CPUUS)
             {
-                fion.timeoutms = 1;
-                fion.ops.fion_setflags(&fion);
-                fion.ops.fion_poll(&fion);
-                fion.timeoutms = 0;
+                cpuusec = tsus;
+                modeperf_publishcpu(&mode->counters[tid]);
             }
+        }
+
+        for (i = 0; i < worker.flows.count; i++)
+        {
+            flow = (struct modeperf_hot *)vector_getval(&worker.flows.hot, i);
 
-            mutexobj_lock(&mode->mtxarr[tid]);
-            mode->workerstats[tid].cpu.startusec = mode->workerstats[tid].info.startusec;
-            utilcpu_getinfo(&mode->workerstats[tid].cpu);
-            mutexobj_unlock(&mode->mtxarr[tid]);
+            if (flow->rr != NULL)
+            {
+                mempool_free(&mode->pools[tid].rrs, flow->rr);
+            }
         }
 
-        UTILMEM_FREE(recvbuf);
-        UTILMEM_FREE(sendbuf);
-        fionpoll_destroy(&fion);
+        UTILMEM_FREE(worker.recvbuf);
+        UTILMEM_FREE(worker.sendbuf);
+        modeperf_zcdestroy(&worker.zcpool);
+        modeperf_destroyflows(&worker.flows);
+        pacetimer_destroy(&pacer);
+        worker.fion.ops.fion_destroy(&worker.fion);
     }
 
+    flowindex_destroy(&worker.index);
     logger_printf(LOGGER_LEVEL_INFO,
                   "Finished working sockets on thread id %u\n",
                   tid);
@@ -1177,49 +6202,252 @@ static void *modeperf_workerthread(void *arg)
     return NULL;
 }
 
-bool modeperf_start(struct modeobj * const mode)
+/**
+ * @brief Attach a classic BPF program to a group of sharded listeners that
+ *        steers each new flow to the listener of the worker pinned to the CPU
+ *        that received the flow (or to CPU modulo worker count if the workers
+ *        are not pinned). Listener i must be the i-th member of the group.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ *
+ * @return True if a program was attached.
+ */
+static bool modeperf_attachcbpf(struct modeobj_priv * const mode)
 {
     bool ret = false;
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_filter *code = NULL;
+    struct sock_fprog prog;
+    uint32_t i, len = 0;
+    int32_t cpu;
+
+    if ((code = UTILMEM_CALLOC(struct sock_filter,
+                               sizeof(struct sock_filter),
+                               2 * mode->listenercount + 3)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate memory\n",
+                      __FUNCTION__);
+    }
+    else
+    {
+        code[len++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+                                                   SKF_AD_OFF + SKF_AD_CPU);
+
+        // Return the listener of the worker pinned to the receiving CPU.
+        for (i = 0; i < mode->listenercount; i++)
+        {
+            if ((cpu = threadpool_getcpu(&mode->threadpool, i)) > -1)
+            {
+                code[len++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                                                           (uint32_t)cpu,
+                                                           0,
+                                                           1);
+                code[len++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, i);
+            }
+        }
+
+        code[len++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_MOD | BPF_K,
+                                                   mode->listenercount);
+        code[len++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_A, 0);
+
+        prog.len    = (uint16_t)len;
+        prog.filter = code;
+
+        if (setsockopt(mode->listeners[0].fd,
+                       SOL_SOCKET,
+                       SO_ATTACH_REUSEPORT_CBPF,
+                       &prog,
+                       sizeof(prog)) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to attach reuseport program (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            ret = true;
+        }
+
+        UTILMEM_FREE(code);
+    }
+#else
+    logger_printf(LOGGER_LEVEL_WARN,
+                  "%s: reuseport programs are not supported\n",
+                  __FUNCTION__);
+#endif
+
+    return ret;
+}
+
+/**
+ * @brief Open the listeners that are owned by workers. Sharded listeners are
+ *        opened in worker order so that the i-th member of the SO_REUSEPORT
+ *        group belongs to worker i.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ *
+ * @return True if the listeners were opened.
+ */
+static bool modeperf_openlisteners(struct modeobj_priv * const mode)
+{
+    bool ret = true;
     uint32_t i;
 
-    if (UTILDEBUG_VERIFY((mode != NULL) && (mode->priv != NULL)))
+    mode->listener = (mode->args.arch == SOCKOBJ_MODEL_SERVER ?
+                      mode->args.listener :
+                      ARGS_LISTENER_SINGLE);
+
+    // A datagram listener is handed to the flow that it accepts, so it can
+    // neither be shared nor keep its place in a reuseport group.
+    if ((mode->args.type == SOCK_DGRAM) &&
+        (mode->listener > ARGS_LISTENER_SHARD))
     {
-        threadpool_stop(&mode->priv->threadpool);
-        ret = threadpool_start(&mode->priv->threadpool);
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: using sharded listeners for UDP\n",
+                      __FUNCTION__);
+        mode->listener = ARGS_LISTENER_SHARD;
+    }
 
-        for (i = 0; i < mode->priv->args.threads; i++)
+    switch (mode->listener)
+    {
+        case ARGS_LISTENER_SHARD:
+        case ARGS_LISTENER_CBPF:
+            mode->listenercount = mode->args.threads;
+            break;
+        case ARGS_LISTENER_EXCLUSIVE:
+            mode->listenercount = 1;
+            break;
+        default:
+            mode->listenercount = 0;
+            break;
+    }
+
+    if ((mode->listenercount > 0) &&
+        ((mode->listeners = UTILMEM_CALLOC(struct sockobj,
+                                           sizeof(struct sockobj),
+                                           mode->listenercount)) == NULL))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate memory\n",
+                      __FUNCTION__);
+        mode->listenercount = 0;
+        ret = false;
+    }
+
+    for (i = 0; (ret) && (i < mode->listenercount); i++)
+    {
+        modeperf_copy(mode, &mode->listeners[i], 0);
+
+        if (!sockmod_init(&mode->listeners[i]))
         {
-            mode->priv->configsocks[i] = 0xFFFFFFFF;
-            ret &= threadpool_execute(&mode->priv->threadpool,
-                                      modeperf_workerthread,
-                                      mode->priv,
-                                      i);
+            mode->listenercount = i;
+            ret = false;
         }
+    }
+
+    if ((ret) &&
+        (mode->listener == ARGS_LISTENER_CBPF) &&
+        (!modeperf_attachcbpf(mode)))
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: using sharded listeners without a program\n",
+                      __FUNCTION__);
+    }
+
+    logger_printf(LOGGER_LEVEL_INFO,
+                  "%s: opened %u listeners (model %d)\n",
+                  __FUNCTION__,
+                  mode->listenercount,
+                  mode->listener);
+
+    return ret;
+}
+
+/**
+ * @brief Close the listeners that are owned by workers.
+ *
+ * @param[in,out] mode A pointer to a mode object.
+ *
+ * @return Void.
+ */
+static void modeperf_closelisteners(struct modeobj_priv * const mode)
+{
+    uint32_t i;
+
+    for (i = 0; i < mode->listenercount; i++)
+    {
+        mode->listeners[i].ops->sock_close(&mode->listeners[i]);
+        mode->listeners[i].ops->sock_destroy(&mode->listeners[i]);
+    }
+
+    UTILMEM_FREE(mode->listeners);
+    mode->listeners     = NULL;
+    mode->listenercount = 0;
+}
+
+bool modeperf_start(struct modeobj * const mode)
+{
+    bool ret = false;
+    uint32_t i, tasks;
 
-        ret &= threadpool_execute(&mode->priv->threadpool,
-                                  modeperf_reporterthread,
-                                  mode->priv,
-                                  mode->priv->args.threads);
+    if (UTILDEBUG_VERIFY((mode != NULL) && (mode->priv != NULL)))
+    {
+        threadpool_stop(&mode->priv->threadpool);
+        modeperf_closelisteners(mode->priv);
 
-        switch (mode->priv->args.arch)
+        if (!modeperf_openlisteners(mode->priv))
         {
-            case SOCKOBJ_MODEL_CLIENT:
-                ret &= threadpool_execute(&mode->priv->threadpool,
-                                          modeperf_connectorthread,
-                                          mode->priv,
-                                          mode->priv->args.threads + 1);
-                break;
-            case SOCKOBJ_MODEL_SERVER:
+            modeperf_closelisteners(mode->priv);
+        }
+        else
+        {
+            ret = threadpool_start(&mode->priv->threadpool);
+            tasks = mode->priv->args.threads + 1;
+
+            for (i = 0; i < mode->priv->args.threads; i++)
+            {
+                __atomic_store_n(&mode->priv->counters[i].configsocks,
+                                 0xFFFFFFFF,
+                                 __ATOMIC_SEQ_CST);
                 ret &= threadpool_execute(&mode->priv->threadpool,
-                                          modeperf_acceptorthread,
+                                          modeperf_workerthread,
                                           mode->priv,
-                                          mode->priv->args.threads + 1);
-                break;
-            default:
-                break;
-        }
+                                          i);
+            }
 
-        threadpool_wait(&mode->priv->threadpool, mode->priv->args.threads + 2);
+            ret &= threadpool_execute(&mode->priv->threadpool,
+                                      modeperf_reporterthread,
+                                      mode->priv,
+                                      mode->priv->args.threads);
+
+            switch (mode->priv->args.arch)
+            {
+                case SOCKOBJ_MODEL_CLIENT:
+                    ret &= threadpool_execute(&mode->priv->threadpool,
+                                              modeperf_connectorthread,
+                                              mode->priv,
+                                              mode->priv->args.threads + 1);
+                    tasks++;
+                    break;
+                case SOCKOBJ_MODEL_SERVER:
+                    // Workers that own listeners accept their own sockets.
+                    if (mode->priv->listenercount == 0)
+                    {
+                        ret &= threadpool_execute(&mode->priv->threadpool,
+                                                  modeperf_acceptorthread,
+                                                  mode->priv,
+                                                  mode->priv->args.threads + 1);
+                        tasks++;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            threadpool_wait(&mode->priv->threadpool, tasks);
+        }
     }
 
     return ret;
@@ -1228,18 +6456,23 @@ bool modeperf_start(struct modeobj * const mode)
 bool modeperf_stop(struct modeobj * const mode)
 {
     bool ret = false;
+    struct sockobj *sock = NULL;
     uint32_t i;
 
     if (UTILDEBUG_VERIFY((mode != NULL) && (mode->priv != NULL)))
     {
         ret  = mode->ops.mode_cancel(mode);
         ret &= threadpool_stop(&mode->priv->threadpool);
+        modeperf_closelisteners(mode->priv);
 
         for (i = 0; i < mode->priv->args.threads; i++)
         {
-            while (mode->priv->sockq[i].size > 0)
+            // Release the sockets that were never picked up by a worker.
+            while ((sock = lfqueue_pop(&mode->priv->sockq[i])) != NULL)
             {
-                dlist_removehead(&mode->priv->sockq[i]);
+                sock->ops->sock_close(sock);
+                sock->ops->sock_destroy(sock);
+                modeperf_freesock(sock);
             }
         }
     }
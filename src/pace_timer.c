@@ -0,0 +1,212 @@
+/**
+ * @file      pace_timer.c
+ * @brief     Pacing timer implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "logger.h"
+#include "pace_timer.h"
+#include "util_date.h"
+#include "util_debug.h"
+#include "util_mem.h"
+#include "util_unit.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#endif
+
+struct pacetimer_priv
+{
+    int32_t  fd;      // Timer file descriptor (-1 if unsupported)
+    uint64_t spinus;  // Time to spin before a deadline in microseconds
+    uint64_t armedus; // Deadline the timer is armed for (0 if disarmed)
+};
+
+bool pacetimer_create(struct pacetimer * const timer,
+                      const uint64_t spinus,
+                      const uint64_t slackns)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((timer != NULL) && (timer->priv == NULL) && (slackns > 0)))
+    {
+        if ((timer->priv = UTILMEM_CALLOC(struct pacetimer_priv,
+                                          sizeof(struct pacetimer_priv),
+                                          1)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate private memory (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+#if defined(__linux__)
+        else if ((timer->priv->fd = timerfd_create(CLOCK_MONOTONIC,
+                                                   TFD_CLOEXEC | TFD_NONBLOCK)) < 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to create timer (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            UTILMEM_FREE(timer->priv);
+            timer->priv = NULL;
+        }
+#endif
+        else
+        {
+#if defined(__linux__)
+            // The slack of the thread delays its event loop timeouts and
+            // sleeps, which would otherwise add up to 50 us to a wakeup.
+            if (prctl(PR_SET_TIMERSLACK, (unsigned long)slackns, 0, 0, 0) != 0)
+            {
+                logger_printf(LOGGER_LEVEL_WARN,
+                              "%s: failed to set timer slack (%d)\n",
+                              __FUNCTION__,
+                              errno);
+            }
+#else
+            timer->priv->fd = -1;
+#endif
+            timer->priv->spinus  = spinus;
+            timer->priv->armedus = 0;
+            timer->arms  = 0;
+            timer->spins = 0;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool pacetimer_destroy(struct pacetimer * const timer)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((timer != NULL) && (timer->priv != NULL)))
+    {
+        if (timer->priv->fd >= 0)
+        {
+            close(timer->priv->fd);
+        }
+
+        UTILMEM_FREE(timer->priv);
+        timer->priv = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+int32_t pacetimer_getfd(const struct pacetimer * const timer)
+{
+    int32_t ret = -1;
+
+    if (UTILDEBUG_VERIFY((timer != NULL) && (timer->priv != NULL)))
+    {
+        ret = timer->priv->fd;
+    }
+
+    return ret;
+}
+
+bool pacetimer_arm(struct pacetimer * const timer, const uint64_t dueus)
+{
+    bool ret = false;
+#if defined(__linux__)
+    struct itimerspec spec;
+    uint64_t wakeus;
+#endif
+
+    if (!UTILDEBUG_VERIFY((timer != NULL) && (timer->priv != NULL)))
+    {
+        // Do nothing.
+    }
+    else if (timer->priv->fd < 0)
+    {
+        // Do nothing.
+    }
+    else if (timer->priv->armedus == dueus)
+    {
+        ret = true;
+    }
+    else
+    {
+#if defined(__linux__)
+        // A zero expiry would disarm the timer.
+        wakeus = (dueus > timer->priv->spinus + 1 ? dueus - timer->priv->spinus : 1);
+        spec.it_interval.tv_sec  = 0;
+        spec.it_interval.tv_nsec = 0;
+        spec.it_value.tv_sec     = (time_t)(wakeus / UNIT_TIME_USEC);
+        spec.it_value.tv_nsec    = (long)(wakeus % UNIT_TIME_USEC) * 1000;
+
+        if (timerfd_settime(timer->priv->fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to arm timer (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            timer->priv->armedus = 0;
+        }
+        else
+        {
+            timer->priv->armedus = dueus;
+            timer->arms++;
+            ret = true;
+        }
+#endif
+    }
+
+    return ret;
+}
+
+bool pacetimer_clear(struct pacetimer * const timer)
+{
+    bool ret = false;
+    uint64_t val;
+
+    if (UTILDEBUG_VERIFY((timer != NULL) && (timer->priv != NULL)))
+    {
+        if ((timer->priv->fd >= 0) &&
+            (read(timer->priv->fd, &val, sizeof(val)) == sizeof(val)))
+        {
+            timer->priv->armedus = 0;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool pacetimer_spin(struct pacetimer * const timer, const uint64_t dueus)
+{
+    bool ret = false;
+    uint64_t tsus;
+
+    if (UTILDEBUG_VERIFY((timer != NULL) && (timer->priv != NULL)) &&
+        (timer->priv->spinus > 0))
+    {
+        tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+        if ((tsus < dueus) && (dueus - tsus <= timer->priv->spinus))
+        {
+            while (tsus < dueus)
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+                tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+            }
+
+            timer->spins++;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
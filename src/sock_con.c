@@ -174,7 +174,7 @@ static void *sockcon_thread(void * const arg)
                 {
                     if (i == 0)
                     {
-                        recvbytes = con->sock->ops.sock_recv(con->sock,
+                        recvbytes = con->sock->ops->sock_recv(con->sock,
                                                              buf,
                                                              buflen);
 
@@ -374,7 +374,6 @@ int32_t sockcon_accept(struct sockcon * const con,
                        socklen_t * const len)
 {
     int32_t ret = -1;
-    uint32_t backlog = 0;
     struct sockcon_pair *pair = NULL;
 
     if (UTILDEBUG_VERIFY((con != NULL) &&
@@ -383,41 +382,35 @@ int32_t sockcon_accept(struct sockcon * const con,
                          (len != NULL) &&
                          (*len > 0)))
     {
+        // The connection manager thread polls the listener and queues the
+        // new "connections," so accepting only takes one from the queue.
         mutexobj_lock(&con->priv->mutex);
-        backlog = vector_getsize(&con->priv->backlog);
-        mutexobj_unlock(&con->priv->mutex);
 
-        if ((backlog > 0) ||
-            (con->sock->event.ops.fion_poll(&con->sock->event)))
+        if (vector_getsize(&con->priv->backlog) > 0)
         {
-            mutexobj_lock(&con->priv->mutex);
+            pair = vector_getval(&con->priv->backlog, 0);
 
-            if ((backlog > 0) || (vector_getsize(&con->priv->backlog) > 0))
+            if (pair == NULL)
             {
-                pair = vector_getval(&con->priv->backlog, 0);
-
-                if (pair == NULL)
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: failed to get pair\n",
+                              __FUNCTION__);
+            }
+            else
+            {
+                if ((uint32_t)(*len) > sizeof(pair->sockaddr))
                 {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: failed to get pair\n",
-                                  __FUNCTION__);
+                    *len = sizeof(pair->sockaddr);
                 }
-                else
-                {
-                    if ((uint32_t)(*len) > sizeof(pair->sockaddr))
-                    {
-                        *len = sizeof(pair->sockaddr);
-                    }
 
-                    memcpy(addr, &pair->sockaddr, *len);
-                    ret = pair->fds[SOCKCON_PEER_INDEX];
-                    vector_inserttail(&con->priv->frontlog, pair);
-                    vector_delete(&con->priv->backlog, 0);
-                }
+                memcpy(addr, &pair->sockaddr, *len);
+                ret = pair->fds[SOCKCON_PEER_INDEX];
+                vector_inserttail(&con->priv->frontlog, pair);
+                vector_delete(&con->priv->backlog, 0);
             }
-
-            mutexobj_unlock(&con->priv->mutex);
         }
+
+        mutexobj_unlock(&con->priv->mutex);
     }
 
     return ret;
@@ -38,20 +38,19 @@ static bool sockmod_initclient(struct sockobj * const sock)
     }
     else if (memcpy(&sock->conf, &conf, sizeof(sock->conf)) == NULL)
     {
-        sock->ops.sock_destroy(sock);
+        sock->ops->sock_destroy(sock);
     }
-    else if (sock->ops.sock_open(sock) == false)
+    else if (sock->ops->sock_open(sock) == false)
     {
-        sock->ops.sock_destroy(sock);
+        sock->ops->sock_destroy(sock);
     }
-    //else if (sock->ops.sock_bind(sock) == false)
+    //else if (sock->ops->sock_bind(sock) == false)
     //{
-    //    sock->ops.sock_close(sock);
+    //    sock->ops->sock_close(sock);
     //}
     else
     {
-        sock->ops.sock_connect(sock);
-        sock->event.timeoutms = conf.timeoutms;
+        sock->ops->sock_connect(sock);
         retval = true;
     }
 
@@ -82,23 +81,22 @@ static bool sockmod_initserver(struct sockobj * const sock)
     }
     else if (memcpy(&sock->conf, &conf, sizeof(sock->conf)) == NULL)
     {
-        sock->ops.sock_destroy(sock);
+        sock->ops->sock_destroy(sock);
     }
-    else if (sock->ops.sock_open(sock) == false)
+    else if (sock->ops->sock_open(sock) == false)
     {
-        sock->ops.sock_destroy(sock);
+        sock->ops->sock_destroy(sock);
     }
-    else if (sock->ops.sock_bind(sock) == false)
+    else if (sock->ops->sock_bind(sock) == false)
     {
-        sock->ops.sock_close(sock);
+        sock->ops->sock_close(sock);
     }
-    else if (sock->ops.sock_listen(sock, sock->conf.backlog) == false)
+    else if (sock->ops->sock_listen(sock, sock->conf.backlog) == false)
     {
-        sock->ops.sock_close(sock);
+        sock->ops->sock_close(sock);
     }
     else
     {
-        sock->event.timeoutms = conf.timeoutms;
         retval = true;
     }
 
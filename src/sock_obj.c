@@ -7,7 +7,6 @@
  *            This project is released under the MIT license.
  */
 
-#include "fion_poll.h"
 #include "logger.h"
 #include "sock_obj.h"
 #include "util_date.h"
@@ -189,6 +188,22 @@ bool sockobj_iserrfatal(const int32_t err)
     return ret;
 }
 
+bool sockobj_issender(const enum sockobj_model model,
+                      const enum sockobj_direction direction)
+{
+    return (model == SOCKOBJ_MODEL_CLIENT ?
+            direction != SOCKOBJ_DIRECTION_REVERSE :
+            direction != SOCKOBJ_DIRECTION_FORWARD);
+}
+
+bool sockobj_isreceiver(const enum sockobj_model model,
+                        const enum sockobj_direction direction)
+{
+    return (model == SOCKOBJ_MODEL_CLIENT ?
+            direction != SOCKOBJ_DIRECTION_FORWARD :
+            direction != SOCKOBJ_DIRECTION_REVERSE);
+}
+
 bool sockobj_create(struct sockobj * const obj)
 {
     bool ret = false;
@@ -196,19 +211,7 @@ bool sockobj_create(struct sockobj * const obj)
     if (UTILDEBUG_VERIFY(obj != NULL))
     {
         memset(obj, 0, sizeof(struct sockobj));
-
-        if (!fionpoll_create(&obj->event))
-        {
-            logger_printf(LOGGER_LEVEL_ERROR,
-                          "%s: event allocation failed\n",
-                          __FUNCTION__);
-        }
-        else
-        {
-            obj->event.pevents = FIONOBJ_PEVENT_IN;
-            //obj->event.ops.fion_setflags(&obj->event);
-            ret = true;
-        }
+        ret = true;
     }
 
     return ret;
@@ -220,21 +223,73 @@ bool sockobj_destroy(struct sockobj * const obj)
 
     if (UTILDEBUG_VERIFY(obj != NULL))
     {
-        ret = obj->event.ops.fion_destroy(&obj->event);
-
-        obj->ops.sock_create   = NULL;
-        obj->ops.sock_destroy  = NULL;
-        obj->ops.sock_open     = NULL;
-        obj->ops.sock_close    = NULL;
-        obj->ops.sock_bind     = NULL;
-        obj->ops.sock_getopts  = NULL;
-        obj->ops.sock_setopts  = NULL;
-        obj->ops.sock_listen   = NULL;
-        obj->ops.sock_accept   = NULL;
-        obj->ops.sock_connect  = NULL;
-        obj->ops.sock_recv     = NULL;
-        obj->ops.sock_send     = NULL;
-        obj->ops.sock_shutdown = NULL;
+        obj->ops = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Bind a client socket to its configured source address before it
+ *        connects. The kernel picks the source port at connect time so that
+ *        ephemeral ports are only shared across distinct four-tuples.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ *
+ * @return True if the socket was bound to its source address.
+ */
+static bool sockobj_bindsource(struct sockobj * const obj)
+{
+    bool ret = false;
+    struct sockaddr_storage addr;
+    socklen_t addrlen = obj->addrpeer.addrlen;
+#if defined(IP_BIND_ADDRESS_NO_PORT)
+    int32_t optval = 1;
+#endif
+
+    memset(&addr, 0, sizeof(addr));
+    addr.ss_family = obj->addrpeer.sockaddr.ss_family;
+
+    if (inet_pton(addr.ss_family,
+                  obj->conf.srcaddr,
+                  utilinet_getaddrfromstorage(&addr)) != 1)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket %u source address %s is invalid\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      obj->conf.srcaddr);
+    }
+#if defined(IP_BIND_ADDRESS_NO_PORT)
+    else if ((obj->conf.type == SOCK_STREAM) &&
+             (setsockopt(obj->fd,
+                         IPPROTO_IP,
+                         IP_BIND_ADDRESS_NO_PORT,
+                         &optval,
+                         sizeof(optval)) != 0))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket %u IP_BIND_ADDRESS_NO_PORT option failed (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      errno);
+    }
+#endif
+    else if (bind(obj->fd, (struct sockaddr *)&addr, addrlen) != 0)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket %u could not be bound to %s (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      obj->conf.srcaddr,
+                      errno);
+    }
+    else
+    {
+        memcpy(&obj->addrself.sockaddr, &addr, sizeof(addr));
+        obj->addrself.addrlen = addrlen;
+        ret = true;
     }
 
     return ret;
@@ -289,19 +344,9 @@ bool sockobj_open(struct sockobj * const obj)
 
                     optlen = sizeof(obj->info.recv.winsize);
                     optval = 1;
-                    obj->event.ops.fion_insertfd(&obj->event, obj->fd);
                     flags = fcntl(obj->fd, F_GETFL, 0);
 
-                    if (!obj->event.ops.fion_setflags(&obj->event))
-                    {
-                        logger_printf(LOGGER_LEVEL_ERROR,
-                                      "%s: socket %u event creation failed\n",
-                                      __FUNCTION__,
-                                      obj->sid,
-                                      errno);
-                        sockobj_close(obj);
-                    }
-                    else if (fcntl(obj->fd, F_SETFL, flags | O_NONBLOCK) != 0)
+                    if (fcntl(obj->fd, F_SETFL, flags | O_NONBLOCK) != 0)
                     {
                         logger_printf(LOGGER_LEVEL_ERROR,
                                       "%s: socket %u O_NONBLOCK option failed (%d)\n",
@@ -354,6 +399,29 @@ bool sockobj_open(struct sockobj * const obj)
                         sockobj_close(obj);
                     }
 #endif
+#if defined(SO_BINDTODEVICE)
+                    else if ((obj->conf.device[0] != '\0') &&
+                             (setsockopt(obj->fd,
+                                         SOL_SOCKET,
+                                         SO_BINDTODEVICE,
+                                         obj->conf.device,
+                                         strlen(obj->conf.device) + 1) != 0))
+                    {
+                        logger_printf(LOGGER_LEVEL_ERROR,
+                                      "%s: socket %u SO_BINDTODEVICE %s option failed (%d)\n",
+                                      __FUNCTION__,
+                                      obj->sid,
+                                      obj->conf.device,
+                                      errno);
+                        sockobj_close(obj);
+                    }
+#endif
+                    else if ((obj->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+                             (obj->conf.srcaddr[0] != '\0') &&
+                             (!sockobj_bindsource(obj)))
+                    {
+                        sockobj_close(obj);
+                    }
                     else if (getsockopt(obj->fd,
                                         SOL_SOCKET,
                                         SO_RCVBUF,
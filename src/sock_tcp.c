@@ -16,6 +16,9 @@
 #include <errno.h>
 #if defined(__linux__)
     #include <fcntl.h>
+    #include <linux/errqueue.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
 #endif
 #include <netinet/tcp.h>
 #include <string.h>
@@ -75,8 +78,10 @@ bool socktcp_getinfo(const int32_t fd, struct socktcp_info * const info)
             info->rxpackets = optval.tcpi_rxpackets;
             info->rxbytes   = optval.tcpi_rxbytes;
             info->rxoobytes = optval.tcpi_rxoutoforderbytes;
+            info->retrans   = optval.tcpi_txretransmitpackets;
     #else
             info->mss       = optval.tcpi_snd_mss;
+            info->retrans   = optval.tcpi_total_retrans;
     #endif
             info->ssthresh  = optval.tcpi_snd_ssthresh;
             info->cwnd      = optval.tcpi_snd_cwnd;
@@ -89,6 +94,249 @@ bool socktcp_getinfo(const int32_t fd, struct socktcp_info * const info)
     return ret;
 }
 
+/**
+ * @brief Enable zero-copy transmits on a TCP socket if they are configured.
+ *        Zero-copy transmits are disabled if they are not supported.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ *
+ * @return True if zero-copy transmits are enabled.
+ */
+static bool socktcp_setzerocopy(struct sockobj * const obj)
+{
+    bool    ret = false;
+    int32_t val = 1;
+
+    if (!obj->conf.zerocopy)
+    {
+        // Do nothing.
+    }
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    else if (setsockopt(obj->fd, SOL_SOCKET, SO_ZEROCOPY, &val, sizeof(val)) != 0)
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: socket %u zero-copy transmit is unavailable (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      errno);
+        obj->conf.zerocopy = false;
+    }
+    else
+    {
+        ret = true;
+    }
+#else
+    else
+    {
+        (void)val;
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: socket %u zero-copy transmit is unsupported\n",
+                      __FUNCTION__,
+                      obj->sid);
+        obj->conf.zerocopy = false;
+    }
+#endif
+
+    return ret;
+}
+
+int32_t socktcp_reapzerocopy(struct sockobj * const obj)
+{
+    int32_t                   ret   = -1;
+#if defined(SO_EE_ORIGIN_ZEROCOPY)
+    uint32_t                  count = 0;
+    struct msghdr             msg;
+    struct cmsghdr           *cmsg  = NULL;
+    struct sock_extended_err *err   = NULL;
+    uint8_t                   control[CMSG_SPACE(sizeof(struct sock_extended_err)) * 8];
+#endif
+
+    if (UTILDEBUG_VERIFY(obj != NULL))
+    {
+        ret = 0;
+#if defined(SO_EE_ORIGIN_ZEROCOPY)
+        // Each notification covers a range of send ids, and ranges are
+        // released in order.
+        while (obj->info.zcdone != obj->info.zcnext)
+        {
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_control    = control;
+            msg.msg_controllen = sizeof(control);
+
+            if (recvmsg(obj->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+                {
+                    logger_printf(LOGGER_LEVEL_ERROR,
+                                  "%s: socket %u error queue failed (%d)\n",
+                                  __FUNCTION__,
+                                  obj->sid,
+                                  errno);
+                    ret = -1;
+                }
+                break;
+            }
+
+            for (cmsg = CMSG_FIRSTHDR(&msg);
+                 cmsg != NULL;
+                 cmsg = CMSG_NXTHDR(&msg, cmsg))
+            {
+                err = (struct sock_extended_err *)CMSG_DATA(cmsg);
+
+                if ((err->ee_errno == 0) &&
+                    (err->ee_origin == SO_EE_ORIGIN_ZEROCOPY))
+                {
+                    // The range of send ids is [ee_info, ee_data].
+                    count = err->ee_data - err->ee_info + 1;
+
+                    if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                    {
+                        obj->info.zccopies += count;
+                    }
+                    else
+                    {
+                        obj->info.zcsends += count;
+                    }
+
+                    obj->info.zcdone = err->ee_data + 1;
+                    ret += (int32_t)count;
+                }
+            }
+        }
+#endif
+    }
+
+    return ret;
+}
+
+#if defined(TCP_ZEROCOPY_RECEIVE)
+/**
+ * @brief Receive data by mapping received pages into a per-socket receive
+ *        window (TCP_ZEROCOPY_RECEIVE). Bytes that cannot be mapped (e.g.,
+ *        partial pages) are copied into the caller's buffer. The socket falls
+ *        back to the copy sink if page mapping is not supported.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ * @param[in,out] buf A pointer to a buffer for bytes that cannot be mapped.
+ * @param[in]     len The maximum number of bytes to receive.
+ *
+ * @return The number of bytes received, 0 on EOF, or -1 on error (errno is
+ *         set).
+ */
+static int32_t socktcp_recvmap(struct sockobj * const obj,
+                               void * const buf,
+                               const uint32_t len)
+{
+    int32_t                      ret     = -1;
+    int32_t                      status  = -1;
+    int32_t                      copied  = 0;
+    uint32_t                     copylen = 0;
+    const uint32_t               pagelen = (uint32_t)sysconf(_SC_PAGESIZE);
+    const uint32_t               maplen  = len - (len % pagelen);
+    void                        *map     = MAP_FAILED;
+    struct tcp_zerocopy_receive  zc;
+    socklen_t                    optlen  = sizeof(zc);
+
+    if ((obj->sinkmap == NULL) && (maplen > 0))
+    {
+        map = mmap(NULL, maplen, PROT_READ, MAP_SHARED, obj->fd, 0);
+
+        if (map != MAP_FAILED)
+        {
+            obj->sinkmap    = map;
+            obj->sinkmaplen = maplen;
+        }
+    }
+
+    if (obj->sinkmap != NULL)
+    {
+        memset(&zc, 0, sizeof(zc));
+        zc.address = (uint64_t)(uintptr_t)obj->sinkmap;
+        zc.length  = obj->sinkmaplen;
+        status     = getsockopt(obj->fd,
+                                IPPROTO_TCP,
+                                TCP_ZEROCOPY_RECEIVE,
+                                &zc,
+                                &optlen);
+    }
+
+    if ((obj->sinkmap == NULL) ||
+        ((status != 0) &&
+         ((errno == EINVAL) || (errno == ENOPROTOOPT) || (errno == EOPNOTSUPP))))
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: socket %u mapped receive is unavailable (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      errno);
+
+        if (obj->sinkmap != NULL)
+        {
+            munmap(obj->sinkmap, obj->sinkmaplen);
+            obj->sinkmap    = NULL;
+            obj->sinkmaplen = 0;
+        }
+
+        obj->conf.sink = SOCKOBJ_SINK_COPY;
+        ret = recv(obj->fd, buf, len, MSG_DONTWAIT);
+    }
+    else if (status != 0)
+    {
+        // The mapped receive failed with a socket error (errno is set).
+    }
+    else
+    {
+        ret = (int32_t)zc.length;
+
+        // The kernel hints at the number of bytes that must be copied before
+        // more pages can be mapped. If nothing was mapped, then a copy also
+        // reports EOF or that no data is available.
+        if (zc.recv_skip_hint > 0)
+        {
+            copylen = (zc.recv_skip_hint < len ? zc.recv_skip_hint : len);
+        }
+        else if (zc.length == 0)
+        {
+            copylen = len;
+        }
+
+        if (copylen > 0)
+        {
+            copied = recv(obj->fd, buf, copylen, MSG_DONTWAIT);
+
+            if (copied > 0)
+            {
+                ret += copied;
+            }
+            else if (ret == 0)
+            {
+                ret = copied;
+            }
+        }
+    }
+
+    return ret;
+}
+#endif
+
+// Every TCP socket shares one operations table.
+static const struct sockobj_ops socktcp_ops =
+{
+    .sock_create   = socktcp_create,
+    .sock_destroy  = socktcp_destroy,
+    .sock_open     = socktcp_open,
+    .sock_close    = socktcp_close,
+    .sock_bind     = sockobj_bind,
+    .sock_getopts  = sockobj_getopts,
+    .sock_setopts  = sockobj_setopts,
+    .sock_listen   = socktcp_listen,
+    .sock_accept   = socktcp_accept,
+    .sock_connect  = socktcp_connect,
+    .sock_recv     = socktcp_recv,
+    .sock_send     = socktcp_send,
+    .sock_shutdown = socktcp_shutdown
+};
+
 bool socktcp_create(struct sockobj * const obj)
 {
     bool ret = false;
@@ -97,19 +345,7 @@ bool socktcp_create(struct sockobj * const obj)
     {
         if (sockobj_create(obj))
         {
-            obj->ops.sock_create   = socktcp_create;
-            obj->ops.sock_destroy  = socktcp_destroy;
-            obj->ops.sock_open     = sockobj_open;
-            obj->ops.sock_close    = sockobj_close;
-            obj->ops.sock_bind     = sockobj_bind;
-            obj->ops.sock_getopts  = sockobj_getopts;
-            obj->ops.sock_setopts  = sockobj_setopts;
-            obj->ops.sock_listen   = socktcp_listen;
-            obj->ops.sock_accept   = socktcp_accept;
-            obj->ops.sock_connect  = socktcp_connect;
-            obj->ops.sock_recv     = socktcp_recv;
-            obj->ops.sock_send     = socktcp_send;
-            obj->ops.sock_shutdown = socktcp_shutdown;
+            obj->ops = &socktcp_ops;
 
             obj->conf.type = SOCK_STREAM;
 
@@ -132,6 +368,93 @@ bool socktcp_destroy(struct sockobj * const obj)
     return ret;
 }
 
+bool socktcp_open(struct sockobj * const obj)
+{
+    bool          ret    = false;
+    int32_t       val    = 1;
+    struct linger linger = { 1, 0 };
+
+    if (!UTILDEBUG_VERIFY((obj != NULL) && (obj->conf.type == SOCK_STREAM)))
+    {
+        // Do nothing.
+    }
+    else if (!sockobj_open(obj))
+    {
+        // Do nothing.
+    }
+    // A reset skips the TIME_WAIT state of an actively closed connection.
+    else if ((obj->conf.reset) &&
+             (setsockopt(obj->fd,
+                         SOL_SOCKET,
+                         SO_LINGER,
+                         &linger,
+                         sizeof(linger)) != 0))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket %u SO_LINGER option failed (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      errno);
+        sockobj_close(obj);
+    }
+    else
+    {
+#if defined(TCP_FASTOPEN_CONNECT)
+        // A client connect is deferred until the first send, which carries
+        // data in the SYN if the client has a Fast Open cookie.
+        if ((obj->conf.fastopen) &&
+            (obj->conf.model == SOCKOBJ_MODEL_CLIENT) &&
+            (setsockopt(obj->fd,
+                        IPPROTO_TCP,
+                        TCP_FASTOPEN_CONNECT,
+                        &val,
+                        sizeof(val)) != 0))
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: socket %u Fast Open is unavailable (%d)\n",
+                          __FUNCTION__,
+                          obj->sid,
+                          errno);
+            obj->conf.fastopen = false;
+        }
+#else
+        (void)val;
+        obj->conf.fastopen = false;
+#endif
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool socktcp_close(struct sockobj * const obj)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->conf.type == SOCK_STREAM)))
+    {
+        // Collect the zero-copy send notifications that are already queued
+        // so that the socket statistics are as complete as possible.
+        if ((obj->conf.zerocopy) && (obj->state & SOCKOBJ_STATE_CONNECT))
+        {
+            socktcp_reapzerocopy(obj);
+        }
+
+#if defined(TCP_ZEROCOPY_RECEIVE)
+        if (obj->sinkmap != NULL)
+        {
+            munmap(obj->sinkmap, obj->sinkmaplen);
+            obj->sinkmap    = NULL;
+            obj->sinkmaplen = 0;
+        }
+#endif
+
+        ret = sockobj_close(obj);
+    }
+
+    return ret;
+}
+
 bool socktcp_listen(struct sockobj * const obj, const int32_t backlog)
 {
     bool ret = false;
@@ -143,6 +466,24 @@ bool socktcp_listen(struct sockobj * const obj, const int32_t backlog)
     // Backlog check: SOMAXCONN
     else if (listen(obj->fd, backlog) == 0)
     {
+#if defined(TCP_FASTOPEN)
+        // Queue up to a backlog of Fast Open connections that have not
+        // completed their handshake.
+        if ((obj->conf.fastopen) &&
+            (setsockopt(obj->fd,
+                        IPPROTO_TCP,
+                        TCP_FASTOPEN,
+                        &backlog,
+                        sizeof(backlog)) != 0))
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: socket %u Fast Open is unavailable (%d)\n",
+                          __FUNCTION__,
+                          obj->sid,
+                          errno);
+        }
+#endif
+
         logger_printf(LOGGER_LEVEL_INFO,
                       "%s: socket %u listening with a backlog of %d\n",
                       __FUNCTION__,
@@ -166,16 +507,84 @@ bool socktcp_listen(struct sockobj * const obj, const int32_t backlog)
     return ret;
 }
 
+bool socktcp_acceptfd(struct sockobj * const listener,
+                      struct sockobj * const obj,
+                      const int32_t fd)
+{
+    bool     ret = false;
+    uint64_t ts  = 0;
+
+    if (UTILDEBUG_VERIFY((listener != NULL) &&
+        (obj != NULL) &&
+        (fd > -1) &&
+        (listener->conf.type == SOCK_STREAM)))
+    {
+        ts = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+        if (!socktcp_create(obj))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u accept initialization failed\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+        else if ((obj->fd = fd) != fd)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u fd clone failed\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+        else if (memcpy(&obj->conf,
+                        &listener->conf,
+                        sizeof(listener->conf)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u configuration clone failed\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+        else if (!sockobj_getaddrself(obj))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u self information is unavailable\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+        else if (!sockobj_getaddrpeer(obj))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u peer information is unavailable\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+        else
+        {
+            logger_printf(LOGGER_LEVEL_TRACE,
+                          "%s: new socket %u accepted on %s from %s\n",
+                          __FUNCTION__,
+                          obj->sid,
+                          obj->addrself.sockaddrstr,
+                          obj->addrpeer.sockaddrstr);
+
+            tokenbucket_init(&obj->tb, obj->conf.ratelimitbps);
+            obj->state = SOCKOBJ_STATE_OPEN | SOCKOBJ_STATE_CONNECT;
+            obj->info.startusec = ts;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
 bool socktcp_accept(struct sockobj * const listener, struct sockobj * const obj)
 {
-    bool      ret        = false;
-    socklen_t socklen    = 0;
-    bool      sockaccept = false;
-    int32_t   fd         = -1;
+    bool      ret     = false;
+    socklen_t socklen = 0;
+    int32_t   fd      = -1;
 #if defined(__linux__)
-    int32_t   flags      = 0;
+    int32_t   flags   = 0;
 #endif
-    uint64_t  ts         = 0;
 
     if (UTILDEBUG_VERIFY((listener != NULL) &&
         (obj != NULL) &&
@@ -183,98 +592,30 @@ bool socktcp_accept(struct sockobj * const listener, struct sockobj * const obj)
     {
         socklen = sizeof(listener->addrpeer.sockaddr);
 #if defined(__linux__)
-        flags = (listener->event.timeoutms > -1 ? O_NONBLOCK : 0);
+        flags = (listener->conf.timeoutms > -1 ? O_NONBLOCK : 0);
 #endif
-        // @todo If timeout is -1 (blocking), then the poll should occur in a
-        //       loop with a small timeout (e.g., 100 ms) or maybe a self-pipe
-        //       for signaling shutdown events, etc.
-
-        if (listener->event.ops.fion_poll(&listener->event))
-        {
-            if (((listener->event.revents & FIONOBJ_REVENT_TIMEOUT) == 0) &&
-                ((listener->event.revents & FIONOBJ_REVENT_ERROR) == 0))
-            {
-                sockaccept = true;
-            }
-        }
-
-        if (sockaccept)
-        {
+        // The listener is non-blocking, and the caller's event loop reports
+        // when it is ready, so an empty accept queue is not an error.
 #if defined(__linux__)
-            if ((fd = accept4(listener->fd,
-                              (struct sockaddr *)&(listener->addrpeer.sockaddr),
-                              &socklen,
-                              flags)) > -1)
+        if ((fd = accept4(listener->fd,
+                          (struct sockaddr *)&(listener->addrpeer.sockaddr),
+                          &socklen,
+                          flags)) > -1)
 #else
-            if ((fd = accept(listener->fd,
-                             (struct sockaddr *)&(listener->addrpeer.sockaddr),
-                             &socklen)) > -1)
+        if ((fd = accept(listener->fd,
+                         (struct sockaddr *)&(listener->addrpeer.sockaddr),
+                         &socklen)) > -1)
 #endif
-            {
-                ts = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
-
-                if (!socktcp_create(obj))
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: socket %u accept initialization failed\n",
-                                  __FUNCTION__,
-                                  obj->sid);
-                }
-                else if (((obj->fd = fd) != fd) ||
-                         (!obj->event.ops.fion_insertfd(&obj->event, fd)) ||
-                         (!obj->event.ops.fion_setflags(&obj->event)))
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: socket %u fd clone failed\n",
-                                  __FUNCTION__,
-                                  obj->sid);
-                }
-                else if (memcpy(&obj->conf,
-                                &listener->conf,
-                                sizeof(listener->conf)) == NULL)
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: socket %u configuration clone failed\n",
-                                  __FUNCTION__,
-                                  obj->sid);
-                }
-                else if (!sockobj_getaddrself(obj))
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: socket %u self information is unavailable\n",
-                                  __FUNCTION__,
-                                  obj->sid);
-                }
-                else if (!sockobj_getaddrpeer(obj))
-                {
-                    logger_printf(LOGGER_LEVEL_ERROR,
-                                  "%s: socket %u peer information is unavailable\n",
-                                  __FUNCTION__,
-                                  obj->sid);
-                }
-                else
-                {
-                    logger_printf(LOGGER_LEVEL_TRACE,
-                                  "%s: new socket %u accepted on %s from %s\n",
-                                  __FUNCTION__,
-                                  obj->sid,
-                                  obj->addrself.sockaddrstr,
-                                  obj->addrpeer.sockaddrstr);
-
-                    tokenbucket_init(&obj->tb, obj->conf.ratelimitbps);
-                    obj->state = SOCKOBJ_STATE_OPEN | SOCKOBJ_STATE_CONNECT;
-                    obj->info.startusec = ts;
-                    ret = true;
-                }
-            }
-            else
-            {
-                logger_printf(LOGGER_LEVEL_ERROR,
-                              "%s: socket %u accept failed (%d)\n",
-                              __FUNCTION__,
-                              listener->sid,
-                              errno);
-            }
+        {
+            ret = socktcp_acceptfd(listener, obj, fd);
+        }
+        else if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: socket %u accept failed (%d)\n",
+                          __FUNCTION__,
+                          listener->sid,
+                          errno);
         }
     }
 
@@ -302,31 +643,16 @@ bool socktcp_connect(struct sockobj * const obj)
         }
         else
         {
+            obj->info.connerr = errno;
+
+            // The caller's event loop reports the socket as writable once
+            // the connect completes, and a second connect returns its result.
             if (errno == EINPROGRESS)
             {
                 logger_printf(LOGGER_LEVEL_DEBUG,
                               "%s: socket %u connect now in progress\n",
                               __FUNCTION__,
                               obj->sid);
-
-                obj->event.pevents = FIONOBJ_PEVENT_IN | FIONOBJ_PEVENT_OUT;
-                obj->event.ops.fion_setflags(&obj->event);
-
-                // @todo If timeout is -1 (blocking), then the poll should occur
-                //       in a loop with a small timeout (e.g., 100 ms) or maybe
-                //       a self-pipe for signaling shutdown events, etc.
-
-                if (obj->event.ops.fion_poll(&obj->event))
-                {
-                    if (((obj->event.revents & FIONOBJ_REVENT_ERROR) == 0) &&
-                        (obj->event.revents & FIONOBJ_REVENT_OUTREADY))
-                    {
-                        ret = true;
-                    }
-                }
-
-                obj->event.pevents = FIONOBJ_PEVENT_IN;
-                obj->event.ops.fion_setflags(&obj->event);
             }
             else if (errno == EINVAL)
             {
@@ -336,7 +662,7 @@ bool socktcp_connect(struct sockobj * const obj)
                               obj->sid,
                               errno);
 
-                obj->ops.sock_close(obj);
+                obj->ops->sock_close(obj);
             }
             else if (errno == EISCONN)
             {
@@ -362,9 +688,11 @@ bool socktcp_connect(struct sockobj * const obj)
         if (ret)
         {
             obj->state |= SOCKOBJ_STATE_CONNECT;
+            obj->info.connerr = 0;
 
             sockobj_getaddrself(obj);
             sockobj_getaddrpeer(obj);
+            socktcp_setzerocopy(obj);
         }
     }
 
@@ -380,7 +708,22 @@ int32_t socktcp_recv(struct sockobj * const obj,
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (buf != NULL)))
     {
-        ret = recv(obj->fd, buf, len, flags);
+#if defined(TCP_ZEROCOPY_RECEIVE)
+        if (obj->conf.sink == SOCKOBJ_SINK_MMAP)
+        {
+            ret = socktcp_recvmap(obj, buf, len);
+        }
+        else
+#endif
+        {
+            // A truncating receive discards the data without copying it.
+            if (obj->conf.sink == SOCKOBJ_SINK_TRUNC)
+            {
+                flags |= MSG_TRUNC;
+            }
+
+            ret = recv(obj->fd, buf, len, flags);
+        }
 
         if (ret > 0)
         {
@@ -391,6 +734,15 @@ int32_t socktcp_recv(struct sockobj * const obj,
                           obj->sid,
                           ret);
         }
+        else if ((ret == 0) && (len > 0))
+        {
+            // The remote peer is closed (EOF).
+            logger_printf(LOGGER_LEVEL_DEBUG,
+                          "%s: socket %u peer is closed\n",
+                          __FUNCTION__,
+                          obj->sid);
+            ret = -1;
+        }
         else
         {
             if (sockobj_iserrfatal(errno))
@@ -411,38 +763,6 @@ int32_t socktcp_recv(struct sockobj * const obj,
                               errno);
                 ret = 0;
             }
-
-            if (ret == 0)
-            {
-                if (!obj->event.ops.fion_poll(&obj->event))
-                {
-                    ret = -1;
-                }
-                else if (obj->event.revents & FIONOBJ_REVENT_ERROR)
-                {
-                    ret = -1;
-                }
-                else if (obj->event.revents & FIONOBJ_REVENT_INREADY)
-                {
-                    ret = recv(obj->fd, buf, len, flags);
-
-                    // Remote peer is closed if input is ready but no bytes are
-                    // received (EOF).
-                    if (ret > 0)
-                    {
-                        utilstats_add(&obj->info.recv.buflen, ret);
-                        logger_printf(LOGGER_LEVEL_TRACE,
-                                      "%s: socket %u received %d bytes\n",
-                                      __FUNCTION__,
-                                      obj->sid,
-                                      ret);
-                    }
-                    else
-                    {
-                        ret = -1;
-                    }
-                }
-            }
         }
     }
 
@@ -462,10 +782,23 @@ int32_t socktcp_send(struct sockobj * const obj,
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (buf != NULL)))
     {
+#if defined(MSG_ZEROCOPY)
+        if (obj->conf.zerocopy)
+        {
+            flags |= MSG_ZEROCOPY;
+        }
+#endif
+
         ret = send(obj->fd, buf, len, flags);
 
         if (ret > 0)
         {
+            // Every successful zero-copy send is assigned the next send id.
+            if (obj->conf.zerocopy)
+            {
+                obj->info.zcnext++;
+            }
+
             utilstats_add(&obj->info.send.buflen, ret);
             logger_printf(LOGGER_LEVEL_TRACE,
                           "%s: socket %u sent %d bytes\n",
@@ -493,18 +826,6 @@ int32_t socktcp_send(struct sockobj * const obj,
                               errno);
                 ret = 0;
             }
-
-            if (ret == 0)
-            {
-                if (!obj->event.ops.fion_poll(&obj->event))
-                {
-                    ret = -1;
-                }
-                else if (obj->event.revents & FIONOBJ_REVENT_ERROR)
-                {
-                    ret = -1;
-                }
-            }
         }
     }
 
@@ -20,9 +20,11 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <netinet/udp.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 /**
  * @brief Get the maximum UDP message size in bytes.
@@ -55,6 +57,304 @@ static int32_t sockudp_getmaxmsgsize(struct sockobj * const obj)
     return ret;
 }
 
+/**
+ * @brief Get the number of datagrams to move in a batched receive or send
+ *        call. A buffer is split into consecutive datagrams of the batch
+ *        datagram length, or of the segment length if segmentation offload is
+ *        enabled (the last datagram may be shorter).
+ *
+ * @param[in] obj A pointer to a socket object.
+ * @param[in] len The size of the buffer in bytes.
+ *
+ * @return The number of datagrams to move (0 if the call is not batched).
+ */
+static uint32_t sockudp_getbatch(const struct sockobj * const obj,
+                                 const uint32_t len)
+{
+    uint32_t ret    = 0;
+    uint32_t seglen = (obj->conf.segmentlen > 0 ?
+                       obj->conf.segmentlen :
+                       obj->conf.batchlen);
+
+    // Only connected sockets are batched since every datagram in a batch is
+    // exchanged with the same peer.
+    if ((obj->conf.batchcount > 1) &&
+        (seglen > 0) &&
+        (len > seglen) &&
+        (obj->state & SOCKOBJ_STATE_CONNECT))
+    {
+#if defined(__linux__)
+        ret = (len - 1) / seglen + 1;
+
+        if (ret > obj->conf.batchcount)
+        {
+            ret = obj->conf.batchcount;
+        }
+
+        if (ret > SOCKUDP_BATCHMAX)
+        {
+            ret = SOCKUDP_BATCHMAX;
+        }
+
+        // A segmentation offload buffer is sent as a single UDP datagram.
+        if (obj->conf.segmentlen > 0)
+        {
+            if (ret > SOCKUDP_SEGMENTMAX)
+            {
+                ret = SOCKUDP_SEGMENTMAX;
+            }
+
+            if (ret > SOCKUDP_OFFLOADMAX / seglen)
+            {
+                ret = SOCKUDP_OFFLOADMAX / seglen;
+            }
+        }
+#endif
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Add the length of each datagram in a buffer of consecutive segments
+ *        to socket statistics.
+ *
+ * @param[in,out] stats  Function-specific socket statistics.
+ * @param[in]     len    The size of the buffer in bytes.
+ * @param[in]     seglen The segment length in bytes.
+ *
+ * @return Void.
+ */
+static void sockudp_addsegments(struct sockobj_flowstats * const stats,
+                                const uint32_t len,
+                                const uint32_t seglen)
+{
+    uint32_t rem = len;
+
+    while (rem > seglen)
+    {
+        utilstats_add(&stats->buflen, seglen);
+        rem -= seglen;
+    }
+
+    utilstats_add(&stats->buflen, rem);
+}
+
+/**
+ * @brief Enable UDP segmentation offload (GSO) and receive offload (GRO) on a
+ *        socket if an offload segment length is configured. The segment
+ *        length is limited to the maximum UDP message size, and offload is
+ *        disabled if it is not supported.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ *
+ * @return True if offload is enabled.
+ */
+static bool sockudp_setoffload(struct sockobj * const obj)
+{
+    bool    ret    = false;
+    int32_t maxlen = 0;
+    int32_t val    = 1;
+
+    if (obj->conf.segmentlen == 0)
+    {
+        // Do nothing.
+    }
+#if defined(UDP_SEGMENT) && defined(UDP_GRO)
+    else if (setsockopt(obj->fd, SOL_UDP, UDP_GRO, &val, sizeof(val)) != 0)
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: socket %u receive offload is unavailable (%d)\n",
+                      __FUNCTION__,
+                      obj->sid,
+                      errno);
+        obj->conf.segmentlen = 0;
+    }
+    else
+    {
+        maxlen = sockudp_getmaxmsgsize(obj);
+
+        if ((maxlen > 0) && ((uint32_t)maxlen < obj->conf.segmentlen))
+        {
+            obj->conf.segmentlen = (uint32_t)maxlen;
+        }
+
+        val = (int32_t)obj->conf.segmentlen;
+
+        if (setsockopt(obj->fd, SOL_UDP, UDP_SEGMENT, &val, sizeof(val)) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: socket %u segmentation offload is unavailable (%d)\n",
+                          __FUNCTION__,
+                          obj->sid,
+                          errno);
+            obj->conf.segmentlen = 0;
+        }
+        else
+        {
+            ret = true;
+        }
+    }
+#else
+    else
+    {
+        (void)maxlen;
+        (void)val;
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: socket %u offload is unsupported\n",
+                      __FUNCTION__,
+                      obj->sid);
+        obj->conf.segmentlen = 0;
+    }
+#endif
+
+    return ret;
+}
+
+#if defined(UDP_GRO)
+/**
+ * @brief Receive a buffer that may hold several coalesced datagrams. The
+ *        segment length reported with the buffer is used to add the length
+ *        of each datagram to the socket statistics.
+ *
+ * @param[in,out] obj A pointer to a socket object.
+ * @param[in,out] buf A pointer to a receive buffer.
+ * @param[in]     len The size of the buffer in bytes.
+ *
+ * @return The number of bytes received (-1 on error).
+ */
+static int32_t sockudp_recvoffload(struct sockobj * const obj,
+                                   void * const buf,
+                                   const uint32_t len)
+{
+    int32_t         ret    = -1;
+    int32_t         seglen = 0;
+    struct msghdr   msg;
+    struct iovec    iov;
+    struct cmsghdr *cmsg   = NULL;
+    uint8_t         control[CMSG_SPACE(sizeof(int32_t))];
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base       = buf;
+    iov.iov_len        = len;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ret = recvmsg(obj->fd, &msg, MSG_DONTWAIT);
+
+    if (ret > 0)
+    {
+        for (cmsg = CMSG_FIRSTHDR(&msg);
+             cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO))
+            {
+                memcpy(&seglen, CMSG_DATA(cmsg), sizeof(seglen));
+            }
+        }
+
+        if (msg.msg_flags & MSG_TRUNC)
+        {
+            logger_printf(LOGGER_LEVEL_DEBUG,
+                          "%s: socket %u coalesced datagrams were truncated\n",
+                          __FUNCTION__,
+                          obj->sid);
+        }
+
+        sockudp_addsegments(&obj->info.recv,
+                            (uint32_t)ret,
+                            seglen > 0 ? (uint32_t)seglen : (uint32_t)ret);
+    }
+
+    return ret;
+}
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief Receive or send a batch of datagrams using a single system call. The
+ *        length of each datagram is added to the socket statistics.
+ *
+ * @param[in,out] obj   A pointer to a socket object.
+ * @param[in,out] buf   A pointer to a buffer of consecutive datagrams.
+ * @param[in]     len   The size of the buffer in bytes.
+ * @param[in]     count The number of datagrams in the buffer.
+ * @param[in]     recv  True to receive datagrams, false to send datagrams.
+ *
+ * @return The number of bytes received or sent (-1 on error).
+ */
+static int32_t sockudp_callbatch(struct sockobj * const obj,
+                                 void * const buf,
+                                 const uint32_t len,
+                                 const uint32_t count,
+                                 const bool recv)
+{
+    int32_t                   ret    = -1;
+    int32_t                   n      = 0;
+    uint32_t                  i      = 0;
+    uint32_t                  offset = 0;
+    struct sockobj_flowstats *stats  = (recv ? &obj->info.recv : &obj->info.send);
+    struct mmsghdr            msgs[SOCKUDP_BATCHMAX];
+    struct iovec              iovs[SOCKUDP_BATCHMAX];
+
+    memset(msgs, 0, count * sizeof(msgs[0]));
+
+    for (i = 0; i < count; i++)
+    {
+        iovs[i].iov_base = (uint8_t *)buf + offset;
+        iovs[i].iov_len  = (len - offset < obj->conf.batchlen ?
+                            len - offset :
+                            obj->conf.batchlen);
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        offset += (uint32_t)iovs[i].iov_len;
+    }
+
+    if (recv)
+    {
+        n = recvmmsg(obj->fd, msgs, count, MSG_DONTWAIT, NULL);
+    }
+    else
+    {
+        n = sendmmsg(obj->fd, msgs, count, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+
+    if (n >= 0)
+    {
+        ret = 0;
+
+        for (i = 0; i < (uint32_t)n; i++)
+        {
+            utilstats_add(&stats->buflen, msgs[i].msg_len);
+            ret += (int32_t)msgs[i].msg_len;
+        }
+    }
+
+    return ret;
+}
+#endif
+
+// Every UDP socket shares one operations table.
+static const struct sockobj_ops sockudp_ops =
+{
+    .sock_create   = sockudp_create,
+    .sock_destroy  = sockudp_destroy,
+    .sock_open     = sockobj_open,
+    .sock_close    = sockobj_close,
+    .sock_bind     = sockobj_bind,
+    .sock_getopts  = sockobj_getopts,
+    .sock_setopts  = sockobj_setopts,
+    .sock_listen   = sockudp_listen,
+    .sock_accept   = sockudp_accept,
+    .sock_connect  = sockudp_connect,
+    .sock_recv     = sockudp_recv,
+    .sock_send     = sockudp_send,
+    .sock_shutdown = sockudp_shutdown
+};
+
 bool sockudp_create(struct sockobj * const obj)
 {
     bool ret = false;
@@ -63,19 +363,7 @@ bool sockudp_create(struct sockobj * const obj)
     {
         if (sockobj_create(obj))
         {
-            obj->ops.sock_create   = sockudp_create;
-            obj->ops.sock_destroy  = sockudp_destroy;
-            obj->ops.sock_open     = sockobj_open;
-            obj->ops.sock_close    = sockobj_close;
-            obj->ops.sock_bind     = sockobj_bind;
-            obj->ops.sock_getopts  = sockobj_getopts;
-            obj->ops.sock_setopts  = sockobj_setopts;
-            obj->ops.sock_listen   = sockudp_listen;
-            obj->ops.sock_accept   = sockudp_accept;
-            obj->ops.sock_connect  = sockudp_connect;
-            obj->ops.sock_recv     = sockudp_recv;
-            obj->ops.sock_send     = sockudp_send;
-            obj->ops.sock_shutdown = sockudp_shutdown;
+            obj->ops = &sockudp_ops;
 
             obj->conf.type = SOCK_DGRAM;
 
@@ -111,6 +399,9 @@ bool sockudp_listen(struct sockobj * const obj, const int32_t backlog)
                       backlog);
         obj->state |= SOCKOBJ_STATE_LISTEN;
         sockobj_getaddrself(obj);
+        // The listener is handed to the flow that it accepts, so coalesced
+        // datagrams must be enabled before the first datagram arrives.
+        sockudp_setoffload(obj);
         ret = true;
     }
 
@@ -127,12 +418,23 @@ bool sockudp_accept(struct sockobj * const listener, struct sockobj * const obj)
                          (listener->conf.type == SOCK_DGRAM) &&
                          (obj != NULL)))
     {
-        // @todo If timeout is -1 (blocking), then the poll should occur in a
-        //       loop with a small timeout (e.g., 100 ms) or maybe a self-pipe
-        //       for signaling shutdown events, etc.
-
-        if ((listener->event.ops.fion_poll(&listener->event)) &&
-            (listener->event.revents & FIONOBJ_REVENT_INREADY))
+        // The caller's event loop reports the listener as readable, and the
+        // listener is only handed over if a datagram is really waiting.
+        if (recv(listener->fd,
+                 &buffer,
+                 sizeof(buffer),
+                 MSG_PEEK | MSG_DONTWAIT) < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: socket %u accept failed (%d)\n",
+                              __FUNCTION__,
+                              listener->sid,
+                              errno);
+            }
+        }
+        else
         {
             ts = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
 
@@ -140,7 +442,7 @@ bool sockudp_accept(struct sockobj * const listener, struct sockobj * const obj)
             //       active at all times to prevent the potential loss of new
             //       incoming "connections."
 
-            if (!listener->ops.sock_create(obj))
+            if (!listener->ops->sock_create(obj))
             {
                 logger_printf(LOGGER_LEVEL_ERROR,
                               "%s: socket %u accept initialization failed\n",
@@ -157,8 +459,6 @@ bool sockudp_accept(struct sockobj * const listener, struct sockobj * const obj)
                              &listener->addrpeer,
                              sizeof(obj->addrpeer)) == NULL) ||
                      ((obj->fd = listener->fd) != listener->fd) ||
-                     (!obj->event.ops.fion_insertfd(&obj->event, obj->fd)) ||
-                     (!obj->event.ops.fion_setflags(&obj->event)) ||
                      ((obj->tid = listener->tid) != listener->tid) ||
                      (memcpy(&obj->conf,
                              &listener->conf,
@@ -169,7 +469,7 @@ bool sockudp_accept(struct sockobj * const listener, struct sockobj * const obj)
                               __FUNCTION__,
                               obj->sid);
             }
-            else if (obj->ops.sock_recv(obj, &buffer, sizeof(buffer)) < 0)
+            else if (obj->ops->sock_recv(obj, &buffer, sizeof(buffer)) < 0)
             {
                 logger_printf(LOGGER_LEVEL_ERROR,
                               "%s: socket %u fd clone failed\n",
@@ -208,10 +508,9 @@ bool sockudp_accept(struct sockobj * const listener, struct sockobj * const obj)
                 ret = true;
             }
 
-            vector_resize(&listener->event.fds, 0);
-            listener->ops.sock_open(listener);
-            listener->ops.sock_bind(listener);
-            listener->ops.sock_listen(listener, listener->conf.backlog);
+            listener->ops->sock_open(listener);
+            listener->ops->sock_bind(listener);
+            listener->ops->sock_listen(listener, listener->conf.backlog);
         }
     }
 
@@ -247,15 +546,18 @@ bool sockudp_connect(struct sockobj * const obj)
 
             // @todo Use a 3-way transport layer handshake using zero payload
             //       datagrams.
-            obj->ops.sock_send(obj, &ret, 0);
+            obj->ops->sock_send(obj, &ret, 0);
 
             sockobj_getaddrself(obj);
             sockobj_getaddrpeer(obj);
+            sockudp_setoffload(obj);
 
+            obj->info.connerr = 0;
             ret = true;
         }
         else
         {
+            obj->info.connerr = errno;
             logger_printf(LOGGER_LEVEL_ERROR,
                           "%s: socket %u connect error (%d)\n",
                           __FUNCTION__,
@@ -275,10 +577,26 @@ int32_t sockudp_recv(struct sockobj * const obj,
     int32_t    flags   = MSG_DONTWAIT;
     socklen_t  socklen = 0;
     uint16_t  *port    = NULL;
+    uint32_t   batch   = 0;
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (buf != NULL)))
     {
-        if (obj->state & SOCKOBJ_STATE_CONNECT)
+        if ((obj->conf.segmentlen > 0) &&
+            (obj->state & SOCKOBJ_STATE_CONNECT))
+        {
+            // Coalesced datagrams are received into a single buffer.
+            batch = 1;
+#if defined(UDP_GRO)
+            ret = sockudp_recvoffload(obj, buf, len);
+#endif
+        }
+        else if ((batch = sockudp_getbatch(obj, len)) > 0)
+        {
+#if defined(__linux__)
+            ret = sockudp_callbatch(obj, buf, len, batch, true);
+#endif
+        }
+        else if (obj->state & SOCKOBJ_STATE_CONNECT)
         {
             ret = recv(obj->fd, buf, len, flags);
         }
@@ -295,7 +613,12 @@ int32_t sockudp_recv(struct sockobj * const obj,
 
         if (ret > 0)
         {
-            utilstats_add(&obj->info.recv.buflen, ret);
+            obj->info.idleusec = 0;
+
+            if (batch == 0)
+            {
+                utilstats_add(&obj->info.recv.buflen, ret);
+            }
 
             if ((obj->state & SOCKOBJ_STATE_CONNECT) == 0)
             {
@@ -341,26 +664,24 @@ int32_t sockudp_recv(struct sockobj * const obj,
                 ret = 0;
             }
 
-            if (ret == 0)
+            // An idle period starts with the first receive that would block.
+            // The owner of the socket may end the flow before it calls the
+            // socket again (see sockobj_conf idlelimitusec).
+            if ((ret == 0) && (obj->conf.idlelimitusec > 0))
             {
-                if (!obj->event.ops.fion_poll(&obj->event))
+                uint64_t tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC,
+                                                   UNIT_TIME_USEC);
+                if (obj->info.idleusec == 0)
                 {
-                    ret = -1;
+                    obj->info.idleusec = tvus;
                 }
-                else if (obj->event.revents & FIONOBJ_REVENT_ERROR)
+                else if ((tvus - obj->info.idleusec) >= obj->conf.idlelimitusec)
                 {
                     ret = -1;
                 }
                 else
                 {
-                    // @todo This is a hack.
-                    uint64_t tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC,
-                                                       UNIT_TIME_USEC);
-                    if (((tvus - obj->info.recv.buflen.tvn) >= 5000000) &&
-                        ((tvus - obj->info.send.buflen.tvn) >= 5000000))
-                    {
-                        ret = -1;
-                    }
+                    // Do nothing.
                 }
             }
         }
@@ -378,15 +699,34 @@ int32_t sockudp_send(struct sockobj * const obj,
                      void * const buf,
                      const uint32_t len)
 {
-    int32_t ret   = -1;
-    int32_t flags = MSG_DONTWAIT;
+    int32_t  ret   = -1;
+    int32_t  flags = MSG_DONTWAIT;
+    uint32_t batch = 0;
 #if defined(__linux__)
     flags |= MSG_NOSIGNAL;
 #endif
 
     if (UTILDEBUG_VERIFY((obj != NULL) && (buf != NULL)))
     {
-        if (obj->state & SOCKOBJ_STATE_CONNECT)
+        if (((batch = sockudp_getbatch(obj, len)) > 0) &&
+            (obj->conf.segmentlen > 0))
+        {
+            // The buffer is split into segments by the kernel (or the
+            // network interface).
+            ret = send(obj->fd,
+                       buf,
+                       (len < batch * obj->conf.segmentlen ?
+                        len :
+                        batch * obj->conf.segmentlen),
+                       flags);
+        }
+        else if (batch > 0)
+        {
+#if defined(__linux__)
+            ret = sockudp_callbatch(obj, buf, len, batch, false);
+#endif
+        }
+        else if (obj->state & SOCKOBJ_STATE_CONNECT)
         {
             // sendto() could be used if the last two arguments were set to NULL
             // and 0, respectively.
@@ -404,7 +744,20 @@ int32_t sockudp_send(struct sockobj * const obj,
 
         if (ret > 0)
         {
-            utilstats_add(&obj->info.send.buflen, ret);
+            obj->info.idleusec = 0;
+
+            if ((obj->conf.segmentlen > 0) &&
+                (obj->state & SOCKOBJ_STATE_CONNECT))
+            {
+                sockudp_addsegments(&obj->info.send,
+                                    (uint32_t)ret,
+                                    obj->conf.segmentlen);
+            }
+            else if (batch == 0)
+            {
+                utilstats_add(&obj->info.send.buflen, ret);
+            }
+
             logger_printf(LOGGER_LEVEL_TRACE,
                           "%s: socket %u sent %d bytes\n",
                           __FUNCTION__,
@@ -419,7 +772,7 @@ int32_t sockudp_send(struct sockobj * const obj,
                               "%s: datagram payload (%u) is larger than the"
                               " maximum message size (%u)\n",
                               __FUNCTION__,
-                              len,
+                              (batch > 0 ? obj->conf.batchlen : len),
                               sockudp_getmaxmsgsize(obj));
                 ret = -1;
             }
@@ -441,38 +794,6 @@ int32_t sockudp_send(struct sockobj * const obj,
                               errno);
                 ret = 0;
             }
-
-            if (ret == 0)
-            {
-                if (!obj->event.ops.fion_poll(&obj->event))
-                {
-                    ret = -1;
-                }
-                else if (obj->event.revents & FIONOBJ_REVENT_ERROR)
-                {
-                    ret = -1;
-                }
-                else if (obj->event.revents & FIONOBJ_REVENT_INREADY)
-                {
-                    ret = recv(obj->fd, buf, len, flags);
-
-                    // Remote peer is closed if input is ready but no bytes are
-                    // received (EOF).
-                    if (ret > 0)
-                    {
-                        utilstats_add(&obj->info.recv.buflen, ret);
-                        logger_printf(LOGGER_LEVEL_TRACE,
-                                      "%s: socket %u received %d bytes\n",
-                                      __FUNCTION__,
-                                      obj->sid,
-                                      ret);
-                    }
-                    else
-                    {
-                        ret = -1;
-                    }
-                }
-            }
         }
     }
 
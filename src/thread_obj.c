@@ -18,6 +18,10 @@
 #include <signal.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 struct threadobj_priv
 {
     char             name[64];
@@ -147,10 +151,12 @@ bool threadobj_stop(struct threadobj * const thread)
         thread->priv->shutdown = true;
         mutexobj_unlock(&thread->priv->mutex);
 
-        while ((thread->priv->handle != 0) &&
-               (pthread_kill(thread->priv->handle, 0) == 0))
+        // A terminated thread that has not been joined is still a valid
+        // pthread_kill() target, so join the thread to wait for its exit.
+        if ((thread->priv->handle != 0) &&
+            (pthread_join(thread->priv->handle, NULL) == 0))
         {
-            threadobj_sleepusec(10 * 1000);
+            thread->priv->handle = 0;
         }
 
         ret = true;
@@ -206,6 +212,73 @@ bool threadobj_isrunning(struct threadobj * const thread)
     return ret;
 }
 
+bool threadobj_setaffinity(struct threadobj * const thread, const int32_t cpu)
+{
+    bool ret = false;
+#if defined(__linux__)
+    cpu_set_t cpus;
+    int32_t err = 0, i;
+#endif
+
+    if (UTILDEBUG_VERIFY((thread != NULL) && (thread->priv != NULL)))
+    {
+#if defined(__linux__)
+        CPU_ZERO(&cpus);
+
+        if (cpu >= CPU_SETSIZE)
+        {
+            err = EINVAL;
+        }
+        else if (cpu >= 0)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+        else
+        {
+            // The kernel ignores CPUs that are not available.
+            for (i = 0; i < CPU_SETSIZE; i++)
+            {
+                CPU_SET(i, &cpus);
+            }
+        }
+
+        if (err != 0)
+        {
+            // Do nothing.
+        }
+        else if (thread->priv->handle != 0)
+        {
+            err = pthread_setaffinity_np(thread->priv->handle,
+                                         sizeof(cpus),
+                                         &cpus);
+        }
+        else
+        {
+            err = pthread_attr_setaffinity_np(&thread->priv->attr,
+                                              sizeof(cpus),
+                                              &cpus);
+        }
+
+        if (err != 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to set CPU affinity to CPU %d (%d)\n",
+                          __FUNCTION__,
+                          cpu,
+                          err);
+        }
+        else
+        {
+            ret = true;
+        }
+#else
+        ret = (cpu < 0);
+#endif
+    }
+
+    return ret;
+}
+
 bool threadobj_join(struct threadobj * const thread)
 {
     bool ret = false;
@@ -20,17 +20,18 @@
 
 struct threadpool_priv
 {
-    struct cvobj    cv_task;
-    struct cvobj    cv_wait;
-    struct mutexobj mtx;
-    struct vector   threads;
-    struct vector   tasks;
-    uint32_t        startup;
-    uint32_t        running;
-    uint32_t        busy;
-    uint32_t        complete;
-    uint32_t        wait;
-    bool            shutdown;
+    struct cvobj       cv_task;
+    struct cvobj       cv_wait;
+    struct mutexobj    mtx;
+    struct vector      threads;
+    struct vector      tasks;
+    struct utilcpu_set affinity;
+    uint32_t           startup;
+    uint32_t           running;
+    uint32_t           busy;
+    uint32_t           complete;
+    uint32_t           wait;
+    bool               shutdown;
 };
 
 struct threadpool_task
@@ -44,10 +45,12 @@ struct threadpool_thread
 {
     struct threadobj handle;
     uint32_t         taskid;
+    int32_t          cpu;
 };
 
 /**
- * @brief Set the thread pool task id of the calling thread.
+ * @brief Set the thread pool task id of the calling thread, and pin the calling
+ *        thread to the CPU of the task.
  *
  * @param[in,out] pool   A pointer to a thread pool to create.
  * @param[in]     taskid A task id to associated with the calling thread.
@@ -61,6 +64,7 @@ static bool threadpool_setid(struct threadpool * const pool,
     uint64_t threadid = threadobj_getcallerid();
     struct threadpool_thread *thread = NULL;
     uint32_t i;
+    int32_t cpu;
 
     for (i = 0; i < vector_getsize(&pool->priv->threads); i++)
     {
@@ -69,6 +73,16 @@ static bool threadpool_setid(struct threadpool * const pool,
         if (threadid == threadobj_getthreadid(&thread->handle))
         {
             thread->taskid = taskid;
+            cpu = threadpool_getcpu(pool, taskid);
+
+            // A thread is reused across tasks, so a thread is also unpinned
+            // if its new task is not pinned.
+            if ((cpu != thread->cpu) &&
+                (threadobj_setaffinity(&thread->handle, cpu)))
+            {
+                thread->cpu = cpu;
+            }
+
             ret = true;
             break;
         }
@@ -181,6 +195,7 @@ bool threadpool_create(struct threadpool * pool, const uint32_t size)
             {
                 thread = vector_getval(&pool->priv->threads, i);
                 memset(thread, 0, sizeof(*thread));
+                thread->cpu = -1;
 
                 if (!threadobj_create(&thread->handle))
                 {
@@ -374,6 +389,40 @@ bool threadpool_execute(struct threadpool * const pool,
     return ret;
 }
 
+bool threadpool_setaffinity(struct threadpool * const pool,
+                            const struct utilcpu_set * const set)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((pool != NULL) &&
+                         (pool->priv != NULL) &&
+                         (set != NULL)))
+    {
+        mutexobj_lock(&pool->priv->mtx);
+        pool->priv->affinity = *set;
+        mutexobj_unlock(&pool->priv->mtx);
+        ret = true;
+    }
+
+    return ret;
+}
+
+int32_t threadpool_getcpu(struct threadpool * const pool, const uint32_t taskid)
+{
+    int32_t ret = -1;
+
+    if (UTILDEBUG_VERIFY((pool != NULL) && (pool->priv != NULL)))
+    {
+        if ((pool->priv->affinity.policy != UTILCPU_POLICY_NONE) &&
+            (pool->priv->affinity.count > 0))
+        {
+            ret = pool->priv->affinity.cpus[taskid % pool->priv->affinity.count];
+        }
+    }
+
+    return ret;
+}
+
 bool threadpool_wait(struct threadpool * const pool, const uint32_t wait_count)
 {
     bool ret = false;
@@ -0,0 +1,412 @@
+/**
+ * @file      timer_wheel.c
+ * @brief     Hierarchical timer wheel implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "logger.h"
+#include "timer_wheel.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define TIMERWHEEL_MASK     (TIMERWHEEL_SLOTS - 1)
+#define TIMERWHEEL_SPAN     (1ULL << (TIMERWHEEL_BITS * TIMERWHEEL_LEVELS))
+#define TIMERWHEEL_FREE     UINT32_MAX
+#define TIMERWHEEL_MINCOUNT 64
+
+struct timerwheel_entry
+{
+    uint64_t key;      // Caller key
+    uint64_t expiryus; // Expiry time in microseconds
+    uint32_t next;     // Next entry in the slot (or free list)
+    uint32_t prev;     // Previous entry in the slot
+    uint32_t slot;     // Slot of the entry (TIMERWHEEL_FREE if free)
+};
+
+// Entries are indexed from 1 so that an index of 0 is the end of a list and an
+// invalid handle.
+struct timerwheel_priv
+{
+    struct timerwheel_entry *entries;
+    uint32_t                 count;  // Entries allocated (including entry 0)
+    uint32_t                 free;   // First free entry (0 if none)
+    uint32_t                 size;   // Scheduled timers
+    uint64_t                 tickus; // Tick length in microseconds
+    uint64_t                 tick;   // Current tick
+    uint32_t                 heads[TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS];
+};
+
+/**
+ * @brief Add an entry to the slot of a timer wheel that its expiry time falls
+ *        in relative to the current tick.
+ *
+ * @param[in,out] priv  A pointer to the private data of a timer wheel.
+ * @param[in]     index The index of the entry.
+ *
+ * @return Void.
+ */
+static void timerwheel_link(struct timerwheel_priv * const priv,
+                            const uint32_t index)
+{
+    struct timerwheel_entry *entry = &priv->entries[index];
+    uint64_t tick = entry->expiryus / priv->tickus;
+    uint32_t level = 0;
+
+    tick = (tick < priv->tick ? priv->tick : tick);
+
+    if (tick - priv->tick >= TIMERWHEEL_SPAN)
+    {
+        tick = priv->tick + TIMERWHEEL_SPAN - 1;
+    }
+
+    while ((level < TIMERWHEEL_LEVELS - 1) &&
+           (tick - priv->tick >= (1ULL << (TIMERWHEEL_BITS * (level + 1)))))
+    {
+        level++;
+    }
+
+    entry->slot = level * TIMERWHEEL_SLOTS +
+                  (uint32_t)((tick >> (TIMERWHEEL_BITS * level)) & TIMERWHEEL_MASK);
+    entry->prev = 0;
+    entry->next = priv->heads[entry->slot];
+
+    if (entry->next != 0)
+    {
+        priv->entries[entry->next].prev = index;
+    }
+
+    priv->heads[entry->slot] = index;
+}
+
+/**
+ * @brief Remove an entry from its slot of a timer wheel.
+ *
+ * @param[in,out] priv  A pointer to the private data of a timer wheel.
+ * @param[in]     index The index of the entry.
+ *
+ * @return Void.
+ */
+static void timerwheel_unlink(struct timerwheel_priv * const priv,
+                              const uint32_t index)
+{
+    struct timerwheel_entry *entry = &priv->entries[index];
+
+    if (entry->prev != 0)
+    {
+        priv->entries[entry->prev].next = entry->next;
+    }
+    else
+    {
+        priv->heads[entry->slot] = entry->next;
+    }
+
+    if (entry->next != 0)
+    {
+        priv->entries[entry->next].prev = entry->prev;
+    }
+}
+
+/**
+ * @brief Return an entry of a timer wheel to its free list.
+ *
+ * @param[in,out] priv  A pointer to the private data of a timer wheel.
+ * @param[in]     index The index of the entry.
+ *
+ * @return Void.
+ */
+static void timerwheel_release(struct timerwheel_priv * const priv,
+                               const uint32_t index)
+{
+    priv->entries[index].slot = TIMERWHEEL_FREE;
+    priv->entries[index].next = priv->free;
+    priv->free = index;
+    priv->size--;
+}
+
+/**
+ * @brief Move the timers of the upper level slots that the current tick of a
+ *        timer wheel has reached down to the lower levels.
+ *
+ * @param[in,out] priv A pointer to the private data of a timer wheel.
+ *
+ * @return Void.
+ */
+static void timerwheel_cascade(struct timerwheel_priv * const priv)
+{
+    uint32_t level = 1, index, next, slot;
+
+    // The slots of the highest level that was reached are moved first so that
+    // their timers are moved again if they land in a reached lower slot.
+    while ((level < TIMERWHEEL_LEVELS - 1) &&
+           ((priv->tick & ((1ULL << (TIMERWHEEL_BITS * (level + 1))) - 1)) == 0))
+    {
+        level++;
+    }
+
+    for (; level > 0; level--)
+    {
+        if ((priv->tick & ((1ULL << (TIMERWHEEL_BITS * level)) - 1)) == 0)
+        {
+            slot = level * TIMERWHEEL_SLOTS +
+                   (uint32_t)((priv->tick >> (TIMERWHEEL_BITS * level)) & TIMERWHEEL_MASK);
+            index = priv->heads[slot];
+            priv->heads[slot] = 0;
+
+            while (index != 0)
+            {
+                next = priv->entries[index].next;
+                timerwheel_link(priv, index);
+                index = next;
+            }
+        }
+    }
+}
+
+bool timerwheel_create(struct timerwheel * const wheel,
+                       const uint64_t tickus,
+                       const uint64_t nowus)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv == NULL) && (tickus > 0)))
+    {
+        if ((wheel->priv = UTILMEM_CALLOC(struct timerwheel_priv,
+                                          sizeof(struct timerwheel_priv),
+                                          1)) == NULL)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: failed to allocate private memory (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            wheel->priv->tickus = tickus;
+            wheel->priv->tick   = nowus / tickus;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool timerwheel_destroy(struct timerwheel * const wheel)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv != NULL)))
+    {
+        UTILMEM_FREE(wheel->priv->entries);
+        UTILMEM_FREE(wheel->priv);
+        wheel->priv = NULL;
+        ret = true;
+    }
+
+    return ret;
+}
+
+uint32_t timerwheel_schedule(struct timerwheel * const wheel,
+                             const uint64_t key,
+                             const uint64_t expiryus)
+{
+    uint32_t ret = 0, count = 0, i;
+    struct timerwheel_entry *entries = NULL;
+
+    if (!UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv != NULL)))
+    {
+        // Do nothing.
+    }
+    else if (wheel->priv->free != 0)
+    {
+        ret = wheel->priv->free;
+    }
+    else if ((count = (wheel->priv->count == 0 ?
+                       TIMERWHEEL_MINCOUNT :
+                       wheel->priv->count * 2)) <= wheel->priv->count)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: too many timers\n",
+                      __FUNCTION__);
+    }
+    else if ((entries = UTILMEM_REALLOC(struct timerwheel_entry,
+                                        wheel->priv->entries,
+                                        sizeof(struct timerwheel_entry) * count)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate timers (%d)\n",
+                      __FUNCTION__,
+                      errno);
+    }
+    else
+    {
+        // Entry 0 is never used.
+        for (i = (wheel->priv->count == 0 ? 1 : wheel->priv->count); i < count; i++)
+        {
+            entries[i].slot = TIMERWHEEL_FREE;
+            entries[i].next = (i + 1 < count ? i + 1 : 0);
+        }
+
+        ret = (wheel->priv->count == 0 ? 1 : wheel->priv->count);
+        wheel->priv->entries = entries;
+        wheel->priv->count   = count;
+        wheel->priv->free    = ret;
+    }
+
+    if (ret != 0)
+    {
+        wheel->priv->free = wheel->priv->entries[ret].next;
+        wheel->priv->entries[ret].key      = key;
+        wheel->priv->entries[ret].expiryus = expiryus;
+        wheel->priv->size++;
+        timerwheel_link(wheel->priv, ret);
+    }
+
+    return ret;
+}
+
+bool timerwheel_cancel(struct timerwheel * const wheel, const uint32_t handle)
+{
+    bool ret = false;
+
+    if (!UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv != NULL)))
+    {
+        // Do nothing.
+    }
+    else if ((handle == 0) ||
+             (handle >= wheel->priv->count) ||
+             (wheel->priv->entries[handle].slot == TIMERWHEEL_FREE))
+    {
+        // Do nothing.
+    }
+    else
+    {
+        timerwheel_unlink(wheel->priv, handle);
+        timerwheel_release(wheel->priv, handle);
+        ret = true;
+    }
+
+    return ret;
+}
+
+uint32_t timerwheel_expire(struct timerwheel * const wheel,
+                           const uint64_t nowus,
+                           struct timerwheel_timer * const timers,
+                           const uint32_t count)
+{
+    uint32_t ret = 0, index, next;
+    uint64_t target = 0;
+    struct timerwheel_priv *priv = NULL;
+
+    if (UTILDEBUG_VERIFY((wheel != NULL) &&
+                         (wheel->priv != NULL) &&
+                         (timers != NULL)))
+    {
+        priv = wheel->priv;
+        target = nowus / priv->tickus;
+
+        while (ret < count)
+        {
+            // Only the slot of the current tick may hold timers that have not
+            // expired yet.
+            index = priv->heads[priv->tick & TIMERWHEEL_MASK];
+
+            while ((index != 0) && (ret < count))
+            {
+                next = priv->entries[index].next;
+
+                if (priv->entries[index].expiryus <= nowus)
+                {
+                    timers[ret].key      = priv->entries[index].key;
+                    timers[ret].expiryus = priv->entries[index].expiryus;
+                    timerwheel_unlink(priv, index);
+                    timerwheel_release(priv, index);
+                    ret++;
+                }
+
+                index = next;
+            }
+
+            if ((ret >= count) || (priv->tick >= target))
+            {
+                break;
+            }
+            else if (priv->size == 0)
+            {
+                priv->tick = target;
+            }
+            else
+            {
+                priv->tick++;
+                timerwheel_cascade(priv);
+            }
+        }
+    }
+
+    return ret;
+}
+
+uint64_t timerwheel_getnext(const struct timerwheel * const wheel)
+{
+    uint64_t ret = UINT64_MAX, tick;
+    uint32_t level, index, i;
+    const struct timerwheel_priv *priv = NULL;
+
+    if (UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv != NULL)))
+    {
+        priv = wheel->priv;
+
+        // A bottom level slot only holds the timers of a single tick.
+        for (i = 0; (priv->size > 0) && (ret == UINT64_MAX) && (i < TIMERWHEEL_SLOTS); i++)
+        {
+            index = priv->heads[(priv->tick + i) & TIMERWHEEL_MASK];
+
+            while (index != 0)
+            {
+                if (priv->entries[index].expiryus < ret)
+                {
+                    ret = priv->entries[index].expiryus;
+                }
+
+                index = priv->entries[index].next;
+            }
+        }
+
+        // The slot of the current tick of an upper level was already moved
+        // down, so it is only reached again after a full turn.
+        for (level = 1;
+             (priv->size > 0) && (ret == UINT64_MAX) && (level < TIMERWHEEL_LEVELS);
+             level++)
+        {
+            tick = priv->tick >> (TIMERWHEEL_BITS * level);
+
+            for (i = 1; (ret == UINT64_MAX) && (i <= TIMERWHEEL_SLOTS); i++)
+            {
+                if (priv->heads[level * TIMERWHEEL_SLOTS +
+                                (uint32_t)((tick + i) & TIMERWHEEL_MASK)] != 0)
+                {
+                    ret = ((tick + i) << (TIMERWHEEL_BITS * level)) * priv->tickus;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+uint32_t timerwheel_getsize(const struct timerwheel * const wheel)
+{
+    uint32_t ret = 0;
+
+    if (UTILDEBUG_VERIFY((wheel != NULL) && (wheel->priv != NULL)))
+    {
+        ret = wheel->priv->size;
+    }
+
+    return ret;
+}
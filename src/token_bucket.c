@@ -24,6 +24,7 @@ bool tokenbucket_init(struct tokenbucket * const tb, const uint64_t rate)
     {
         tb->rate = rate;
         tb->size = 0;
+        tb->rem  = 0;
         tb->tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
 
         ret = true;
@@ -47,13 +48,12 @@ uint64_t tokenbucket_remove(struct tokenbucket * const tb,
         if (tb->rate > 0)
         {
             tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
-            addtokens = tb->rate * (tsus - tb->tsus) / UNIT_TIME_USEC;
-
-            if (addtokens > 0)
-            {
-                tb->size += addtokens;
-                tb->tsus  = tsus;
-            }
+            // Keep the part of a token that was earned since the last fill
+            // so that a low fill rate is not rounded down on every fill.
+            addtokens = tb->rate * (tsus - tb->tsus) + tb->rem;
+            tb->size += addtokens / UNIT_TIME_USEC;
+            tb->rem   = addtokens % UNIT_TIME_USEC;
+            tb->tsus  = tsus;
 
             if (tokens > 0)
             {
@@ -106,9 +106,111 @@ uint64_t tokenbucket_delay(struct tokenbucket * const tb,
     {
         if ((tb->rate > 0) && (tb->size < tokens))
         {
-            ret = (tokens - tb->size) * UNIT_TIME_USEC / tb->rate;
+            // Round up so that the tokens are available after the delay.
+            ret = ((tokens - tb->size) * UNIT_TIME_USEC - tb->rem + tb->rate - 1) /
+                  tb->rate;
         }
     }
 
     return ret;
 }
+
+/**
+ * @brief Get the time that a shared token bucket takes to earn a number of
+ *        tokens, rounded up so that the bucket never exceeds its rate.
+ *
+ * @param[in] tb     A pointer to a shared token bucket.
+ * @param[in] tokens A number of tokens.
+ *
+ * @return The time to earn the tokens in nanoseconds.
+ */
+static uint64_t tokenbucket_sharedcost(const struct tokenbucket_shared * const tb,
+                                       const uint64_t tokens)
+{
+    return (uint64_t)(((unsigned __int128)tokens * UNIT_TIME_NSEC + tb->rate - 1) /
+                      tb->rate);
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool tokenbucket_sharedinit(struct tokenbucket_shared * const tb,
+                            const uint64_t rate,
+                            const uint64_t size)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY(tb != NULL) == true)
+    {
+        tb->rate    = rate;
+        tb->depthns = (rate > 0 ? tokenbucket_sharedcost(tb, size) : 0);
+        tb->drainns = 0;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+uint64_t tokenbucket_sharedtake(struct tokenbucket_shared * const tb,
+                                const uint64_t tokens,
+                                const uint64_t tsns)
+{
+    uint64_t ret = 0, drainns, startns;
+
+    if (UTILDEBUG_VERIFY(tb != NULL) == true)
+    {
+        if (tb->rate > 0)
+        {
+            drainns = __atomic_load_n(&tb->drainns, __ATOMIC_RELAXED);
+
+            do
+            {
+                // Tokens that were not taken over the depth of the bucket
+                // overflowed it.
+                startns = (tsns > tb->depthns) && (drainns < tsns - tb->depthns) ?
+                          tsns - tb->depthns :
+                          drainns;
+                ret = startns + tokenbucket_sharedcost(tb, tokens);
+            }
+            while (!__atomic_compare_exchange_n(&tb->drainns,
+                                                &drainns,
+                                                ret,
+                                                false,
+                                                __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED));
+        }
+        else
+        {
+            ret = tsns;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+uint64_t tokenbucket_sharedreturn(struct tokenbucket_shared * const tb,
+                                  const uint64_t tokens)
+{
+    uint64_t ret = 0;
+
+    if (UTILDEBUG_VERIFY(tb != NULL) == true)
+    {
+        if ((tb->rate > 0) && (tokens > 0))
+        {
+            __atomic_sub_fetch(&tb->drainns,
+                               tokenbucket_sharedcost(tb, tokens),
+                               __ATOMIC_RELAXED);
+        }
+
+        ret = tokens;
+    }
+
+    return ret;
+}
@@ -0,0 +1,966 @@
+/**
+ * @file      uring_obj.c
+ * @brief     Asynchronous I/O ring (io_uring) object implementation.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "logger.h"
+#include "uring_obj.h"
+#include "util_debug.h"
+#include "util_mem.h"
+
+#include <errno.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <linux/io_uring.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct uringobj_priv
+{
+    int32_t                  fd;
+    uint32_t                 ringflags;
+    // Submission queue
+    void                    *sqring;
+    size_t                   sqringlen;
+    uint32_t                *sqhead;
+    uint32_t                *sqtail;
+    uint32_t                 sqmask;
+    uint32_t                 sqentries;
+    uint32_t                 sqlocal;   // Local (unpublished) tail
+    struct io_uring_sqe     *sqes;
+    size_t                   sqeslen;
+    // Completion queue
+    void                    *cqring;
+    size_t                   cqringlen;
+    uint32_t                *cqhead;
+    uint32_t                *cqtail;
+    uint32_t                 cqmask;
+    struct io_uring_cqe     *cqes;
+    // Provided buffer ring
+    struct io_uring_buf_ring *br;
+    size_t                   brlen;
+    uint8_t                 *brbufs;
+    uint32_t                 brbufsize;
+    uint16_t                 brmask;
+    uint16_t                 brtail;
+    uint16_t                 brgroup;
+};
+
+/**
+ * @brief Set up an io_uring instance with the most efficient set of flags
+ *        supported by the kernel.
+ *
+ * @param[in]     entries The minimum number of submission queue entries.
+ * @param[in,out] params  A pointer to io_uring parameters.
+ *
+ * @return An io_uring file descriptor (-1 on error).
+ */
+static int32_t uringobj_setup(const uint32_t entries,
+                              struct io_uring_params * const params)
+{
+    int32_t ret = -1;
+    uint32_t flags[] =
+    {
+#if defined(IORING_SETUP_SINGLE_ISSUER) && defined(IORING_SETUP_DEFER_TASKRUN)
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+#endif
+#if defined(IORING_SETUP_COOP_TASKRUN)
+        IORING_SETUP_COOP_TASKRUN,
+#endif
+        0
+    };
+    uint32_t i;
+
+    for (i = 0; (ret < 0) && (i < sizeof(flags) / sizeof(flags[0])); i++)
+    {
+        memset(params, 0, sizeof(*params));
+        // Size the completion queue for multishot requests that generate
+        // several completions per submission.
+        params->flags      = flags[i] | IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+        params->cq_entries = entries * 4;
+        ret = (int32_t)syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get a free submission queue entry.
+ *
+ * @param[in,out] obj A pointer to an asynchronous I/O ring object.
+ *
+ * @return A pointer to a cleared submission queue entry (NULL if the
+ *         submission queue is full).
+ */
+static struct io_uring_sqe *uringobj_getsqe(struct uringobj * const obj)
+{
+    struct io_uring_sqe *ret = NULL;
+    struct uringobj_priv *priv = obj->priv;
+
+    // Flush the submission queue if it is full.
+    if ((priv->sqlocal - __atomic_load_n(priv->sqhead, __ATOMIC_ACQUIRE)) >=
+        priv->sqentries)
+    {
+        uringobj_submit(obj, 0, 0);
+    }
+
+    if ((priv->sqlocal - __atomic_load_n(priv->sqhead, __ATOMIC_ACQUIRE)) <
+        priv->sqentries)
+    {
+        ret = &priv->sqes[priv->sqlocal & priv->sqmask];
+        memset(ret, 0, sizeof(*ret));
+        priv->sqlocal++;
+        obj->sqecnt++;
+    }
+    else
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: submission queue is full\n",
+                      __FUNCTION__);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check if the kernel supports multishot receive (and therefore
+ *        multishot accept, which was added in an earlier release). Flags of
+ *        an operation can't be probed for, so a multishot receive request is
+ *        issued on a socket pair with readable data and an unknown buffer
+ *        group: a kernel that supports it fails the request with ENOBUFS
+ *        while an older kernel rejects the flag with EINVAL.
+ *
+ * @param[in,out] obj A pointer to an asynchronous I/O ring object with an
+ *                    empty completion queue.
+ *
+ * @return True if multishot receive is supported.
+ */
+static bool uringobj_ismultishotsupported(struct uringobj * const obj)
+{
+    bool ret = false;
+    struct uringobj_cqe cqe;
+    int32_t fds[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) != 0)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: socket pair creation failed (%d)\n",
+                      __FUNCTION__,
+                      errno);
+    }
+    else
+    {
+        if ((write(fds[1], "", 1) == 1) &&
+            (uringobj_recvmulti(obj, fds[0], UINT16_MAX, 0)) &&
+            (uringobj_submit(obj, 1, 1000000)) &&
+            (uringobj_reap(obj, &cqe, 1) == 1) &&
+            (cqe.res != -EINVAL))
+        {
+            ret = true;
+        }
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    return ret;
+}
+
+bool uringobj_create(struct uringobj * const obj, const uint32_t entries)
+{
+    bool ret = false;
+    struct uringobj_priv *priv = NULL;
+    struct io_uring_params params;
+    uint32_t i;
+
+    if (!UTILDEBUG_VERIFY((obj != NULL) && (obj->priv == NULL) && (entries > 0)))
+    {
+        // Do nothing.
+    }
+    else if ((priv = UTILMEM_CALLOC(struct uringobj_priv,
+                                    sizeof(struct uringobj_priv),
+                                    1)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate memory\n",
+                      __FUNCTION__);
+    }
+    else
+    {
+        obj->priv     = priv;
+        obj->features = 0;
+        obj->entercnt = 0;
+        obj->sqecnt   = 0;
+        obj->cqecnt   = 0;
+        priv->sqring  = MAP_FAILED;
+        priv->cqring  = MAP_FAILED;
+        priv->sqes    = MAP_FAILED;
+        priv->br      = MAP_FAILED;
+
+        if ((priv->fd = uringobj_setup(entries, &params)) < 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: io_uring setup failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else if ((params.features & IORING_FEAT_EXT_ARG) == 0)
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: io_uring wait timeouts are not supported\n",
+                          __FUNCTION__);
+        }
+        else
+        {
+            priv->ringflags = params.flags;
+            priv->sqringlen = params.sq_off.array +
+                              params.sq_entries * sizeof(uint32_t);
+            priv->cqringlen = params.cq_off.cqes +
+                              params.cq_entries * sizeof(struct io_uring_cqe);
+            priv->sqeslen   = params.sq_entries * sizeof(struct io_uring_sqe);
+
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                if (priv->cqringlen > priv->sqringlen)
+                {
+                    priv->sqringlen = priv->cqringlen;
+                }
+                priv->cqringlen = priv->sqringlen;
+            }
+
+            priv->sqring = mmap(NULL,
+                                priv->sqringlen,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE,
+                                priv->fd,
+                                IORING_OFF_SQ_RING);
+
+            if ((priv->sqring != MAP_FAILED) &&
+                (params.features & IORING_FEAT_SINGLE_MMAP))
+            {
+                priv->cqring = priv->sqring;
+            }
+            else if (priv->sqring != MAP_FAILED)
+            {
+                priv->cqring = mmap(NULL,
+                                    priv->cqringlen,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE,
+                                    priv->fd,
+                                    IORING_OFF_CQ_RING);
+            }
+
+            if (priv->cqring != MAP_FAILED)
+            {
+                priv->sqes = mmap(NULL,
+                                  priv->sqeslen,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE,
+                                  priv->fd,
+                                  IORING_OFF_SQES);
+            }
+
+            if (priv->sqes == MAP_FAILED)
+            {
+                logger_printf(LOGGER_LEVEL_ERROR,
+                              "%s: io_uring memory map failed (%d)\n",
+                              __FUNCTION__,
+                              errno);
+            }
+            else
+            {
+                priv->sqhead    = (uint32_t *)((uint8_t *)priv->sqring + params.sq_off.head);
+                priv->sqtail    = (uint32_t *)((uint8_t *)priv->sqring + params.sq_off.tail);
+                priv->sqmask    = *(uint32_t *)((uint8_t *)priv->sqring + params.sq_off.ring_mask);
+                priv->sqentries = params.sq_entries;
+                priv->sqlocal   = *priv->sqtail;
+                priv->cqhead    = (uint32_t *)((uint8_t *)priv->cqring + params.cq_off.head);
+                priv->cqtail    = (uint32_t *)((uint8_t *)priv->cqring + params.cq_off.tail);
+                priv->cqmask    = *(uint32_t *)((uint8_t *)priv->cqring + params.cq_off.ring_mask);
+                priv->cqes      = (struct io_uring_cqe *)((uint8_t *)priv->cqring + params.cq_off.cqes);
+
+                // Use an identity mapping between the submission queue array
+                // and the submission queue entries.
+                for (i = 0; i < params.sq_entries; i++)
+                {
+                    ((uint32_t *)((uint8_t *)priv->sqring + params.sq_off.array))[i] = i;
+                }
+
+                ret = true;
+
+                if (uringobj_ismultishotsupported(obj))
+                {
+                    obj->features |= URINGOBJ_FEATURE_MULTISHOT;
+                }
+
+                obj->entercnt = 0;
+                obj->sqecnt   = 0;
+                obj->cqecnt   = 0;
+            }
+        }
+
+        if (!ret)
+        {
+            uringobj_destroy(obj);
+        }
+    }
+
+    return ret;
+}
+
+bool uringobj_destroy(struct uringobj * const obj)
+{
+    bool ret = false;
+    struct uringobj_priv *priv = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        priv = obj->priv;
+
+        if (priv->br != MAP_FAILED)
+        {
+            munmap(priv->br, priv->brlen);
+        }
+
+        if (priv->brbufs != NULL)
+        {
+            UTILMEM_FREE(priv->brbufs);
+        }
+
+        if (priv->sqes != MAP_FAILED)
+        {
+            munmap(priv->sqes, priv->sqeslen);
+        }
+
+        if ((priv->cqring != MAP_FAILED) && (priv->cqring != priv->sqring))
+        {
+            munmap(priv->cqring, priv->cqringlen);
+        }
+
+        if (priv->sqring != MAP_FAILED)
+        {
+            munmap(priv->sqring, priv->sqringlen);
+        }
+
+        if (priv->fd >= 0)
+        {
+            close(priv->fd);
+        }
+
+        UTILMEM_FREE(priv);
+        obj->priv     = NULL;
+        obj->features = 0;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_registerbufs(struct uringobj * const obj,
+                           const struct iovec * const iov,
+                           const uint32_t count)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->priv != NULL) &&
+                         (iov != NULL) &&
+                         (count > 0)))
+    {
+        if (syscall(__NR_io_uring_register,
+                    obj->priv->fd,
+                    IORING_REGISTER_BUFFERS,
+                    iov,
+                    count) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: buffer registration failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+        else
+        {
+            obj->features |= URINGOBJ_FEATURE_FIXEDBUFS;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool uringobj_createbufring(struct uringobj * const obj,
+                            const uint16_t group,
+                            const uint16_t count,
+                            const uint32_t size)
+{
+    bool ret = false;
+    struct uringobj_priv *priv = NULL;
+    struct io_uring_buf_reg reg;
+    struct io_uring_buf *buf = NULL;
+    uint32_t i;
+
+    if (!UTILDEBUG_VERIFY((obj != NULL) &&
+                          (obj->priv != NULL) &&
+                          (obj->priv->br == MAP_FAILED) &&
+                          (count > 0) &&
+                          ((count & (count - 1)) == 0) &&
+                          (size > 0)))
+    {
+        // Do nothing.
+    }
+    else if ((obj->priv->brbufs = UTILMEM_CALLOC(uint8_t,
+                                                 size,
+                                                 count)) == NULL)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to allocate memory\n",
+                      __FUNCTION__);
+    }
+    else if ((obj->priv->br = mmap(NULL,
+                                   count * sizeof(struct io_uring_buf),
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_ANONYMOUS | MAP_PRIVATE,
+                                   -1,
+                                   0)) == MAP_FAILED)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: buffer ring memory map failed (%d)\n",
+                      __FUNCTION__,
+                      errno);
+    }
+    else
+    {
+        priv            = obj->priv;
+        priv->brlen     = count * sizeof(struct io_uring_buf);
+        priv->brbufsize = size;
+        priv->brmask    = count - 1;
+        priv->brtail    = 0;
+        priv->brgroup   = group;
+
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr    = (uint64_t)(uintptr_t)priv->br;
+        reg.ring_entries = count;
+        reg.bgid         = group;
+
+        if (syscall(__NR_io_uring_register,
+                    priv->fd,
+                    IORING_REGISTER_PBUF_RING,
+                    &reg,
+                    1) != 0)
+        {
+            logger_printf(LOGGER_LEVEL_WARN,
+                          "%s: buffer ring registration failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+            munmap(priv->br, priv->brlen);
+            priv->br = MAP_FAILED;
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                buf       = &priv->br->bufs[i];
+                buf->addr = (uint64_t)(uintptr_t)(priv->brbufs + i * size);
+                buf->len  = size;
+                buf->bid  = (uint16_t)i;
+            }
+
+            priv->brtail = count;
+            __atomic_store_n(&priv->br->tail, priv->brtail, __ATOMIC_RELEASE);
+            obj->features |= URINGOBJ_FEATURE_BUFRING;
+            ret = true;
+        }
+    }
+
+    if ((!ret) && (obj != NULL) && (obj->priv != NULL))
+    {
+        UTILMEM_FREE(obj->priv->brbufs);
+        obj->priv->brbufs = NULL;
+    }
+
+    return ret;
+}
+
+void *uringobj_getbuf(struct uringobj * const obj,
+                      const struct uringobj_cqe * const cqe)
+{
+    void *ret = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->priv != NULL) &&
+                         (cqe != NULL)) &&
+        (obj->priv->br != MAP_FAILED) &&
+        (cqe->flags & URINGOBJ_CQEFLAG_BUFFER))
+    {
+        ret = obj->priv->brbufs +
+              (cqe->flags >> IORING_CQE_BUFFER_SHIFT) * obj->priv->brbufsize;
+    }
+
+    return ret;
+}
+
+bool uringobj_returnbuf(struct uringobj * const obj,
+                        const struct uringobj_cqe * const cqe)
+{
+    bool ret = false;
+    struct uringobj_priv *priv = NULL;
+    struct io_uring_buf *buf = NULL;
+    uint16_t bid;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) &&
+                         (obj->priv != NULL) &&
+                         (cqe != NULL)) &&
+        (obj->priv->br != MAP_FAILED) &&
+        (cqe->flags & URINGOBJ_CQEFLAG_BUFFER))
+    {
+        priv      = obj->priv;
+        bid       = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        buf       = &priv->br->bufs[priv->brtail & priv->brmask];
+        buf->addr = (uint64_t)(uintptr_t)(priv->brbufs + bid * priv->brbufsize);
+        buf->len  = priv->brbufsize;
+        buf->bid  = bid;
+        priv->brtail++;
+        __atomic_store_n(&priv->br->tail, priv->brtail, __ATOMIC_RELEASE);
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_accept(struct uringobj * const obj,
+                     const int32_t fd,
+                     const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode       = IORING_OP_ACCEPT;
+        sqe->fd           = fd;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data    = data;
+
+        if (obj->features & URINGOBJ_FEATURE_MULTISHOT)
+        {
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_recvmulti(struct uringobj * const obj,
+                        const int32_t fd,
+                        const uint16_t group,
+                        const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode    = IORING_OP_RECV;
+        sqe->fd        = fd;
+        sqe->flags     = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = group;
+        sqe->ioprio    = IORING_RECV_MULTISHOT;
+        sqe->user_data = data;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_recv(struct uringobj * const obj,
+                   const int32_t fd,
+                   void * const buf,
+                   const uint32_t len,
+                   const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode    = IORING_OP_RECV;
+        sqe->fd        = fd;
+        sqe->addr      = (uint64_t)(uintptr_t)buf;
+        sqe->len       = len;
+        sqe->user_data = data;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_poll(struct uringobj * const obj,
+                   const int32_t fd,
+                   const uint32_t events,
+                   const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = fd;
+        sqe->poll32_events = events;
+        sqe->user_data     = data;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_readfixed(struct uringobj * const obj,
+                        const int32_t fd,
+                        void * const buf,
+                        const uint32_t len,
+                        const uint16_t index,
+                        const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode    = IORING_OP_READ_FIXED;
+        sqe->fd        = fd;
+        sqe->addr      = (uint64_t)(uintptr_t)buf;
+        sqe->len       = len;
+        sqe->buf_index = index;
+        sqe->user_data = data;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_send(struct uringobj * const obj,
+                   const int32_t fd,
+                   const void * const buf,
+                   const uint32_t len,
+                   const int32_t flags,
+                   const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode    = IORING_OP_SEND;
+        sqe->fd        = fd;
+        sqe->addr      = (uint64_t)(uintptr_t)buf;
+        sqe->len       = len;
+        sqe->msg_flags = (uint32_t)flags;
+        sqe->user_data = data;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_cancel(struct uringobj * const obj, const uint64_t data)
+{
+    bool ret = false;
+    struct io_uring_sqe *sqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)) &&
+        ((sqe = uringobj_getsqe(obj)) != NULL))
+    {
+        sqe->opcode       = IORING_OP_ASYNC_CANCEL;
+        sqe->fd           = -1;
+        sqe->addr         = data;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data    = 0;
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool uringobj_submit(struct uringobj * const obj,
+                     const uint32_t waitcnt,
+                     const uint64_t timeoutus)
+{
+    bool ret = false;
+    struct uringobj_priv *priv = NULL;
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    uint32_t count, flags = IORING_ENTER_GETEVENTS;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL)))
+    {
+        priv  = obj->priv;
+        count = priv->sqlocal - *priv->sqtail;
+        __atomic_store_n(priv->sqtail, priv->sqlocal, __ATOMIC_RELEASE);
+
+        memset(&arg, 0, sizeof(arg));
+
+        if (waitcnt > 0)
+        {
+            ts.tv_sec      = (int64_t)(timeoutus / 1000000);
+            ts.tv_nsec     = (int64_t)(timeoutus % 1000000) * 1000;
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts         = (uint64_t)(uintptr_t)&ts;
+            flags         |= IORING_ENTER_EXT_ARG;
+        }
+
+        obj->entercnt++;
+
+        if ((syscall(__NR_io_uring_enter,
+                     priv->fd,
+                     count,
+                     waitcnt,
+                     flags,
+                     waitcnt > 0 ? &arg : NULL,
+                     waitcnt > 0 ? sizeof(arg) : _NSIG / 8) >= 0) ||
+            (errno == ETIME) ||
+            (errno == EINTR) ||
+            (errno == EAGAIN) ||
+            (errno == EBUSY))
+        {
+            ret = true;
+        }
+        else
+        {
+            logger_printf(LOGGER_LEVEL_ERROR,
+                          "%s: io_uring enter failed (%d)\n",
+                          __FUNCTION__,
+                          errno);
+        }
+    }
+
+    return ret;
+}
+
+uint32_t uringobj_reap(struct uringobj * const obj,
+                       struct uringobj_cqe * const cqes,
+                       const uint32_t count)
+{
+    uint32_t ret = 0, head, tail;
+    struct uringobj_priv *priv = NULL;
+    struct io_uring_cqe *cqe = NULL;
+
+    if (UTILDEBUG_VERIFY((obj != NULL) && (obj->priv != NULL) && (cqes != NULL)))
+    {
+        priv = obj->priv;
+        head = *priv->cqhead;
+        tail = __atomic_load_n(priv->cqtail, __ATOMIC_ACQUIRE);
+
+        while ((head != tail) && (ret < count))
+        {
+            cqe = &priv->cqes[head & priv->cqmask];
+            cqes[ret].data  = cqe->user_data;
+            cqes[ret].res   = cqe->res;
+            cqes[ret].flags = 0;
+
+            if (cqe->flags & IORING_CQE_F_BUFFER)
+            {
+                cqes[ret].flags |= URINGOBJ_CQEFLAG_BUFFER |
+                                   (cqe->flags & ~((1U << IORING_CQE_BUFFER_SHIFT) - 1));
+            }
+
+            if (cqe->flags & IORING_CQE_F_MORE)
+            {
+                cqes[ret].flags |= URINGOBJ_CQEFLAG_MORE;
+            }
+
+            head++;
+            ret++;
+        }
+
+        // Release the whole batch of completion queue entries at once.
+        __atomic_store_n(priv->cqhead, head, __ATOMIC_RELEASE);
+        obj->cqecnt += ret;
+    }
+
+    return ret;
+}
+
+#else
+
+bool uringobj_create(struct uringobj * const obj, const uint32_t entries)
+{
+    (void)obj;
+    (void)entries;
+
+    logger_printf(LOGGER_LEVEL_ERROR,
+                  "%s: io_uring is not supported on this platform\n",
+                  __FUNCTION__);
+
+    return false;
+}
+
+bool uringobj_destroy(struct uringobj * const obj)
+{
+    (void)obj;
+    return false;
+}
+
+bool uringobj_registerbufs(struct uringobj * const obj,
+                           const struct iovec * const iov,
+                           const uint32_t count)
+{
+    (void)obj;
+    (void)iov;
+    (void)count;
+    return false;
+}
+
+bool uringobj_createbufring(struct uringobj * const obj,
+                            const uint16_t group,
+                            const uint16_t count,
+                            const uint32_t size)
+{
+    (void)obj;
+    (void)group;
+    (void)count;
+    (void)size;
+    return false;
+}
+
+void *uringobj_getbuf(struct uringobj * const obj,
+                      const struct uringobj_cqe * const cqe)
+{
+    (void)obj;
+    (void)cqe;
+    return NULL;
+}
+
+bool uringobj_returnbuf(struct uringobj * const obj,
+                        const struct uringobj_cqe * const cqe)
+{
+    (void)obj;
+    (void)cqe;
+    return false;
+}
+
+bool uringobj_accept(struct uringobj * const obj,
+                     const int32_t fd,
+                     const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)data;
+    return false;
+}
+
+bool uringobj_recvmulti(struct uringobj * const obj,
+                        const int32_t fd,
+                        const uint16_t group,
+                        const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)group;
+    (void)data;
+    return false;
+}
+
+bool uringobj_recv(struct uringobj * const obj,
+                   const int32_t fd,
+                   void * const buf,
+                   const uint32_t len,
+                   const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)buf;
+    (void)len;
+    (void)data;
+    return false;
+}
+
+bool uringobj_poll(struct uringobj * const obj,
+                   const int32_t fd,
+                   const uint32_t events,
+                   const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)events;
+    (void)data;
+    return false;
+}
+
+bool uringobj_readfixed(struct uringobj * const obj,
+                        const int32_t fd,
+                        void * const buf,
+                        const uint32_t len,
+                        const uint16_t index,
+                        const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)buf;
+    (void)len;
+    (void)index;
+    (void)data;
+    return false;
+}
+
+bool uringobj_send(struct uringobj * const obj,
+                   const int32_t fd,
+                   const void * const buf,
+                   const uint32_t len,
+                   const int32_t flags,
+                   const uint64_t data)
+{
+    (void)obj;
+    (void)fd;
+    (void)buf;
+    (void)len;
+    (void)flags;
+    (void)data;
+    return false;
+}
+
+bool uringobj_cancel(struct uringobj * const obj, const uint64_t data)
+{
+    (void)obj;
+    (void)data;
+    return false;
+}
+
+bool uringobj_submit(struct uringobj * const obj,
+                     const uint32_t waitcnt,
+                     const uint64_t timeoutus)
+{
+    (void)obj;
+    (void)waitcnt;
+    (void)timeoutus;
+    return false;
+}
+
+uint32_t uringobj_reap(struct uringobj * const obj,
+                       struct uringobj_cqe * const cqes,
+                       const uint32_t count)
+{
+    (void)obj;
+    (void)cqes;
+    (void)count;
+    return 0;
+}
+
+#endif
@@ -11,19 +11,27 @@
 #include "util_cpu.h"
 #include "util_date.h"
 #include "util_debug.h"
+#include "util_string.h"
 #include "util_unit.h"
 
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #if defined(__APPLE__)
    #include <mach/mach_init.h>
    #include <mach/mach_port.h>
    #include <mach/thread_act.h>
 #elif defined(__linux__)
+    #include <dirent.h>
+    #include <sched.h>
     #include <sys/time.h>
     #include <sys/resource.h>
 #endif
 
+#define UTILCPU_MAXCPU 1024
+
 #if defined(__linux__)
 /**
  * @brief Calculate CPU usage.
@@ -126,3 +134,278 @@ bool utilcpu_getinfo(struct utilcpu_info * const info)
 
     return ret;
 }
+
+/**
+ * @brief Parse a CPU list (e.g., "0,2,4-7").
+ *
+ * @param[in]     str   A pointer to a CPU list string.
+ * @param[in,out] cpus  A pointer to an array of CPU numbers.
+ * @param[in]     max   The maximum number of CPU numbers in the array.
+ * @param[out]    count A pointer to the number of CPU numbers parsed.
+ *
+ * @return True if a CPU list was parsed.
+ */
+static bool utilcpu_parselist(const char * const str,
+                              uint16_t * const cpus,
+                              const uint16_t max,
+                              uint16_t * const count)
+{
+    bool ret = true;
+    const char *pos = str;
+    char *end = NULL;
+    unsigned long first, last;
+
+    *count = 0;
+
+    while (ret && (*pos != '\0') && (*pos != '\n'))
+    {
+        first = strtoul(pos, &end, 10);
+        last  = first;
+
+        if (end == pos)
+        {
+            ret = false;
+        }
+        else if (*end == '-')
+        {
+            pos  = end + 1;
+            last = strtoul(pos, &end, 10);
+            ret  = (end != pos);
+        }
+
+        if (!ret)
+        {
+            // Do nothing.
+        }
+        else if ((first > last) || (last >= UTILCPU_MAXCPU))
+        {
+            ret = false;
+        }
+        else
+        {
+            while ((first <= last) && (*count < max))
+            {
+                cpus[(*count)++] = (uint16_t)first++;
+            }
+
+            pos = end;
+
+            if (*pos == ',')
+            {
+                pos++;
+                ret = ((*pos != '\0') && (*pos != '\n'));
+            }
+            else if ((*pos != '\0') && (*pos != '\n'))
+            {
+                ret = false;
+            }
+        }
+    }
+
+    return ret && (*count > 0);
+}
+
+bool utilcpu_parseset(const char * const str, struct utilcpu_set * const set)
+{
+    bool ret = false;
+
+    if (UTILDEBUG_VERIFY((str != NULL) && (set != NULL)))
+    {
+        set->count = 0;
+
+        if (utilstring_compare(str, "none", 0, true))
+        {
+            set->policy = UTILCPU_POLICY_NONE;
+            ret = true;
+        }
+        else if (utilstring_compare(str, "cpu", 0, true))
+        {
+            set->policy = UTILCPU_POLICY_CPU;
+            ret = true;
+        }
+        else if (utilstring_compare(str, "core", 0, true))
+        {
+            set->policy = UTILCPU_POLICY_CORE;
+            ret = true;
+        }
+        else if (utilcpu_parselist(str, set->cpus, UTILCPU_SETMAX, &set->count))
+        {
+            set->policy = UTILCPU_POLICY_LIST;
+            ret = true;
+        }
+        else
+        {
+            set->policy = UTILCPU_POLICY_NONE;
+            set->count  = 0;
+        }
+    }
+
+    return ret;
+}
+
+#if defined(__linux__)
+/**
+ * @brief Get the SMT siblings of a CPU (including the CPU itself).
+ *
+ * @param[in]     cpu      A CPU number.
+ * @param[in,out] siblings A pointer to a CPU set of siblings.
+ *
+ * @return True if the siblings of a CPU were found.
+ */
+static bool utilcpu_getsiblings(const uint16_t cpu, cpu_set_t * const siblings)
+{
+    bool ret = false;
+    char buf[256], path[128];
+    uint16_t cpus[UTILCPU_SETMAX], count = 0, i;
+    FILE *file = NULL;
+
+    CPU_ZERO(siblings);
+    CPU_SET(cpu, siblings);
+
+    utilstring_concat(path,
+                      sizeof(path),
+                      "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list",
+                      cpu);
+
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        // Do nothing (assume that the CPU has no siblings).
+    }
+    else
+    {
+        if ((fgets(buf, sizeof(buf), file) != NULL) &&
+            (utilcpu_parselist(buf, cpus, UTILCPU_SETMAX, &count)))
+        {
+            for (i = 0; i < count; i++)
+            {
+                CPU_SET(cpus[i], siblings);
+            }
+
+            ret = true;
+        }
+
+        fclose(file);
+    }
+
+    return ret;
+}
+#endif
+
+bool utilcpu_getset(struct utilcpu_set * const set)
+{
+    bool ret = false;
+#if defined(__linux__)
+    cpu_set_t allowed, siblings, taken;
+    uint16_t count = 0, cpu, i;
+#endif
+
+    if (!UTILDEBUG_VERIFY(set != NULL))
+    {
+        // Do nothing.
+    }
+    else if (set->policy == UTILCPU_POLICY_NONE)
+    {
+        set->count = 0;
+        ret = true;
+    }
+#if defined(__linux__)
+    else if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: failed to get CPU affinity (%d)\n",
+                      __FUNCTION__,
+                      errno);
+    }
+    else
+    {
+        CPU_ZERO(&taken);
+
+        if (set->policy == UTILCPU_POLICY_LIST)
+        {
+            // Keep the listed CPUs that the process is allowed to run on.
+            for (i = 0; i < set->count; i++)
+            {
+                if (CPU_ISSET(set->cpus[i], &allowed))
+                {
+                    set->cpus[count++] = set->cpus[i];
+                }
+                else
+                {
+                    logger_printf(LOGGER_LEVEL_WARN,
+                                  "%s: CPU %u is not available\n",
+                                  __FUNCTION__,
+                                  set->cpus[i]);
+                }
+            }
+        }
+        else
+        {
+            for (cpu = 0; (cpu < CPU_SETSIZE) && (count < UTILCPU_SETMAX); cpu++)
+            {
+                if (!CPU_ISSET(cpu, &allowed) || CPU_ISSET(cpu, &taken))
+                {
+                    // Do nothing.
+                }
+                else
+                {
+                    set->cpus[count++] = cpu;
+
+                    // Skip the SMT siblings of the CPU (same physical core).
+                    if ((set->policy == UTILCPU_POLICY_CORE) &&
+                        (utilcpu_getsiblings(cpu, &siblings)))
+                    {
+                        CPU_OR(&taken, &taken, &siblings);
+                    }
+                }
+            }
+        }
+
+        set->count = count;
+        ret = (count > 0);
+    }
+#else
+    else
+    {
+        logger_printf(LOGGER_LEVEL_WARN,
+                      "%s: CPU affinity is not supported\n",
+                      __FUNCTION__);
+        set->policy = UTILCPU_POLICY_NONE;
+        set->count  = 0;
+        ret = true;
+    }
+#endif
+
+    return ret;
+}
+
+int32_t utilcpu_getnode(const uint16_t cpu)
+{
+    int32_t ret = -1;
+#if defined(__linux__)
+    char path[64];
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+
+    utilstring_concat(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+
+    if ((dir = opendir(path)) != NULL)
+    {
+        // The CPU directory links to its node (e.g., "node0").
+        while ((ret < 0) && ((entry = readdir(dir)) != NULL))
+        {
+            if ((strncmp(entry->d_name, "node", 4) == 0) &&
+                (entry->d_name[4] >= '0') &&
+                (entry->d_name[4] <= '9'))
+            {
+                ret = (int32_t)strtol(entry->d_name + 4, NULL, 10);
+            }
+        }
+
+        closedir(dir);
+    }
+#else
+    (void)cpu;
+#endif
+
+    return ret;
+}
@@ -9,6 +9,7 @@
 
 #include "logger.h"
 #include "util_inet.h"
+#include "util_string.h"
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -202,3 +203,308 @@ uint16_t *utilinet_getportfromstorage(const struct sockaddr_storage * const addr
 
     return ret;
 }
+
+/**
+ * @brief Parse a port or a range of ports (e.g., "5001" or "5001-5004").
+ *
+ * @param[in]     str     A pointer to a port string.
+ * @param[in,out] range   A pointer to an IP address range.
+ *
+ * @return True if a port or a range of ports was parsed.
+ */
+static bool utilinet_parseports(const char * const str,
+                                struct utilinet_range * const range)
+{
+    bool ret = false;
+    char *end = NULL;
+    unsigned long first, last;
+
+    first = strtoul(str, &end, 10);
+    last  = first;
+
+    if ((end == str) || (first == 0) || (first > UINT16_MAX))
+    {
+        // Do nothing.
+    }
+    else if (*end == '-')
+    {
+        last = strtoul(end + 1, &end, 10);
+        ret  = ((*end == '\0') && (last >= first) && (last <= UINT16_MAX));
+    }
+    else
+    {
+        ret = (*end == '\0');
+    }
+
+    if (ret)
+    {
+        range->portmin = (uint16_t)first;
+        range->portmax = (uint16_t)last;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Parse an IP address or a CIDR block (e.g., "10.0.0.0/24").
+ *
+ * @param[in,out] str   A pointer to an IP address string (modified).
+ * @param[in,out] range A pointer to an IP address range.
+ *
+ * @return True if an IP address or a CIDR block was parsed.
+ */
+static bool utilinet_parseblock(char * const str,
+                                struct utilinet_range * const range)
+{
+    bool ret = false;
+    char *end = NULL, *pos = strchr(str, '/');
+    unsigned long prefix = 0, bits;
+    uint32_t i, ipv4, mask;
+    uint8_t *ipv6;
+
+    if (pos != NULL)
+    {
+        *pos++ = '\0';
+        prefix = strtoul(pos, &end, 10);
+    }
+
+    memset(&range->addr, 0, sizeof(range->addr));
+    range->count = 1;
+
+    if (inet_pton(AF_INET,
+                  str,
+                  &((struct sockaddr_in *)&range->addr)->sin_addr) == 1)
+    {
+        range->addr.ss_family = AF_INET;
+        bits = 32;
+    }
+    else if (inet_pton(AF_INET6,
+                       str,
+                       &((struct sockaddr_in6 *)&range->addr)->sin6_addr) == 1)
+    {
+        range->addr.ss_family = AF_INET6;
+        bits = 128;
+    }
+    else
+    {
+        bits = 0;
+    }
+
+    if (bits == 0)
+    {
+        // Do nothing.
+    }
+    else if (pos == NULL)
+    {
+        ret = true;
+    }
+    else if ((end == pos) ||
+             (*end != '\0') ||
+             (prefix > bits) ||
+             ((1ULL << (bits - prefix)) > UTILINET_RANGEMAX))
+    {
+        // Do nothing.
+    }
+    else if (range->addr.ss_family == AF_INET)
+    {
+        mask = (prefix == 0 ? 0 : 0xFFFFFFFFU << (bits - prefix));
+        ipv4 = ntohl(((struct sockaddr_in *)&range->addr)->sin_addr.s_addr) & mask;
+        range->count = (uint32_t)(1ULL << (bits - prefix));
+
+        // The network and broadcast addresses of a block are not hosts.
+        if (range->count > 2)
+        {
+            ipv4++;
+            range->count -= 2;
+        }
+
+        ((struct sockaddr_in *)&range->addr)->sin_addr.s_addr = htonl(ipv4);
+        ret = true;
+    }
+    else
+    {
+        ipv6 = ((struct sockaddr_in6 *)&range->addr)->sin6_addr.s6_addr;
+        range->count = (uint32_t)(1ULL << (bits - prefix));
+
+        // Clear the host bits of the block, which are in the last bytes.
+        for (i = 15, bits -= prefix; bits > 0; i--)
+        {
+            ipv6[i] &= (uint8_t)(0xFF << (bits > 8 ? 8 : bits));
+            bits -= (bits > 8 ? 8 : bits);
+        }
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool utilinet_parseset(const char * const str, struct utilinet_set * const set)
+{
+    bool ret = false;
+    char entry[INET6_ADDRSTRLEN + 16], *host, *ports, *pos;
+    const char *next = str;
+    size_t len;
+    struct utilinet_range *range;
+
+    if ((str == NULL) || (set == NULL))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: parameter validation failed\n",
+                      __FUNCTION__);
+    }
+    else if (utilstring_compare(str, "none", 0, true))
+    {
+        set->count = 0;
+        set->size  = 0;
+        ret = true;
+    }
+    else
+    {
+        set->count = 0;
+        set->size  = 0;
+        ret = (*next != '\0');
+
+        while ((ret) && (*next != '\0'))
+        {
+            len   = strcspn(next, ",");
+            range = &set->ranges[set->count];
+            host  = entry;
+            ports = NULL;
+            pos   = NULL;
+            ret   = ((len > 0) &&
+                     (len < sizeof(entry)) &&
+                     (set->count < UTILINET_SETMAX));
+
+            if (ret)
+            {
+                memcpy(entry, next, len);
+                entry[len] = '\0';
+                next += len;
+                next += (*next == ',' ? 1 : 0);
+                ret = ((next[-1] != ',') || (*next != '\0'));
+            }
+
+            // An IPv6 address is enclosed in brackets if it has ports.
+            if (!ret)
+            {
+                // Do nothing.
+            }
+            else if (entry[0] == '[')
+            {
+                host++;
+
+                if ((pos = strchr(host, ']')) == NULL)
+                {
+                    ret = false;
+                }
+                else
+                {
+                    *pos++ = '\0';
+                    ports = (*pos == ':' ? pos + 1 : NULL);
+                    ret = ((*pos == ':') || (*pos == '\0'));
+                }
+            }
+            else if (((pos = strchr(host, ':')) != NULL) &&
+                     (strchr(pos + 1, ':') == NULL))
+            {
+                *pos  = '\0';
+                ports = pos + 1;
+            }
+
+            if (ret)
+            {
+                range->portmin = 0;
+                range->portmax = 0;
+                ret = ((utilinet_parseblock(host, range)) &&
+                       ((ports == NULL) || (utilinet_parseports(ports, range))));
+            }
+
+            if (ret)
+            {
+                set->size += (uint64_t)range->count *
+                             (uint64_t)(range->portmax - range->portmin + 1);
+                set->count++;
+            }
+        }
+
+        if (!ret)
+        {
+            set->count = 0;
+            set->size  = 0;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @see See header file for interface comments.
+ */
+bool utilinet_getsetaddr(const struct utilinet_set * const set,
+                         const uint64_t index,
+                         const uint16_t defport,
+                         struct sockaddr_storage * const addr)
+{
+    bool ret = false;
+    const struct utilinet_range *range;
+    uint64_t pos, size;
+    uint32_t i, offset, ports;
+    uint8_t *ipv6;
+
+    if ((set == NULL) || (addr == NULL))
+    {
+        logger_printf(LOGGER_LEVEL_ERROR,
+                      "%s: parameter validation failed\n",
+                      __FUNCTION__);
+    }
+    else if (set->size > 0)
+    {
+        pos = index % set->size;
+
+        for (i = 0; (i < set->count) && (!ret); i++)
+        {
+            range = &set->ranges[i];
+            ports = (uint32_t)(range->portmax - range->portmin + 1);
+            size  = (uint64_t)range->count * ports;
+
+            if (pos >= size)
+            {
+                pos -= size;
+            }
+            else
+            {
+                memcpy(addr, &range->addr, sizeof(*addr));
+                offset = (uint32_t)(pos % range->count);
+
+                if (addr->ss_family == AF_INET)
+                {
+                    ((struct sockaddr_in *)addr)->sin_addr.s_addr =
+                        htonl(ntohl(((struct sockaddr_in *)addr)->sin_addr.s_addr) + offset);
+                }
+                else
+                {
+                    // A range spans at most the last three bytes.
+                    ipv6 = ((struct sockaddr_in6 *)addr)->sin6_addr.s6_addr;
+                    offset += ((uint32_t)ipv6[13] << 16) |
+                              ((uint32_t)ipv6[14] << 8) |
+                              (uint32_t)ipv6[15];
+                    ipv6[13] = (uint8_t)(offset >> 16);
+                    ipv6[14] = (uint8_t)(offset >> 8);
+                    ipv6[15] = (uint8_t)offset;
+                }
+
+                *utilinet_getportfromstorage(addr) =
+                    htons(range->portmin == 0 ?
+                          defport :
+                          (uint16_t)(range->portmin + pos / range->count));
+                ret = true;
+            }
+        }
+    }
+
+    return ret;
+}
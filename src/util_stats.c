@@ -7,45 +7,237 @@
  *            This project is released under the MIT license.
  */
 
-#include "util_date.h"
 #include "util_debug.h"
 #include "util_stats.h"
 
+#include <string.h>
+
 bool utilstats_add(struct utilstats_qty * const stats, const int64_t val)
 {
     bool ret = false;
-    uint64_t tvus = 0;
 
     if (UTILDEBUG_VERIFY(stats != NULL))
     {
-        tvus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+        if ((stats->cnt == 0) || (val > stats->max))
+        {
+            stats->max = val;
+        }
+
+        if ((stats->cnt == 0) || (val < stats->min))
+        {
+            stats->min = val;
+        }
+
         stats->cnt++;
         stats->sum += val;
 
-        if (stats->cnt != 0)
+        ret = true;
+    }
+
+    return ret;
+}
+
+int64_t utilstats_getavg(const struct utilstats_qty * const stats)
+{
+    int64_t ret = 0;
+
+    if (UTILDEBUG_VERIFY(stats != NULL) && (stats->cnt > 0))
+    {
+        ret = stats->sum / (int64_t)stats->cnt;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the bucket of a histogram that holds a value.
+ *
+ * @param[in] val A data sample value.
+ *
+ * @return The bucket index.
+ */
+static uint32_t utilstats_histindex(uint64_t val)
+{
+    uint32_t ret = 0, exp = 0;
+
+    if (val >= (2ULL << UTILSTATS_HISTEXP))
+    {
+        val = (2ULL << UTILSTATS_HISTEXP) - 1;
+    }
+
+    if (val < (2ULL << UTILSTATS_HISTSUB))
+    {
+        ret = (uint32_t)val;
+    }
+    else
+    {
+        exp = 63 - (uint32_t)__builtin_clzll(val);
+        ret = ((exp - UTILSTATS_HISTSUB + 1) << UTILSTATS_HISTSUB) +
+              (uint32_t)(val >> (exp - UTILSTATS_HISTSUB)) -
+              (1U << UTILSTATS_HISTSUB);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the largest value held by a histogram bucket.
+ *
+ * @param[in] index A bucket index.
+ *
+ * @return The largest data sample value held by the bucket.
+ */
+static uint64_t utilstats_histvalue(const uint32_t index)
+{
+    uint64_t ret = index;
+    uint32_t shift;
+
+    if (index >= (2U << UTILSTATS_HISTSUB))
+    {
+        shift = (index >> UTILSTATS_HISTSUB) - 1;
+        ret   = ((uint64_t)((index & ((1U << UTILSTATS_HISTSUB) - 1)) +
+                            (1U << UTILSTATS_HISTSUB)) << shift) +
+                (1ULL << shift) - 1;
+    }
+
+    return ret;
+}
+
+bool utilstats_histrecord(struct utilstats_hist * const hist,
+                          const uint64_t val)
+{
+    bool ret = false;
+    uint64_t *count = NULL;
+
+    if (UTILDEBUG_VERIFY(hist != NULL))
+    {
+        // A histogram has a single writer, so a relaxed load and store is
+        // enough (no locked read-modify-write) and readers never see a torn
+        // count.
+        count = &hist->counts[utilstats_histindex(val)];
+        __atomic_store_n(count,
+                         __atomic_load_n(count, __ATOMIC_RELAXED) + 1,
+                         __ATOMIC_RELAXED);
+
+        if (val > __atomic_load_n(&hist->max, __ATOMIC_RELAXED))
         {
-            stats->avg = stats->sum / stats->cnt;
+            __atomic_store_n(&hist->max, val, __ATOMIC_RELAXED);
         }
 
-        if (val > stats->max)
+        if (~val > __atomic_load_n(&hist->minnot, __ATOMIC_RELAXED))
         {
-            stats->max = val;
+            __atomic_store_n(&hist->minnot, ~val, __ATOMIC_RELAXED);
         }
 
-        if (val < stats->min)
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool utilstats_histcopy(struct utilstats_hist * const dst,
+                        const struct utilstats_hist * const src)
+{
+    bool ret = false;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((dst != NULL) && (src != NULL)))
+    {
+        for (i = 0; i < UTILSTATS_HISTLEN; i++)
         {
-            stats->min = val;
+            dst->counts[i] = __atomic_load_n(&src->counts[i], __ATOMIC_RELAXED);
         }
 
-        if (stats->tv0 == 0)
+        dst->max    = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+        dst->minnot = __atomic_load_n(&src->minnot, __ATOMIC_RELAXED);
+        ret = true;
+    }
+
+    return ret;
+}
+
+bool utilstats_histmerge(struct utilstats_hist * const dst,
+                         const struct utilstats_hist * const cur,
+                         const struct utilstats_hist * const prev)
+{
+    bool ret = false;
+    uint64_t count, added = 0;
+    uint32_t i;
+
+    if (UTILDEBUG_VERIFY((dst != NULL) && (cur != NULL)))
+    {
+        for (i = 0; i < UTILSTATS_HISTLEN; i++)
         {
-            stats->tv0 = tvus;
+            count = cur->counts[i] - (prev == NULL ? 0 : prev->counts[i]);
+            dst->counts[i] += count;
+            added += count;
         }
 
-        stats->tvn = tvus;
+        // The samples of the difference are no smaller or larger than the
+        // smallest and largest samples of the current snapshot.
+        if (added > 0)
+        {
+            dst->max    = (cur->max > dst->max ? cur->max : dst->max);
+            dst->minnot = (cur->minnot > dst->minnot ? cur->minnot : dst->minnot);
+        }
 
         ret = true;
     }
 
     return ret;
 }
+
+uint64_t utilstats_histget(const struct utilstats_hist * const hist,
+                           const uint32_t * const permille,
+                           uint64_t * const vals,
+                           const uint32_t count)
+{
+    uint64_t ret = 0, sum = 0, min;
+    uint32_t i, j = 0;
+
+    if (UTILDEBUG_VERIFY((hist != NULL) &&
+                         ((count == 0) || ((permille != NULL) && (vals != NULL)))))
+    {
+        if (count > 0)
+        {
+            memset(vals, 0, sizeof(*vals) * count);
+        }
+
+        min = ~hist->minnot;
+
+        for (i = 0; i < UTILSTATS_HISTLEN; i++)
+        {
+            ret += hist->counts[i];
+        }
+
+        for (i = 0; (i < UTILSTATS_HISTLEN) && (j < count) && (ret > 0); i++)
+        {
+            if (hist->counts[i] > 0)
+            {
+                sum += hist->counts[i];
+
+                // A quantile is the first bucket that holds the rank of the
+                // quantile (rounded up), the maximum is the last bucket that
+                // holds a sample, and the minimum is the first. A bucket value
+                // is bounded by the smallest and largest samples.
+                while ((j < count) && (sum * 1000 >= ret * permille[j]))
+                {
+                    if (permille[j] == 0)
+                    {
+                        vals[j] = (i == 0 ? 0 : utilstats_histvalue(i - 1) + 1);
+                        vals[j] = (vals[j] < min ? min : vals[j]);
+                    }
+                    else
+                    {
+                        vals[j] = utilstats_histvalue(i);
+                        vals[j] = (vals[j] > hist->max ? hist->max : vals[j]);
+                    }
+
+                    j++;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
@@ -33,7 +33,7 @@ bool vector_create(struct vector * const vector,
                          (size > 0) &&
                          (vector->priv == NULL)))
     {
-        vector->priv = UTILMEM_CALLOC(struct privs,
+        vector->priv = UTILMEM_CALLOC(struct vector_priv,
                                       sizeof(struct vector_priv),
                                       1);
 
@@ -0,0 +1,411 @@
+/**
+ * @file      brbench.cpp
+ * @brief     Bottlerocket socket handoff microbenchmark. Loopback connections
+ *            are accepted by an acceptor thread and handed off to a worker
+ *            thread through a lock-free queue and a doorbell, the same way
+ *            that modeperf_putsock() and modeperf_getsock() hand off sockets.
+ *            The benchmark reports the latency from accept to the first byte
+ *            read by the worker and the rate of sockets handed off.
+ * @author    Shane Barnes
+ * @date      16 Oct 2026
+ * @copyright Copyright 2016 Shane Barnes. All rights reserved.
+ *            This project is released under the MIT license.
+ */
+
+#include "doorbell_obj.c"
+#include "lfqueue.c"
+#include "logger.c"
+#include "mutex_obj.c"
+#include "output_if_std.c"
+#include "util_date.c"
+#include "util_debug.c"
+#include "util_stats.c"
+#include "util_string.c"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define BENCH_COUNT     20000 // Connections per pass
+#define BENCH_WINDOWMAX   128 // Largest number of connections in flight
+#define BENCH_QUEUE       256 // Handoff queue capacity
+#define BENCH_TIMEOUTMS  1000 // Connect, accept and read timeout
+
+// A socket accepted by the acceptor and handed off to the worker.
+struct bench_sock
+{
+    int32_t  fd;       // Accepted socket
+    uint64_t acceptus; // Time that the socket was accepted
+};
+
+struct bench
+{
+    struct lfqueue         queue;
+    struct doorbellobj     bell;
+    struct utilstats_hist  latency;           // Accept to first byte (usec)
+    struct bench_sock      socks[BENCH_COUNT];
+    int32_t                listenfd;
+    uint16_t               port;
+    uint32_t               window;            // Connections in flight
+    uint32_t               accepted;          // Sockets handed off
+    uint32_t               read;              // First bytes read by the worker
+    uint32_t               failed;            // Connections that timed out
+    uint64_t               firstus;           // Time of the first accept
+    uint64_t               lastus;            // Time of the last first byte
+    bool                   stop;              // A thread gave up
+};
+
+/**
+ * @brief Connect the client sockets of a window, send one byte on each, and
+ *        wait for the worker to close them.
+ *
+ * @param[in,out] b     A pointer to a benchmark.
+ * @param[in]     count The number of connections in the window.
+ *
+ * @return True if all of the connections of the window completed in time.
+ */
+static bool bench_window(struct bench * const b, const uint32_t count)
+{
+    struct pollfd pfds[BENCH_WINDOWMAX];
+    struct sockaddr_in addr;
+    struct linger linger;
+    socklen_t len = sizeof(int32_t);
+    int32_t err = 0;
+    uint32_t i, done = 0;
+    char byte = 0;
+    bool ret = true;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(b->port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    // Reset the client sockets so that the passes do not exhaust the
+    // ephemeral ports with sockets in the TIME_WAIT state.
+    linger.l_onoff  = 1;
+    linger.l_linger = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        pfds[i].fd     = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        pfds[i].events = POLLOUT;
+
+        if ((pfds[i].fd < 0) ||
+            ((connect(pfds[i].fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) &&
+             (errno != EINPROGRESS)))
+        {
+            ret = false;
+        }
+        else
+        {
+            setsockopt(pfds[i].fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+        }
+    }
+
+    // Send the first byte on each socket as soon as it connects.
+    while ((ret) && (done < count))
+    {
+        if (poll(pfds, count, BENCH_TIMEOUTMS) <= 0)
+        {
+            ret = false;
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                if ((pfds[i].events == POLLOUT) && (pfds[i].revents != 0))
+                {
+                    if ((getsockopt(pfds[i].fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) ||
+                        (err != 0) ||
+                        (send(pfds[i].fd, &byte, sizeof(byte), 0) != sizeof(byte)))
+                    {
+                        ret = false;
+                    }
+
+                    pfds[i].events = POLLIN;
+                    done++;
+                }
+            }
+        }
+    }
+
+    // Wait for the worker to close each socket after it read the first byte.
+    for (done = 0; (ret) && (done < count);)
+    {
+        if (poll(pfds, count, BENCH_TIMEOUTMS) <= 0)
+        {
+            ret = false;
+        }
+        else
+        {
+            for (i = 0; i < count; i++)
+            {
+                if ((pfds[i].events == POLLIN) && (pfds[i].revents != 0))
+                {
+                    pfds[i].events = 0;
+                    done++;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (pfds[i].fd >= 0)
+        {
+            close(pfds[i].fd);
+        }
+    }
+
+    return ret;
+}
+
+static void *bench_client(void *arg)
+{
+    struct bench *b = (struct bench*)arg;
+    uint32_t i, count;
+
+    for (i = 0; (i < BENCH_COUNT) && (!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)); i += count)
+    {
+        count = (BENCH_COUNT - i < b->window ? BENCH_COUNT - i : b->window);
+
+        if (!bench_window(b, count))
+        {
+            b->failed += count;
+            __atomic_store_n(&b->stop, true, __ATOMIC_RELEASE);
+        }
+    }
+
+    return NULL;
+}
+
+static void *bench_acceptor(void *arg)
+{
+    struct bench *b = (struct bench*)arg;
+    struct bench_sock *sock;
+    struct pollfd pfd;
+
+    pfd.fd     = b->listenfd;
+    pfd.events = POLLIN;
+
+    while ((b->accepted < BENCH_COUNT) && (!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)))
+    {
+        if (poll(&pfd, 1, BENCH_TIMEOUTMS) <= 0)
+        {
+            __atomic_store_n(&b->stop, true, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            sock = &b->socks[b->accepted];
+
+            if ((sock->fd = accept4(b->listenfd, NULL, NULL, SOCK_NONBLOCK)) >= 0)
+            {
+                sock->acceptus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+
+                if (b->accepted == 0)
+                {
+                    b->firstus = sock->acceptus;
+                }
+
+                b->accepted++;
+
+                // A full queue means the worker is behind, so wake it and
+                // back off until it catches up.
+                while ((!lfqueue_push(&b->queue, sock)) &&
+                       (!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)))
+                {
+                    doorbellobj_ring(&b->bell);
+                    sched_yield();
+                }
+
+                doorbellobj_ring(&b->bell);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Take the sockets handed off to the worker, read the first byte of
+ *        each, and close it.
+ *
+ * @param[in,out] b A pointer to a benchmark.
+ *
+ * @return Void.
+ */
+static void bench_worker(struct bench * const b)
+{
+    // The doorbell is watched next to the sockets in the event loop.
+    struct pollfd pfds[BENCH_QUEUE + BENCH_WINDOWMAX + 1];
+    struct bench_sock *socks[BENCH_QUEUE + BENCH_WINDOWMAX + 1];
+    struct bench_sock *sock;
+    uint32_t i, count = 1;
+    uint64_t tsus;
+    char byte;
+
+    pfds[0].fd     = doorbellobj_getfd(&b->bell);
+    pfds[0].events = POLLIN;
+
+    while ((b->read < BENCH_COUNT) && (!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)))
+    {
+        while ((count < BENCH_QUEUE + BENCH_WINDOWMAX + 1) &&
+               ((sock = (struct bench_sock*)lfqueue_pop(&b->queue)) != NULL))
+        {
+            pfds[count].fd     = sock->fd;
+            pfds[count].events = POLLIN;
+            socks[count]       = sock;
+            count++;
+        }
+
+        // Arm the doorbell, check the queue again, and only then block.
+        doorbellobj_arm(&b->bell);
+
+        if ((lfqueue_getsize(&b->queue) == 0) &&
+            (poll(pfds, count, BENCH_TIMEOUTMS) == 0))
+        {
+            __atomic_store_n(&b->stop, true, __ATOMIC_RELEASE);
+        }
+
+        doorbellobj_clear(&b->bell);
+
+        for (i = 1; i < count;)
+        {
+            if ((pfds[i].revents != 0) && (recv(pfds[i].fd, &byte, sizeof(byte), 0) == sizeof(byte)))
+            {
+                tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+                utilstats_histrecord(&b->latency, tsus - socks[i]->acceptus);
+                b->lastus = tsus;
+                b->read++;
+                close(pfds[i].fd);
+
+                // Keep the sockets that are waiting for data packed.
+                count--;
+                pfds[i]  = pfds[count];
+                socks[i] = socks[count];
+            }
+            else
+            {
+                pfds[i].revents = 0;
+                i++;
+            }
+        }
+    }
+
+    for (i = 1; i < count; i++)
+    {
+        close(pfds[i].fd);
+    }
+}
+
+/**
+ * @brief Run a pass of the benchmark and print its results.
+ *
+ * @param[in] window The number of connections in flight.
+ *
+ * @return True if every connection of the pass was handed off in time.
+ */
+static bool bench_run(const uint32_t window)
+{
+    const uint32_t permille[] = {0, 500, 900, 990, 999, 1000};
+    uint64_t vals[sizeof(permille) / sizeof(permille[0])];
+    struct bench *b = (struct bench*)calloc(1, sizeof(struct bench));
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    pthread_t client, acceptor;
+    bool ret = false;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (b != NULL)
+    {
+        b->listenfd = -1;
+    }
+
+    if (b == NULL)
+    {
+        fprintf(stderr, "%s: failed to allocate benchmark\n", __FUNCTION__);
+    }
+    else if ((!lfqueue_create(&b->queue, BENCH_QUEUE)) ||
+             (!doorbellobj_create(&b->bell)))
+    {
+        fprintf(stderr, "%s: failed to create handoff\n", __FUNCTION__);
+    }
+    else if (((b->listenfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) ||
+             (bind(b->listenfd, (struct sockaddr*)&addr, sizeof(addr)) != 0) ||
+             (listen(b->listenfd, SOMAXCONN) != 0) ||
+             (getsockname(b->listenfd, (struct sockaddr*)&addr, &len) != 0))
+    {
+        fprintf(stderr, "%s: failed to listen (%d)\n", __FUNCTION__, errno);
+    }
+    else
+    {
+        b->port   = ntohs(addr.sin_port);
+        b->window = window;
+
+        pthread_create(&acceptor, NULL, bench_acceptor, b);
+        pthread_create(&client, NULL, bench_client, b);
+        bench_worker(b);
+        __atomic_store_n(&b->stop, true, __ATOMIC_RELEASE);
+        pthread_join(client, NULL);
+        pthread_join(acceptor, NULL);
+
+        utilstats_histget(&b->latency, permille, vals, sizeof(permille) / sizeof(permille[0]));
+
+        printf("window %3u: %u handed off, %u failed, %.0f handoffs/s, "
+               "accept to first byte usec min/p50/p90/p99/p99.9/max: "
+               "%lu / %lu / %lu / %lu / %lu / %lu, %lu doorbell writes\n",
+               window,
+               b->read,
+               b->failed + (BENCH_COUNT - b->read),
+               (b->lastus > b->firstus ?
+                (double)b->read * UNIT_TIME_USEC / (double)(b->lastus - b->firstus) : 0.0),
+               vals[0], vals[1], vals[2], vals[3], vals[4], vals[5],
+               b->bell.ringcnt);
+
+        ret = (b->read == BENCH_COUNT);
+    }
+
+    if (b != NULL)
+    {
+        if (b->listenfd >= 0)
+        {
+            close(b->listenfd);
+        }
+
+        doorbellobj_destroy(&b->bell);
+        lfqueue_destroy(&b->queue);
+        free(b);
+    }
+
+    return ret;
+}
+
+int main(void)
+{
+    struct output_if_ops output_if;
+    bool ret = true;
+
+    logger_create();
+    output_if.oio_send = output_if_std_send;
+    logger_set_output(&output_if);
+    logger_set_level(LOGGER_LEVEL_OFF);
+
+    // One connection in flight gives the unloaded accept to first byte
+    // latency, and a full window gives the maximum handoff rate.
+    ret = bench_run(1) && ret;
+    ret = bench_run(BENCH_WINDOWMAX) && ret;
+
+    logger_destroy();
+
+    return (ret ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -7,11 +7,25 @@
  *            This project is released under the MIT license.
  */
 
+#include "doorbell_obj.c"
+#include "fion_epoll.c"
+#include "fion_obj.c"
+#include "fion_poll.c"
+#include "flow_index.c"
+#include "flow_rank.c"
+#include "lfqueue.c"
 #include "logger.c"
+#include "mem_pool.c"
 #include "mutex_obj.c"
 #include "output_if_std.c"
+#include "pace_timer.c"
+#include "timer_wheel.c"
+#include "token_bucket.c"
+#include "util_cpu.c"
 #include "util_date.c"
 #include "util_debug.c"
+#include "util_inet.c"
+#include "util_stats.c"
 #include "util_string.c"
 #include "vector.c"
 
@@ -7,14 +7,28 @@
  *            This project is released under the MIT license.
  */
 
+#include "doorbell_obj.h"
+#include "fion_obj.h"
+#include "flow_index.h"
+#include "flow_rank.h"
+#include "lfqueue.h"
 #include "logger.h"
+#include "mem_pool.h"
 #include "mutex_obj.h"
+#include "pace_timer.h"
+#include "timer_wheel.h"
+#include "token_bucket.h"
 #include "util_date.h"
 #include "util_debug.h"
+#include "util_mem.h"
 #include "util_string.h"
 #include "vector.h"
 
 #include <gtest/gtest.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 TEST (VectorTest, Vector)
 {
@@ -90,3 +104,744 @@ TEST (VectorTest, Vector)
     ASSERT_TRUE(vector_destroy(&vec));
     ASSERT_FALSE(vector_destroy(&vec));
 }
+
+TEST (LfqueueTest, Lfqueue)
+{
+    struct lfqueue queue = {0};
+    uintptr_t i, size = 100;
+
+    ASSERT_FALSE(lfqueue_create(NULL, size));
+    ASSERT_FALSE(lfqueue_create(&queue, 0));
+    ASSERT_TRUE(lfqueue_create(&queue, size));
+    ASSERT_FALSE(lfqueue_create(&queue, size));
+
+    // The capacity is rounded up to a power of two.
+    ASSERT_EQ(128u, lfqueue_getcapacity(&queue));
+    ASSERT_EQ(0u, lfqueue_getsize(&queue));
+    ASSERT_EQ(NULL, lfqueue_pop(&queue));
+    ASSERT_FALSE(lfqueue_push(&queue, NULL));
+
+    // Fill and drain the queue twice so that every slot is reused.
+    for (size = 0; size < 2; size++)
+    {
+        for (i = 1; i <= lfqueue_getcapacity(&queue); i++)
+        {
+            ASSERT_TRUE(lfqueue_push(&queue, (void*)i));
+            ASSERT_EQ(i, lfqueue_getsize(&queue));
+        }
+
+        ASSERT_FALSE(lfqueue_push(&queue, (void*)i));
+
+        for (i = 1; i <= lfqueue_getcapacity(&queue); i++)
+        {
+            ASSERT_EQ((void*)i, lfqueue_pop(&queue));
+        }
+
+        ASSERT_EQ(NULL, lfqueue_pop(&queue));
+        ASSERT_EQ(0u, lfqueue_getsize(&queue));
+    }
+
+    ASSERT_FALSE(lfqueue_destroy(NULL));
+    ASSERT_TRUE(lfqueue_destroy(&queue));
+    ASSERT_FALSE(lfqueue_destroy(&queue));
+}
+
+TEST (FlowRankTest, TopN)
+{
+    struct flowrank rank, merged;
+    struct flowrank_entry entry;
+    uint32_t i;
+
+    memset(&rank, 0, sizeof(rank));
+    memset(&merged, 0, sizeof(merged));
+    memset(&entry, 0, sizeof(entry));
+
+    ASSERT_FALSE(flowrank_create(NULL, 4, false));
+    ASSERT_FALSE(flowrank_create(&rank, 0, false));
+    ASSERT_TRUE(flowrank_create(&rank, 4, false));
+    ASSERT_FALSE(flowrank_create(&rank, 4, false));
+    ASSERT_TRUE(flowrank_create(&merged, 4, true));
+
+    // Only the four highest of the values offered are kept.
+    for (i = 0; i < 100; i++)
+    {
+        entry.val = (i * 37) % 100;
+        entry.sid = i;
+        flowrank_offer(&rank, &entry);
+    }
+
+    ASSERT_FALSE(flowrank_isranked(&rank, 95));
+    ASSERT_TRUE(flowrank_isranked(&rank, 97));
+    ASSERT_EQ(4u, flowrank_sort(&rank));
+
+    for (i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(99u - i, rank.entries[i].val);
+        ASSERT_EQ((99u - i) * 73 % 100, rank.entries[i].sid);
+    }
+
+    // A ranking of the lowest values keeps the lowest of the entries merged.
+    for (i = 0; i < 4; i++)
+    {
+        entry.val = 98 + i;
+        ASSERT_TRUE(flowrank_offer(&merged, &entry));
+    }
+
+    ASSERT_FALSE(flowrank_offer(&merged, &entry));
+    ASSERT_EQ(4u, flowrank_merge(&merged, &rank));
+    ASSERT_EQ(4u, flowrank_sort(&merged));
+    ASSERT_EQ(96u, merged.entries[0].val);
+    ASSERT_EQ(97u, merged.entries[1].val);
+    ASSERT_EQ(98u, merged.entries[3].val);
+
+    flowrank_clear(&rank);
+    ASSERT_EQ(0u, flowrank_sort(&rank));
+
+    ASSERT_TRUE(flowrank_destroy(&rank));
+    ASSERT_TRUE(flowrank_destroy(&merged));
+}
+
+#define FLOWINDEX_COUNT 1000
+
+TEST (FlowIndexTest, Index)
+{
+    struct flowindex index;
+    struct flowindex_node *nodes = (struct flowindex_node*)calloc(FLOWINDEX_COUNT,
+                                                                  sizeof(struct flowindex_node));
+    struct flowindex_node *node;
+    struct flowindex_tuple tuple;
+    uint32_t i, id;
+
+    ASSERT_NE((struct flowindex_node*)NULL, nodes);
+    ASSERT_FALSE(flowindex_create(NULL));
+    ASSERT_TRUE(flowindex_create(&index));
+    ASSERT_EQ(NULL, flowindex_firstid(&index));
+    ASSERT_EQ(NULL, flowindex_getoldest(&index));
+
+    // Flows are added out of order, and their client ports run opposite to
+    // their flow ids.
+    for (i = 0; i < FLOWINDEX_COUNT; i++)
+    {
+        id = (i * 7919) % FLOWINDEX_COUNT;
+        nodes[id].id               = id;
+        nodes[id].ageus            = i;
+        nodes[id].tuple.proto      = IPPROTO_TCP;
+        nodes[id].tuple.family     = AF_INET;
+        nodes[id].tuple.clientport = (uint16_t)(FLOWINDEX_COUNT - id);
+        nodes[id].tuple.serverport = 5001;
+        ASSERT_TRUE(flowindex_insert(&index, &nodes[id]));
+    }
+
+    ASSERT_FALSE(flowindex_insert(&index, &nodes[0]));
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT, flowindex_getcount(&index));
+
+    // The trees stay balanced (an AVL tree of 1000 nodes is at most 14 high).
+    ASSERT_LE(index.idroot->height, 14);
+    ASSERT_LE(index.tupleroot->height, 14);
+
+    for (i = 0, node = flowindex_firstid(&index); node != NULL; i++, node = flowindex_nextid(node))
+    {
+        ASSERT_EQ(i, node->id);
+    }
+
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT, i);
+
+    for (i = 0, node = flowindex_firsttuple(&index); node != NULL; i++, node = flowindex_nexttuple(node))
+    {
+        ASSERT_EQ(FLOWINDEX_COUNT - 1 - i, node->id);
+    }
+
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT, i);
+
+    // Remove the flows with odd ids out of order.
+    for (i = 0; i < FLOWINDEX_COUNT; i++)
+    {
+        id = (i * 7919) % FLOWINDEX_COUNT;
+
+        if ((id & 1) != 0)
+        {
+            ASSERT_TRUE(flowindex_remove(&index, &nodes[id]));
+        }
+    }
+
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT / 2, flowindex_getcount(&index));
+    ASSERT_LE(index.idroot->height, 13);
+
+    for (i = 0; i < FLOWINDEX_COUNT; i++)
+    {
+        ASSERT_EQ((i & 1) != 0 ? NULL : &nodes[i], flowindex_getid(&index, i));
+    }
+
+    for (i = 0, node = flowindex_firstid(&index); node != NULL; i += 2, node = flowindex_nextid(node))
+    {
+        ASSERT_EQ(i, node->id);
+    }
+
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT, i);
+
+    // A flow that shares the five-tuple of another flow is found after it.
+    memcpy(&tuple, &nodes[10].tuple, sizeof(tuple));
+    ASSERT_TRUE(flowindex_settuple(&index, &nodes[20], &tuple));
+    ASSERT_EQ(&nodes[10], flowindex_gettuple(&index, &tuple));
+    ASSERT_EQ(&nodes[20], flowindex_nexttuple(&nodes[10]));
+    ASSERT_TRUE(flowindex_remove(&index, &nodes[10]));
+    ASSERT_EQ(&nodes[20], flowindex_gettuple(&index, &tuple));
+    tuple.clientport = 1;
+    ASSERT_EQ(NULL, flowindex_gettuple(&index, &tuple));
+
+    // The flows that were not touched since a time are the oldest flows, and
+    // a new flow is older than every flow that was touched.
+    for (node = flowindex_firstid(&index); node != NULL; node = flowindex_nextid(node))
+    {
+        flowindex_touch(&index, node, node->id);
+    }
+
+    ASSERT_EQ(&nodes[0], flowindex_getoldest(&index));
+    nodes[1].ageus = FLOWINDEX_COUNT;
+    ASSERT_TRUE(flowindex_insert(&index, &nodes[1]));
+    ASSERT_EQ(&nodes[1], flowindex_getoldest(&index));
+
+    for (i = 0;
+         ((node = flowindex_getoldest(&index)) != NULL) &&
+         ((node->ageus < FLOWINDEX_COUNT / 2) || (node == &nodes[1]));
+         i++)
+    {
+        flowindex_touch(&index, node, FLOWINDEX_COUNT);
+    }
+
+    ASSERT_EQ((uint32_t)FLOWINDEX_COUNT / 4, i);
+    ASSERT_EQ(&nodes[FLOWINDEX_COUNT / 2], flowindex_getoldest(&index));
+
+    while ((node = flowindex_firstid(&index)) != NULL)
+    {
+        ASSERT_TRUE(flowindex_remove(&index, node));
+    }
+
+    ASSERT_EQ(0u, flowindex_getcount(&index));
+    ASSERT_EQ(NULL, flowindex_getoldest(&index));
+    ASSERT_EQ(NULL, index.tupleroot);
+    ASSERT_TRUE(flowindex_destroy(&index));
+    free(nodes);
+}
+
+TEST (MemPoolTest, MemPool)
+{
+    struct mempool pool;
+    struct mempool_stats stats;
+    uint64_t *objs[5];
+    uint32_t i;
+
+    memset(&pool, 0, sizeof(pool));
+
+    ASSERT_FALSE(mempool_create(NULL, 8, 4));
+    ASSERT_FALSE(mempool_create(&pool, 0, 4));
+    ASSERT_FALSE(mempool_create(&pool, 8, 0));
+    ASSERT_TRUE(mempool_create(&pool, 8, 4));
+    ASSERT_FALSE(mempool_create(&pool, 8, 4));
+
+    // The fifth object does not fit in the slab and is taken from the heap.
+    for (i = 0; i < 5; i++)
+    {
+        objs[i] = (uint64_t *)mempool_get(&pool);
+        ASSERT_NE((void *)NULL, objs[i]);
+        ASSERT_EQ(0u, *objs[i]);
+        *objs[i] = i + 1;
+    }
+
+    ASSERT_TRUE(mempool_getstats(&pool, &stats));
+    ASSERT_EQ(4u, stats.count);
+    ASSERT_EQ(4u, stats.inuse);
+    ASSERT_EQ(4u, stats.peak);
+    ASSERT_EQ(4u, stats.gets);
+    ASSERT_EQ(1u, stats.misses);
+
+    ASSERT_FALSE(mempool_put(&pool, objs[4]));
+    mempool_free(&pool, objs[4]);
+
+    for (i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(mempool_put(&pool, objs[i]));
+    }
+
+    // Returned objects are reused zeroed.
+    objs[0] = (uint64_t *)mempool_get(&pool);
+    ASSERT_EQ(0u, *objs[0]);
+    mempool_free(&pool, objs[0]);
+
+    ASSERT_TRUE(mempool_getstats(&pool, &stats));
+    ASSERT_EQ(0u, stats.inuse);
+    ASSERT_EQ(4u, stats.peak);
+    ASSERT_EQ(5u, stats.gets);
+
+    ASSERT_TRUE(mempool_destroy(&pool));
+    ASSERT_FALSE(mempool_destroy(&pool));
+}
+
+TEST (TimerWheelTest, TimerWheel)
+{
+    struct timerwheel wheel;
+    struct timerwheel_timer timers[4];
+    uint64_t expiry[1000], nowus = 0, prevus = 0;
+    uint32_t handle, i, n, fired = 0;
+
+    memset(&wheel, 0, sizeof(wheel));
+
+    ASSERT_FALSE(timerwheel_create(NULL, 100, 0));
+    ASSERT_FALSE(timerwheel_create(&wheel, 0, 0));
+    ASSERT_TRUE(timerwheel_create(&wheel, 100, 0));
+    ASSERT_EQ(UINT64_MAX, timerwheel_getnext(&wheel));
+
+    // A cancelled timer never expires, and a handle is only cancelled once.
+    handle = timerwheel_schedule(&wheel, 7, 1000);
+    ASSERT_NE(0u, handle);
+    ASSERT_EQ(1000u, timerwheel_getnext(&wheel));
+    ASSERT_TRUE(timerwheel_cancel(&wheel, handle));
+    ASSERT_FALSE(timerwheel_cancel(&wheel, handle));
+    ASSERT_EQ(0u, timerwheel_getsize(&wheel));
+    ASSERT_EQ(0u, timerwheel_expire(&wheel, 2000, timers, 4));
+
+    // Timers in every level expire in order and never early.
+    srand(1);
+    nowus = 2000;
+
+    for (i = 0; i < 1000; i++)
+    {
+        expiry[i] = nowus + (uint64_t)rand() % 2000000000ULL;
+        ASSERT_NE(0u, timerwheel_schedule(&wheel, i, expiry[i]));
+    }
+
+    ASSERT_EQ(1000u, timerwheel_getsize(&wheel));
+
+    while (fired < 1000)
+    {
+        ASSERT_GE(timerwheel_getnext(&wheel), prevus);
+        prevus = nowus;
+        nowus += (uint64_t)rand() % 5000000ULL;
+
+        while ((n = timerwheel_expire(&wheel, nowus, timers, 4)) > 0)
+        {
+            for (i = 0; i < n; i++)
+            {
+                ASSERT_LT(timers[i].key, 1000u);
+                ASSERT_EQ(expiry[timers[i].key], timers[i].expiryus);
+                ASSERT_LE(timers[i].expiryus, nowus);
+                ASSERT_GT(timers[i].expiryus, prevus);
+                expiry[timers[i].key] = UINT64_MAX;
+                fired++;
+            }
+        }
+    }
+
+    ASSERT_EQ(0u, timerwheel_getsize(&wheel));
+    ASSERT_EQ(UINT64_MAX, timerwheel_getnext(&wheel));
+
+    ASSERT_TRUE(timerwheel_destroy(&wheel));
+    ASSERT_FALSE(timerwheel_destroy(&wheel));
+}
+
+/**
+ * @brief Poll a file I/O event notification object and get the events of a
+ *        file descriptor if it is ready.
+ *
+ * @param[in,out] fion A pointer to a file I/O event notification object.
+ * @param[in]     fd   A file descriptor.
+ *
+ * @return The events of the file descriptor (0 if it is not ready).
+ */
+static uint32_t fionobj_pollfd(struct fionobj * const fion, const int32_t fd)
+{
+    uint32_t ret = 0, events, i;
+    int32_t readyfd = -1;
+
+    EXPECT_TRUE(fion->ops.fion_poll(fion));
+
+    for (i = 0; i < fion->readycount; i++)
+    {
+        events = fion->ops.fion_getready(fion, i, &readyfd);
+        EXPECT_NE(0u, events);
+
+        if (readyfd == fd)
+        {
+            ret = events;
+        }
+    }
+
+    EXPECT_EQ(0u, fion->ops.fion_getready(fion, fion->readycount, &readyfd));
+
+    return ret;
+}
+
+TEST (FionObjTest, Models)
+{
+    const enum fionobj_model models[] = { FIONOBJ_MODEL_POLL,
+                                          FIONOBJ_MODEL_EPOLL,
+                                          FIONOBJ_MODEL_EPOLLET };
+    struct fionobj fion;
+    int32_t a[2], b[2], fd = -1;
+    uint32_t i;
+    bool edge;
+
+    for (i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        edge = (models[i] == FIONOBJ_MODEL_EPOLLET);
+        memset(&fion, 0, sizeof(fion));
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, a));
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, b));
+        ASSERT_TRUE(fionobj_create(&fion, models[i]));
+        fion.timeoutms = 0;
+        fion.pevents   = FIONOBJ_PEVENT_IN;
+
+        ASSERT_TRUE(fion.ops.fion_insertfd(&fion, a[0]));
+        ASSERT_FALSE(fion.ops.fion_insertfd(&fion, a[0]));
+        ASSERT_TRUE(fion.ops.fion_insertfd(&fion, b[0]));
+
+        // Nothing is ready until data arrives.
+        ASSERT_TRUE(fion.ops.fion_poll(&fion));
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_TIMEOUT, fion.revents);
+        ASSERT_EQ(0u, fion.readycount);
+        ASSERT_EQ(0u, fion.ops.fion_getready(&fion, 0, &fd));
+
+        // Both file descriptors are visited in order when both are ready.
+        ASSERT_EQ(1, write(a[1], "a", 1));
+        ASSERT_EQ(1, write(b[1], "b", 1));
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_INREADY, fionobj_pollfd(&fion, a[0]));
+        ASSERT_EQ(2u, fion.readycount);
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_INREADY, fion.ops.fion_getready(&fion, 1, &fd));
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_INREADY, fion.ops.fion_getready(&fion, 0, &fd));
+
+        // Unread input is reported again unless it is edge-triggered.
+        ASSERT_EQ(edge ? 0u : (uint32_t)FIONOBJ_REVENT_INREADY,
+                  fionobj_pollfd(&fion, a[0]));
+
+        // A new interest mask is reported (and rearms an edge-triggered file
+        // descriptor).
+        ASSERT_TRUE(fion.ops.fion_setfdflags(&fion,
+                                             a[0],
+                                             FIONOBJ_PEVENT_IN | FIONOBJ_PEVENT_OUT));
+        ASSERT_FALSE(fion.ops.fion_setfdflags(&fion, a[1], FIONOBJ_PEVENT_IN));
+        ASSERT_EQ((uint32_t)(FIONOBJ_REVENT_INREADY | FIONOBJ_REVENT_OUTREADY),
+                  fionobj_pollfd(&fion, a[0]));
+        ASSERT_TRUE(fion.ops.fion_setfdflags(&fion, a[0], FIONOBJ_PEVENT_OUT));
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_OUTREADY, fionobj_pollfd(&fion, a[0]));
+
+        // Events are also found by position within the group.
+        ASSERT_EQ((uint32_t)FIONOBJ_REVENT_OUTREADY, fion.ops.fion_getevents(&fion, 0));
+        ASSERT_EQ(edge ? (uint32_t)FIONOBJ_REVENT_TIMEOUT : (uint32_t)FIONOBJ_REVENT_INREADY,
+                  fion.ops.fion_getevents(&fion, 1));
+        ASSERT_EQ(0u, fion.ops.fion_getevents(&fion, 2));
+
+        // A deleted file descriptor is no longer reported.
+        ASSERT_TRUE(fion.ops.fion_deletefd(&fion, a[0]));
+        ASSERT_FALSE(fion.ops.fion_deletefd(&fion, a[0]));
+        ASSERT_FALSE(fion.ops.fion_setfdflags(&fion, a[0], FIONOBJ_PEVENT_IN));
+        ASSERT_EQ(0u, fionobj_pollfd(&fion, a[0]));
+        ASSERT_EQ(edge ? 0u : 1u, fion.readycount);
+
+        // A peer that shuts down its side leaves its input readable.
+        ASSERT_EQ(0, shutdown(b[1], SHUT_WR));
+        ASSERT_EQ((uint32_t)(FIONOBJ_REVENT_INREADY | FIONOBJ_REVENT_HANGUP),
+                  fionobj_pollfd(&fion, b[0]));
+        ASSERT_EQ((uint32_t)(FIONOBJ_REVENT_INREADY | FIONOBJ_REVENT_HANGUP),
+                  fion.ops.fion_getevents(&fion, 0));
+        ASSERT_EQ(0u, fion.ops.fion_getevents(&fion, 1));
+
+        ASSERT_TRUE(fion.ops.fion_destroy(&fion));
+        close(a[0]);
+        close(a[1]);
+        close(b[0]);
+        close(b[1]);
+    }
+}
+
+TEST (DoorbellTest, Doorbell)
+{
+    struct doorbellobj bell = {0, 0};
+    struct pollfd pfd;
+
+    ASSERT_FALSE(doorbellobj_create(NULL));
+    ASSERT_TRUE(doorbellobj_create(&bell));
+    ASSERT_FALSE(doorbellobj_create(&bell));
+
+    pfd.fd     = doorbellobj_getfd(&bell);
+    pfd.events = POLLIN;
+    ASSERT_GE(pfd.fd, 0);
+
+    // An unarmed doorbell does not write its file descriptor.
+    ASSERT_FALSE(doorbellobj_ring(&bell));
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+
+    ASSERT_TRUE(doorbellobj_arm(&bell));
+    ASSERT_TRUE(doorbellobj_ring(&bell));
+    ASSERT_FALSE(doorbellobj_ring(&bell));
+    ASSERT_EQ(1, poll(&pfd, 1, 0));
+    ASSERT_EQ(1u, bell.ringcnt);
+
+    ASSERT_TRUE(doorbellobj_clear(&bell));
+    ASSERT_FALSE(doorbellobj_clear(&bell));
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+
+    ASSERT_FALSE(doorbellobj_destroy(NULL));
+    ASSERT_TRUE(doorbellobj_destroy(&bell));
+    ASSERT_FALSE(doorbellobj_destroy(&bell));
+}
+
+TEST (PaceTimerTest, PaceTimer)
+{
+    struct pacetimer timer;
+    struct pollfd pfd;
+    uint64_t dueus, tsus;
+
+    memset(&timer, 0, sizeof(timer));
+
+    ASSERT_FALSE(pacetimer_create(NULL, 0, 1));
+    ASSERT_FALSE(pacetimer_create(&timer, 0, 0));
+    ASSERT_TRUE(pacetimer_create(&timer, 500, 1));
+    ASSERT_FALSE(pacetimer_create(&timer, 500, 1));
+
+    pfd.fd     = pacetimer_getfd(&timer);
+    pfd.events = POLLIN;
+    ASSERT_GE(pfd.fd, 0);
+    ASSERT_FALSE(pacetimer_clear(&timer));
+
+    // A timer fires the spin time before its deadline, and is only armed
+    // once for a deadline.
+    dueus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC) + 20000;
+    ASSERT_TRUE(pacetimer_arm(&timer, dueus));
+    ASSERT_TRUE(pacetimer_arm(&timer, dueus));
+    ASSERT_EQ(1u, timer.arms);
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+    ASSERT_EQ(1, poll(&pfd, 1, 1000));
+    ASSERT_GE(utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC), dueus - 500);
+    ASSERT_TRUE(pacetimer_clear(&timer));
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+
+    // The rest of the time is spun, but a deadline beyond the spin time is
+    // not.
+    ASSERT_FALSE(pacetimer_spin(&timer, dueus + 1000000));
+    pacetimer_spin(&timer, dueus);
+    tsus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC);
+    ASSERT_GE(tsus, dueus);
+    ASSERT_FALSE(pacetimer_spin(&timer, tsus));
+
+    ASSERT_FALSE(pacetimer_destroy(NULL));
+    ASSERT_TRUE(pacetimer_destroy(&timer));
+    ASSERT_FALSE(pacetimer_destroy(&timer));
+}
+
+#define SHARED_TAKES 100000
+
+static void *tokenbucket_sharedthread(void *arg)
+{
+    struct tokenbucket_shared *tb = (struct tokenbucket_shared *)arg;
+    uint32_t i;
+
+    for (i = 0; i < SHARED_TAKES; i++)
+    {
+        tokenbucket_sharedtake(tb, 1, 1000000000);
+    }
+
+    return NULL;
+}
+
+TEST (TokenBucketTest, Shared)
+{
+    struct tokenbucket_shared tb;
+    pthread_t threads[2];
+    uint64_t tsns = 10000000000ULL;
+    uint32_t i;
+
+    ASSERT_FALSE(tokenbucket_sharedinit(NULL, 1000000, 1000));
+
+    // An unlimited bucket always has tokens.
+    ASSERT_TRUE(tokenbucket_sharedinit(&tb, 0, 0));
+    ASSERT_EQ(tsns, tokenbucket_sharedtake(&tb, 1000000, tsns));
+
+    // A bucket that earns a token per microsecond starts full, and tokens
+    // taken beyond its size are earned in turn.
+    ASSERT_TRUE(tokenbucket_sharedinit(&tb, 1000000, 1000));
+    ASSERT_LE(tokenbucket_sharedtake(&tb, 500, tsns), tsns);
+    ASSERT_EQ(tsns, tokenbucket_sharedtake(&tb, 500, tsns));
+    ASSERT_EQ(tsns + 1000, tokenbucket_sharedtake(&tb, 1, tsns));
+    ASSERT_EQ(tsns + 3000, tokenbucket_sharedtake(&tb, 2, tsns));
+
+    // Returned tokens may be taken again.
+    ASSERT_EQ(2u, tokenbucket_sharedreturn(&tb, 2));
+    ASSERT_EQ(tsns + 2000, tokenbucket_sharedtake(&tb, 1, tsns));
+
+    // A bucket never holds more than its size.
+    tsns += 1000000000;
+    ASSERT_LE(tokenbucket_sharedtake(&tb, 1000, tsns), tsns);
+    ASSERT_GT(tokenbucket_sharedtake(&tb, 1, tsns), tsns);
+
+    // Tokens taken by concurrent threads are all accounted for.
+    ASSERT_TRUE(tokenbucket_sharedinit(&tb, 1000000, 1));
+
+    for (i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, tokenbucket_sharedthread, &tb));
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(0, pthread_join(threads[i], NULL));
+    }
+
+    ASSERT_EQ(1000000000ULL - 1000 + 2 * SHARED_TAKES * 1000,
+              tokenbucket_sharedtake(&tb, 0, 1000000000));
+}
+
+#define LEVEL_THREADS 4
+
+// The rate limits of the workers and, last, the rate limit of all workers, as
+// a mode allocates them (see struct modeperf_limit).
+struct tokenbucket_level
+{
+    struct tokenbucket_shared tb;
+    uint8_t                   pad[UTILMEM_CACHELINE -
+                                  sizeof(struct tokenbucket_shared) % UTILMEM_CACHELINE];
+};
+
+TEST (TokenBucketTest, Levels)
+{
+    struct tokenbucket_level *levels = NULL;
+    const uint32_t threads = LEVEL_THREADS;
+    uint64_t readyns, allns, tsns = 10000000000ULL;
+    uint32_t i;
+
+    levels = UTILMEM_ALIGNED_ALLOC(struct tokenbucket_level,
+                                   UTILMEM_CACHELINE,
+                                   sizeof(struct tokenbucket_level),
+                                   threads + 1);
+    ASSERT_NE((struct tokenbucket_level *)NULL, levels);
+    ASSERT_EQ(0U, (uintptr_t)&levels[threads] % UTILMEM_CACHELINE);
+
+    // Each worker earns a token per microsecond, and all workers together
+    // earn two.
+    for (i = 0; i <= threads; i++)
+    {
+        ASSERT_TRUE(tokenbucket_sharedinit(&levels[i].tb,
+                                           (i < threads ? 1000000 : 2000000),
+                                           1000));
+    }
+
+    // A full send of each worker is within its own limit, so the limit of
+    // all workers sets when the tokens are earned.
+    for (i = 0; i < threads; i++)
+    {
+        readyns = tokenbucket_sharedtake(&levels[i].tb, 1000, tsns);
+        allns = tokenbucket_sharedtake(&levels[threads].tb, 1000, tsns);
+        ASSERT_LE(readyns, tsns);
+        ASSERT_EQ(tsns + i * 500000ULL, allns);
+    }
+
+    // Tokens that a worker did not use are returned to both of its limits.
+    ASSERT_EQ(1000U, tokenbucket_sharedreturn(&levels[0].tb, 1000));
+    ASSERT_EQ(1000U, tokenbucket_sharedreturn(&levels[threads].tb, 1000));
+    ASSERT_LE(tokenbucket_sharedtake(&levels[0].tb, 1000, tsns), tsns);
+    ASSERT_EQ(tsns + 1500000ULL,
+              tokenbucket_sharedtake(&levels[threads].tb, 1000, tsns));
+
+    UTILMEM_FREE(levels);
+}
+
+#define HANDOFF_COUNT     200000
+#define HANDOFF_QUEUE        256
+#define HANDOFF_TIMEOUTMS   1000
+#define HANDOFF_DEADLINEUS (10 * UNIT_TIME_USEC)
+
+// A socket handoff from a scheduler thread to a worker, which takes the new
+// sockets from a lock-free queue and waits for more with a doorbell in its
+// event loop (see modeperf_putsock() and modeperf_getsock()).
+struct handoff
+{
+    struct lfqueue     queue;
+    struct doorbellobj bell;
+    bool               stop; // The worker gave up
+};
+
+static void *handoff_scheduler(void *arg)
+{
+    struct handoff *h = (struct handoff*)arg;
+    uintptr_t i;
+
+    for (i = 1; (i <= HANDOFF_COUNT) && (!__atomic_load_n(&h->stop, __ATOMIC_ACQUIRE)); i++)
+    {
+        // A full queue means the worker is behind, so back off until it
+        // catches up rather than dropping the value.
+        while ((!lfqueue_push(&h->queue, (void*)i)) &&
+               (!__atomic_load_n(&h->stop, __ATOMIC_ACQUIRE)))
+        {
+            doorbellobj_ring(&h->bell);
+            usleep(100);
+        }
+
+        doorbellobj_ring(&h->bell);
+    }
+
+    return NULL;
+}
+
+TEST (LfqueueTest, Handoff)
+{
+    struct handoff *h = (struct handoff*)calloc(1, sizeof(struct handoff));
+    struct pollfd pfd;
+    pthread_t thread;
+    uintptr_t expected = 1, val;
+    uint64_t arms = 0, timeouts = 0, deadlineus;
+
+    ASSERT_NE((struct handoff*)NULL, h);
+    ASSERT_TRUE(lfqueue_create(&h->queue, HANDOFF_QUEUE));
+    ASSERT_TRUE(doorbellobj_create(&h->bell));
+    ASSERT_EQ(0, pthread_create(&thread, NULL, handoff_scheduler, h));
+
+    pfd.fd     = doorbellobj_getfd(&h->bell);
+    pfd.events = POLLIN;
+    deadlineus = utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC) +
+                 HANDOFF_DEADLINEUS;
+
+    while ((expected <= HANDOFF_COUNT) &&
+           (utildate_gettstime(DATE_CLOCK_MONOTONIC, UNIT_TIME_USEC) < deadlineus))
+    {
+        if ((val = (uintptr_t)lfqueue_pop(&h->queue)) != 0)
+        {
+            // Values must arrive in order and without loss.
+            if (val != expected)
+            {
+                break;
+            }
+
+            expected++;
+        }
+        else
+        {
+            // Arm the doorbell, check the queue again, and only then block.
+            doorbellobj_arm(&h->bell);
+            arms++;
+
+            if (lfqueue_getsize(&h->queue) == 0)
+            {
+                if (poll(&pfd, 1, HANDOFF_TIMEOUTMS) == 0)
+                {
+                    timeouts++;
+                }
+            }
+
+            doorbellobj_clear(&h->bell);
+        }
+    }
+
+    __atomic_store_n(&h->stop, true, __ATOMIC_RELEASE);
+    ASSERT_EQ(0, pthread_join(thread, NULL));
+
+    ASSERT_EQ((uintptr_t)HANDOFF_COUNT + 1, expected);
+    ASSERT_EQ(NULL, lfqueue_pop(&h->queue));
+
+    // The scheduler writes the doorbell at most once per time that the
+    // worker armed it, and a blocked worker is never left waiting.
+    ASSERT_LE(h->bell.ringcnt, arms);
+    ASSERT_EQ(0u, timeouts);
+
+    ASSERT_TRUE(doorbellobj_destroy(&h->bell));
+    ASSERT_TRUE(lfqueue_destroy(&h->queue));
+    free(h);
+}
@@ -10,9 +10,14 @@
 #include "logger.h"
 #include "mutex_obj.h"
 #include "output_if_std.h"
+#include "util_cpu.h"
 #include "util_date.h"
+#include "util_inet.h"
+#include "util_mem.h"
+#include "util_stats.h"
 #include "util_string.h"
 
+#include <arpa/inet.h>
 #include <gtest/gtest.h>
 
 TEST (ManipStringTest, Compare)
@@ -73,3 +78,205 @@ TEST (ManipStringTest, Concat)
     ASSERT_EQ(strsize, utilstring_concat(buf, strsize, "%s", str));
     ASSERT_EQ(strsize - 1, utilstring_concat(buf, strsize - 1, "%s", str));
 }
+
+TEST (UtilCpuTest, ParseSet)
+{
+    struct utilcpu_set set;
+
+    // Policies.
+    ASSERT_TRUE(utilcpu_parseset("none", &set));
+    ASSERT_EQ(UTILCPU_POLICY_NONE, set.policy);
+    ASSERT_TRUE(utilcpu_parseset("CPU", &set));
+    ASSERT_EQ(UTILCPU_POLICY_CPU, set.policy);
+    ASSERT_TRUE(utilcpu_parseset("core", &set));
+    ASSERT_EQ(UTILCPU_POLICY_CORE, set.policy);
+    ASSERT_EQ(0, set.count);
+
+    // CPU lists.
+    ASSERT_TRUE(utilcpu_parseset("0,2,4-6", &set));
+    ASSERT_EQ(UTILCPU_POLICY_LIST, set.policy);
+    ASSERT_EQ(5, set.count);
+    ASSERT_EQ(0, set.cpus[0]);
+    ASSERT_EQ(2, set.cpus[1]);
+    ASSERT_EQ(4, set.cpus[2]);
+    ASSERT_EQ(6, set.cpus[4]);
+
+    // Invalid policies or CPU lists.
+    ASSERT_FALSE(utilcpu_parseset("", &set));
+    ASSERT_FALSE(utilcpu_parseset("cores", &set));
+    ASSERT_FALSE(utilcpu_parseset("0,", &set));
+    ASSERT_FALSE(utilcpu_parseset("3-1", &set));
+    ASSERT_FALSE(utilcpu_parseset("0-", &set));
+    ASSERT_FALSE(utilcpu_parseset("65536", &set));
+    ASSERT_EQ(UTILCPU_POLICY_NONE, set.policy);
+
+    // A resolved CPU list only contains available CPUs.
+    ASSERT_TRUE(utilcpu_parseset("cpu", &set));
+    ASSERT_TRUE(utilcpu_getset(&set));
+    ASSERT_GT(set.count, 0);
+    ASSERT_GE(utilcpu_getnode(set.cpus[0]), -1);
+}
+
+TEST (UtilInetTest, ParseSet)
+{
+    struct utilinet_set set;
+    struct sockaddr_storage addr;
+    char str[INET6_ADDRSTRLEN];
+
+    // Empty set.
+    ASSERT_TRUE(utilinet_parseset("none", &set));
+    ASSERT_EQ(0, set.count);
+    ASSERT_FALSE(utilinet_getsetaddr(&set, 0, 5001, &addr));
+
+    // Addresses, blocks and ports.
+    ASSERT_TRUE(utilinet_parseset("10.0.0.1,10.0.1.0/30:6001-6002,[::1]:7001", &set));
+    ASSERT_EQ(3, set.count);
+    ASSERT_EQ(1U + 2 * 2 + 1, set.size);
+
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 0, 5001, &addr));
+    ASSERT_STREQ("10.0.0.1", inet_ntop(AF_INET, utilinet_getaddrfromstorage(&addr), str, sizeof(str)));
+    ASSERT_EQ(5001, ntohs(*utilinet_getportfromstorage(&addr)));
+
+    // The network and broadcast addresses of a block are skipped, and the
+    // addresses of a range are visited before its ports.
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 2, 5001, &addr));
+    ASSERT_STREQ("10.0.1.2", inet_ntop(AF_INET, utilinet_getaddrfromstorage(&addr), str, sizeof(str)));
+    ASSERT_EQ(6001, ntohs(*utilinet_getportfromstorage(&addr)));
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 3, 5001, &addr));
+    ASSERT_STREQ("10.0.1.1", inet_ntop(AF_INET, utilinet_getaddrfromstorage(&addr), str, sizeof(str)));
+    ASSERT_EQ(6002, ntohs(*utilinet_getportfromstorage(&addr)));
+
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 5, 5001, &addr));
+    ASSERT_EQ(AF_INET6, addr.ss_family);
+    ASSERT_EQ(7001, ntohs(*utilinet_getportfromstorage(&addr)));
+
+    // An index wraps around the set.
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 6, 5001, &addr));
+    ASSERT_STREQ("10.0.0.1", inet_ntop(AF_INET, utilinet_getaddrfromstorage(&addr), str, sizeof(str)));
+
+    ASSERT_TRUE(utilinet_parseset("fd00::1/120", &set));
+    ASSERT_EQ(256U, set.size);
+    ASSERT_TRUE(utilinet_getsetaddr(&set, 255, 5001, &addr));
+    ASSERT_STREQ("fd00::ff", inet_ntop(AF_INET6, utilinet_getaddrfromstorage(&addr), str, sizeof(str)));
+
+    // Invalid sets.
+    ASSERT_FALSE(utilinet_parseset("", &set));
+    ASSERT_FALSE(utilinet_parseset("10.0.0.1,", &set));
+    ASSERT_FALSE(utilinet_parseset("10.0.0.256", &set));
+    ASSERT_FALSE(utilinet_parseset("10.0.0.0/4", &set));
+    ASSERT_FALSE(utilinet_parseset("10.0.0.1:0", &set));
+    ASSERT_FALSE(utilinet_parseset("10.0.0.1:6002-6001", &set));
+    ASSERT_FALSE(utilinet_parseset("[::1", &set));
+    ASSERT_EQ(0, set.count);
+}
+
+TEST (UtilStatsTest, Hist)
+{
+    const uint32_t permille[] = { 500, 990, 1000 };
+    struct utilstats_hist hist, prev, total;
+    uint64_t vals[3];
+    uint64_t i;
+
+    memset(&hist, 0, sizeof(hist));
+    memset(&total, 0, sizeof(total));
+
+    ASSERT_EQ(0U, utilstats_histget(&hist, permille, vals, 3));
+    ASSERT_EQ(0U, vals[2]);
+
+    // Small values are recorded exactly.
+    for (i = 1; i <= 100; i++)
+    {
+        ASSERT_TRUE(utilstats_histrecord(&hist, i));
+    }
+
+    ASSERT_EQ(100U, utilstats_histget(&hist, permille, vals, 3));
+    ASSERT_EQ(50U, vals[0]);
+    ASSERT_EQ(99U, vals[1]);
+    ASSERT_EQ(100U, vals[2]);
+
+    // A large value is off by no more than 1/32.
+    utilstats_histcopy(&prev, &hist);
+    ASSERT_TRUE(utilstats_histrecord(&hist, 1000000));
+    ASSERT_EQ(101U, utilstats_histget(&hist, permille, vals, 3));
+    ASSERT_GE(vals[2], 1000000U);
+    ASSERT_LE(vals[2], 1000000U + 1000000U / 32);
+
+    // Merging the difference of two snapshots adds only the newer samples.
+    ASSERT_TRUE(utilstats_histmerge(&total, &hist, &prev));
+    ASSERT_EQ(1U, utilstats_histget(&total, permille, vals, 3));
+    ASSERT_EQ(vals[0], vals[2]);
+    ASSERT_TRUE(utilstats_histmerge(&total, &prev, NULL));
+    ASSERT_EQ(101U, utilstats_histget(&total, permille, vals, 3));
+
+    // Values beyond the largest power of two are clamped.
+    ASSERT_TRUE(utilstats_histrecord(&total, UINT64_MAX));
+    ASSERT_EQ(102U, utilstats_histget(&total, permille, vals, 3));
+    ASSERT_EQ((2ULL << UTILSTATS_HISTEXP) - 1, vals[2]);
+}
+
+TEST (UtilStatsTest, HistBounds)
+{
+    const uint32_t permille[] = { 0, 500, 1000 };
+    struct utilstats_hist hist, prev, diff;
+    uint64_t vals[3];
+    uint32_t i;
+
+    // Samples of a single value are reported exactly rather than as the
+    // largest value of their bucket.
+    memset(&hist, 0, sizeof(hist));
+
+    for (i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(utilstats_histrecord(&hist, 1000));
+    }
+
+    ASSERT_EQ(10U, utilstats_histget(&hist, permille, vals, 3));
+    ASSERT_EQ(1000U, vals[0]);
+    ASSERT_EQ(1000U, vals[1]);
+    ASSERT_EQ(1000U, vals[2]);
+
+    // The minimum and maximum are exact.
+    ASSERT_TRUE(utilstats_histrecord(&hist, 128000));
+    ASSERT_TRUE(utilstats_histrecord(&hist, 0));
+    ASSERT_EQ(12U, utilstats_histget(&hist, permille, vals, 3));
+    ASSERT_EQ(0U, vals[0]);
+    ASSERT_GE(vals[1], 1000U);
+    ASSERT_LE(vals[1], 1000U + 1000U / 32);
+    ASSERT_EQ(128000U, vals[2]);
+
+    // The difference of two snapshots is bounded by its own buckets and by
+    // the smallest and largest samples of the newer snapshot.
+    utilstats_histcopy(&prev, &hist);
+    ASSERT_TRUE(utilstats_histrecord(&hist, 5000));
+    memset(&diff, 0, sizeof(diff));
+    ASSERT_TRUE(utilstats_histmerge(&diff, &hist, &prev));
+    ASSERT_EQ(1U, utilstats_histget(&diff, permille, vals, 3));
+    ASSERT_LE(vals[0], 5000U);
+    ASSERT_GE(vals[0], 5000U - 5000U / 32);
+    ASSERT_GE(vals[2], 5000U);
+    ASSERT_LE(vals[2], 5000U + 5000U / 32);
+
+    // An empty difference leaves the bounds of a histogram unchanged.
+    memset(&diff, 0, sizeof(diff));
+    ASSERT_TRUE(utilstats_histmerge(&diff, &prev, &prev));
+    ASSERT_EQ(0U, diff.max);
+    ASSERT_EQ(0U, diff.minnot);
+}
+
+TEST (UtilMemTest, AlignedAlloc)
+{
+    const uint32_t count = 3;
+    uint8_t *mem = NULL;
+
+    // The element count is an expression, and the size is rounded up to a
+    // multiple of the alignment.
+    ASSERT_EQ(32U, UTILMEM_ALIGNED_SIZE(8, 16, count - 2 + 1));
+    ASSERT_EQ(64U, UTILMEM_ALIGNED_SIZE(64, 20, count));
+    ASSERT_EQ(128U, UTILMEM_ALIGNED_SIZE(64, 65, 1));
+
+    mem = UTILMEM_ALIGNED_ALLOC(uint8_t, 64, 40, count + 1);
+    ASSERT_NE((uint8_t *)NULL, mem);
+    ASSERT_EQ(0U, (uintptr_t)mem % 64);
+    memset(mem, 0, 40 * (count + 1));
+    UTILMEM_FREE(mem);
+}